@@ -0,0 +1,102 @@
+#ifndef DRIVE_MIXER_H
+#define DRIVE_MIXER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief 差速底盘混控
+ *
+ * 把前进速度v和转向w(均为-1~1)混合为左右轮命令: left = v + w, right = v - w,
+ * 超出范围时两轮按同一比例缩小以保持转弯半径。每个轮子再经过死区、
+ * 起转占空比和增益补偿换算为带符号的PWM占空比, 最后按加速/减速斜率限幅输出。
+ * 不依赖Arduino, 可直接在主机上编译。
+ */
+
+#define DRIVE_WHEEL_LEFT 0  /**< 左轮(电机A) */
+#define DRIVE_WHEEL_RIGHT 1 /**< 右轮(电机B) */
+#define DRIVE_WHEEL_NUM 2
+
+/**
+ * @brief 混控参数
+ */
+typedef struct
+{
+    float deadband;                    /**< 轮子命令绝对值小于此值时输出0 */
+    uint16_t max_duty;                 /**< 最大占空比(PWM满量程) */
+    uint16_t min_duty[DRIVE_WHEEL_NUM]; /**< 起转占空比, 克服静摩擦, 每个电机单独标定 */
+    float gain[DRIVE_WHEEL_NUM];       /**< 增益补偿, 较快的电机设为小于1使两轮同速 */
+    float accel_rate;                  /**< 占空比绝对值增大的最大速率(每秒) */
+    float decel_rate;                  /**< 占空比绝对值减小的最大速率(每秒) */
+} drive_mixer_config_t;
+
+/**
+ * @brief 混控状态
+ */
+typedef struct
+{
+    drive_mixer_config_t config;
+    float target[DRIVE_WHEEL_NUM]; /**< 目标占空比(带符号) */
+    float duty[DRIVE_WHEEL_NUM];   /**< 当前输出占空比(带符号) */
+} drive_mixer_t;
+
+/**
+ * @brief 获取默认参数(8位PWM, 起转占空比70, 0到满速0.5秒, 满速到停0.1秒)
+ *
+ * @param config 输出参数
+ */
+void drive_mixer_default_config(drive_mixer_config_t *config);
+
+/**
+ * @brief 初始化混控, 输出为0
+ *
+ * @param mixer 混控状态
+ * @param config 参数, 为NULL时使用默认参数
+ */
+void drive_mixer_init(drive_mixer_t *mixer, const drive_mixer_config_t *config);
+
+/**
+ * @brief 差速混合
+ *
+ * @param v 前进速度(-1~1), 负数后退, 超出范围时限幅, 非有限值按0处理
+ * @param w 转向(-1~1), 正数右转, 同上
+ * @param left 输出左轮命令(-1~1)
+ * @param right 输出右轮命令(-1~1)
+ */
+void drive_mix(float v, float w, float *left, float *right);
+
+/**
+ * @brief 轮子命令换算为占空比(死区、起转占空比、增益补偿)
+ *
+ * @param config 参数
+ * @param wheel 轮子 DRIVE_WHEEL_xxx
+ * @param command 轮子命令(-1~1)
+ * @return float 带符号占空比
+ */
+float drive_wheel_duty(const drive_mixer_config_t *config, uint8_t wheel, float command);
+
+/**
+ * @brief 设置目标速度和转向, 输出由drive_mixer_update逐步逼近
+ *
+ * @param mixer 混控状态
+ * @param v 前进速度(-1~1)
+ * @param w 转向(-1~1)
+ */
+void drive_mixer_set(drive_mixer_t *mixer, float v, float w);
+
+/**
+ * @brief 按斜率限幅更新输出, 以固定周期调用
+ *
+ * @param mixer 混控状态
+ * @param dt 距上次调用的时间(s)
+ */
+void drive_mixer_update(drive_mixer_t *mixer, float dt);
+
+/**
+ * @brief 立即停止(不经过斜率限幅), 用于超时停车
+ *
+ * @param mixer 混控状态
+ */
+void drive_mixer_stop(drive_mixer_t *mixer);
+
+#endif // DRIVE_MIXER_H
@@ -0,0 +1,142 @@
+#ifndef TELEOP_PROTOCOL_H
+#define TELEOP_PROTOCOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief UDP遥控协议
+ *
+ * 命令包(14字节, 数值为小端):
+ *   0xC5 0x5C | VER | TYPE | SEQ(u16) | SPEED(i16) | TURN(i16) | CLIENT_MS(u32)
+ * 应答包(14字节):
+ *   0xC5 0x5C | VER | TELEOP_TYPE_ACK | SEQ(u16) | CLIENT_MS(u32) | STATUS | 0 | STALE(u16)
+ *
+ * 上位机以固定频率(建议50Hz)重复发送当前命令, 每个包同时作为心跳;
+ * 超过TELEOP_DEADMAN_MS没有收到有效包时停车。序号不大于上一个有效包的包(重复或乱序)直接丢弃,
+ * 停车超时后仍然检查, WiFi卡顿后才到达的旧包不会重新开动小车。
+ * 上位机新会话(重启)时在TYPE中置TELEOP_FLAG_SYNC, 直到收到第一个应答, 小车接受其中任意序号;
+ * 超过TELEOP_RESYNC_MS没有有效包时也接受任意序号。
+ * 不依赖Arduino, 可直接在主机上编译。
+ */
+#define TELEOP_PORT 4210
+#define TELEOP_MAGIC1 0xC5
+#define TELEOP_MAGIC2 0x5C
+#define TELEOP_VERSION 1
+#define TELEOP_PACKET_LEN 14
+#define TELEOP_ACK_LEN 14
+#define TELEOP_DEADMAN_MS 100 /**< 心跳超时停车时间 */
+#define TELEOP_RESYNC_MS 3000 /**< 超过此时间没有有效包时接受任意序号 */
+#define TELEOP_VALUE_MAX 1000 /**< SPEED/TURN范围为±1000(千分比) */
+
+/**
+ * @brief 包类型
+ */
+#define TELEOP_TYPE_DRIVE 0x01 /**< 行驶命令 */
+#define TELEOP_TYPE_STOP 0x02  /**< 立即停车(忽略SPEED/TURN), 链路保持有效 */
+#define TELEOP_TYPE_ACK 0x80   /**< 应答 */
+#define TELEOP_FLAG_SYNC 0x40  /**< TYPE的标志位: 新会话, 重新同步序号 */
+
+/**
+ * @brief 应答状态位
+ */
+#define TELEOP_STATUS_ACTIVE 0x01 /**< 链路有效, 正在执行命令 */
+#define TELEOP_STATUS_TIMEOUT 0x02 /**< 此前发生过心跳超时停车 */
+
+/**
+ * @brief 错误码定义
+ */
+#define TELEOP_EOK 0    /**< 操作成功 */
+#define TELEOP_EINVAL 1 /**< 长度、帧头、版本、类型或数值无效 */
+#define TELEOP_ESTALE 2 /**< 重复或乱序的包 */
+
+/**
+ * @brief 命令包内容
+ */
+typedef struct
+{
+    uint8_t type;       /**< 包类型 TELEOP_TYPE_xxx(不含标志位) */
+    bool sync;          /**< 带TELEOP_FLAG_SYNC标志 */
+    uint16_t seq;       /**< 序号, 每包加1, 回绕 */
+    int16_t speed;      /**< 前进速度(千分比), 负数为后退 */
+    int16_t turn;       /**< 转向(千分比), 正数为右转 */
+    uint32_t client_ms; /**< 上位机发送时间, 在应答中原样返回 */
+} teleop_cmd_t;
+
+/**
+ * @brief 链路状态(序号和心跳)
+ */
+typedef struct
+{
+    bool active;         /**< 心跳未超时 */
+    bool synced;         /**< 已收到过有效包, last_seq有效 */
+    uint16_t last_seq;   /**< 最近一个有效包的序号, 停车超时后保留 */
+    uint32_t last_ms;    /**< 最近一个有效包的接收时间 */
+    uint32_t timeout_ms; /**< 心跳超时时间 */
+    uint32_t accepted;   /**< 有效包数 */
+    uint32_t stale;      /**< 丢弃的重复或乱序包数 */
+    uint32_t invalid;    /**< 格式错误的包数 */
+    uint32_t lost;       /**< 根据序号推算的丢包数 */
+    uint32_t timeouts;   /**< 心跳超时次数 */
+    uint32_t resyncs;    /**< 重新同步序号的次数(新会话或长时间空闲) */
+} teleop_link_t;
+
+/**
+ * @brief 解析命令包
+ *
+ * @param data 收到的数据
+ * @param len 数据长度
+ * @param cmd 输出命令
+ * @return uint8_t 错误码(0=成功，TELEOP_EINVAL=无效包)
+ */
+uint8_t teleop_decode(const uint8_t *data, size_t len, teleop_cmd_t *cmd);
+
+/**
+ * @brief 编码命令包(供上位机或回环测试使用)
+ *
+ * @param cmd 命令
+ * @param buf 输出缓冲区, 至少TELEOP_PACKET_LEN字节
+ */
+void teleop_encode(const teleop_cmd_t *cmd, uint8_t *buf);
+
+/**
+ * @brief 编码应答包
+ *
+ * @param link 链路状态
+ * @param cmd 被应答的命令
+ * @param buf 输出缓冲区, 至少TELEOP_ACK_LEN字节
+ */
+void teleop_encode_ack(const teleop_link_t *link, const teleop_cmd_t *cmd, uint8_t *buf);
+
+/**
+ * @brief 初始化链路状态
+ *
+ * @param link 链路状态
+ * @param timeout_ms 心跳超时时间
+ */
+void teleop_link_init(teleop_link_t *link, uint32_t timeout_ms);
+
+/**
+ * @brief 检查序号并刷新心跳
+ * 首个包、带TELEOP_FLAG_SYNC的包或空闲超过TELEOP_RESYNC_MS后接受任意序号(上位机重启后重新同步),
+ * 其他情况(包括停车超时后)序号必须大于上一个有效包
+ *
+ * @param link 链路状态
+ * @param cmd 解析出的命令
+ * @param now_ms 当前时间
+ * @return uint8_t 错误码(0=接受，TELEOP_ESTALE=丢弃)
+ */
+uint8_t teleop_link_accept(teleop_link_t *link, const teleop_cmd_t *cmd, uint32_t now_ms);
+
+/**
+ * @brief 检查心跳是否超时, 超时时链路变为无效
+ *
+ * @param link 链路状态
+ * @param now_ms 当前时间
+ * @return true 本次调用时刚超时(只返回一次), 调用者应停车
+ * @return false 未超时或早已超时
+ */
+bool teleop_link_expired(teleop_link_t *link, uint32_t now_ms);
+
+#endif // TELEOP_PROTOCOL_H
@@ -0,0 +1,116 @@
+#include "drive_mixer.h"
+
+#include <string.h>
+#include <math.h>
+
+static float clampf(float value, float low, float high)
+{
+    return value < low ? low : (value > high ? high : value);
+}
+
+void drive_mixer_default_config(drive_mixer_config_t *config)
+{
+    config->deadband = 0.05f;
+    config->max_duty = 255;
+    config->min_duty[DRIVE_WHEEL_LEFT] = 70;
+    config->min_duty[DRIVE_WHEEL_RIGHT] = 70;
+    config->gain[DRIVE_WHEEL_LEFT] = 1.0f;
+    config->gain[DRIVE_WHEEL_RIGHT] = 1.0f;
+    config->accel_rate = 510.0f;
+    config->decel_rate = 2550.0f;
+}
+
+void drive_mixer_init(drive_mixer_t *mixer, const drive_mixer_config_t *config)
+{
+    memset(mixer, 0, sizeof(*mixer));
+    if (config != NULL)
+        mixer->config = *config;
+    else
+        drive_mixer_default_config(&mixer->config);
+}
+
+void drive_mix(float v, float w, float *left, float *right)
+{
+    // NaN会穿过clampf, 非有限值按0处理
+    if (!isfinite(v))
+        v = 0.0f;
+    if (!isfinite(w))
+        w = 0.0f;
+    v = clampf(v, -1.0f, 1.0f);
+    w = clampf(w, -1.0f, 1.0f);
+    float l = v + w;
+    float r = v - w;
+
+    // 超出范围时等比例缩小, 保持两轮速度比(转弯半径)不变
+    float m = fabsf(l) > fabsf(r) ? fabsf(l) : fabsf(r);
+    if (m > 1.0f)
+    {
+        l /= m;
+        r /= m;
+    }
+    *left = l;
+    *right = r;
+}
+
+float drive_wheel_duty(const drive_mixer_config_t *config, uint8_t wheel, float command)
+{
+    float mag = fabsf(command);
+    if (mag < config->deadband)
+        return 0.0f;
+    if (mag > 1.0f)
+        mag = 1.0f;
+
+    // 死区外从起转占空比线性增加到满量程, 再乘增益补偿
+    float span = 1.0f - config->deadband;
+    float ratio = span > 0.0f ? (mag - config->deadband) / span : 1.0f;
+    float min_duty = config->min_duty[wheel];
+    float duty = (min_duty + (config->max_duty - min_duty) * ratio) * config->gain[wheel];
+    duty = clampf(duty, 0.0f, config->max_duty);
+    return command < 0.0f ? -duty : duty;
+}
+
+void drive_mixer_set(drive_mixer_t *mixer, float v, float w)
+{
+    float cmd[DRIVE_WHEEL_NUM];
+    drive_mix(v, w, &cmd[DRIVE_WHEEL_LEFT], &cmd[DRIVE_WHEEL_RIGHT]);
+    for (uint8_t i = 0; i < DRIVE_WHEEL_NUM; i++)
+        mixer->target[i] = drive_wheel_duty(&mixer->config, i, cmd[i]);
+}
+
+// 单个轮子向目标逼近: 绝对值减小(含过零反向的前半段)按减速斜率, 增大按加速斜率
+static float slew(float duty, float target, float accel_step, float decel_step)
+{
+    if (duty != 0.0f && (target == 0.0f || (duty > 0.0f) != (target > 0.0f)))
+    {
+        // 反向或停止: 先减速到0
+        float mag = fabsf(duty) - decel_step;
+        if (mag > 0.0f)
+            return duty > 0.0f ? mag : -mag;
+        if (target == 0.0f)
+            return 0.0f;
+        duty = 0.0f;
+    }
+
+    if (fabsf(target) > fabsf(duty))
+        return duty + clampf(target - duty, -accel_step, accel_step);
+    return duty + clampf(target - duty, -decel_step, decel_step);
+}
+
+void drive_mixer_update(drive_mixer_t *mixer, float dt)
+{
+    if (dt < 0.0f)
+        dt = 0.0f;
+    float accel_step = mixer->config.accel_rate * dt;
+    float decel_step = mixer->config.decel_rate * dt;
+    for (uint8_t i = 0; i < DRIVE_WHEEL_NUM; i++)
+        mixer->duty[i] = slew(mixer->duty[i], mixer->target[i], accel_step, decel_step);
+}
+
+void drive_mixer_stop(drive_mixer_t *mixer)
+{
+    for (uint8_t i = 0; i < DRIVE_WHEEL_NUM; i++)
+    {
+        mixer->target[i] = 0.0f;
+        mixer->duty[i] = 0.0f;
+    }
+}
@@ -2,15 +2,29 @@
 #include <WiFi.h>
 #include <WebServer.h>
 #include <ESPmDNS.h>
+#include <WiFiUdp.h>
+#include "teleop_protocol.h"
+#include "drive_mixer.h"
 
 // 定义连接到L298N的引脚
-const int motorAin1 = 17; // 电机A的输入1
-const int motorAin2 = 16; // 电机A的输入2
-const int motorBin1 = 5;  // 电机B的输入1
-const int motorBin2 = 18; // 电机B的输入2
+const int motorAin1 = 17; // 电机A(左轮)的输入1
+const int motorAin2 = 16; // 电机A(左轮)的输入2
+const int motorBin1 = 5;  // 电机B(右轮)的输入1
+const int motorBin2 = 18; // 电机B(右轮)的输入2
 const int enA = 19;       // 电机A的使能引脚
 const int enB = 21;       // 电机B的使能引脚
 
+// 使能引脚的LEDC通道，每个电机独立占空比
+#define PWM_CHANNEL_A 0
+#define PWM_CHANNEL_B 1
+#define PWM_FREQ 1000 // L298N适合较低的PWM频率
+#define PWM_BITS 8    // 占空比0-255，与drive_mixer默认max_duty一致
+#define DRIVE_PERIOD_MS 10 // 混控斜率更新周期
+
+// 差速混控，命令只设置目标，loop按固定周期逼近
+drive_mixer_t driveMixer;
+unsigned long lastDriveUpdate = 0;
+
 // 初始化电机控制函数
 void setupMotorPins()
 {
@@ -18,46 +32,26 @@ void setupMotorPins()
   pinMode(motorAin2, OUTPUT);
   pinMode(motorBin1, OUTPUT);
   pinMode(motorBin2, OUTPUT);
-  pinMode(enA, OUTPUT);
-  pinMode(enB, OUTPUT);
-
-  digitalWrite(enA, LOW); // 默认使ENA处于启用状态
-  digitalWrite(enB, LOW); // 默认使ENB处于启用状态
-}
-
-// 函数声明
-void setMotorSpeed(int motorPin1, int motorPin2, int speed);
-void stopMotor(int motorPin1, int motorPin2);
-void enableMotor(int enPin);
-void disableMotor(int enPin);
-void moveForward();
-void moveBackward();
-void turnLeft();
-void turnRight();
 
-// setup 和 loop 函数保持不变
+  ledcSetup(PWM_CHANNEL_A, PWM_FREQ, PWM_BITS);
+  ledcSetup(PWM_CHANNEL_B, PWM_FREQ, PWM_BITS);
+  ledcAttachPin(enA, PWM_CHANNEL_A);
+  ledcAttachPin(enB, PWM_CHANNEL_B);
+  ledcWrite(PWM_CHANNEL_A, 0);
+  ledcWrite(PWM_CHANNEL_B, 0);
 
-// 启用电机
-void enableMotor(int enPin)
-{
-  digitalWrite(enPin, HIGH);
+  drive_mixer_init(&driveMixer, NULL);
 }
 
-// 禁用电机
-void disableMotor(int enPin)
+// 设置单个电机的方向和占空比（正数向前，负数向后）
+void setMotorSpeed(int motorPin1, int motorPin2, uint8_t channel, int duty)
 {
-  digitalWrite(enPin, LOW);
-}
-
-// 设置电机速度（正数向前，负数向后）
-void setMotorSpeed(int motorPin1, int motorPin2, int speed)
-{
-  if (speed > 0)
+  if (duty > 0)
   {
     digitalWrite(motorPin1, HIGH);
     digitalWrite(motorPin2, LOW);
   }
-  else if (speed < 0)
+  else if (duty < 0)
   {
     digitalWrite(motorPin1, LOW);
     digitalWrite(motorPin2, HIGH);
@@ -67,104 +61,118 @@ void setMotorSpeed(int motorPin1, int motorPin2, int speed)
     digitalWrite(motorPin1, LOW);
     digitalWrite(motorPin2, LOW);
   }
-  analogWrite(enA, abs(speed));
-  analogWrite(enB, abs(speed));
-}
-
-// 停止电机
-void stopMotor(int motorPin1, int motorPin2)
-{
-  digitalWrite(motorPin1, LOW);
-  digitalWrite(motorPin2, LOW);
-  analogWrite(enA, 0);
-  analogWrite(enB, 0);
-}
-
-// 小车前进
-void moveForward()
-{
-  setMotorSpeed(motorAin1, motorAin2, 150); // 电机A向前
-  setMotorSpeed(motorBin1, motorBin2, 150); // 电机B向前
+  ledcWrite(channel, abs(duty));
 }
 
-// 小车后退
-void moveBackward()
+// 把混控输出写到两个电机
+void writeMotors()
 {
-  setMotorSpeed(motorAin1, motorAin2, -150); // 电机A向后
-  setMotorSpeed(motorBin1, motorBin2, -150); // 电机B向后
+  setMotorSpeed(motorAin1, motorAin2, PWM_CHANNEL_A, (int)lroundf(driveMixer.duty[DRIVE_WHEEL_LEFT]));
+  setMotorSpeed(motorBin1, motorBin2, PWM_CHANNEL_B, (int)lroundf(driveMixer.duty[DRIVE_WHEEL_RIGHT]));
 }
 
-// 小车左转
-void turnLeft()
+// 立即停止两个电机(不经过斜率限幅)
+void stopMotors()
 {
-  setMotorSpeed(motorAin1, motorAin2, -150); // 电机A向后
-  setMotorSpeed(motorBin1, motorBin2, 150);  // 电机B向前
+  drive_mixer_stop(&driveMixer);
+  writeMotors();
 }
 
-// 小车右转
-void turnRight()
+// 按固定周期更新混控输出
+void updateMotors()
 {
-  setMotorSpeed(motorAin1, motorAin2, 150);  // 电机A向前
-  setMotorSpeed(motorBin1, motorBin2, -150); // 电机B向后
+  unsigned long now = millis();
+  if (now - lastDriveUpdate < DRIVE_PERIOD_MS)
+  {
+    return;
+  }
+  drive_mixer_update(&driveMixer, (now - lastDriveUpdate) / 1000.0f);
+  lastDriveUpdate = now;
+  writeMotors();
 }
 
-
 // 接收信息的web server 监听80端口
 WebServer server(80);
 
+// UDP遥控通道，心跳超时TELEOP_DEADMAN_MS后停车
+WiFiUDP teleopUdp;
+teleop_link_t teleopLink;
+
 unsigned long timeNow = 0;
 unsigned long lastDataTickTime = 0;
+unsigned long commandTimeout = 1000; // 最近一次命令来源的超时时间：HTTP为1秒
 
 int LED_BUILTIN = 2;
 bool ledShow = false;
 int ledLoopTick = -1;
 
+// 按速度和转向(±100)设置目标，比例混合为左右轮占空比
+void applyDrive(float speed, float turn)
+{
+  drive_mixer_set(&driveMixer, speed / 100.0f, turn / 100.0f);
+}
+
 void handleRoot()
 {
   String c = server.arg("c");
   // Serial.println(c.c_str());
-  float speed, turn;
-  sscanf(c.c_str(), "c:%f,%f", &speed, &turn);
+  float speed = 0, turn = 0;
+  if (sscanf(c.c_str(), "c:%f,%f", &speed, &turn) != 2 || !isfinite(speed) || !isfinite(turn))
+  {
+    // 格式错误或非有限值(nan/inf)不执行, 也不刷新命令超时
+    server.send(400, "text/plain", "bad command");
+    return;
+  }
   Serial.println("speed: " + String(speed) + " turn: " + String(turn));
-  if(speed > turn)
+  applyDrive(speed, turn);
+  lastDataTickTime = millis();
+  commandTimeout = 1000;
+  server.send(200, "text/plain", "success");
+}
+
+// 处理已到达的全部UDP遥控包，每个有效包立即执行并应答
+void handleTeleop()
+{
+  uint8_t buf[TELEOP_PACKET_LEN + 1];
+  uint8_t ack[TELEOP_ACK_LEN];
+  teleop_cmd_t cmd;
+
+  while (teleopUdp.parsePacket() > 0)
   {
-    if (speed > 10)
-    {
-      moveForward();
-    }
-    else if (speed < -10)
-    {
-      moveBackward();
-    }
-    else
+    int len = teleopUdp.read(buf, sizeof(buf));
+    if (len <= 0 || teleop_decode(buf, len, &cmd) != TELEOP_EOK)
     {
-      stopMotor(motorAin1, motorAin2);
-      stopMotor(motorBin1, motorBin2);
+      teleopLink.invalid++;
+      continue;
     }
-  }
-  else if(speed < turn)
-  {
-    if (turn > 10)
+    if (teleop_link_accept(&teleopLink, &cmd, millis()) != TELEOP_EOK)
     {
-      turnRight();
+      continue; // 重复或乱序的旧包，不执行也不应答
     }
-    else if (turn < -10)
+
+    if (cmd.type == TELEOP_TYPE_STOP)
     {
-      turnLeft();
+      stopMotors();
     }
     else
     {
-      stopMotor(motorAin1, motorAin2);
-      stopMotor(motorBin1, motorBin2);
+      applyDrive(cmd.speed / 10.0f, cmd.turn / 10.0f);
     }
+    lastDataTickTime = millis();
+    commandTimeout = TELEOP_DEADMAN_MS;
+
+    teleop_encode_ack(&teleopLink, &cmd, ack);
+    teleopUdp.beginPacket(teleopUdp.remoteIP(), teleopUdp.remotePort());
+    teleopUdp.write(ack, sizeof(ack));
+    teleopUdp.endPacket();
   }
-  else
+
+  if (teleop_link_expired(&teleopLink, millis()))
   {
-    stopMotor(motorAin1, motorAin2);
-    stopMotor(motorBin1, motorBin2);
+    stopMotors();
+    Serial.printf("[TELEOP] deadman stop (accepted: %u, stale: %u, lost: %u, invalid: %u, resyncs: %u)\n",
+                  teleopLink.accepted, teleopLink.stale, teleopLink.lost, teleopLink.invalid, teleopLink.resyncs);
   }
-  lastDataTickTime = millis();
-  server.send(200, "text/plain", "success");
 }
 
 void registerEvent()
@@ -174,6 +182,10 @@ void registerEvent()
   server.enableCORS();
   server.begin();
   Serial.println("HTTP server started");
+
+  teleop_link_init(&teleopLink, TELEOP_DEADMAN_MS);
+  teleopUdp.begin(TELEOP_PORT);
+  Serial.printf("UDP teleop on port %d\n", TELEOP_PORT);
 }
 
 void setup()
@@ -188,6 +200,7 @@ void setup()
   Serial.println();
   Serial.print("Configuring access point...");
   WiFi.softAP("txw", "twx20051");
+  WiFi.setSleep(false); // 关闭省电模式，降低遥控包的接收延迟
   IPAddress myIP = WiFi.softAPIP();
   Serial.print("AP IP address: ");
   Serial.println(myIP);
@@ -203,13 +216,14 @@ void setup()
 void loop()
 {
   server.handleClient();
+  handleTeleop();
+  updateMotors();
   timeNow = millis();
 
-  if (timeNow > lastDataTickTime && timeNow - lastDataTickTime > 1000)
+  if (timeNow > lastDataTickTime && timeNow - lastDataTickTime > commandTimeout)
   {
-    // 超过1秒未收到数据，自动停止，开始闪灯
-    stopMotor(motorAin1, motorAin2);
-    stopMotor(motorBin1, motorBin2);
+    // 超时未收到数据(HTTP 1秒，UDP 100ms)，自动停止，开始闪灯
+    stopMotors();
 
     ledLoopTick += 1;
     if (ledLoopTick >= 50)
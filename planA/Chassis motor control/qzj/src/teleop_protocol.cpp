@@ -0,0 +1,116 @@
+#include "teleop_protocol.h"
+
+#include <string.h>
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static void put_header(uint8_t *buf, uint8_t type)
+{
+    buf[0] = TELEOP_MAGIC1;
+    buf[1] = TELEOP_MAGIC2;
+    buf[2] = TELEOP_VERSION;
+    buf[3] = type;
+}
+
+uint8_t teleop_decode(const uint8_t *data, size_t len, teleop_cmd_t *cmd)
+{
+    if (len != TELEOP_PACKET_LEN || data[0] != TELEOP_MAGIC1 || data[1] != TELEOP_MAGIC2 || data[2] != TELEOP_VERSION)
+        return TELEOP_EINVAL;
+    uint8_t type = data[3] & ~TELEOP_FLAG_SYNC;
+    if (type != TELEOP_TYPE_DRIVE && type != TELEOP_TYPE_STOP)
+        return TELEOP_EINVAL;
+
+    cmd->type = type;
+    cmd->sync = (data[3] & TELEOP_FLAG_SYNC) != 0;
+    cmd->seq = get_u16(data + 4);
+    cmd->speed = (int16_t)get_u16(data + 6);
+    cmd->turn = (int16_t)get_u16(data + 8);
+    cmd->client_ms = get_u32(data + 10);
+
+    if (cmd->speed > TELEOP_VALUE_MAX || cmd->speed < -TELEOP_VALUE_MAX ||
+        cmd->turn > TELEOP_VALUE_MAX || cmd->turn < -TELEOP_VALUE_MAX)
+        return TELEOP_EINVAL;
+    return TELEOP_EOK;
+}
+
+void teleop_encode(const teleop_cmd_t *cmd, uint8_t *buf)
+{
+    put_header(buf, cmd->type | (cmd->sync ? TELEOP_FLAG_SYNC : 0));
+    put_u16(buf + 4, cmd->seq);
+    put_u16(buf + 6, (uint16_t)cmd->speed);
+    put_u16(buf + 8, (uint16_t)cmd->turn);
+    put_u32(buf + 10, cmd->client_ms);
+}
+
+void teleop_encode_ack(const teleop_link_t *link, const teleop_cmd_t *cmd, uint8_t *buf)
+{
+    put_header(buf, TELEOP_TYPE_ACK);
+    put_u16(buf + 4, cmd->seq);
+    put_u32(buf + 6, cmd->client_ms);
+    buf[10] = (link->active ? TELEOP_STATUS_ACTIVE : 0) | (link->timeouts > 0 ? TELEOP_STATUS_TIMEOUT : 0);
+    buf[11] = 0;
+    put_u16(buf + 12, (uint16_t)(link->stale > 0xFFFF ? 0xFFFF : link->stale));
+}
+
+void teleop_link_init(teleop_link_t *link, uint32_t timeout_ms)
+{
+    memset(link, 0, sizeof(*link));
+    link->timeout_ms = timeout_ms;
+}
+
+uint8_t teleop_link_accept(teleop_link_t *link, const teleop_cmd_t *cmd, uint32_t now_ms)
+{
+    // 停车超时后仍检查序号, 只有新会话或长时间空闲才重新同步
+    bool resync = !link->synced || cmd->sync || now_ms - link->last_ms > TELEOP_RESYNC_MS;
+    if (!resync)
+    {
+        int16_t diff = (int16_t)(cmd->seq - link->last_seq);
+        if (diff <= 0)
+        {
+            link->stale++;
+            return TELEOP_ESTALE;
+        }
+        link->lost += diff - 1;
+    }
+    else if (link->synced)
+    {
+        link->resyncs++;
+    }
+
+    link->synced = true;
+    link->active = true;
+    link->last_seq = cmd->seq;
+    link->last_ms = now_ms;
+    link->accepted++;
+    return TELEOP_EOK;
+}
+
+bool teleop_link_expired(teleop_link_t *link, uint32_t now_ms)
+{
+    if (!link->active || now_ms - link->last_ms <= link->timeout_ms)
+        return false;
+
+    link->active = false;
+    link->timeouts++;
+    return true;
+}
@@ -0,0 +1,209 @@
+// 差速混控主机端测试: 比例混合、死区和起转补偿、斜率限幅, 以及非法输入
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../../include -I../../../../test -o drive_mixer_test drive_mixer_test.cpp ../../src/drive_mixer.cpp
+//   ./drive_mixer_test [随机种子]
+//
+// 检查:
+//   - drive_mix: 未饱和时left=v+w、right=v-w; 饱和时两轮等比例缩小, 速度比不变; 输出在±1内
+//   - drive_wheel_duty: 死区内为0, 死区边缘为起转占空比, 满量程为max_duty, 单调且符号与命令一致,
+//     增益补偿大于1时不超过max_duty
+//   - 斜率限幅: 0到满速用时max_duty/accel_rate, 满速到停用时max_duty/decel_rate, 反向先按减速斜率过零,
+//     每步不越过目标; drive_mixer_stop立即为0
+//   - NaN/无穷大的速度和转向按0处理, 输出始终为有限值
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "drive_mixer.h"
+#include "test_util.h"
+
+static bool near(float a, float b, float tol = 1e-4f)
+{
+    return fabsf(a - b) <= tol;
+}
+
+static void test_mix(void)
+{
+    float l, r;
+    drive_mix(0.5f, 0.0f, &l, &r);
+    CHECK(near(l, 0.5f) && near(r, 0.5f), "straight: %g %g", l, r);
+    drive_mix(0.0f, 0.4f, &l, &r);
+    CHECK(near(l, 0.4f) && near(r, -0.4f), "spin right: %g %g", l, r);
+    drive_mix(1.0f, 1.0f, &l, &r);
+    CHECK(near(l, 1.0f) && near(r, 0.0f), "full speed full right: %g %g", l, r);
+    drive_mix(-2.0f, 0.0f, &l, &r);
+    CHECK(near(l, -1.0f) && near(r, -1.0f), "input not clamped: %g %g", l, r);
+
+    for (int i = 0; i < 200000; i++)
+    {
+        float v = rng_uniform(-1.2f, 1.2f), w = rng_uniform(-1.2f, 1.2f);
+        drive_mix(v, w, &l, &r);
+        CHECK(fabsf(l) <= 1.0f + 1e-6f && fabsf(r) <= 1.0f + 1e-6f, "v %g w %g -> %g %g out of range", v, w, l, r);
+        float cv = fmaxf(-1.0f, fminf(1.0f, v)), cw = fmaxf(-1.0f, fminf(1.0f, w));
+        float el = cv + cw, er = cv - cw;
+        float m = fmaxf(fabsf(el), fabsf(er));
+        if (m <= 1.0f)
+        {
+            CHECK(near(l, el) && near(r, er), "v %g w %g -> %g %g, expected %g %g", v, w, l, r, el, er);
+        }
+        else
+        {
+            // 等比例缩小: 与未缩小的结果方向相同, 较大的一侧为±1
+            CHECK(near(l * m, el, 1e-3f) && near(r * m, er, 1e-3f) && near(fmaxf(fabsf(l), fabsf(r)), 1.0f),
+                  "v %g w %g -> %g %g, ratio not kept", v, w, l, r);
+        }
+    }
+    printf("mix: ok\n");
+}
+
+static void test_wheel_duty(void)
+{
+    drive_mixer_config_t cfg;
+    drive_mixer_default_config(&cfg);
+    for (uint8_t wheel = 0; wheel < DRIVE_WHEEL_NUM; wheel++)
+    {
+        CHECK(drive_wheel_duty(&cfg, wheel, 0.0f) == 0.0f, "zero command");
+        CHECK(drive_wheel_duty(&cfg, wheel, cfg.deadband * 0.99f) == 0.0f, "inside deadband");
+        CHECK(near(drive_wheel_duty(&cfg, wheel, cfg.deadband), cfg.min_duty[wheel]), "deadband edge %g",
+              drive_wheel_duty(&cfg, wheel, cfg.deadband));
+        CHECK(near(drive_wheel_duty(&cfg, wheel, 1.0f), cfg.max_duty), "full forward");
+        CHECK(near(drive_wheel_duty(&cfg, wheel, -1.0f), -(float)cfg.max_duty), "full reverse");
+        CHECK(near(drive_wheel_duty(&cfg, wheel, 3.0f), cfg.max_duty), "command above 1");
+
+        float prev = 0.0f;
+        for (int i = 0; i <= 1000; i++)
+        {
+            float cmd = i / 1000.0f;
+            float duty = drive_wheel_duty(&cfg, wheel, cmd);
+            CHECK(duty >= prev, "not monotonic at %g: %g < %g", cmd, duty, prev);
+            CHECK(near(drive_wheel_duty(&cfg, wheel, -cmd), -duty), "asymmetric at %g", cmd);
+            prev = duty;
+        }
+    }
+
+    // 增益补偿: 较快的电机按比例缩小, 增益大于1时不超过满量程
+    cfg.gain[DRIVE_WHEEL_LEFT] = 0.9f;
+    cfg.gain[DRIVE_WHEEL_RIGHT] = 1.2f;
+    CHECK(near(drive_wheel_duty(&cfg, DRIVE_WHEEL_LEFT, 1.0f), cfg.max_duty * 0.9f, 1e-3f), "gain 0.9");
+    CHECK(near(drive_wheel_duty(&cfg, DRIVE_WHEEL_RIGHT, 1.0f), cfg.max_duty), "gain 1.2 exceeds max_duty");
+    printf("wheel duty: ok\n");
+}
+
+// 以dt运行到输出等于目标, 返回用时(s)
+static float ramp_time(drive_mixer_t *mixer, float dt, int max_steps)
+{
+    float t = 0.0f;
+    for (int i = 0; i < max_steps; i++)
+    {
+        if (mixer->duty[DRIVE_WHEEL_LEFT] == mixer->target[DRIVE_WHEEL_LEFT] &&
+            mixer->duty[DRIVE_WHEEL_RIGHT] == mixer->target[DRIVE_WHEEL_RIGHT])
+            return t;
+        float before = mixer->duty[DRIVE_WHEEL_LEFT];
+        drive_mixer_update(mixer, dt);
+        float after = mixer->duty[DRIVE_WHEEL_LEFT];
+        float target = mixer->target[DRIVE_WHEEL_LEFT];
+        CHECK((before <= target) ? after <= target + 1e-4f : after >= target - 1e-4f,
+              "overshoot: %g -> %g, target %g", before, after, target);
+        t += dt;
+    }
+    return -1.0f;
+}
+
+static void test_slew(void)
+{
+    drive_mixer_t mixer;
+    drive_mixer_init(&mixer, NULL);
+    const drive_mixer_config_t &cfg = mixer.config;
+    const float dt = 0.01f; // 与main.cpp的DRIVE_PERIOD_MS一致
+
+    drive_mixer_set(&mixer, 1.0f, 0.0f);
+    float t = ramp_time(&mixer, dt, 1000);
+    CHECK(near(t, cfg.max_duty / cfg.accel_rate, dt + 1e-4f), "0 to full took %g s", t);
+
+    drive_mixer_set(&mixer, 0.0f, 0.0f);
+    t = ramp_time(&mixer, dt, 1000);
+    CHECK(near(t, cfg.max_duty / cfg.decel_rate, dt + 1e-4f), "full to stop took %g s", t);
+
+    // 反向: 先按减速斜率过零, 再按加速斜率到反向满速
+    drive_mixer_set(&mixer, 1.0f, 0.0f);
+    ramp_time(&mixer, dt, 1000);
+    drive_mixer_set(&mixer, -1.0f, 0.0f);
+    float zero_at = -1.0f;
+    t = 0.0f;
+    while (mixer.duty[DRIVE_WHEEL_LEFT] != mixer.target[DRIVE_WHEEL_LEFT] && t < 5.0f)
+    {
+        drive_mixer_update(&mixer, dt);
+        t += dt;
+        if (zero_at < 0.0f && mixer.duty[DRIVE_WHEEL_LEFT] <= 0.0f)
+            zero_at = t;
+    }
+    CHECK(near(zero_at, cfg.max_duty / cfg.decel_rate, dt + 1e-4f), "reached zero after %g s", zero_at);
+    CHECK(near(t, cfg.max_duty / cfg.decel_rate + cfg.max_duty / cfg.accel_rate, 2 * dt + 1e-4f),
+          "reverse took %g s", t);
+
+    // 负的dt不改变输出, 停车立即生效
+    float before = mixer.duty[DRIVE_WHEEL_LEFT];
+    drive_mixer_set(&mixer, 0.5f, 0.0f);
+    drive_mixer_update(&mixer, -1.0f);
+    CHECK(mixer.duty[DRIVE_WHEEL_LEFT] == before, "negative dt changed output");
+    drive_mixer_stop(&mixer);
+    CHECK(mixer.duty[DRIVE_WHEEL_LEFT] == 0.0f && mixer.duty[DRIVE_WHEEL_RIGHT] == 0.0f &&
+              mixer.target[DRIVE_WHEEL_LEFT] == 0.0f && mixer.target[DRIVE_WHEEL_RIGHT] == 0.0f,
+          "stop did not zero output");
+
+    // 随机命令序列: 每步变化量不超过对应的斜率
+    drive_mixer_init(&mixer, NULL);
+    for (int i = 0; i < 100000; i++)
+    {
+        if (rng_next() % 20 == 0)
+            drive_mixer_set(&mixer, rng_uniform(-1, 1), rng_uniform(-1, 1));
+        float prev[DRIVE_WHEEL_NUM] = {mixer.duty[0], mixer.duty[1]};
+        drive_mixer_update(&mixer, dt);
+        for (uint8_t w = 0; w < DRIVE_WHEEL_NUM; w++)
+        {
+            float step = fabsf(mixer.duty[w] - prev[w]);
+            CHECK(step <= cfg.decel_rate * dt + cfg.accel_rate * dt + 1e-3f, "step %g too large", step);
+            if (fabsf(mixer.duty[w]) > fabsf(prev[w]) && (mixer.duty[w] > 0) == (prev[w] > 0) && prev[w] != 0.0f)
+                CHECK(step <= cfg.accel_rate * dt + 1e-3f, "accelerated by %g in one step", step);
+        }
+    }
+    printf("slew: ok\n");
+}
+
+static void test_non_finite(void)
+{
+    const float bad[] = {NAN, INFINITY, -INFINITY};
+    drive_mixer_t mixer;
+    drive_mixer_init(&mixer, NULL);
+    for (float x : bad)
+    {
+        float l, r;
+        drive_mix(x, 0.3f, &l, &r);
+        CHECK(near(l, 0.3f) && near(r, -0.3f), "v=%g -> %g %g", x, l, r);
+        drive_mix(0.3f, x, &l, &r);
+        CHECK(near(l, 0.3f) && near(r, 0.3f), "w=%g -> %g %g", x, l, r);
+
+        drive_mixer_set(&mixer, x, x);
+        for (int i = 0; i < 100; i++)
+            drive_mixer_update(&mixer, 0.01f);
+        for (uint8_t w = 0; w < DRIVE_WHEEL_NUM; w++)
+            CHECK(isfinite(mixer.target[w]) && isfinite(mixer.duty[w]) && mixer.duty[w] == 0.0f,
+                  "wheel %u duty %g after %g", w, mixer.duty[w], x);
+    }
+    printf("non-finite input: ok\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        rng_seed(argv[1]);
+    printf("seed %u\n", (unsigned)g_rng);
+    test_mix();
+    test_wheel_duty();
+    test_slew();
+    test_non_finite();
+    return test_summary();
+}
@@ -0,0 +1,209 @@
+// UDP遥控协议主机端测试: 编解码往返, 以及序号检查在停车超时前后的行为
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../../include -I../../../../test -o teleop_protocol_test teleop_protocol_test.cpp ../../src/teleop_protocol.cpp
+//   ./teleop_protocol_test [随机种子]
+//
+// 检查:
+//   - 随机命令(含TELEOP_FLAG_SYNC)编码后解码得到相同的内容; 未知类型、错误长度和超范围数值被拒绝
+//   - 停车超时后, WiFi卡顿期间缓存的旧包(序号不大于最后一个有效包)仍被丢弃, 不会重新开动
+//   - 新序号的包在停车超时后恢复链路, 丢包数按序号统计
+//   - 上位机重启(序号从头开始): 带TELEOP_FLAG_SYNC的包或空闲超过TELEOP_RESYNC_MS后重新同步
+//   - 随机丢包、重复和乱序: 接受的序号严格递增
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "teleop_protocol.h"
+#include "test_util.h"
+
+static teleop_cmd_t make_cmd(uint16_t seq, bool sync)
+{
+    teleop_cmd_t cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.type = TELEOP_TYPE_DRIVE;
+    cmd.sync = sync;
+    cmd.seq = seq;
+    cmd.speed = 500;
+    cmd.client_ms = seq * 20u;
+    return cmd;
+}
+
+// 模拟经过网络: 编码后再解码, 与main.cpp的处理一致
+static uint8_t deliver(teleop_link_t *link, uint16_t seq, bool sync, uint32_t now_ms)
+{
+    uint8_t buf[TELEOP_PACKET_LEN];
+    teleop_cmd_t cmd = make_cmd(seq, sync);
+    teleop_encode(&cmd, buf);
+    if (teleop_decode(buf, sizeof(buf), &cmd) != TELEOP_EOK)
+        return TELEOP_EINVAL;
+    return teleop_link_accept(link, &cmd, now_ms);
+}
+
+static void test_codec(void)
+{
+    for (int i = 0; i < 100000; i++)
+    {
+        teleop_cmd_t in, out;
+        uint8_t buf[TELEOP_PACKET_LEN];
+        memset(&in, 0, sizeof(in));
+        in.type = rng_next() % 2 ? TELEOP_TYPE_DRIVE : TELEOP_TYPE_STOP;
+        in.sync = rng_next() % 2;
+        in.seq = (uint16_t)rng_next();
+        in.speed = (int16_t)(rng_next() % (2 * TELEOP_VALUE_MAX + 1) - TELEOP_VALUE_MAX);
+        in.turn = (int16_t)(rng_next() % (2 * TELEOP_VALUE_MAX + 1) - TELEOP_VALUE_MAX);
+        in.client_ms = rng_next();
+        teleop_encode(&in, buf);
+        CHECK(teleop_decode(buf, sizeof(buf), &out) == TELEOP_EOK && out.type == in.type && out.sync == in.sync &&
+                  out.seq == in.seq && out.speed == in.speed && out.turn == in.turn && out.client_ms == in.client_ms,
+              "round trip of packet %d failed", i);
+    }
+
+    teleop_cmd_t cmd = make_cmd(1, false), out;
+    uint8_t buf[TELEOP_PACKET_LEN];
+    teleop_encode(&cmd, buf);
+    CHECK(teleop_decode(buf, sizeof(buf) - 1, &out) == TELEOP_EINVAL, "short packet accepted");
+    buf[3] = TELEOP_TYPE_ACK;
+    CHECK(teleop_decode(buf, sizeof(buf), &out) == TELEOP_EINVAL, "ack accepted as command");
+    buf[3] = 0x03 | TELEOP_FLAG_SYNC;
+    CHECK(teleop_decode(buf, sizeof(buf), &out) == TELEOP_EINVAL, "unknown type with sync flag accepted");
+    cmd.speed = TELEOP_VALUE_MAX + 1;
+    teleop_encode(&cmd, buf);
+    CHECK(teleop_decode(buf, sizeof(buf), &out) == TELEOP_EINVAL, "out of range speed accepted");
+    printf("codec: ok\n");
+}
+
+static void test_deadman_keeps_sequence(void)
+{
+    teleop_link_t link;
+    teleop_link_init(&link, TELEOP_DEADMAN_MS);
+    uint32_t now = 1000;
+
+    // 正常行驶到序号100
+    CHECK(deliver(&link, 1, true, now) == TELEOP_EOK, "first packet rejected");
+    for (uint16_t seq = 2; seq <= 100; seq++)
+    {
+        now += 20;
+        CHECK(deliver(&link, seq, false, now) == TELEOP_EOK, "packet %u rejected", seq);
+        CHECK(!teleop_link_expired(&link, now), "expired while receiving");
+    }
+
+    // WiFi卡顿: 停车超时
+    now += TELEOP_DEADMAN_MS + 1;
+    CHECK(teleop_link_expired(&link, now), "deadman did not trip");
+    CHECK(!link.active, "link still active after deadman");
+
+    // 卡顿结束, 先到达缓存的旧包(重复和乱序), 不能恢复链路
+    uint16_t old_seqs[] = {100, 97, 99, 98, 60};
+    for (uint16_t seq : old_seqs)
+    {
+        now += 1;
+        CHECK(deliver(&link, seq, false, now) == TELEOP_ESTALE, "old packet %u accepted after deadman", seq);
+        CHECK(!link.active, "old packet %u re-activated the link", seq);
+    }
+
+    // 新包恢复链路, 卡顿期间丢失的序号计入丢包
+    uint32_t lost_before = link.lost;
+    now += 1;
+    CHECK(deliver(&link, 108, false, now) == TELEOP_EOK && link.active, "new packet rejected");
+    CHECK(link.lost - lost_before == 7, "lost %u after outage, expected 7", link.lost - lost_before);
+    CHECK(link.resyncs == 0, "%u resyncs without restart", link.resyncs);
+    printf("deadman: stale packets after stop dropped (%u), link resumed at seq 108\n", link.stale);
+}
+
+static void test_client_restart(void)
+{
+    teleop_link_t link;
+    teleop_link_init(&link, TELEOP_DEADMAN_MS);
+    uint32_t now = 0;
+    for (uint16_t seq = 30000; seq < 30050; seq++)
+    {
+        now += 20;
+        deliver(&link, seq, false, now);
+    }
+
+    // 重启后立即重连: 没有同步标志的小序号被当作旧包, 带标志的第一个包重新同步
+    now += 200;
+    teleop_link_expired(&link, now);
+    CHECK(deliver(&link, 1, false, now) == TELEOP_ESTALE, "restart without sync flag accepted");
+    CHECK(deliver(&link, 2, true, now) == TELEOP_EOK, "sync packet rejected");
+    CHECK(deliver(&link, 3, false, now + 20) == TELEOP_EOK, "packet after sync rejected");
+    CHECK(link.resyncs == 1, "%u resyncs after sync flag", link.resyncs);
+
+    // 旧客户端(不发同步标志)长时间空闲后重连
+    now += 20 + TELEOP_RESYNC_MS;
+    CHECK(deliver(&link, 1, false, now) == TELEOP_ESTALE, "resynced before TELEOP_RESYNC_MS");
+    now += 1;
+    CHECK(deliver(&link, 1, false, now) == TELEOP_EOK, "no resync after idle");
+    CHECK(link.resyncs == 2, "%u resyncs after idle", link.resyncs);
+    printf("restart: resync by flag and after %d ms idle\n", TELEOP_RESYNC_MS);
+}
+
+static void test_random_network(void)
+{
+    teleop_link_t link;
+    teleop_link_init(&link, TELEOP_DEADMAN_MS);
+    uint16_t seq = 0, held = 0, last_accepted = 0;
+    bool have_held = false, have_accepted = false;
+    uint32_t now = 0, accepted = 0;
+    for (int i = 0; i < 200000; i++)
+    {
+        now += 20;
+        seq++;
+        uint16_t out[3];
+        bool sync[3] = {false, false, false};
+        int n = 0;
+        if (rng_next() % 500 == 0)
+            now += 150 + rng_next() % 1000; // 卡顿, 超过停车时间但不到重新同步时间
+        bool send_held = have_held;
+        uint16_t prev_held = held;
+        have_held = false;
+        uint32_t r = rng_next() % 100;
+        if (r < 10)
+        {
+            // 丢包
+        }
+        else if (r < 20)
+        {
+            held = seq; // 跟在下一个包后面发出, 形成乱序
+            have_held = true;
+        }
+        else
+        {
+            sync[n] = i == 0;
+            out[n++] = seq;
+            if (r < 25)
+                out[n++] = seq;
+        }
+        if (send_held)
+            out[n++] = prev_held;
+        for (int k = 0; k < n; k++)
+        {
+            teleop_link_expired(&link, now);
+            if (deliver(&link, out[k], sync[k], now) != TELEOP_EOK)
+                continue;
+            CHECK(!have_accepted || (int16_t)(out[k] - last_accepted) > 0, "seq %u accepted after %u", out[k],
+                  last_accepted);
+            last_accepted = out[k];
+            have_accepted = true;
+            accepted++;
+        }
+    }
+    CHECK(link.resyncs == 0, "%u resyncs on a lossy link", link.resyncs);
+    printf("random network: %u accepted, %u stale, %u lost, %u deadman stops\n", accepted, link.stale, link.lost,
+           link.timeouts);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        rng_seed(argv[1]);
+    printf("seed %u\n", (unsigned)g_rng);
+    test_codec();
+    test_deadman_keeps_sequence();
+    test_client_restart();
+    test_random_network();
+    return test_summary();
+}
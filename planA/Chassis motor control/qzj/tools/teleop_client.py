@@ -0,0 +1,211 @@
+# qzj小车UDP遥控测试客户端(协议见include/teleop_protocol.h)
+#
+# 以固定频率发送行驶命令, 统计应答往返时间; 可模拟丢包、乱序、重复和断线,
+# 检查小车是否丢弃旧包、断线后是否在100ms内停车。
+#
+# 用法(电脑连接小车热点txw后运行):
+#   python teleop_client.py --speed 500 --duration 5
+#   python teleop_client.py --speed 500 --loss 0.2 --reorder 0.1 --dup 0.05
+#   python teleop_client.py --speed 500 --outage 3.0:0.5      # 第3秒开始断线0.5秒
+#   python teleop_client.py --selftest                        # 不连接小车, 用本地模拟的链路检查丢包模拟和序号逻辑
+import argparse
+import random
+import socket
+import struct
+import sys
+import time
+
+MAGIC = b'\xc5\x5c'
+VERSION = 1
+TYPE_DRIVE = 0x01
+TYPE_STOP = 0x02
+TYPE_ACK = 0x80
+FLAG_SYNC = 0x40  # 新会话: 收到第一个应答前置位, 小车接受任意序号
+STATUS_ACTIVE = 0x01
+DEADMAN_MS = 100
+RESYNC_MS = 3000
+PACKET_FMT = '<2sBBHhhI'
+ACK_FMT = '<2sBBHIBBH'
+
+
+def encode(ptype, seq, speed, turn, client_ms):
+    return struct.pack(PACKET_FMT, MAGIC, VERSION, ptype, seq & 0xFFFF, speed, turn, client_ms & 0xFFFFFFFF)
+
+
+def decode_ack(data):
+    if len(data) != struct.calcsize(ACK_FMT):
+        return None
+    magic, ver, ptype, seq, client_ms, status, _, stale = struct.unpack(ACK_FMT, data)
+    if magic != MAGIC or ver != VERSION or ptype != TYPE_ACK:
+        return None
+    return seq, client_ms, status, stale
+
+
+class LossSimulator:
+    """在发送端模拟丢包、重复、乱序(延后一个周期发送)和断线"""
+
+    def __init__(self, loss, dup, reorder, outage, rng):
+        self.loss = loss
+        self.dup = dup
+        self.reorder = reorder
+        self.outage = outage
+        self.rng = rng
+        self.held = None
+        self.dropped = 0
+
+    def process(self, packet, t):
+        held, self.held = self.held, None
+        out = [held] if held is not None else []
+        if self.outage and self.outage[0] <= t < self.outage[0] + self.outage[1]:
+            self.dropped += 1
+            return out
+        if self.rng.random() < self.loss:
+            self.dropped += 1
+            return out
+        if self.rng.random() < self.reorder:
+            self.held = packet  # 在下一个包之后发出
+            return out
+        out.insert(0, packet)  # 被延后的旧包跟在新包后面, 形成乱序
+        if self.rng.random() < self.dup:
+            out.append(packet)
+        return out
+
+
+class LocalCar:
+    """与teleop_protocol.cpp相同的序号和心跳逻辑, 用于--selftest"""
+
+    def __init__(self):
+        self.active = False
+        self.synced = False
+        self.last_seq = 0
+        self.last_ms = 0
+        self.stale = 0
+
+    def receive(self, data, now_ms):
+        _, _, ptype, seq, speed, turn, client_ms = struct.unpack(PACKET_FMT, data)
+        # 停车超时后仍检查序号, 只有新会话或长时间空闲才重新同步
+        resync = not self.synced or ptype & FLAG_SYNC or now_ms - self.last_ms > RESYNC_MS
+        if not resync:
+            diff = (seq - self.last_seq) & 0xFFFF
+            if diff == 0 or diff >= 0x8000:
+                self.stale += 1
+                return None
+        self.synced = True
+        self.active = True
+        self.last_seq = seq
+        self.last_ms = now_ms
+        return struct.pack(ACK_FMT, MAGIC, VERSION, TYPE_ACK, seq, client_ms, STATUS_ACTIVE, 0, self.stale)
+
+    def check(self, now_ms):
+        if self.active and now_ms - self.last_ms > DEADMAN_MS:
+            self.active = False
+            return True
+        return False
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(round(p / 100.0 * (len(values) - 1))))]
+
+
+def run(args):
+    rng = random.Random(args.seed)
+    outage = tuple(float(v) for v in args.outage.split(':')) if args.outage else None
+    sim = LossSimulator(args.loss, args.dup, args.reorder, outage, rng)
+    car = LocalCar() if args.selftest else None
+
+    sock = None
+    if car is None:
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.setblocking(False)
+
+    period = 1.0 / args.rate
+    start = time.time()
+    next_send = start
+    seq = 0
+    sent = 0
+    rtts = []
+    acks = 0
+    stale_reported = 0
+    inactive_acks = 0
+    deadman_trips = 0
+    last_stop = None
+
+    while True:
+        now = time.time()
+        t = now - start
+        if t >= args.duration:
+            break
+
+        if now >= next_send:
+            next_send += period
+            seq = (seq + 1) & 0xFFFF
+            client_ms = int((now - start) * 1000)
+            packet = encode(TYPE_DRIVE | (FLAG_SYNC if acks == 0 else 0), seq, args.speed, args.turn, client_ms)
+            for p in sim.process(packet, t):
+                sent += 1
+                if car is not None:
+                    ack = car.receive(p, client_ms)
+                    if ack is not None:
+                        acks += 1
+                        stale_reported = decode_ack(ack)[3]
+                else:
+                    sock.sendto(p, (args.host, args.port))
+
+        if car is not None:
+            if car.check(int((now - start) * 1000)):
+                deadman_trips += 1
+                last_stop = t
+        else:
+            try:
+                while True:
+                    data, _ = sock.recvfrom(64)
+                    ack = decode_ack(data)
+                    if ack is None:
+                        continue
+                    acks += 1
+                    rtts.append(int((time.time() - start) * 1000) - ack[1])
+                    stale_reported = ack[3]
+                    if not ack[2] & STATUS_ACTIVE:
+                        inactive_acks += 1
+            except BlockingIOError:
+                pass
+        time.sleep(min(0.001, max(0.0, next_send - time.time())))
+
+    # 结束时发送停车包
+    if sock is not None:
+        seq = (seq + 1) & 0xFFFF
+        sock.sendto(encode(TYPE_STOP, seq, 0, 0, int((time.time() - start) * 1000)), (args.host, args.port))
+
+    print('sent: %d, dropped by simulator: %d, acks: %d' % (sent, sim.dropped, acks))
+    print('stale packets dropped by car: %d' % stale_reported)
+    if inactive_acks:
+        print('acks after deadman stop: %d' % inactive_acks)
+    if rtts:
+        print('rtt ms: p50 %d, p90 %d, p99 %d, max %d' % (percentile(rtts, 50), percentile(rtts, 90),
+                                                           percentile(rtts, 99), max(rtts)))
+    if car is not None:
+        print('deadman trips: %d%s' % (deadman_trips, ' (last at %.2fs)' % last_stop if last_stop else ''))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='qzj UDP teleop test client')
+    parser.add_argument('--host', default='192.168.4.1')
+    parser.add_argument('--port', type=int, default=4210)
+    parser.add_argument('--rate', type=float, default=50.0, help='packets per second')
+    parser.add_argument('--speed', type=int, default=0, help='-1000..1000')
+    parser.add_argument('--turn', type=int, default=0, help='-1000..1000')
+    parser.add_argument('--duration', type=float, default=5.0)
+    parser.add_argument('--loss', type=float, default=0.0, help='drop probability')
+    parser.add_argument('--dup', type=float, default=0.0, help='duplicate probability')
+    parser.add_argument('--reorder', type=float, default=0.0, help='swap-with-next probability')
+    parser.add_argument('--outage', help='start:length in seconds')
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--selftest', action='store_true', help='use a local model of the car')
+    args = parser.parse_args()
+    return run(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,83 @@
+#ifndef SERVO_PROTOCOL_H
+#define SERVO_PROTOCOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief 双舵机串口帧协议
+ *
+ * 帧格式(7字节, 数值为小端):
+ *   0xAA 0x55 | CMD | ID | VAL_L | VAL_H | SUM
+ *   SUM = (CMD + ID + VAL_L + VAL_H) & 0xFF
+ *
+ * 解析器逐字节喂入, 不依赖串口时序, 可在主循环中一次性处理缓冲区内所有字节。
+ * 为兼容旧上位机, 空闲状态下收到的单字节命令 'r' 'l' 'f' 'b' 仍按1度微调处理。
+ */
+#define SERVO_FRAME_HEAD1 0xAA
+#define SERVO_FRAME_HEAD2 0x55
+#define SERVO_FRAME_LEN 7
+
+/**
+ * @brief 帧命令定义
+ */
+#define SERVO_CMD_ABS 0x01  /**< 绝对目标角度, VAL单位0.1度 */
+#define SERVO_CMD_VEL 0x02  /**< 速度设定, VAL单位0.1度/秒, 持续转动直到新命令 */
+#define SERVO_CMD_REL 0x03  /**< 相对当前位置微调, VAL单位0.1度 */
+#define SERVO_CMD_STOP 0x04 /**< 停在当前位置, 忽略VAL */
+
+/**
+ * @brief 舵机编号, SERVO_ID_ALL 表示同时作用于两个舵机
+ */
+#define SERVO_ID_PAN 0
+#define SERVO_ID_TILT 1
+#define SERVO_ID_ALL 0xFF
+
+/**
+ * @brief 解析得到的一条命令
+ */
+typedef struct
+{
+    uint8_t cmd;   /**< 命令类型 SERVO_CMD_xxx */
+    uint8_t id;    /**< 舵机编号 */
+    int16_t value; /**< 命令参数 */
+} servo_cmd_t;
+
+/**
+ * @brief 帧解析器状态
+ */
+typedef struct
+{
+    uint8_t buf[SERVO_FRAME_LEN]; /**< 当前帧缓存 */
+    uint8_t cnt;                  /**< 已接收字节数 */
+    uint32_t frames;              /**< 成功解析的帧数 */
+    uint32_t errors;              /**< 校验失败/非法命令的帧数 */
+} servo_parser_t;
+
+/**
+ * @brief 复位解析器
+ *
+ * @param parser 解析器
+ */
+void servo_parser_reset(servo_parser_t *parser);
+
+/**
+ * @brief 喂入一个字节
+ *
+ * @param parser 解析器
+ * @param byte 串口收到的字节
+ * @param cmd 解析出完整命令时写入
+ * @return true 得到一条完整命令
+ * @return false 仍在等待后续字节或该字节被丢弃
+ */
+bool servo_parser_feed(servo_parser_t *parser, uint8_t byte, servo_cmd_t *cmd);
+
+/**
+ * @brief 将命令编码为一帧(供上位机或回环测试使用)
+ *
+ * @param cmd 命令
+ * @param frame 输出缓冲区, 至少SERVO_FRAME_LEN字节
+ */
+void servo_frame_encode(const servo_cmd_t *cmd, uint8_t *frame);
+
+#endif // SERVO_PROTOCOL_H
@@ -1,15 +1,34 @@
 #include <Arduino.h>
 #include <ESP32Servo.h>
+#include "servo_protocol.h"
 
 Servo servo_1; // 创建Servo对象
 Servo servo_2;
 // 初始化舵机的中间位置
 const int middlePosition = 40;
-int servoPosition = middlePosition; // 当前舵机位置
 const int ledPin = 2;
 bool ledState = false; // 使用布尔类型来表示LED状态
 unsigned long lastMillis = 0;
-int Last_Command = 0;
+
+// 速度模式下的位置积分周期(毫秒)
+const unsigned long servoUpdateInterval = 10;
+
+// 单个舵机的运动状态, 两个舵机各自独立
+typedef struct
+{
+  Servo *servo;       // 舵机对象
+  float position;     // 当前角度(度)
+  float velocity;     // 速度模式下的角速度(度/秒)
+  bool velocityMode;  // true=速度模式, false=位置模式
+  int writtenAngle;   // 最近一次写入舵机的角度
+} ServoAxis;
+
+ServoAxis servoAxes[2] = {
+    {&servo_1, middlePosition, 0, false, -1},
+    {&servo_2, middlePosition, 0, false, -1},
+};
+
+servo_parser_t servoParser;
 // int ENA1 = 16;  // 使能信号的io口
 // int PUL1 = 5; // 脉冲信号的io口
 // int DIR1 = 17; // 方向信号的io口
@@ -17,8 +36,8 @@ int Last_Command = 0;
 // const int stepsPerRevolution1 = 200; // 每转一圈的步数（根据具体电机参数调整）
 // const int speed1 = 5;                // 脉冲间隔（单位：毫秒）
 // 函数声明
-void turnServoLeft(int degrees);
-void turnServoRight(int degrees);
+void applyServoCommand(const servo_cmd_t &cmd);
+void updateServoAxes(float dt);
 
 
 // void maichong1(int times, int speed) // times是脉冲的数量，speed是脉冲间隔，对应着电机的速度
@@ -54,40 +73,75 @@ void turnServoRight(int degrees);
 //   }
 // }
 
-// 定义左转函数
-void turnServoLeft_1(int degrees)
+// 将角度限制在舵机物理范围内并写入(角度未变化时不重复写)
+void writeServoAxis(ServoAxis &axis)
 {
-  int newAngle = servoPosition - degrees;
-  newAngle = constrain(newAngle, 0, 180); // 确保角度不超过舵机的物理限制
-  servo_1.write(newAngle);
-  servoPosition = newAngle; // 更新当前舵机位置
+  axis.position = constrain(axis.position, 0.0f, 180.0f); // 确保角度不超过舵机的物理限制
+  int angle = (int)(axis.position + 0.5f);
+  if (angle != axis.writtenAngle)
+  {
+    axis.servo->write(angle);
+    axis.writtenAngle = angle;
+  }
 }
 
-// 定义右转函数
-void turnServoRight_1(int degrees)
+// 对单个舵机执行一条命令
+void applyAxisCommand(ServoAxis &axis, const servo_cmd_t &cmd)
 {
-  int newAngle = servoPosition + degrees;
-  newAngle = constrain(newAngle, 0, 180); // 确保角度不超过舵机的物理限制
-  servo_1.write(newAngle);
-  servoPosition = newAngle; // 更新当前舵机位置
+  switch (cmd.cmd)
+  {
+  case SERVO_CMD_ABS:
+    axis.velocityMode = false;
+    axis.position = cmd.value / 10.0f;
+    break;
+  case SERVO_CMD_VEL:
+    axis.velocityMode = (cmd.value != 0);
+    axis.velocity = cmd.value / 10.0f;
+    break;
+  case SERVO_CMD_REL:
+    axis.velocityMode = false;
+    axis.position += cmd.value / 10.0f;
+    break;
+  case SERVO_CMD_STOP:
+    axis.velocityMode = false;
+    axis.velocity = 0;
+    break;
+  }
+  writeServoAxis(axis);
 }
 
-void turnServoLeft_2(int degrees)
+// 执行一条解析完成的命令
+void applyServoCommand(const servo_cmd_t &cmd)
 {
-  int newAngle = servoPosition - degrees;
-  newAngle = constrain(newAngle, 0, 180); // 确保角度不超过舵机的物理限制
-  servo_2.write(newAngle);
-  servoPosition = newAngle; // 更新当前舵机位置
+  if (cmd.id == SERVO_ID_ALL)
+  {
+    applyAxisCommand(servoAxes[SERVO_ID_PAN], cmd);
+    applyAxisCommand(servoAxes[SERVO_ID_TILT], cmd);
+  }
+  else
+  {
+    applyAxisCommand(servoAxes[cmd.id], cmd);
+  }
+  // 每收到一条命令切换一次LED, 不阻塞
+  ledState = !ledState;
+  digitalWrite(ledPin, ledState);
 }
 
-// 定义右转函数
-void turnServoRight_2(int degrees)
+// 速度模式下按实际经过的时间积分角度
+void updateServoAxes(float dt)
 {
-  int newAngle = servoPosition + degrees;
-  newAngle = constrain(newAngle, 0, 180); // 确保角度不超过舵机的物理限制
-  servo_2.write(newAngle);
-  servoPosition = newAngle; // 更新当前舵机位置
+  for (ServoAxis &axis : servoAxes)
+  {
+    if (!axis.velocityMode)
+      continue;
+    axis.position += axis.velocity * dt;
+    writeServoAxis(axis);
+    // 到达限位后自动停止
+    if (axis.position <= 0.0f || axis.position >= 180.0f)
+      axis.velocityMode = false;
+  }
 }
+
 // 将字符转换为对应的整数值
 // int hexCharToInt(char c)
 // {
@@ -145,50 +199,28 @@ void setup()
   servo_2.attach(19);
   pinMode(ledPin, OUTPUT); // 设置LED引脚为输出模式
   digitalWrite(ledPin, ledState);
+
+  servo_parser_reset(&servoParser);
+  lastMillis = millis();
 }
 
 void loop()
 {
-  // 检查是否已经过了1秒
-  if (millis() - lastMillis > 10)
+  // 每次循环都处理串口缓冲区中的全部字节, 一帧即可完成一次大角度移动
+  while (Serial.available() > 0)
   {
-    // 保存当前时间作为下一次检查的基准
-    lastMillis = millis();
-
-    // 检查串口是否有数据
-    if (Serial.available() > 0)
+    servo_cmd_t cmd;
+    if (servo_parser_feed(&servoParser, (uint8_t)Serial.read(), &cmd))
     {
-      // 读取数据
-
-      int command = Serial.read();
-      Serial.print(command);
-      Last_Command = command;
-      command = Serial.read();
-      if (command != Last_Command)
-      {
-        command = Last_Command;
-        switch (command)
-        {
-        case 0x72:
-          // blinkLED();
-          turnServoLeft_1(1);
-          break;
-        case 0x6c:
-          // blinkLED();
-          turnServoRight_1(1); // 舵机右转
-          break;
-        case 0x66:
-          // 下
-          blinkLED();
-          turnServoRight_2(1);
-          break;
-        case 0x62:
-          // 上
-          blinkLED();
-          turnServoLeft_2(1);
-          break;
-        }
-      }
+      applyServoCommand(cmd);
     }
   }
+
+  // 速度模式的舵机按固定周期更新位置
+  unsigned long now = millis();
+  if (now - lastMillis >= servoUpdateInterval)
+  {
+    updateServoAxes((now - lastMillis) / 1000.0f);
+    lastMillis = now;
+  }
 }
@@ -0,0 +1,127 @@
+#include "servo_protocol.h"
+
+#include <string.h>
+
+// 旧上位机使用的单字节命令
+#define LEGACY_CMD_PAN_LEFT 0x72  // 'r'
+#define LEGACY_CMD_PAN_RIGHT 0x6c // 'l'
+#define LEGACY_CMD_TILT_DOWN 0x66 // 'f'
+#define LEGACY_CMD_TILT_UP 0x62   // 'b'
+#define LEGACY_STEP 10            // 旧命令每次转动1度(0.1度单位)
+
+// 计算帧校验和
+static uint8_t frame_sum(const uint8_t *frame)
+{
+    return (uint8_t)(frame[2] + frame[3] + frame[4] + frame[5]);
+}
+
+// 检查命令和编号是否合法
+static bool frame_valid(const uint8_t *frame)
+{
+    if (frame_sum(frame) != frame[6])
+        return false;
+    if (frame[2] < SERVO_CMD_ABS || frame[2] > SERVO_CMD_STOP)
+        return false;
+    if (frame[3] != SERVO_ID_PAN && frame[3] != SERVO_ID_TILT && frame[3] != SERVO_ID_ALL)
+        return false;
+    return true;
+}
+
+// 旧的单字节命令转换为相对微调命令
+static bool legacy_decode(uint8_t byte, servo_cmd_t *cmd)
+{
+    switch (byte)
+    {
+    case LEGACY_CMD_PAN_LEFT:
+        cmd->id = SERVO_ID_PAN;
+        cmd->value = -LEGACY_STEP;
+        break;
+    case LEGACY_CMD_PAN_RIGHT:
+        cmd->id = SERVO_ID_PAN;
+        cmd->value = LEGACY_STEP;
+        break;
+    case LEGACY_CMD_TILT_DOWN:
+        cmd->id = SERVO_ID_TILT;
+        cmd->value = LEGACY_STEP;
+        break;
+    case LEGACY_CMD_TILT_UP:
+        cmd->id = SERVO_ID_TILT;
+        cmd->value = -LEGACY_STEP;
+        break;
+    default:
+        return false;
+    }
+    cmd->cmd = SERVO_CMD_REL;
+    return true;
+}
+
+// 校验失败后, 在已收字节中寻找下一个帧头重新同步
+static void parser_resync(servo_parser_t *parser)
+{
+    uint8_t i;
+    for (i = 1; i < parser->cnt; i++)
+    {
+        if (parser->buf[i] == SERVO_FRAME_HEAD1)
+            break;
+    }
+    parser->cnt -= i;
+    memmove(parser->buf, parser->buf + i, parser->cnt);
+
+    // 帧头第二字节不匹配时继续丢弃
+    if (parser->cnt >= 2 && parser->buf[1] != SERVO_FRAME_HEAD2)
+        parser_resync(parser);
+}
+
+void servo_parser_reset(servo_parser_t *parser)
+{
+    memset(parser, 0, sizeof(*parser));
+}
+
+bool servo_parser_feed(servo_parser_t *parser, uint8_t byte, servo_cmd_t *cmd)
+{
+    if (parser->cnt == 0)
+    {
+        if (byte == SERVO_FRAME_HEAD1)
+        {
+            parser->buf[parser->cnt++] = byte;
+            return false;
+        }
+        return legacy_decode(byte, cmd);
+    }
+
+    if (parser->cnt == 1 && byte != SERVO_FRAME_HEAD2)
+    {
+        // 连续的0xAA视为新的帧头
+        parser->cnt = (byte == SERVO_FRAME_HEAD1) ? 1 : 0;
+        return false;
+    }
+
+    parser->buf[parser->cnt++] = byte;
+    if (parser->cnt < SERVO_FRAME_LEN)
+        return false;
+
+    if (!frame_valid(parser->buf))
+    {
+        parser->errors++;
+        parser_resync(parser);
+        return false;
+    }
+
+    cmd->cmd = parser->buf[2];
+    cmd->id = parser->buf[3];
+    cmd->value = (int16_t)(parser->buf[4] | (parser->buf[5] << 8));
+    parser->frames++;
+    parser->cnt = 0;
+    return true;
+}
+
+void servo_frame_encode(const servo_cmd_t *cmd, uint8_t *frame)
+{
+    frame[0] = SERVO_FRAME_HEAD1;
+    frame[1] = SERVO_FRAME_HEAD2;
+    frame[2] = cmd->cmd;
+    frame[3] = cmd->id;
+    frame[4] = (uint8_t)(cmd->value & 0xFF);
+    frame[5] = (uint8_t)((uint16_t)cmd->value >> 8);
+    frame[6] = frame_sum(frame);
+}
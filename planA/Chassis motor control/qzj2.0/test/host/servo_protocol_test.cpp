@@ -0,0 +1,154 @@
+// 舵机帧协议主机端测试: 编解码往返、随机字节模糊测试和解析吞吐量
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../../include -I../../../../test -o servo_protocol_test servo_protocol_test.cpp ../../src/servo_protocol.cpp
+//   ./servo_protocol_test [随机种子]
+//
+// 模糊测试检查:
+//   - 任意字节流都不会越界或解析出非法的命令/编号
+//   - 随机垃圾之后紧跟的有效帧, 最迟在再发一帧后被正确解析(重新同步)
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "servo_protocol.h"
+#include "test_util.h"
+
+static bool cmd_legal(const servo_cmd_t &cmd)
+{
+    return cmd.cmd >= SERVO_CMD_ABS && cmd.cmd <= SERVO_CMD_STOP &&
+           (cmd.id == SERVO_ID_PAN || cmd.id == SERVO_ID_TILT || cmd.id == SERVO_ID_ALL);
+}
+
+// 每种命令/编号与一组边界值编码后再解析, 结果应与原命令相同
+static void test_round_trip(void)
+{
+    const uint8_t ids[] = {SERVO_ID_PAN, SERVO_ID_TILT, SERVO_ID_ALL};
+    const int16_t values[] = {0, 1, -1, 900, -900, 1800, 32767, -32768, 0x00AA, 0x5500, (int16_t)0xAA55};
+    servo_parser_t parser;
+    servo_parser_reset(&parser);
+
+    for (uint8_t c = SERVO_CMD_ABS; c <= SERVO_CMD_STOP; c++)
+        for (uint8_t id : ids)
+            for (int16_t v : values)
+            {
+                servo_cmd_t in = {c, id, v}, out;
+                uint8_t frame[SERVO_FRAME_LEN];
+                servo_frame_encode(&in, frame);
+                int got = 0;
+                for (int i = 0; i < SERVO_FRAME_LEN; i++)
+                    got += servo_parser_feed(&parser, frame[i], &out);
+                CHECK(got == 1 && out.cmd == c && out.id == id && out.value == v,
+                      "round trip cmd=%u id=%u value=%d", c, id, v);
+            }
+    CHECK(parser.errors == 0, "round trip errors=%u", (unsigned)parser.errors);
+}
+
+// 旧上位机的单字节命令仍按1度微调处理
+static void test_legacy(void)
+{
+    servo_parser_t parser;
+    servo_cmd_t cmd;
+    servo_parser_reset(&parser);
+    CHECK(servo_parser_feed(&parser, 'r', &cmd) && cmd.cmd == SERVO_CMD_REL && cmd.id == SERVO_ID_PAN &&
+              cmd.value == -10, "legacy 'r'");
+    CHECK(servo_parser_feed(&parser, 'b', &cmd) && cmd.id == SERVO_ID_TILT && cmd.value == -10, "legacy 'b'");
+    CHECK(!servo_parser_feed(&parser, 'x', &cmd), "unknown single byte accepted");
+}
+
+// 随机字节流: 只允许解析出合法命令
+static void test_fuzz_garbage(int rounds)
+{
+    servo_parser_t parser;
+    servo_parser_reset(&parser);
+    unsigned long decoded = 0;
+    for (int i = 0; i < rounds; i++)
+    {
+        uint8_t byte = (uint8_t)rng_next();
+        if (rng_next() % 4 == 0)
+            byte = (rng_next() & 1) ? SERVO_FRAME_HEAD1 : SERVO_FRAME_HEAD2; // 多制造帧头
+        servo_cmd_t cmd;
+        if (servo_parser_feed(&parser, byte, &cmd))
+        {
+            decoded++;
+            CHECK(cmd_legal(cmd), "illegal command decoded from noise: cmd=%u id=%u", cmd.cmd, cmd.id);
+        }
+        CHECK(parser.cnt < SERVO_FRAME_LEN, "parser buffer count %u", parser.cnt);
+    }
+    printf("fuzz garbage: %d bytes, %lu commands (legacy bytes and chance checksums), %u bad frames\n", rounds,
+           decoded, (unsigned)parser.errors);
+}
+
+// 垃圾 + 有效帧 + 有效帧: 第二帧必须解析成功, 统计第一帧直接恢复的比例
+static void test_fuzz_resync(int trials)
+{
+    int first_ok = 0;
+    for (int t = 0; t < trials; t++)
+    {
+        servo_parser_t parser;
+        servo_parser_reset(&parser);
+        servo_cmd_t cmd;
+        int garbage = rng_next() % 20;
+        for (int i = 0; i < garbage; i++)
+        {
+            uint8_t byte = (rng_next() % 3 == 0) ? SERVO_FRAME_HEAD1 : (uint8_t)rng_next();
+            servo_parser_feed(&parser, byte, &cmd);
+        }
+
+        servo_cmd_t want = {(uint8_t)(SERVO_CMD_ABS + rng_next() % 4), SERVO_ID_TILT, (int16_t)rng_next()};
+        uint8_t frame[SERVO_FRAME_LEN];
+        servo_frame_encode(&want, frame);
+        bool got_first = false, got_second = false;
+        for (int i = 0; i < SERVO_FRAME_LEN; i++)
+            if (servo_parser_feed(&parser, frame[i], &cmd) && i == SERVO_FRAME_LEN - 1 && cmd.value == want.value)
+                got_first = true;
+        for (int i = 0; i < SERVO_FRAME_LEN; i++)
+            if (servo_parser_feed(&parser, frame[i], &cmd) && i == SERVO_FRAME_LEN - 1)
+                got_second = cmd.cmd == want.cmd && cmd.id == want.id && cmd.value == want.value;
+        first_ok += got_first;
+        CHECK(got_second, "no resync after %d garbage bytes (trial %d)", garbage, t);
+    }
+    printf("fuzz resync: %d trials, frame right after garbage decoded in %.1f%%\n", trials,
+           100.0 * first_ok / trials);
+}
+
+// 吞吐量: 连续有效帧
+static void test_throughput(void)
+{
+    const int frames = 2000000;
+    uint8_t stream[SERVO_FRAME_LEN * 64];
+    for (int i = 0; i < 64; i++)
+    {
+        servo_cmd_t cmd = {SERVO_CMD_ABS, (uint8_t)(i & 1), (int16_t)(i * 28)};
+        servo_frame_encode(&cmd, stream + i * SERVO_FRAME_LEN);
+    }
+    servo_parser_t parser;
+    servo_parser_reset(&parser);
+    servo_cmd_t cmd;
+    long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f += 64)
+        for (size_t i = 0; i < sizeof(stream); i++)
+            if (servo_parser_feed(&parser, stream[i], &cmd))
+                sum += cmd.value;
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    CHECK(parser.frames == (uint32_t)frames, "throughput frames=%u", (unsigned)parser.frames);
+    // 9600波特率每秒最多约137帧
+    printf("throughput: %.1f Mframes/s, %.1f MB/s on this host (9600 baud needs 137 frames/s) [%ld]\n",
+           frames / s / 1e6, frames * SERVO_FRAME_LEN / s / 1e6, sum & 1);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        rng_seed(argv[1]);
+    test_round_trip();
+    test_legacy();
+    test_fuzz_garbage(1000000);
+    test_fuzz_resync(100000);
+    test_throughput();
+    return test_summary();
+}
@@ -0,0 +1,91 @@
+/**
+ * 步进电机运动任务队列: HTTP处理函数只提交任务并立即返回任务ID, 运动任务按顺序取出执行,
+ * 执行过程中更新进度; 停止请求让当前任务减速停止并取消排队的任务。
+ * 不依赖Arduino, 多任务访问时由调用方加锁(板上用portMUX临界区)。
+ * 实现在src/motion_jobs.cpp。
+ */
+#ifndef MOTION_JOBS_H
+#define MOTION_JOBS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define MOTION_JOBS_MAX 8 // 保存的任务记录个数(排队、运行和最近完成的任务)
+
+// 任务状态
+#define MOTION_JOB_QUEUED 0    // 排队中
+#define MOTION_JOB_RUNNING 1   // 运行中
+#define MOTION_JOB_DONE 2      // 到达目标位置
+#define MOTION_JOB_STOPPED 3   // 运行中被停止
+#define MOTION_JOB_CANCELLED 4 // 排队时被取消
+
+typedef struct
+{
+    uint32_t id;       // 任务ID, 从1开始, 0表示空记录
+    uint8_t state;     // MOTION_JOB_xxx
+    long target;       // 目标位置(步)
+    float speed;       // 最大速度(步/秒)
+    float accel;       // 加速度(步/秒^2)
+    long start;        // 开始运行时的位置
+    long position;     // 最近一次更新的位置
+} motion_job_t;
+
+typedef struct
+{
+    motion_job_t jobs[MOTION_JOBS_MAX];
+    uint32_t next_id;      // 下一个任务ID
+    volatile bool stop_request; // 当前任务需要停止, 运动任务每一步检查
+    uint32_t submitted;    // 提交的任务数
+    uint32_t rejected;     // 队列满被拒绝的任务数
+} motion_jobs_t;
+
+// 初始化, 清空全部记录
+void motion_jobs_init(motion_jobs_t *q);
+
+/**
+ * 提交一个运动任务。优先使用空记录, 否则覆盖最早的已结束任务。
+ * 返回任务ID, 所有记录都在排队或运行时返回0。
+ */
+uint32_t motion_jobs_submit(motion_jobs_t *q, long target, float speed, float accel);
+
+/**
+ * 运动任务取出下一个排队的任务(ID最小的), 标记为运行中并记录起始位置。
+ * 没有排队任务时返回0。
+ */
+motion_job_t *motion_jobs_start_next(motion_jobs_t *q, long position);
+
+// 按ID查找任务记录, 不存在时返回0
+motion_job_t *motion_jobs_find(motion_jobs_t *q, uint32_t id);
+
+// 正在运行的任务, 没有时返回0
+motion_job_t *motion_jobs_running(motion_jobs_t *q);
+
+// 排队中的任务个数
+uint8_t motion_jobs_pending(const motion_jobs_t *q);
+
+/**
+ * 请求停止: 取消所有排队的任务, 运行中的任务由运动任务减速停止。
+ * 返回是否有正在运行的任务。
+ */
+bool motion_jobs_stop(motion_jobs_t *q);
+
+/**
+ * 任务结束。interrupted为运动任务是否因停止请求在到达目标前开始减速:
+ * 是则记为STOPPED, 否则为DONE(运动已完成后才到达的停止请求不影响结果)。
+ */
+void motion_jobs_finish(motion_jobs_t *q, motion_job_t *job, long position, bool interrupted);
+
+// 任务进度(0-100), 排队中为0, 完成为100
+uint8_t motion_job_progress(const motion_job_t *job);
+
+// 状态名(queued/running/done/stopped/cancelled)
+const char *motion_job_state_name(uint8_t state);
+
+/**
+ * 生成/stepper/status的JSON应答。job为0时表示空闲, 返回当前位置和排队个数。
+ * 返回写入的长度(不含结尾0), 与snprintf相同。
+ */
+int motion_job_status_json(const motion_job_t *job, uint8_t pending, long position, char *buf, size_t size);
+
+#endif // MOTION_JOBS_H
@@ -0,0 +1,82 @@
+/**
+ * 网页控制面板的运动部分: HTTP接口(提交/查询/停止)和步进定时器的单步处理。
+ * HTTP处理函数只生成应答(状态码和JSON), 由调用方发送; 电机由定时器按步驱动, 每一步安排下一次触发,
+ * 运动中不占用CPU忙等, 核心0的空闲任务照常运行, 任务看门狗保持开启。
+ * 板上由2.H把WebServer、esp_timer和任务通知接到这里, 主机测试编译同一个文件, 用模拟的AccelStepper。
+ * 实现在src/motion_panel.cpp。
+ */
+#ifndef MOTION_PANEL_H
+#define MOTION_PANEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <AccelStepper.h>
+
+#include "motion_jobs.h"
+
+#define MOTION_PANEL_REPLY_MAX 192  // 应答缓冲区大小
+#define MOTION_PANEL_RETRY_US 20    // 定时器早到(还没到下一步)时的重试间隔(us)
+#define MOTION_PANEL_DEFAULT_SPEED 1500 // /stepper/move不带speed时的速度(步/秒)
+#define MOTION_PANEL_DEFAULT_ACCEL 1800 // 不带accel时的加速度(步/秒^2)
+
+// 平台相关的操作: 板上是portMUX临界区和任务通知, 主机测试中是std::mutex和条件变量
+typedef struct
+{
+    void (*lock)(void);   // 进入临界区(保护任务队列)
+    void (*unlock)(void); // 退出临界区
+    void (*wake)(void);   // 有新任务, 唤醒运动任务
+} motion_panel_port_t;
+
+typedef struct
+{
+    motion_jobs_t jobs;
+    AccelStepper *stepper;
+    const motion_panel_port_t *port;
+    motion_job_t *current; // 运行中的任务记录, 只由运动任务和步进定时器访问
+    bool stopping;         // 停止请求是否在到达目标前打断了本次运动
+} motion_panel_t;
+
+// 初始化, 清空任务队列
+void motion_panel_init(motion_panel_t *p, AccelStepper *stepper, const motion_panel_port_t *port);
+
+/* ---------------- HTTP接口, 返回HTTP状态码, JSON应答写入buf ---------------- */
+
+/**
+ * 提交运动任务并立即返回任务ID(/stepper/move1~4)。
+ * 队列已满返回503。
+ */
+int motion_panel_submit(motion_panel_t *p, long target, float speed, float accel, const char *message, char *buf,
+                        size_t size);
+
+/**
+ * 自定义移动(/stepper/move?steps=&speed=&accel=), 参数为请求中的文本, 没有该参数时为NULL。
+ * 缺少steps或速度、加速度不大于0时返回400。
+ */
+int motion_panel_move(motion_panel_t *p, const char *steps, const char *speed, const char *accel, char *buf,
+                      size_t size);
+
+// 任务状态(/stepper/status?id=), id为NULL时返回当前任务; 未知任务返回404
+int motion_panel_status(motion_panel_t *p, const char *id, char *buf, size_t size);
+
+// 停止(/stepper/stop): 当前任务减速停止, 取消排队的任务
+int motion_panel_stop(motion_panel_t *p, char *buf, size_t size);
+
+/* ---------------- 运动任务和步进定时器 ---------------- */
+
+/**
+ * 运动任务: 取出下一个排队的任务并设置电机, 之后由调用方启动步进定时器。
+ * 没有排队任务时返回false。
+ */
+bool motion_panel_start_next(motion_panel_t *p);
+
+/**
+ * 步进定时器回调: 检查停止请求, 到期时走一步并更新任务位置。
+ * 返回到下一步的时间(us), 用于安排下一次触发; 返回0表示本次运动结束, 此后调用motion_panel_finish。
+ */
+uint32_t motion_panel_step(motion_panel_t *p);
+
+// 运动任务: 记录本次运动的结果, done不为NULL时复制结束时的任务记录
+void motion_panel_finish(motion_panel_t *p, motion_job_t *done);
+
+#endif // MOTION_PANEL_H
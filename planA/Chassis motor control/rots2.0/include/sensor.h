@@ -1,48 +1,119 @@
 /**
  * 通过超声波传感器测量距离，并根据距离设置chaosheng状态。
+ * 定时器按时隙轮流触发各传感器，GPIO中断记录回波边沿时间，测距在后台完成，
+ * measureDistanceAndSetState()只返回最新结果，不再用pulseIn阻塞调用方。
  */
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <ultrasonic.h>
+
 const int TRIGPIN = 25; // 超声波发射端
 const int ECHOPIN = 33;
-int chaosheng = 0;       // chaosheng状态，0为停止，1为行驶
-int averageDistance = 0; // 平均距离
-int measureDistanceAndSetState()
+#define ULTRASONIC_SLOT_US 60000 // 每个传感器的时隙，等上一次回波的余震消失后再触发下一个
+
+// 传感器引脚表，增加传感器时在这里添加，0号传感器决定chaosheng
+struct UltrasonicPins
 {
-    float totalDistance = 0;         // 用于存储多次读取的总和
-    const int numReadings = 3;       // 定义读取次数，取平均值以提高准确性
-    const float distanceFactor = 58; // 距离转换系数，基于声速和脉冲时间
+    uint8_t trig;
+    uint8_t echo;
+};
+const UltrasonicPins ultrasonicPins[] = {
+    {TRIGPIN, ECHOPIN},
+};
+const uint8_t ultrasonicNum = sizeof(ultrasonicPins) / sizeof(ultrasonicPins[0]);
 
-    // 清零TRIGPIN，准备触发超声波传感器
-    digitalWrite(TRIGPIN, LOW);
-    delayMicroseconds(2);
+ultrasonic_bus_t ultrasonicBus;
+portMUX_TYPE ultrasonicMux = portMUX_INITIALIZER_UNLOCKED;
+esp_timer_handle_t ultrasonicTimer = NULL;
 
-    // 循环进行多次测量，计算平均距离
-    for (int i = 0; i < numReadings; i++)
-    {
-        digitalWrite(TRIGPIN, HIGH); // 触发超声波传感器发送信号
-        delayMicroseconds(10);
-        digitalWrite(TRIGPIN, LOW); // 信号发送完毕
+volatile int chaosheng = 0;       // chaosheng状态，0为停止，1为行驶
+volatile int averageDistance = 0; // 平均距离
+
+// 回波引脚中断：记录边沿时间
+void IRAM_ATTR ultrasonicEchoISR(void *arg)
+{
+    uint8_t sensor = (uint8_t)(uintptr_t)arg;
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    bool level = digitalRead(ultrasonicPins[sensor].echo);
 
-        // 使用pulseIn函数读取脉冲宽度，计算距离
-        float distance = pulseIn(ECHOPIN, HIGH) / distanceFactor;
-        totalDistance += distance; // 累加每次的距离读数
+    portENTER_CRITICAL_ISR(&ultrasonicMux);
+    ultrasonic_bus_edge(&ultrasonicBus, sensor, level, now);
+    portEXIT_CRITICAL_ISR(&ultrasonicMux);
+}
 
-        // 等待一段时间，确保传感器稳定
-        delay(10);
+// 定时器回调：发布上一时隙的结果，然后触发下一个传感器
+void ultrasonicTimerCallback(void *arg)
+{
+    float distance;
+    bool valid;
+
+    portENTER_CRITICAL(&ultrasonicMux);
+    valid = ultrasonic_bus_distance(&ultrasonicBus, 0, &distance);
+    uint8_t sensor = ultrasonic_bus_next(&ultrasonicBus);
+    portEXIT_CRITICAL(&ultrasonicMux);
+    if (sensor == ULTRASONIC_NONE)
+    {
+        return;
+    }
+
+    // 没有回波时保持上一次的结果
+    if (valid)
+    {
+        averageDistance = (int)distance;
+        chaosheng = averageDistance <= 4 ? 0 : 1; // 距离小于等于4时设置为0，否则为1
     }
 
-    averageDistance = totalDistance / numReadings; // 计算平均距离
+    digitalWrite(ultrasonicPins[sensor].trig, HIGH); // 触发超声波传感器发送信号
+    delayMicroseconds(10);
+    digitalWrite(ultrasonicPins[sensor].trig, LOW); // 信号发送完毕
+}
 
-    // 根据平均距离设置chaosheng状态
-    if (averageDistance <= 4)
+// 初始化超声波传感器，启动后台测距
+void ultrasonicInit()
+{
+    if (ultrasonicTimer != NULL)
+    {
+        return;
+    }
+
+    if (!ultrasonic_bus_init(&ultrasonicBus, ultrasonicNum))
+    {
+        return;
+    }
+    for (uint8_t i = 0; i < ultrasonicNum; i++)
     {
-        chaosheng = 0; // 距离小于等于4时，设置为0
+        pinMode(ultrasonicPins[i].trig, OUTPUT);
+        digitalWrite(ultrasonicPins[i].trig, LOW);
+        pinMode(ultrasonicPins[i].echo, INPUT);
+        attachInterruptArg(ultrasonicPins[i].echo, ultrasonicEchoISR, (void *)(uintptr_t)i, CHANGE);
     }
-    else
+
+    esp_timer_create_args_t args = {};
+    args.callback = ultrasonicTimerCallback;
+    args.name = "ultrasonic";
+    esp_timer_create(&args, &ultrasonicTimer);
+    esp_timer_start_periodic(ultrasonicTimer, ULTRASONIC_SLOT_US);
+}
+
+// 获取某个传感器的平均距离(cm)，尚无有效回波或连续无回波时返回false
+bool ultrasonicGetDistance(uint8_t sensor, float *distance)
+{
+    if (sensor >= ultrasonicNum)
     {
-        chaosheng = 1; // 距离大于4时，设置为1
+        return false;
     }
+    portENTER_CRITICAL(&ultrasonicMux);
+    bool valid = ultrasonic_bus_distance(&ultrasonicBus, sensor, distance);
+    portEXIT_CRITICAL(&ultrasonicMux);
+    return valid;
+}
+
+int measureDistanceAndSetState()
+{
+    // 第一次调用时启动后台测距
+    ultrasonicInit();
     return chaosheng;
     // 打印平均距离值，帮助调试（根据需要取消注释）
     // Serial.print("Average Distance: ");
     // Serial.println(averageDistance);
-}
\ No newline at end of file
+}
@@ -0,0 +1,70 @@
+/**
+ * 超声波测距核心: 按轮询顺序触发多个传感器, 根据回波上升/下降沿时间戳计算距离并取平均。
+ * 不依赖Arduino, 边沿由调用方输入: 板上来自GPIO中断, 主机上可以直接喂入模拟的边沿序列。
+ * 实现在src/ultrasonic.cpp。
+ */
+#ifndef ULTRASONIC_H
+#define ULTRASONIC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+#define ULTRASONIC_MAX_SENSORS 4       // 最多传感器个数
+#define ULTRASONIC_NUM_READINGS 3      // 平均的读数个数
+#define ULTRASONIC_ECHO_TIMEOUT_US 25000 // 回波脉宽上限(约4.3m), 超过视为无回波
+#define ULTRASONIC_US_PER_CM 58        // 距离转换系数，基于声速和脉冲时间
+#define ULTRASONIC_MAX_MISSES 3        // 连续无回波达到此次数时清空读数, 不再返回旧距离
+#define ULTRASONIC_NONE 0xFF           // 没有可触发的传感器
+
+// 通道状态
+#define ULTRASONIC_IDLE 0      // 未触发
+#define ULTRASONIC_WAIT_RISE 1 // 已触发, 等待回波上升沿
+#define ULTRASONIC_WAIT_FALL 2 // 回波高电平中, 等待下降沿
+
+typedef struct
+{
+    volatile uint8_t state;
+    volatile uint32_t rise_us;                   // 回波上升沿时间
+    uint16_t readings[ULTRASONIC_NUM_READINGS];  // 最近几次回波脉宽(us)
+    uint8_t count;                               // readings中的有效个数
+    uint8_t head;                                // 下一个写入位置
+    uint32_t samples;                            // 有效回波次数
+    uint32_t misses;                             // 无回波次数
+    uint8_t consecutive_misses;                  // 连续无回波次数
+} ultrasonic_channel_t;
+
+typedef struct
+{
+    ultrasonic_channel_t channels[ULTRASONIC_MAX_SENSORS];
+    uint8_t num;     // 传感器个数
+    uint8_t current; // 当前触发的传感器
+} ultrasonic_bus_t;
+
+/**
+ * 初始化, num超过ULTRASONIC_MAX_SENSORS时按上限处理。num为0时返回false, 之后的调用均无效果。
+ */
+bool ultrasonic_bus_init(ultrasonic_bus_t *bus, uint8_t num);
+
+/**
+ * 选择下一个要触发的传感器。上一个传感器若仍未收到完整回波则记一次无回波。
+ * 一次只触发一个传感器, 避免相互串扰。返回应触发的传感器编号, 没有传感器时返回ULTRASONIC_NONE。
+ */
+uint8_t ultrasonic_bus_next(ultrasonic_bus_t *bus);
+
+/**
+ * 输入一个回波边沿(level为边沿之后的电平, now_us为时间戳)。
+ * 得到一个有效回波时返回true; sensor超出范围时忽略。
+ */
+bool ultrasonic_bus_edge(ultrasonic_bus_t *bus, uint8_t sensor, bool level, uint32_t now_us);
+
+/**
+ * 计算最近几次有效回波的平均距离(cm)。没有有效回波或sensor超出范围时返回false。
+ * 连续ULTRASONIC_MAX_MISSES次无回波后读数被清空, 收到新的回波前返回false。
+ */
+bool ultrasonic_bus_distance(const ultrasonic_bus_t *bus, uint8_t sensor, float *distance);
+
+#endif // ULTRASONIC_H
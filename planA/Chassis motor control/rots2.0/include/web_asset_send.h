@@ -0,0 +1,37 @@
+/**
+ * 发送Flash中的gzip网页资源(web_assets.h中由tools/embed_web.py生成的数组)。
+ * 数组用send_P直接发送, 不在堆上复制页面; 浏览器缓存的ETag与当前一致时只回复304。
+ * 服务器类型为模板参数: 板上是WebServer, 主机测试中是替身。不依赖Arduino, 可直接在主机上编译。
+ */
+#ifndef WEB_ASSET_SEND_H
+#define WEB_ASSET_SEND_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief       发送一个gzip网页资源
+ * @param       server: WebServer(需要在collectHeaders中收集If-None-Match)
+ * @param       data: gzip数据(Flash中)
+ * @param       len: 数据长度
+ * @param       type: Content-Type
+ * @param       etag: ETag(带引号)
+ * @retval      无
+ */
+template <typename Server>
+void web_asset_send(Server &server, const uint8_t *data, size_t len, const char *type, const char *etag)
+{
+    // 304也带ETag和Cache-Control, 浏览器据此刷新缓存的校验信息
+    server.sendHeader("ETag", etag);
+    server.sendHeader("Cache-Control", "no-cache"); // 每次用ETag校验, 页面更新后立即生效
+    if (strcmp(server.header("If-None-Match").c_str(), etag) == 0)
+    {
+        server.send(304);
+        return;
+    }
+    server.sendHeader("Content-Encoding", "gzip");
+    server.send_P(200, type, (const char *)data, len);
+}
+
+#endif // WEB_ASSET_SEND_H
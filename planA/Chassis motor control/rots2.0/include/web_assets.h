@@ -0,0 +1,79 @@
+// 由tools/embed_web.py生成, 不要手动修改, 修改对应的网页源文件后重新生成
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+// index.html: 3246 -> 2637 -> 962 bytes (source, minified, gzip)
+#define WEB_INDEX_HTML_TYPE "text/html"
+#define WEB_INDEX_HTML_ETAG "\"aec8d1cc\""
+constexpr size_t WEB_INDEX_HTML_GZ_LEN = 962;
+constexpr uint8_t WEB_INDEX_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xdd, 0x56, 0x51, 0x6f, 0x22, 0x37,
+    0x10, 0x7e, 0xdf, 0x5f, 0xe1, 0xa6, 0x0f, 0x5e, 0x54, 0x76, 0x81, 0x00, 0xea, 0x15, 0x58, 0xa4,
+    0x94, 0x70, 0xed, 0x55, 0xa1, 0x89, 0x9a, 0x54, 0x6a, 0x1f, 0x8d, 0x3d, 0x80, 0x1b, 0x63, 0xef,
+    0xd9, 0x5e, 0x08, 0xaa, 0xee, 0xbf, 0x77, 0xcc, 0xee, 0x26, 0x1b, 0x8e, 0xb6, 0xa7, 0xd3, 0xf5,
+    0xa5, 0x8a, 0xc8, 0xae, 0x3d, 0x33, 0xdf, 0xcc, 0x37, 0x33, 0x1e, 0xef, 0xe4, 0xab, 0xeb, 0xdb,
+    0xd9, 0xc3, 0xef, 0x77, 0x73, 0xb2, 0xf1, 0x5b, 0x35, 0x8d, 0x26, 0xe1, 0x41, 0x14, 0xd3, 0xeb,
+    0xec, 0x02, 0xf4, 0x45, 0xd8, 0x00, 0x26, 0xf0, 0xb1, 0x05, 0xcf, 0x08, 0xdf, 0x30, 0xeb, 0xc0,
+    0x67, 0xf4, 0xd7, 0x87, 0xb7, 0xc9, 0x1b, 0x5a, 0x6f, 0x6b, 0xb6, 0x85, 0x8c, 0xee, 0x24, 0xec,
+    0x73, 0x63, 0x3d, 0x25, 0xdc, 0x68, 0x0f, 0x1a, 0xd5, 0xf6, 0x52, 0xf8, 0x4d, 0x26, 0x60, 0x27,
+    0x39, 0x24, 0xc7, 0x45, 0x9b, 0x48, 0x2d, 0xbd, 0x64, 0x2a, 0x71, 0x9c, 0x29, 0xc8, 0x7a, 0x69,
+    0x37, 0xc0, 0x78, 0xe9, 0x15, 0x4c, 0xe7, 0xf7, 0x77, 0xfd, 0x4b, 0x32, 0x43, 0x6b, 0x6b, 0x14,
+    0xb9, 0x63, 0x1a, 0xd4, 0xa4, 0x53, 0x8a, 0xa2, 0x89, 0xf3, 0x87, 0xf0, 0x5c, 0x1a, 0x71, 0x20,
+    0x7f, 0x46, 0x2b, 0x54, 0x4a, 0x56, 0x6c, 0x2b, 0xd5, 0x61, 0x44, 0xe8, 0x95, 0x45, 0x44, 0xda,
+    0x26, 0x8e, 0x69, 0x97, 0x38, 0xb0, 0x72, 0x35, 0x8e, 0x96, 0x8c, 0x3f, 0xae, 0xad, 0x29, 0xb4,
+    0x48, 0xb8, 0x51, 0xc6, 0x8e, 0xc8, 0xd7, 0xab, 0x41, 0xf8, 0x1b, 0x47, 0x5b, 0x66, 0xd7, 0x52,
+    0x8f, 0x48, 0x77, 0x1c, 0xe5, 0x4c, 0x08, 0xa9, 0xd7, 0x23, 0x72, 0xd9, 0xcd, 0x9f, 0xc6, 0x91,
+    0x87, 0x27, 0x9f, 0x30, 0x25, 0xd7, 0x28, 0xe5, 0x48, 0x01, 0xec, 0x38, 0xfa, 0x10, 0x6d, 0x7a,
+    0xe8, 0xb1, 0x06, 0xe9, 0xf7, 0xfb, 0x61, 0x2f, 0x5d, 0x16, 0xde, 0x1b, 0x8d, 0x02, 0x21, 0x5d,
+    0xae, 0x18, 0x86, 0x21, 0xb5, 0x92, 0x1a, 0x92, 0xa5, 0x32, 0xfc, 0xb1, 0x81, 0xdc, 0x43, 0xe4,
+    0x0a, 0xbe, 0x76, 0x3c, 0x0c, 0x8b, 0x33, 0x01, 0x0e, 0x66, 0x57, 0x6f, 0x87, 0x18, 0x55, 0xb5,
+    0xde, 0x6f, 0xa4, 0x87, 0x2a, 0x28, 0x01, 0xdc, 0x58, 0xe6, 0xa5, 0x41, 0x73, 0x6d, 0x34, 0x6e,
+    0x2f, 0x8d, 0x15, 0x60, 0x5f, 0xaf, 0x12, 0xcb, 0x84, 0x2c, 0xdc, 0x88, 0x0c, 0x82, 0x07, 0x5e,
+    0x58, 0x17, 0x70, 0x72, 0x23, 0x4b, 0x2a, 0xde, 0x62, 0x82, 0x64, 0x09, 0x72, 0xea, 0x9e, 0x74,
+    0xd3, 0xbe, 0x6b, 0x30, 0x1b, 0x6d, 0xcc, 0x0e, 0x2c, 0xf2, 0x3b, 0x17, 0xe7, 0x90, 0x75, 0x07,
+    0xdf, 0x1d, 0x95, 0x79, 0x59, 0xad, 0x24, 0x68, 0xe4, 0xa8, 0x5d, 0x52, 0x4c, 0x96, 0x06, 0x31,
+    0xb6, 0x75, 0x5a, 0x51, 0xcf, 0x82, 0xcb, 0x8d, 0x76, 0x90, 0x6c, 0xc1, 0x39, 0xb6, 0x86, 0x17,
+    0x55, 0x6f, 0xf2, 0x5a, 0xaf, 0xc6, 0xbf, 0x7c, 0xc3, 0xbe, 0x1d, 0x0c, 0x83, 0xdd, 0xa4, 0x53,
+    0xd5, 0x7d, 0xd2, 0xa9, 0x1a, 0x31, 0x34, 0x40, 0x68, 0xcb, 0xde, 0xf9, 0x76, 0xc1, 0xfd, 0x68,
+    0x22, 0xe4, 0x8e, 0x70, 0xc5, 0x9c, 0xcb, 0xe8, 0xab, 0xf8, 0x42, 0xab, 0x55, 0x75, 0xab, 0xc4,
+    0xd5, 0x4a, 0x41, 0x20, 0x77, 0xd4, 0xa4, 0x44, 0x30, 0xcf, 0x12, 0xc6, 0x43, 0x9a, 0x32, 0x7a,
+    0x33, 0xbf, 0xee, 0x18, 0x4d, 0xa7, 0xb7, 0x39, 0x68, 0x82, 0x8b, 0x49, 0xa7, 0x34, 0xf9, 0x4c,
+    0xa4, 0xd5, 0x8a, 0x4e, 0x67, 0xca, 0x38, 0x38, 0xc1, 0xea, 0x60, 0xc8, 0x9f, 0x13, 0xb8, 0xf3,
+    0x90, 0xe7, 0x58, 0xf7, 0xf3, 0x2e, 0x2b, 0x69, 0x67, 0x8b, 0xa5, 0xec, 0xd1, 0xe9, 0x02, 0x1f,
+    0x64, 0x65, 0xec, 0x9e, 0x59, 0xf1, 0x6f, 0x3c, 0x3e, 0x1d, 0xf8, 0xb2, 0x02, 0x0e, 0x7d, 0xf2,
+    0x65, 0x91, 0xfb, 0xff, 0x55, 0xc8, 0x83, 0x93, 0x90, 0x7b, 0x5f, 0x06, 0xda, 0x61, 0x2b, 0xd3,
+    0xe9, 0x3d, 0xfe, 0x27, 0x0b, 0xe3, 0x8d, 0x3d, 0x5f, 0x5f, 0x29, 0x32, 0x7a, 0x7a, 0x1a, 0x68,
+    0xed, 0xef, 0x23, 0xc1, 0xf4, 0xd4, 0xf4, 0x0f, 0xb3, 0x4c, 0x9c, 0x67, 0xbe, 0x70, 0x2f, 0x32,
+    0xc7, 0xad, 0xcc, 0xfd, 0x34, 0x12, 0x86, 0x17, 0x5b, 0x1c, 0x5b, 0x29, 0xce, 0x9e, 0xf9, 0x0e,
+    0x5f, 0x6e, 0x24, 0xc6, 0xa6, 0xc1, 0xc6, 0xf4, 0xfa, 0x76, 0x31, 0x2b, 0xc7, 0xf2, 0x8d, 0x61,
+    0x02, 0x04, 0x4e, 0xcb, 0x55, 0xa1, 0x8f, 0x04, 0xe2, 0x16, 0x1e, 0xc6, 0x1d, 0xb3, 0xa1, 0x77,
+    0xab, 0xd3, 0xe4, 0x48, 0x46, 0x9e, 0xc1, 0xde, 0x17, 0x60, 0x0f, 0xf7, 0xa0, 0x80, 0x23, 0xa7,
+    0x2b, 0xa5, 0x62, 0x9a, 0x36, 0xbb, 0xbc, 0x35, 0x3e, 0x1a, 0x57, 0x49, 0xf8, 0x44, 0x80, 0xd3,
+    0x84, 0x56, 0x20, 0x35, 0xfd, 0x45, 0x35, 0x24, 0x1a, 0x20, 0x6b, 0xf0, 0x73, 0x05, 0xe1, 0xf5,
+    0xfb, 0xc3, 0x3b, 0x11, 0x7f, 0x9c, 0x29, 0x84, 0x68, 0x10, 0x48, 0xb1, 0x69, 0xe6, 0x8c, 0x6f,
+    0xe2, 0x67, 0x96, 0x65, 0x2d, 0x02, 0xd7, 0xf2, 0xed, 0x4c, 0x92, 0xb8, 0x92, 0xfc, 0xb1, 0x99,
+    0x19, 0x08, 0xf2, 0x60, 0xe2, 0x40, 0x8b, 0x5f, 0x00, 0x89, 0x38, 0x1f, 0xfb, 0x8d, 0x74, 0x21,
+    0x9c, 0x2b, 0xef, 0xad, 0x44, 0x2c, 0x88, 0x69, 0xa3, 0x1d, 0x68, 0xab, 0x61, 0x5f, 0xc5, 0x16,
+    0x10, 0x4e, 0xa8, 0xa5, 0x61, 0xaa, 0x57, 0x15, 0x41, 0x9a, 0x95, 0x22, 0x8e, 0xbc, 0xd6, 0xcb,
+    0xef, 0x24, 0xa5, 0xff, 0x07, 0x4a, 0x35, 0x0c, 0x69, 0x7a, 0x2f, 0xac, 0x6a, 0x13, 0xfc, 0x1c,
+    0x50, 0xe1, 0x3c, 0xd6, 0xcd, 0xf8, 0xb4, 0xb1, 0x08, 0xa2, 0x61, 0x4f, 0x7e, 0x5b, 0xdc, 0xfc,
+    0xe8, 0x7d, 0x5e, 0x6b, 0x23, 0x0a, 0xca, 0x52, 0x83, 0x03, 0x39, 0xa6, 0x3f, 0xcc, 0x1f, 0x90,
+    0xdc, 0x11, 0xc0, 0xdb, 0x02, 0x6a, 0x99, 0x56, 0xd8, 0xe4, 0x68, 0xfe, 0xaa, 0xc5, 0xe5, 0x8a,
+    0x94, 0x44, 0xcb, 0xe3, 0x43, 0xb2, 0x2c, 0xc3, 0x7b, 0xa7, 0x5b, 0x3b, 0xac, 0xd9, 0xa0, 0xd9,
+    0x4f, 0xf7, 0xb7, 0x3f, 0xa7, 0x79, 0xf8, 0xd6, 0x29, 0x0d, 0x6a, 0xd1, 0x03, 0x12, 0x44, 0x17,
+    0x75, 0xa8, 0x71, 0xbd, 0x9f, 0x56, 0x5c, 0xdb, 0xcf, 0x20, 0x81, 0x2e, 0x01, 0xe5, 0xc2, 0x3d,
+    0xf7, 0xac, 0x7e, 0x31, 0xb7, 0x36, 0xdc, 0x6f, 0x17, 0xe4, 0x1b, 0xd2, 0x08, 0x24, 0xe8, 0x46,
+    0x1f, 0xca, 0xc8, 0x43, 0x5a, 0xe2, 0xe3, 0x06, 0x7e, 0x67, 0xbd, 0x0b, 0xb7, 0xf6, 0x8e, 0xa9,
+    0xf8, 0x15, 0x8d, 0x66, 0xe6, 0x1a, 0xa3, 0xe7, 0x38, 0x11, 0xce, 0xd7, 0xe9, 0x6f, 0xcf, 0x50,
+    0x63, 0x96, 0xb4, 0xfe, 0xb1, 0x7a, 0x6d, 0x32, 0xc4, 0x44, 0x95, 0x0b, 0xbc, 0x92, 0xab, 0x71,
+    0x83, 0xf3, 0xad, 0xbc, 0x8c, 0x3b, 0xe5, 0xc7, 0xe3, 0x5f, 0x32, 0xa6, 0xcd, 0x89, 0x4d, 0x0a,
+    0x00, 0x00,
+};
+
+#endif // WEB_ASSETS_H
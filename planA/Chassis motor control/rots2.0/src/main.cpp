@@ -1,3 +1,7 @@
+#ifdef ROTS_WEB_PANEL
+// 网页控制面板(include/2.H): 运动任务队列、步进定时器和Flash中的gzip页面, 由env:esp32dev_web编译
+#include "2.H"
+#else
 #include <AccelStepper.h>
 #include <Arduino.h>
 #include <freertos/FreeRTOS.h>
@@ -18,4 +22,5 @@ void setup()
 void loop()
 {
 
-}
\ No newline at end of file
+}
+#endif
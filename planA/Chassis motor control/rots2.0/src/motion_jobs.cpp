@@ -0,0 +1,170 @@
+#include "motion_jobs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+void motion_jobs_init(motion_jobs_t *q)
+{
+    memset(q, 0, sizeof(*q));
+    q->next_id = 1;
+}
+
+static bool motion_job_active(const motion_job_t *job)
+{
+    return job->id != 0 && (job->state == MOTION_JOB_QUEUED || job->state == MOTION_JOB_RUNNING);
+}
+
+uint32_t motion_jobs_submit(motion_jobs_t *q, long target, float speed, float accel)
+{
+    motion_job_t *slot = 0;
+    for (uint8_t i = 0; i < MOTION_JOBS_MAX; i++)
+    {
+        motion_job_t *job = &q->jobs[i];
+        if (motion_job_active(job))
+            continue;
+        if (slot == 0 || job->id < slot->id)
+            slot = job;
+    }
+    if (slot == 0)
+    {
+        q->rejected++;
+        return 0;
+    }
+
+    slot->id = q->next_id++;
+    if (q->next_id == 0)
+        q->next_id = 1;
+    slot->state = MOTION_JOB_QUEUED;
+    slot->target = target;
+    slot->speed = speed;
+    slot->accel = accel;
+    slot->start = 0;
+    slot->position = 0;
+    q->submitted++;
+    return slot->id;
+}
+
+motion_job_t *motion_jobs_start_next(motion_jobs_t *q, long position)
+{
+    motion_job_t *next = 0;
+    for (uint8_t i = 0; i < MOTION_JOBS_MAX; i++)
+    {
+        motion_job_t *job = &q->jobs[i];
+        if (job->id != 0 && job->state == MOTION_JOB_QUEUED && (next == 0 || job->id < next->id))
+            next = job;
+    }
+    if (next != 0)
+    {
+        next->state = MOTION_JOB_RUNNING;
+        next->start = position;
+        next->position = position;
+        q->stop_request = false;
+    }
+    return next;
+}
+
+motion_job_t *motion_jobs_find(motion_jobs_t *q, uint32_t id)
+{
+    if (id == 0)
+        return 0;
+    for (uint8_t i = 0; i < MOTION_JOBS_MAX; i++)
+    {
+        if (q->jobs[i].id == id)
+            return &q->jobs[i];
+    }
+    return 0;
+}
+
+motion_job_t *motion_jobs_running(motion_jobs_t *q)
+{
+    for (uint8_t i = 0; i < MOTION_JOBS_MAX; i++)
+    {
+        if (q->jobs[i].id != 0 && q->jobs[i].state == MOTION_JOB_RUNNING)
+            return &q->jobs[i];
+    }
+    return 0;
+}
+
+uint8_t motion_jobs_pending(const motion_jobs_t *q)
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < MOTION_JOBS_MAX; i++)
+    {
+        if (q->jobs[i].id != 0 && q->jobs[i].state == MOTION_JOB_QUEUED)
+            n++;
+    }
+    return n;
+}
+
+bool motion_jobs_stop(motion_jobs_t *q)
+{
+    bool running = false;
+    for (uint8_t i = 0; i < MOTION_JOBS_MAX; i++)
+    {
+        motion_job_t *job = &q->jobs[i];
+        if (job->id == 0)
+            continue;
+        if (job->state == MOTION_JOB_QUEUED)
+            job->state = MOTION_JOB_CANCELLED;
+        else if (job->state == MOTION_JOB_RUNNING)
+            running = true;
+    }
+    q->stop_request = running;
+    return running;
+}
+
+void motion_jobs_finish(motion_jobs_t *q, motion_job_t *job, long position, bool interrupted)
+{
+    job->position = position;
+    job->state = interrupted ? MOTION_JOB_STOPPED : MOTION_JOB_DONE;
+    q->stop_request = false;
+}
+
+uint8_t motion_job_progress(const motion_job_t *job)
+{
+    if (job->state == MOTION_JOB_QUEUED || job->state == MOTION_JOB_CANCELLED)
+        return 0;
+    if (job->state == MOTION_JOB_DONE)
+        return 100;
+
+    long total = job->target - job->start;
+    if (total == 0)
+        return 100;
+    long done = job->position - job->start;
+    long percent = done * 100 / total;
+    return percent < 0 ? 0 : (percent > 100 ? 100 : (uint8_t)percent);
+}
+
+const char *motion_job_state_name(uint8_t state)
+{
+    switch (state)
+    {
+    case MOTION_JOB_QUEUED:
+        return "queued";
+    case MOTION_JOB_RUNNING:
+        return "running";
+    case MOTION_JOB_DONE:
+        return "done";
+    case MOTION_JOB_STOPPED:
+        return "stopped";
+    case MOTION_JOB_CANCELLED:
+        return "cancelled";
+    default:
+        return "unknown";
+    }
+}
+
+int motion_job_status_json(const motion_job_t *job, uint8_t pending, long position, char *buf, size_t size)
+{
+    if (job == 0)
+        return snprintf(buf, size, "{\"status\":\"idle\",\"message\":\"Idle\",\"pending\":%u,\"position\":%ld}",
+                        pending, position);
+
+    const char *state = motion_job_state_name(job->state);
+    uint8_t progress = motion_job_progress(job);
+    return snprintf(buf, size,
+                    "{\"status\":\"%s\",\"message\":\"Job %u %s %u%%\",\"id\":%u,\"progress\":%u,"
+                    "\"position\":%ld,\"target\":%ld,\"pending\":%u}",
+                    state, (unsigned)job->id, state, progress, (unsigned)job->id, progress, job->position,
+                    job->target, pending);
+}
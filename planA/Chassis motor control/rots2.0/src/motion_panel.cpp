@@ -0,0 +1,134 @@
+#include "motion_panel.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void motion_panel_init(motion_panel_t *p, AccelStepper *stepper, const motion_panel_port_t *port)
+{
+    motion_jobs_init(&p->jobs);
+    p->stepper = stepper;
+    p->port = port;
+    p->current = 0;
+    p->stopping = false;
+}
+
+static int reply(char *buf, size_t size, int code, const char *json)
+{
+    snprintf(buf, size, "%s", json);
+    return code;
+}
+
+int motion_panel_submit(motion_panel_t *p, long target, float speed, float accel, const char *message, char *buf,
+                        size_t size)
+{
+    p->port->lock();
+    uint32_t id = motion_jobs_submit(&p->jobs, target, speed, accel);
+    p->port->unlock();
+
+    if (id == 0)
+        return reply(buf, size, 503, "{\"status\":\"error\",\"message\":\"Queue full\"}");
+    p->port->wake();
+    snprintf(buf, size, "{\"status\":\"queued\",\"message\":\"%s (job %u)\",\"id\":%u}", message, (unsigned)id,
+             (unsigned)id);
+    return 200;
+}
+
+int motion_panel_move(motion_panel_t *p, const char *steps, const char *speed, const char *accel, char *buf,
+                      size_t size)
+{
+    if (steps == 0)
+        return reply(buf, size, 400, "{\"status\":\"error\",\"message\":\"Missing steps\"}");
+    float v = speed != 0 ? strtof(speed, 0) : MOTION_PANEL_DEFAULT_SPEED;
+    float a = accel != 0 ? strtof(accel, 0) : MOTION_PANEL_DEFAULT_ACCEL;
+    if (!(v > 0) || !(a > 0))
+        return reply(buf, size, 400, "{\"status\":\"error\",\"message\":\"Invalid speed or accel\"}");
+    return motion_panel_submit(p, strtol(steps, 0, 10), v, a, "Moving", buf, size);
+}
+
+int motion_panel_status(motion_panel_t *p, const char *id, char *buf, size_t size)
+{
+    p->port->lock();
+    motion_job_t *found = id != 0 ? motion_jobs_find(&p->jobs, (uint32_t)strtoul(id, 0, 10))
+                                  : motion_jobs_running(&p->jobs);
+    motion_job_t job;
+    if (found != 0)
+        job = *found;
+    uint8_t pending = motion_jobs_pending(&p->jobs);
+    long position = p->stepper->currentPosition();
+    p->port->unlock();
+
+    if (found == 0 && id != 0)
+        return reply(buf, size, 404, "{\"status\":\"error\",\"message\":\"Unknown job\"}");
+    motion_job_status_json(found != 0 ? &job : 0, pending, position, buf, size);
+    return 200;
+}
+
+int motion_panel_stop(motion_panel_t *p, char *buf, size_t size)
+{
+    p->port->lock();
+    bool running = motion_jobs_stop(&p->jobs);
+    p->port->unlock();
+
+    return reply(buf, size, 200,
+                 running ? "{\"status\":\"stopping\",\"message\":\"Stopping\"}"
+                         : "{\"status\":\"idle\",\"message\":\"Motor stopped\"}");
+}
+
+bool motion_panel_start_next(motion_panel_t *p)
+{
+    AccelStepper *stepper = p->stepper;
+    p->port->lock();
+    motion_job_t *job = motion_jobs_start_next(&p->jobs, stepper->currentPosition());
+    motion_job_t run;
+    if (job != 0)
+        run = *job;
+    p->port->unlock();
+
+    p->current = job;
+    p->stopping = false;
+    if (job == 0)
+        return false;
+    stepper->setMaxSpeed(run.speed);
+    stepper->setAcceleration(run.accel);
+    stepper->moveTo(run.target);
+    return true;
+}
+
+uint32_t motion_panel_step(motion_panel_t *p)
+{
+    AccelStepper *stepper = p->stepper;
+    if (p->jobs.stop_request && !p->stopping)
+    {
+        stepper->stop(); // 按当前加速度减速停止
+        p->stopping = true;
+    }
+
+    long before = stepper->currentPosition();
+    stepper->run();
+    long position = stepper->currentPosition();
+    if (stepper->distanceToGo() == 0)
+        return 0;
+    if (position == before)
+        return MOTION_PANEL_RETRY_US; // 还没到下一步
+
+    p->port->lock();
+    p->current->position = position;
+    p->port->unlock();
+    float speed = fabsf(stepper->speed());
+    if (speed < 1.0f)
+        return MOTION_PANEL_RETRY_US;
+    return (uint32_t)(1000000.0f / speed); // 与AccelStepper的步间隔相同
+}
+
+void motion_panel_finish(motion_panel_t *p, motion_job_t *done)
+{
+    if (p->current == 0)
+        return;
+    p->port->lock();
+    motion_jobs_finish(&p->jobs, p->current, p->stepper->currentPosition(), p->stopping);
+    if (done != 0)
+        *done = *p->current;
+    p->port->unlock();
+    p->current = 0;
+}
@@ -0,0 +1,106 @@
+#ifdef ARDUINO
+#include <Arduino.h> // IRAM_ATTR
+#endif
+#include "ultrasonic.h"
+
+#include <string.h>
+
+// 记一次无回波, 连续达到上限时清空读数(目标离开或传感器失效, 旧距离已不可信)
+static IRAM_ATTR void channel_miss(ultrasonic_channel_t *ch)
+{
+    ch->misses++;
+    if (ch->consecutive_misses < 255)
+        ch->consecutive_misses++;
+    if (ch->consecutive_misses >= ULTRASONIC_MAX_MISSES)
+    {
+        ch->count = 0;
+        ch->head = 0;
+    }
+}
+
+bool ultrasonic_bus_init(ultrasonic_bus_t *bus, uint8_t num)
+{
+    memset(bus, 0, sizeof(*bus));
+    if (num == 0)
+    {
+        return false;
+    }
+    bus->num = num > ULTRASONIC_MAX_SENSORS ? ULTRASONIC_MAX_SENSORS : num;
+    bus->current = bus->num - 1; // 第一次轮询从0号开始
+    return true;
+}
+
+uint8_t ultrasonic_bus_next(ultrasonic_bus_t *bus)
+{
+    if (bus->num == 0)
+    {
+        return ULTRASONIC_NONE;
+    }
+
+    ultrasonic_channel_t *last = &bus->channels[bus->current];
+    if (last->state != ULTRASONIC_IDLE)
+    {
+        channel_miss(last);
+    }
+    last->state = ULTRASONIC_IDLE;
+
+    bus->current = (bus->current + 1) % bus->num;
+    bus->channels[bus->current].state = ULTRASONIC_WAIT_RISE;
+    return bus->current;
+}
+
+IRAM_ATTR bool ultrasonic_bus_edge(ultrasonic_bus_t *bus, uint8_t sensor, bool level, uint32_t now_us)
+{
+    if (sensor >= bus->num)
+    {
+        return false;
+    }
+    ultrasonic_channel_t *ch = &bus->channels[sensor];
+
+    if (level)
+    {
+        if (ch->state == ULTRASONIC_WAIT_RISE)
+        {
+            ch->rise_us = now_us;
+            ch->state = ULTRASONIC_WAIT_FALL;
+        }
+        return false;
+    }
+
+    if (ch->state != ULTRASONIC_WAIT_FALL)
+        return false;
+    ch->state = ULTRASONIC_IDLE;
+
+    uint32_t width = now_us - ch->rise_us;
+    if (width >= ULTRASONIC_ECHO_TIMEOUT_US)
+    {
+        // 传感器自身超时输出的长脉冲, 同样视为无回波
+        channel_miss(ch);
+        return false;
+    }
+
+    ch->readings[ch->head] = (uint16_t)width;
+    ch->head = (ch->head + 1) % ULTRASONIC_NUM_READINGS;
+    if (ch->count < ULTRASONIC_NUM_READINGS)
+        ch->count++;
+    ch->samples++;
+    ch->consecutive_misses = 0;
+    return true;
+}
+
+bool ultrasonic_bus_distance(const ultrasonic_bus_t *bus, uint8_t sensor, float *distance)
+{
+    if (sensor >= bus->num)
+        return false;
+    const ultrasonic_channel_t *ch = &bus->channels[sensor];
+    if (ch->count == 0)
+        return false;
+
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < ch->count; i++)
+    {
+        total += ch->readings[i];
+    }
+    *distance = (float)total / ch->count / ULTRASONIC_US_PER_CM;
+    return true;
+}
@@ -0,0 +1,86 @@
+#ifndef HOST_ACCELSTEPPER_H
+#define HOST_ACCELSTEPPER_H
+
+/**
+ * 主机测试用的AccelStepper: 只实现motion_panel.cpp用到的接口, 按真实时间产生梯形加减速的步,
+ * speed()与AccelStepper相同为带方向的当前速度(步/秒)。位置可以在其他线程读取。
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+class AccelStepper
+{
+public:
+    enum
+    {
+        DRIVER = 1
+    };
+
+    AccelStepper(uint8_t interface = DRIVER, uint8_t pin1 = 2, uint8_t pin2 = 3)
+    {
+        (void)interface;
+        (void)pin1;
+        (void)pin2;
+    }
+
+    void setMaxSpeed(float speed) { max_speed_ = speed; }
+    void setAcceleration(float accel) { accel_ = accel; }
+    void moveTo(long target) { target_ = target; }
+    long distanceToGo() { return target_ - position_; }
+    long currentPosition() { return position_; }
+    float speed() { return distanceToGo() >= 0 ? speed_ : -speed_; }
+
+    // 按当前加速度减速停止: 目标改为停止距离之外
+    void stop()
+    {
+        long steps = (long)ceilf(speed_ * speed_ / (2.0f * accel_));
+        target_ = position_ + (distanceToGo() >= 0 ? steps : -steps);
+    }
+
+    // 到时间时走一步, 返回是否还在运动
+    bool run()
+    {
+        long remaining = labs(distanceToGo());
+        if (remaining == 0)
+        {
+            speed_ = 0.0f;
+            return false;
+        }
+        clock::time_point now = clock::now();
+        float min_speed = sqrtf(2.0f * accel_);
+        if (speed_ == 0.0f)
+        {
+            speed_ = min_speed;
+            last_step_ = now;
+        }
+        if (std::chrono::duration<float>(now - last_step_).count() < 1.0f / speed_)
+            return true;
+        last_step_ = now;
+        position_ += distanceToGo() > 0 ? 1 : -1;
+        remaining--;
+        if (remaining == 0)
+            speed_ = 0.0f;
+        else if (remaining <= speed_ * speed_ / (2.0f * accel_))
+            speed_ = std::max(min_speed, speed_ - accel_ / speed_);
+        else
+            speed_ = std::min(max_speed_, speed_ + accel_ / speed_);
+        return remaining != 0;
+    }
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    std::atomic<long> position_{0};
+    std::atomic<long> target_{0};
+    float max_speed_ = 1000.0f;
+    float accel_ = 1000.0f;
+    float speed_ = 0.0f;
+    clock::time_point last_step_;
+};
+
+#endif // HOST_ACCELSTEPPER_H
@@ -0,0 +1,400 @@
+// 运动任务队列的主机端测试: 在本机回环地址上运行一个HTTP替身, 按2.H的接口提交、查询和停止运动任务
+//
+// 编译并运行(在本目录, Linux/macOS):
+//   g++ -O2 -std=c++11 -pthread -Ihal -I../../include -I../../../../test -o motion_jobs_http_test motion_jobs_http_test.cpp ../../src/motion_jobs.cpp ../../src/motion_panel.cpp
+//   ./motion_jobs_http_test
+//
+// HTTP处理和步进逻辑就是固件编译的src/motion_panel.cpp, 只替换平台部分: hal/AccelStepper.h按真实时间产生步,
+// std::mutex代替portMUX, 条件变量代替任务通知, 运动线程按motion_panel_step返回的间隔休眠代替esp_timer。
+// 一个线程像loop()一样逐个处理请求并按2.H的路由调用motion_panel_xxx, 测试线程作为面板用真实的HTTP请求访问。检查:
+//   - 提交立即返回任务ID, 电机运行期间状态查询的应答时间远小于运动时间(面板保持响应)
+//   - 状态依次为queued/running/done, 进度不减少, 完成时位置等于目标
+//   - 运动中停止: 当前任务减速停在起点和目标之间, 记为stopped, 排队的任务全部cancelled
+//   - 8个任务记录都在排队或运行时返回503; 未知任务404; 缺少steps或速度无效400
+//   - 运动完成后、记录结束前到达的停止请求不把任务记为stopped
+//   - 步进定时器两次触发之间不忙等: 每一步的回调次数接近1
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <arpa/inet.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "motion_panel.h"
+#include "test_util.h"
+
+typedef std::chrono::steady_clock test_clock;
+
+static double elapsed_ms(test_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(test_clock::now() - start).count();
+}
+
+/* ---------------- 板上平台部分的替身 ---------------- */
+
+static AccelStepper stepper(AccelStepper::DRIVER, 18, 19);
+static motion_panel_t panel;
+static std::mutex jobMux;
+static std::condition_variable motionNotify;
+static bool motionPending = false;
+static std::atomic<bool> g_quit(false);
+static std::atomic<unsigned long> g_step_calls(0); // 步进定时器回调次数
+
+static void motion_lock(void) { jobMux.lock(); }
+static void motion_unlock(void) { jobMux.unlock(); }
+static void motion_wake(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(jobMux);
+        motionPending = true;
+    }
+    motionNotify.notify_one();
+}
+static const motion_panel_port_t port = {motion_lock, motion_unlock, motion_wake};
+
+// 2.H的motionTask和stepTimerCallback: 取出任务, 按返回的间隔触发步进直到运动结束
+static void motion_task(void)
+{
+    while (!g_quit)
+    {
+        if (!motion_panel_start_next(&panel))
+        {
+            std::unique_lock<std::mutex> lock(jobMux);
+            motionNotify.wait_for(lock, std::chrono::milliseconds(50), [] { return motionPending; });
+            motionPending = false;
+            continue;
+        }
+        uint32_t next = 1;
+        while (next != 0 && !g_quit)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(next));
+            next = motion_panel_step(&panel);
+            g_step_calls++;
+        }
+        motion_panel_finish(&panel, NULL);
+    }
+}
+
+typedef std::map<std::string, std::string> args_t;
+
+static const char *arg(const args_t &args, const char *name)
+{
+    args_t::const_iterator it = args.find(name);
+    return it != args.end() ? it->second.c_str() : NULL;
+}
+
+// 与2.H的路由相同
+static std::string handle_request(const std::string &path, const args_t &args, int *code)
+{
+    char buf[MOTION_PANEL_REPLY_MAX];
+    if (path == "/stepper/move1")
+        *code = motion_panel_submit(&panel, 2000, 1500, 1800, "Moving forward", buf, sizeof(buf));
+    else if (path == "/stepper/move")
+        *code = motion_panel_move(&panel, arg(args, "steps"), arg(args, "speed"), arg(args, "accel"), buf, sizeof(buf));
+    else if (path == "/stepper/status")
+        *code = motion_panel_status(&panel, arg(args, "id"), buf, sizeof(buf));
+    else if (path == "/stepper/stop")
+        *code = motion_panel_stop(&panel, buf, sizeof(buf));
+    else
+    {
+        *code = 404;
+        snprintf(buf, sizeof(buf), "{\"status\":\"error\",\"message\":\"Not found\"}");
+    }
+    return buf;
+}
+
+// 像loop()中的server.handleClient()一样逐个处理连接
+static void http_loop(int listen_fd)
+{
+    while (!g_quit)
+    {
+        struct pollfd pfd = {listen_fd, POLLIN, 0};
+        if (poll(&pfd, 1, 20) <= 0)
+            continue;
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0)
+            continue;
+        std::string request;
+        char buf[512];
+        while (request.find("\r\n\r\n") == std::string::npos)
+        {
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0)
+                break;
+            request.append(buf, n);
+        }
+
+        // "GET /path?a=1&b=2 HTTP/1.1"
+        std::string target = request.substr(4, request.find(' ', 4) - 4);
+        std::string path = target.substr(0, target.find('?'));
+        args_t args;
+        if (target.find('?') != std::string::npos)
+        {
+            std::string query = target.substr(target.find('?') + 1);
+            size_t pos = 0;
+            while (pos < query.size())
+            {
+                size_t end = query.find('&', pos);
+                std::string pair = query.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+                size_t eq = pair.find('=');
+                args[pair.substr(0, eq)] = eq == std::string::npos ? "" : pair.substr(eq + 1);
+                if (end == std::string::npos)
+                    break;
+                pos = end + 1;
+            }
+        }
+
+        int code = 500;
+        std::string body = handle_request(path, args, &code);
+        char header[160];
+        snprintf(header, sizeof(header),
+                 "HTTP/1.1 %d OK\r\nContent-Type: application/json\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+                 code, (unsigned)body.size());
+        std::string reply = header + body;
+        send(fd, reply.data(), reply.size(), 0);
+        close(fd);
+    }
+}
+
+/* ---------------- 面板(HTTP客户端) ---------------- */
+
+static int g_port = 0;
+static std::vector<double> g_latency_ms; // 电机运行期间的请求耗时
+
+static int http_get(const std::string &path, std::string *body, bool record = false)
+{
+    test_clock::time_point start = test_clock::now();
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(g_port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: 192.168.4.1\r\n\r\n";
+    send(fd, request.data(), request.size(), 0);
+    std::string reply;
+    char buf[512];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0)
+        reply.append(buf, n);
+    close(fd);
+    if (record)
+        g_latency_ms.push_back(elapsed_ms(start));
+
+    int code = 0;
+    sscanf(reply.c_str(), "HTTP/1.1 %d", &code);
+    size_t split = reply.find("\r\n\r\n");
+    *body = split == std::string::npos ? "" : reply.substr(split + 4);
+    return code;
+}
+
+// 取JSON中的数值或字符串字段(应答只有一层)
+static std::string json_field(const std::string &body, const char *key)
+{
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t pos = body.find(pattern);
+    if (pos == std::string::npos)
+        return "";
+    pos += pattern.size();
+    if (body[pos] == '"')
+        return body.substr(pos + 1, body.find('"', pos + 1) - pos - 1);
+    return body.substr(pos, body.find_first_of(",}", pos) - pos);
+}
+
+static uint32_t submit(const char *query)
+{
+    std::string body;
+    int code = http_get(std::string("/stepper/move?") + query, &body, true);
+    CHECK(code == 200 && json_field(body, "status") == "queued", "move %s -> %d %s", query, code, body.c_str());
+    return (uint32_t)atol(json_field(body, "id").c_str());
+}
+
+static std::string job_state(uint32_t id, std::string *body)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/stepper/status?id=%u", id);
+    int code = http_get(path, body, true);
+    CHECK(code == 200, "status of job %u -> %d", id, code);
+    return json_field(*body, "status");
+}
+
+// 轮询到任务结束, 返回最终状态
+static std::string wait_job(uint32_t id, std::string *body, double timeout_ms)
+{
+    test_clock::time_point start = test_clock::now();
+    int last_progress = 0;
+    std::string state;
+    while (elapsed_ms(start) < timeout_ms)
+    {
+        state = job_state(id, body);
+        int progress = atoi(json_field(*body, "progress").c_str());
+        if (state == "running")
+        {
+            CHECK(progress >= last_progress, "job %u progress went back from %d to %d", id, last_progress, progress);
+            last_progress = progress;
+        }
+        if (state != "queued" && state != "running")
+            return state;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return state;
+}
+
+static void test_move(void)
+{
+    std::string body;
+    unsigned long calls = g_step_calls;
+    test_clock::time_point start = test_clock::now();
+    uint32_t id = submit("steps=600&speed=3000&accel=20000");
+    double submit_ms = elapsed_ms(start);
+    CHECK(id != 0, "no job id");
+
+    bool saw_running = false;
+    while (elapsed_ms(start) < 5000)
+    {
+        std::string state = job_state(id, &body);
+        if (state == "running")
+            saw_running = true;
+        if (state == "done")
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    double move_ms = elapsed_ms(start);
+    CHECK(saw_running, "job %u never reported running", id);
+    CHECK(json_field(body, "status") == "done" && json_field(body, "position") == "600" &&
+              json_field(body, "progress") == "100",
+          "job %u finished as %s", id, body.c_str());
+    CHECK(submit_ms < 50, "submit took %.1f ms", submit_ms);
+    double calls_per_step = (g_step_calls - calls) / 600.0;
+    CHECK(calls_per_step < 1.5, "%.2f timer callbacks per step, stepping is polling", calls_per_step);
+    printf("move: submit %.2f ms, move %.0f ms, %.2f timer callbacks per step\n", submit_ms, move_ms,
+           calls_per_step);
+}
+
+static void test_stop(void)
+{
+    std::string body;
+    http_get("/stepper/status", &body);
+    long start_pos = atol(json_field(body, "position").c_str());
+    uint32_t first = submit("steps=-3000&speed=3000&accel=20000");
+    uint32_t second = submit("steps=600");
+    uint32_t third = submit("steps=0");
+
+    // 运动到一段距离后停止
+    test_clock::time_point start = test_clock::now();
+    while (elapsed_ms(start) < 5000)
+    {
+        if (job_state(first, &body) == "running" && atol(json_field(body, "position").c_str()) < start_pos - 300)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    CHECK(http_get("/stepper/stop", &body, true) == 200 && json_field(body, "status") == "stopping",
+          "stop -> %s", body.c_str());
+    std::string state = wait_job(first, &body, 5000);
+    long pos = atol(json_field(body, "position").c_str());
+    CHECK(state == "stopped", "stopped job %u finished as %s", first, state.c_str());
+    CHECK(pos < start_pos && pos > -3000, "stopped at %ld, start %ld, target -3000", pos, start_pos);
+    CHECK(job_state(second, &body) == "cancelled" && job_state(third, &body) == "cancelled",
+          "queued jobs not cancelled");
+    CHECK(http_get("/stepper/stop", &body) == 200 && json_field(body, "status") == "idle", "stop when idle -> %s",
+          body.c_str());
+    printf("stop: job %u stopped at %ld (from %ld towards -3000), 2 queued jobs cancelled\n", first, pos, start_pos);
+}
+
+static void test_errors(void)
+{
+    std::string body;
+    // 一个很慢的任务运行, 再排7个, 第9个被拒绝
+    uint32_t ids[MOTION_JOBS_MAX];
+    for (int i = 0; i < MOTION_JOBS_MAX; i++)
+        ids[i] = submit(i == 0 ? "steps=100000&speed=200&accel=1000" : "steps=0");
+    CHECK(http_get("/stepper/move?steps=5", &body) == 503, "ninth job accepted: %s", body.c_str());
+    CHECK(ids[MOTION_JOBS_MAX - 1] != 0, "eighth job rejected");
+    CHECK(http_get("/stepper/status?id=99999", &body) == 404, "unknown job -> %s", body.c_str());
+    CHECK(http_get("/stepper/move?speed=100", &body) == 400, "move without steps -> %s", body.c_str());
+    CHECK(http_get("/stepper/move?steps=5&speed=0", &body) == 400, "zero speed -> %s", body.c_str());
+    http_get("/stepper/stop", &body);
+    wait_job(ids[0], &body, 5000);
+    CHECK(http_get("/stepper/status", &body) == 200 && json_field(body, "status") == "idle", "idle status -> %s",
+          body.c_str());
+    printf("errors: queue full 503, unknown job 404, bad arguments 400\n");
+}
+
+// 运动已到达目标、记录结束前收到停止请求: 仍记为done
+static void test_late_stop(void)
+{
+    motion_jobs_t q;
+    motion_jobs_init(&q);
+    uint32_t id = motion_jobs_submit(&q, 100, 1000, 1000);
+    motion_job_t *job = motion_jobs_start_next(&q, 0);
+    CHECK(job != NULL && job->id == id, "job not started");
+    CHECK(motion_jobs_stop(&q), "running job not seen by stop");
+    motion_jobs_finish(&q, job, 100, false);
+    CHECK(job->state == MOTION_JOB_DONE, "late stop recorded as %s", motion_job_state_name(job->state));
+    CHECK(!q.stop_request, "stop request left set");
+    printf("late stop: recorded as done\n");
+}
+
+int main(void)
+{
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listen_fd, 8) != 0 ||
+        getsockname(listen_fd, (struct sockaddr *)&addr, &len) != 0)
+    {
+        perror("listen");
+        return 1;
+    }
+    g_port = ntohs(addr.sin_port);
+    printf("HTTP stand-in on 127.0.0.1:%d\n", g_port);
+
+    motion_panel_init(&panel, &stepper, &port);
+    std::thread server(http_loop, listen_fd);
+    std::thread motion(motion_task);
+
+    test_move();
+    test_stop();
+    test_errors();
+    test_late_stop();
+
+    g_quit = true;
+    motionNotify.notify_one();
+    server.join();
+    motion.join();
+    close(listen_fd);
+
+    if (!g_latency_ms.empty())
+    {
+        std::sort(g_latency_ms.begin(), g_latency_ms.end());
+        double p99 = g_latency_ms[(g_latency_ms.size() - 1) * 99 / 100];
+        printf("panel requests: %u, median %.2f ms, p99 %.2f ms, max %.2f ms\n", (unsigned)g_latency_ms.size(),
+               g_latency_ms[g_latency_ms.size() / 2], p99, g_latency_ms.back());
+        CHECK(p99 < 50, "p99 request time %.1f ms while the motor runs", p99);
+    }
+    return test_summary();
+}
@@ -0,0 +1,193 @@
+// 超声波测距核心的主机端测试: 用模拟的触发/回波边沿序列代替GPIO中断和定时器
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../../include -I../../../../test -o ultrasonic_test ultrasonic_test.cpp ../../src/ultrasonic.cpp
+//   ./ultrasonic_test [随机种子]
+//
+// 模拟边沿源按sensor.h的时隙(60ms)轮流触发各传感器, 对当前传感器按其距离产生回波上升/下降沿,
+// 并按比例注入: 无回波、传感器超时长脉冲、未触发时的毛刺边沿、其他传感器的串扰边沿。检查:
+//   - 每个传感器的平均距离与设定距离相差不超过1cm
+//   - 有效回波数和无回波数与注入的情况一致, 毛刺和串扰不产生读数
+//   - 连续ULTRASONIC_MAX_MISSES次无回波(含超时长脉冲)后不再返回旧距离, 新回波到来后只按新读数计算
+//   - num为0时初始化失败且各接口无效果, num超过上限时按上限处理, 编号超出范围的边沿被忽略
+// 本文件和ultrasonic.cpp都包含ultrasonic.h, 能链接即说明头文件中没有非inline的函数定义。
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ultrasonic.h"
+#include "test_util.h"
+
+#define SLOT_US 60000 // 与sensor.h中的ULTRASONIC_SLOT_US相同
+
+typedef struct
+{
+    float distance_cm; // 设定距离
+    uint32_t echoes;   // 产生的有效回波
+    uint32_t misses;   // 无回波或超时长脉冲
+    uint32_t consecutive; // 当前连续无回波次数
+} sim_sensor_t;
+
+// 运行slots个时隙: 与sensor.h的定时器回调相同, 先next再触发, 回波边沿在时隙内按时间输入
+static void run_slots(ultrasonic_bus_t *bus, sim_sensor_t *sensors, uint32_t slots, uint32_t *t_us)
+{
+    for (uint32_t s = 0; s < slots; s++)
+    {
+        uint8_t cur = ultrasonic_bus_next(bus);
+        uint32_t t0 = *t_us;
+        uint32_t r = rng_next() % 100;
+
+        // 触发之前的毛刺: 上一时隙的余震落在当前传感器上
+        if (r % 7 == 0)
+        {
+            ultrasonic_bus_edge(bus, cur, false, t0 + 5);
+        }
+
+        // 其他传感器的串扰边沿(未触发, 应被忽略)
+        if (bus->num > 1 && r % 5 == 0)
+        {
+            uint8_t other = (uint8_t)((cur + 1) % bus->num);
+            CHECK(!ultrasonic_bus_edge(bus, other, true, t0 + 300) && !ultrasonic_bus_edge(bus, other, false, t0 + 900),
+                  "crosstalk produced a reading on sensor %u", other);
+        }
+
+        sim_sensor_t *sensor = &sensors[cur];
+        uint32_t rise = t0 + 450; // 触发到回波上升沿的固定延迟
+        if (r < 8)
+        {
+            sensor->misses++; // 无回波: 时隙内没有边沿, 下一次next记为无回波
+            sensor->consecutive++;
+        }
+        else if (r < 12)
+        {
+            // 传感器自身超时输出约38ms的长脉冲
+            ultrasonic_bus_edge(bus, cur, true, rise);
+            CHECK(!ultrasonic_bus_edge(bus, cur, false, rise + 38000), "timeout pulse produced a reading");
+            sensor->misses++;
+            sensor->consecutive++;
+        }
+        else
+        {
+            // 回波脉宽 = 距离 * 58us/cm, 加±20us抖动
+            int jitter = (int)(rng_next() % 41) - 20;
+            uint32_t width = (uint32_t)lroundf(sensor->distance_cm * ULTRASONIC_US_PER_CM) + jitter;
+            ultrasonic_bus_edge(bus, cur, true, rise);
+            ultrasonic_bus_edge(bus, cur, true, rise + 3); // 重复的上升沿(抖动)不改变起点
+            CHECK(ultrasonic_bus_edge(bus, cur, false, rise + width), "echo on sensor %u not accepted", cur);
+            sensor->echoes++;
+            sensor->consecutive = 0;
+        }
+        *t_us += SLOT_US;
+    }
+}
+
+static void test_bus(uint8_t num)
+{
+    ultrasonic_bus_t bus;
+    sim_sensor_t sensors[ULTRASONIC_MAX_SENSORS];
+    CHECK(ultrasonic_bus_init(&bus, num), "init(%u) failed", num);
+    for (uint8_t i = 0; i < ULTRASONIC_MAX_SENSORS; i++)
+        sensors[i] = {(float)(8 + 37 * i), 0, 0, 0};
+
+    uint32_t t = 0xFFF00000u; // 计时器在测试中途回绕
+    run_slots(&bus, sensors, 4000, &t);
+    ultrasonic_bus_next(&bus); // 结束最后一个时隙, 使其无回波被计入
+
+    for (uint8_t i = 0; i < bus.num; i++)
+    {
+        float d;
+        const ultrasonic_channel_t *ch = &bus.channels[i];
+        if (sensors[i].consecutive >= ULTRASONIC_MAX_MISSES)
+            CHECK(!ultrasonic_bus_distance(&bus, i, &d), "sensor %u: stale distance after %u misses", i,
+                  (unsigned)sensors[i].consecutive);
+        else
+            CHECK(ultrasonic_bus_distance(&bus, i, &d) && fabsf(d - sensors[i].distance_cm) < 1.0f,
+                  "sensor %u: %.2f cm, expected %.1f", i, d, sensors[i].distance_cm);
+        CHECK(ch->samples == sensors[i].echoes, "sensor %u: %u samples, expected %u", i, (unsigned)ch->samples,
+              (unsigned)sensors[i].echoes);
+        CHECK(ch->misses == sensors[i].misses, "sensor %u: %u misses, expected %u", i, (unsigned)ch->misses,
+              (unsigned)sensors[i].misses);
+    }
+    printf("num=%u: %u sensors, sensor0 %u echoes / %u misses\n", num, bus.num, (unsigned)bus.channels[0].samples,
+           (unsigned)bus.channels[0].misses);
+}
+
+static void test_bounds(void)
+{
+    ultrasonic_bus_t bus;
+    float d;
+
+    CHECK(!ultrasonic_bus_init(&bus, 0), "init(0) accepted");
+    CHECK(ultrasonic_bus_next(&bus) == ULTRASONIC_NONE, "next() with no sensors");
+    CHECK(!ultrasonic_bus_edge(&bus, 0, true, 100) && !ultrasonic_bus_edge(&bus, 0, false, 700),
+          "edge() with no sensors");
+    CHECK(!ultrasonic_bus_distance(&bus, 0, &d), "distance() with no sensors");
+
+    CHECK(ultrasonic_bus_init(&bus, ULTRASONIC_MAX_SENSORS + 3) && bus.num == ULTRASONIC_MAX_SENSORS,
+          "num not clamped: %u", bus.num);
+    CHECK(ultrasonic_bus_init(&bus, 1), "init(1)");
+    CHECK(ultrasonic_bus_next(&bus) == 0 && ultrasonic_bus_next(&bus) == 0, "single sensor polling");
+    CHECK(!ultrasonic_bus_edge(&bus, 1, true, 100) && !ultrasonic_bus_edge(&bus, 200, false, 700),
+          "out-of-range sensor accepted");
+    CHECK(!ultrasonic_bus_distance(&bus, 1, &d), "distance() for out-of-range sensor");
+}
+
+// 一个传感器: 输入一次回波
+static void echo(ultrasonic_bus_t *bus, uint32_t width, uint32_t *t_us)
+{
+    ultrasonic_bus_next(bus);
+    ultrasonic_bus_edge(bus, 0, true, *t_us + 450);
+    ultrasonic_bus_edge(bus, 0, false, *t_us + 450 + width);
+    *t_us += SLOT_US;
+}
+
+// 目标离开后不能一直返回旧距离
+static void test_stale(void)
+{
+    ultrasonic_bus_t bus;
+    uint32_t t = 0;
+    float d;
+    ultrasonic_bus_init(&bus, 1);
+    for (int i = 0; i < ULTRASONIC_NUM_READINGS; i++)
+        echo(&bus, 20 * ULTRASONIC_US_PER_CM, &t);
+
+    // 不到上限的无回波保留读数
+    for (int i = 0; i < ULTRASONIC_MAX_MISSES - 1; i++)
+        ultrasonic_bus_next(&bus);
+    ultrasonic_bus_next(&bus);
+    CHECK(ultrasonic_bus_distance(&bus, 0, &d) && fabsf(d - 20.0f) < 0.01f, "%d misses dropped the reading: %.2f",
+          ULTRASONIC_MAX_MISSES - 1, d);
+
+    // 再一次无回波达到上限
+    ultrasonic_bus_next(&bus);
+    CHECK(!ultrasonic_bus_distance(&bus, 0, &d), "stale distance %.2f after %d misses", d, ULTRASONIC_MAX_MISSES);
+    for (int i = 0; i < 100; i++)
+        ultrasonic_bus_next(&bus);
+    CHECK(!ultrasonic_bus_distance(&bus, 0, &d) && bus.channels[0].consecutive_misses > 100,
+          "stale distance after many misses");
+
+    // 新回波只按新读数计算, 不与旧距离平均
+    echo(&bus, 50 * ULTRASONIC_US_PER_CM, &t);
+    CHECK(ultrasonic_bus_distance(&bus, 0, &d) && fabsf(d - 50.0f) < 0.01f, "new echo mixed with old: %.2f", d);
+
+    // 超时长脉冲同样计入连续无回波
+    for (int i = 0; i < ULTRASONIC_MAX_MISSES; i++)
+        echo(&bus, 38000, &t);
+    ultrasonic_bus_next(&bus);
+    CHECK(!ultrasonic_bus_distance(&bus, 0, &d), "stale distance %.2f after timeout pulses", d);
+    printf("stale: cleared after %d consecutive misses\n", ULTRASONIC_MAX_MISSES);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        rng_seed(argv[1]);
+    test_bounds();
+    test_stale();
+    test_bus(1);
+    test_bus(3);
+    test_bus(ULTRASONIC_MAX_SENSORS);
+    return test_summary();
+}
@@ -0,0 +1,233 @@
+// 网页资源发送的主机端测试: 每个请求的堆分配、零拷贝发送、ETag/304, 以及生成的gzip数组内容
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../../include -I../../../../test -o web_assets_test web_assets_test.cpp -lz
+//   ./web_assets_test
+//
+// 用不分配内存的WebServer替身调用web_asset_send, 替换全局operator new/delete统计堆分配。检查:
+//   - 连续请求页面时处理函数不分配堆内存, 发送的就是web_assets.h中的Flash数组(指针和长度相同)
+//   - 响应带Content-Encoding: gzip、ETag; If-None-Match与ETag相同时回复304且不发送正文(仍带ETag和Cache-Control),
+//     不同时发送页面
+//   - 数组是有效的gzip数据(头部时间为0, 生成结果可重复), 解压后是控制面板页面, ETag为gzip数据的CRC32
+// 同时打印改动前的做法(页面存放在String中, 每次请求复制后发送)每个请求的堆分配作为对比。
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <string>
+#include <zlib.h>
+
+#include "web_asset_send.h"
+#include "web_assets.h"
+#include "test_util.h"
+
+/* ---------------- 堆分配统计 ---------------- */
+
+static size_t g_alloc_count = 0;
+static size_t g_alloc_bytes = 0;
+
+void *operator new(size_t size)
+{
+    g_alloc_count++;
+    g_alloc_bytes += size;
+    void *p = malloc(size ? size : 1);
+    if (p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+/* ---------------- WebServer替身 ---------------- */
+
+#define FAKE_HEADERS_MAX 8
+
+// header()的返回值, 只需要c_str()
+struct FakeHeaderValue
+{
+    const char *value;
+    const char *c_str() const { return value; }
+};
+
+class FakeServer
+{
+public:
+    const char *if_none_match = ""; // 请求中的If-None-Match, 空串表示没有
+
+    int code;
+    const char *type;
+    const char *body;
+    size_t body_len;
+    const char *header_names[FAKE_HEADERS_MAX];
+    const char *header_values[FAKE_HEADERS_MAX];
+    int header_count;
+
+    void reset()
+    {
+        code = 0;
+        type = NULL;
+        body = NULL;
+        body_len = 0;
+        header_count = 0;
+    }
+
+    FakeHeaderValue header(const char *name)
+    {
+        FakeHeaderValue v = {strcmp(name, "If-None-Match") == 0 ? if_none_match : ""};
+        return v;
+    }
+    void sendHeader(const char *name, const char *value)
+    {
+        if (header_count < FAKE_HEADERS_MAX)
+        {
+            header_names[header_count] = name;
+            header_values[header_count++] = value;
+        }
+    }
+    void send(int c) { code = c; }
+    void send(int c, const char *t, const std::string &content)
+    {
+        code = c;
+        type = t;
+        body = content.data();
+        body_len = content.size();
+    }
+    void send_P(int c, const char *t, const char *content, size_t len)
+    {
+        code = c;
+        type = t;
+        body = content;
+        body_len = len;
+    }
+
+    const char *sent_header(const char *name) const
+    {
+        for (int i = 0; i < header_count; i++)
+            if (strcmp(header_names[i], name) == 0)
+                return header_values[i];
+        return NULL;
+    }
+};
+
+static FakeServer server;
+
+// 与2.H的handleRoot相同
+static void handle_root(void)
+{
+    web_asset_send(server, WEB_INDEX_HTML_GZ, WEB_INDEX_HTML_GZ_LEN, WEB_INDEX_HTML_TYPE, WEB_INDEX_HTML_ETAG);
+}
+
+/* ---------------- 测试 ---------------- */
+
+#define REQUESTS 1000
+
+static void test_heap_per_request(void)
+{
+    size_t count = g_alloc_count, bytes = g_alloc_bytes;
+    bool zero_copy = true;
+    for (int i = 0; i < REQUESTS; i++)
+    {
+        server.reset();
+        handle_root();
+        zero_copy = zero_copy && server.code == 200 && server.body == (const char *)WEB_INDEX_HTML_GZ &&
+                    server.body_len == WEB_INDEX_HTML_GZ_LEN;
+    }
+    size_t allocs = g_alloc_count - count, alloc_bytes = g_alloc_bytes - bytes;
+    CHECK(zero_copy, "page not sent straight from the flash array");
+    CHECK(allocs == 0, "%u allocations (%u bytes) in %d requests", (unsigned)allocs, (unsigned)alloc_bytes, REQUESTS);
+    CHECK(strcmp(server.type, "text/html") == 0, "content type %s", server.type);
+    CHECK(server.sent_header("Content-Encoding") != NULL && strcmp(server.sent_header("Content-Encoding"), "gzip") == 0,
+          "no Content-Encoding: gzip");
+    CHECK(server.sent_header("ETag") != NULL && strcmp(server.sent_header("ETag"), WEB_INDEX_HTML_ETAG) == 0,
+          "no ETag");
+    printf("flash asset: %.1f allocations, %.0f heap bytes per request, %u bytes sent\n", (double)allocs / REQUESTS,
+           (double)alloc_bytes / REQUESTS, (unsigned)WEB_INDEX_HTML_GZ_LEN);
+}
+
+static void test_etag(void)
+{
+    server.if_none_match = WEB_INDEX_HTML_ETAG;
+    server.reset();
+    size_t count = g_alloc_count;
+    handle_root();
+    CHECK(server.code == 304 && server.body == NULL, "matching ETag -> %d, %u bytes", server.code,
+          (unsigned)server.body_len);
+    CHECK(server.sent_header("ETag") != NULL && strcmp(server.sent_header("ETag"), WEB_INDEX_HTML_ETAG) == 0 &&
+              server.sent_header("Cache-Control") != NULL && strcmp(server.sent_header("Cache-Control"), "no-cache") == 0,
+          "304 without ETag/Cache-Control");
+    CHECK(server.sent_header("Content-Encoding") == NULL, "304 with Content-Encoding");
+    CHECK(g_alloc_count == count, "304 path allocated");
+
+    server.if_none_match = "\"00000000\"";
+    server.reset();
+    handle_root();
+    CHECK(server.code == 200 && server.body_len == WEB_INDEX_HTML_GZ_LEN, "stale ETag -> %d", server.code);
+    server.if_none_match = "";
+    printf("etag: 304 with ETag on match, page on mismatch\n");
+}
+
+// 解压并检查生成的数组, 返回解压后的页面
+static std::string test_gzip(void)
+{
+    CHECK(WEB_INDEX_HTML_GZ[0] == 0x1f && WEB_INDEX_HTML_GZ[1] == 0x8b, "not gzip data");
+    CHECK(WEB_INDEX_HTML_GZ[4] == 0 && WEB_INDEX_HTML_GZ[5] == 0 && WEB_INDEX_HTML_GZ[6] == 0 &&
+              WEB_INDEX_HTML_GZ[7] == 0,
+          "gzip mtime not 0, regenerated header would change on every build");
+
+    std::string page(64 * 1024, '\0');
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    inflateInit2(&zs, 16 + MAX_WBITS); // 16: gzip头
+    zs.next_in = (Bytef *)WEB_INDEX_HTML_GZ;
+    zs.avail_in = (uInt)WEB_INDEX_HTML_GZ_LEN;
+    zs.next_out = (Bytef *)&page[0];
+    zs.avail_out = (uInt)page.size();
+    int ret = inflate(&zs, Z_FINISH);
+    page.resize(zs.total_out);
+    inflateEnd(&zs);
+    CHECK(ret == Z_STREAM_END, "inflate returned %d", ret);
+    CHECK(page.find("<html") != std::string::npos && page.find("stepper/move1") != std::string::npos &&
+              page.find("stepper/status") != std::string::npos && page.find("stepper/stop") != std::string::npos,
+          "inflated page is not the control panel");
+
+    char etag[16];
+    snprintf(etag, sizeof(etag), "\"%08lx\"", crc32(0, WEB_INDEX_HTML_GZ, (uInt)WEB_INDEX_HTML_GZ_LEN));
+    CHECK(strcmp(etag, WEB_INDEX_HTML_ETAG) == 0, "ETag %s, CRC32 of data %s", WEB_INDEX_HTML_ETAG, etag);
+    printf("gzip: %u -> %u bytes, ETag %s\n", (unsigned)page.size(), (unsigned)WEB_INDEX_HTML_GZ_LEN, etag);
+    return page;
+}
+
+// 改动前: 页面存放在全局String中, 发送时复制一份
+static void print_string_baseline(const std::string &html)
+{
+    std::string global_page = html; // 对应全局String HTML, 启动时就占用堆
+    size_t count = g_alloc_count, bytes = g_alloc_bytes;
+    for (int i = 0; i < REQUESTS; i++)
+    {
+        std::string copy = global_page;
+        server.reset();
+        server.send(200, "text/html", copy);
+    }
+    printf("String page (before): %u resident heap bytes, %.1f allocations, %.0f heap bytes per request\n",
+           (unsigned)global_page.size(), (double)(g_alloc_count - count) / REQUESTS,
+           (double)(g_alloc_bytes - bytes) / REQUESTS);
+}
+
+int main(void)
+{
+    test_heap_per_request();
+    test_etag();
+    std::string page = test_gzip();
+    print_string_baseline(page);
+    return test_summary();
+}
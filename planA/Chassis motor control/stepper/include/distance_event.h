@@ -0,0 +1,89 @@
+#ifndef DISTANCE_EVENT_H
+#define DISTANCE_EVENT_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include "distance_threshold.h"
+
+/**
+ * @brief 距离事件错误码定义
+ */
+#define DISTANCE_EVENT_EOK 0      /**< 操作成功 */
+#define DISTANCE_EVENT_ERROR 1    /**< 操作失败 */
+#define DISTANCE_EVENT_ETIMEOUT 2 /**< 等待超时 */
+#define DISTANCE_EVENT_EINVAL 3   /**< 无效参数 */
+#define DISTANCE_EVENT_EFULL 4    /**< 阈值已满 */
+
+/**
+ * @brief 距离来源, 所有来源统一使用mm
+ */
+#define DISTANCE_SOURCE_LASER 0      /**< 激光传感器(滤波后距离) */
+#define DISTANCE_SOURCE_ULTRASONIC 1 /**< 超声波传感器(本工程尚无超声波驱动, 目前只由仿真输入) */
+#define DISTANCE_SOURCE_NUM 2
+
+/**
+ * @brief 最多可注册的阈值个数(每个阈值占事件组2位)
+ */
+#define DISTANCE_EVENT_MAX 8
+
+/**
+ * @brief 阈值id对应的事件位, 状态位为电平: 当前状态的位置1, 另一位清0
+ */
+#define DISTANCE_EVENT_NEAR_BIT(id) ((EventBits_t)1 << (2 * (id)))
+#define DISTANCE_EVENT_FAR_BIT(id) ((EventBits_t)1 << (2 * (id) + 1))
+
+/**
+ * @brief 初始化距离事件(创建事件组), 在注册阈值和传感器初始化之前调用
+ * 注册阈值的提示只写到log, 本模块不使用Serial(任务程序中Serial连接底盘)
+ *
+ * @param log 打印提示的串口, NULL表示不打印
+ */
+void distance_event_init(Stream *log);
+
+/**
+ * @brief 注册一个带回差的距离阈值
+ *
+ * @param source 距离来源 DISTANCE_SOURCE_xxx
+ * @param near 进入"近"状态的距离(mm)
+ * @param far 进入"远"状态的距离(mm)
+ * @param id 输出阈值id
+ * @return uint8_t 错误码(0=成功，DISTANCE_EVENT_EFULL=阈值已满)
+ */
+uint8_t distance_event_register(uint8_t source, float near, float far, uint8_t *id);
+
+/**
+ * @brief 输入一个距离样本, 由传感器驱动在得到新样本时调用
+ * 越过阈值时在事件组中更新状态位, 等待的任务在同一个样本内被唤醒
+ *
+ * @param source 距离来源
+ * @param distance 距离(mm)
+ */
+void distance_event_feed(uint8_t source, float distance);
+
+/**
+ * @brief 阻塞等待阈值进入"近"或"远"状态(当前已处于该状态则立即返回)
+ *
+ * @param id 阈值id
+ * @param timeout_ms 超时时间(ms), portMAX_DELAY表示一直等待
+ * @param state 输出当前状态 DISTANCE_STATE_NEAR/FAR
+ * @return uint8_t 错误码(0=成功，DISTANCE_EVENT_ETIMEOUT=超时)
+ */
+uint8_t distance_event_wait(uint8_t id, uint32_t timeout_ms, uint8_t *state);
+
+/**
+ * @brief 获取阈值当前状态(非阻塞)
+ *
+ * @param id 阈值id
+ * @return uint8_t DISTANCE_STATE_xxx
+ */
+uint8_t distance_event_get_state(uint8_t id);
+
+/**
+ * @brief 获取事件组句柄, 用于同时等待多个阈值
+ *
+ * @return EventGroupHandle_t 事件组
+ */
+EventGroupHandle_t distance_event_group(void);
+
+#endif // DISTANCE_EVENT_H
@@ -0,0 +1,53 @@
+#ifndef DISTANCE_THRESHOLD_H
+#define DISTANCE_THRESHOLD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief 带回差的距离阈值
+ *
+ * 距离小于等于near时进入"近"状态, 大于等于far时进入"远"状态,
+ * 两者之间保持原状态, 避免在阈值附近来回抖动。
+ * 不依赖Arduino, 可直接在主机上用合成的距离序列驱动。
+ */
+
+/**
+ * @brief 阈值状态
+ */
+#define DISTANCE_STATE_UNKNOWN 0 /**< 尚未收到数据 */
+#define DISTANCE_STATE_NEAR 1    /**< 距离 <= near */
+#define DISTANCE_STATE_FAR 2     /**< 距离 >= far */
+
+/**
+ * @brief 阈值
+ */
+typedef struct
+{
+    float near;         /**< 进入"近"状态的距离 */
+    float far;          /**< 进入"远"状态的距离, 须大于等于near */
+    uint8_t state;      /**< DISTANCE_STATE_xxx */
+    uint32_t crossings; /**< 状态变化次数 */
+} distance_threshold_t;
+
+/**
+ * @brief 初始化阈值
+ *
+ * @param threshold 阈值
+ * @param near 进入"近"状态的距离
+ * @param far 进入"远"状态的距离
+ */
+void distance_threshold_init(distance_threshold_t *threshold, float near, float far);
+
+/**
+ * @brief 输入一个距离
+ * 第一个样本按near划分状态, 之后只在越过near/far时改变状态
+ *
+ * @param threshold 阈值
+ * @param distance 距离
+ * @return true 状态发生变化
+ * @return false 状态不变
+ */
+bool distance_threshold_update(distance_threshold_t *threshold, float distance);
+
+#endif // DISTANCE_THRESHOLD_H
@@ -7,6 +7,6 @@
 
 // 函数声明
 void laser_init(void);
-float jiguang(void);
+float jiguang(void); // 返回距离(mm)，无数据时返回-1
 
 #endif // _LASER_H_ 
\ No newline at end of file
@@ -0,0 +1,118 @@
+#ifndef LASER_FILTER_H
+#define LASER_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief 激光距离滤波: 野值剔除 -> 中值窗口 -> alpha-beta滤波
+ *
+ * 每个输出都带有效/新鲜标志, 没有数据时不再给出伪造的距离。
+ * 不依赖Arduino, 可直接在主机上编译。
+ */
+
+/** 中值窗口最大长度 */
+#define LASER_FILTER_MEDIAN_MAX 9
+
+/** outlier_reset最小值: 为0或1时每个野值都会立即重新初始化, 野值剔除失效 */
+#define LASER_FILTER_OUTLIER_RESET_MIN 2
+
+/** stale_ms范围(ms) */
+#define LASER_FILTER_STALE_MIN_MS 10
+#define LASER_FILTER_STALE_MAX_MS 10000
+
+/**
+ * @brief 输出标志
+ */
+#define LASER_FILTER_FLAG_VALID 0x01   /**< 滤波器已初始化, 距离可用 */
+#define LASER_FILTER_FLAG_FRESH 0x02   /**< 最近一次接受的样本未超过stale_ms */
+#define LASER_FILTER_FLAG_OUTLIER 0x04 /**< 最近一个原始样本被判为野值丢弃 */
+
+/**
+ * @brief 滤波参数
+ */
+typedef struct
+{
+    uint8_t median_window;  /**< 中值窗口长度(1-9), 1表示不做中值 */
+    float alpha;            /**< 位置修正系数(0-1) */
+    float beta;             /**< 速度修正系数(0-1) */
+    float outlier_gate;     /**< 与预测值相差超过此值(mm)视为野值 */
+    uint8_t outlier_reset;  /**< 连续多少个野值后认为目标真实跳变并重新初始化(>=2) */
+    uint32_t stale_ms;      /**< 超过此时间(ms)没有新样本则清除新鲜标志(10-10000) */
+} laser_filter_config_t;
+
+/**
+ * @brief 滤波输出
+ */
+typedef struct
+{
+    float distance;     /**< 滤波后距离(mm) */
+    float velocity;     /**< 距离变化率(mm/s), 靠近为负 */
+    uint32_t timestamp; /**< 最近一次接受样本的时间(ms) */
+    uint8_t flags;      /**< LASER_FILTER_FLAG_xxx */
+} laser_filtered_t;
+
+/**
+ * @brief 滤波器状态
+ */
+typedef struct
+{
+    laser_filter_config_t config;
+    uint16_t window[LASER_FILTER_MEDIAN_MAX]; /**< 中值窗口(环形) */
+    uint8_t window_count;                     /**< 窗口内样本数 */
+    uint8_t window_head;                      /**< 下一个写入位置 */
+    float x;                                  /**< 位置估计 */
+    float v;                                  /**< 速度估计 */
+    uint32_t timestamp;                       /**< 最近一次接受样本的时间 */
+    bool initialized;                         /**< 是否已有估计 */
+    bool last_outlier;                        /**< 最近一个样本是否被丢弃 */
+    uint8_t rejects;                          /**< 连续野值个数 */
+    uint32_t accepted;                        /**< 接受的样本数 */
+    uint32_t outliers;                        /**< 丢弃的样本数 */
+} laser_filter_t;
+
+/**
+ * @brief 获取默认参数(中值5点, alpha=0.5, beta=0.1, 野值门限150mm)
+ *
+ * @param config 输出参数
+ */
+void laser_filter_default_config(laser_filter_config_t *config);
+
+/**
+ * @brief 检查参数是否都在有效范围内
+ *
+ * @param config 参数
+ * @return true 参数有效
+ * @return false 为NULL或有参数超出范围
+ */
+bool laser_filter_config_check(const laser_filter_config_t *config);
+
+/**
+ * @brief 初始化滤波器
+ *
+ * @param filter 滤波器
+ * @param config 参数, 为NULL时使用默认参数
+ */
+void laser_filter_init(laser_filter_t *filter, const laser_filter_config_t *config);
+
+/**
+ * @brief 输入一个原始样本
+ *
+ * @param filter 滤波器
+ * @param distance 原始距离(mm)
+ * @param timestamp 样本时间(ms)
+ * @return true 样本被接受
+ * @return false 样本被判为野值
+ */
+bool laser_filter_update(laser_filter_t *filter, uint16_t distance, uint32_t timestamp);
+
+/**
+ * @brief 获取滤波输出
+ *
+ * @param filter 滤波器
+ * @param now 当前时间(ms), 用于判断新鲜度
+ * @param out 输出
+ */
+void laser_filter_get(const laser_filter_t *filter, uint32_t now, laser_filtered_t *out);
+
+#endif // LASER_FILTER_H
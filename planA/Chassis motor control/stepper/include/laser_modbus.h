@@ -0,0 +1,171 @@
+#ifndef LASER_MODBUS_H
+#define LASER_MODBUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief ATK-MS53L2M Modbus RTU 帧编解码
+ *
+ * 只实现驱动用到的两个功能码: 0x03读保持寄存器, 0x06写单个寄存器。
+ * 应答帧长度由功能码(和字节数)确定, 按固定长度收齐后做CRC16校验。
+ * 不依赖Arduino, 可直接在主机上编译。
+ */
+
+/** 传感器默认从机地址 */
+#define LASER_MB_ADDR_DEFAULT 0x01
+
+/** 功能码 */
+#define LASER_MB_FUNC_READ 0x03
+#define LASER_MB_FUNC_WRITE 0x06
+#define LASER_MB_FUNC_ERROR 0x80 /**< 异常应答时功能码最高位置1 */
+
+/**
+ * @brief 传感器寄存器地址(以ATK-MS53L2M用户手册为准)
+ * 除距离寄存器外均未核实, 驱动默认不写入(见laser_sensor.h中的LASER_SENSOR_MODBUS_CONFIG)
+ */
+#define LASER_MB_REG_WORKMODE 0x0003 /**< 工作模式 */
+#define LASER_MB_REG_MEASMODE 0x0004 /**< 测量模式 */
+#define LASER_MB_REG_DISTANCE 0x0005 /**< 测量数据(mm) */
+#define LASER_MB_REG_OUTFREQ 0x0006  /**< 输出频率 */
+
+/**
+ * @brief 寄存器取值
+ */
+#define LASER_MB_WORKMODE_MODBUS 0x00 /**< Modbus接口, 主机查询 */
+#define LASER_MB_WORKMODE_ASCII 0x01  /**< ASCII接口, 主动输出 */
+#define LASER_MB_MEASMODE_HIGH_SPEED 0x02 /**< 高速测量模式 */
+#define LASER_MB_OUTFREQ_MAX 0x07         /**< 最高输出频率档位 */
+
+/** 请求帧长度(读和写相同) */
+#define LASER_MB_REQUEST_LEN 8
+
+/** 最多一次读取的寄存器个数 */
+#define LASER_MB_MAX_REGS 2
+
+/** 配置寄存器写入: 等待回显的时间(ms)和重试次数 */
+#define LASER_MB_WRITE_TIMEOUT_MS 100
+#define LASER_MB_WRITE_RETRY 3
+
+/**
+ * @brief 解码得到的应答
+ */
+typedef struct
+{
+    uint8_t func;                       /**< 功能码(不含异常位) */
+    uint8_t exception;                  /**< 异常码, 0表示正常应答 */
+    uint8_t count;                      /**< 读应答中的寄存器个数 */
+    uint16_t reg;                       /**< 写应答中的寄存器地址 */
+    uint16_t values[LASER_MB_MAX_REGS]; /**< 读到的寄存器值或写入值 */
+} laser_mb_reply_t;
+
+/**
+ * @brief 应答帧解码器
+ */
+typedef struct
+{
+    uint8_t addr;        /**< 期望的从机地址 */
+    uint8_t buf[5 + 2 * LASER_MB_MAX_REGS];
+    uint8_t cnt;         /**< 已收字节数 */
+    uint8_t len;         /**< 当前帧总长度, 0表示尚未确定 */
+    uint32_t frames;     /**< 校验通过的帧数 */
+    uint32_t crc_errors; /**< 校验失败的帧数 */
+} laser_mb_decoder_t;
+
+/**
+ * @brief 计算Modbus CRC16
+ *
+ * @param data 数据
+ * @param len 长度
+ * @return uint16_t CRC值(发送时低字节在前)
+ */
+uint16_t laser_mb_crc16(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 生成读保持寄存器请求
+ *
+ * @param addr 从机地址
+ * @param reg 起始寄存器
+ * @param count 寄存器个数(1-LASER_MB_MAX_REGS)
+ * @param frame 输出缓冲区, 至少LASER_MB_REQUEST_LEN字节
+ * @return uint8_t 帧长度
+ */
+uint8_t laser_mb_build_read(uint8_t addr, uint16_t reg, uint16_t count, uint8_t *frame);
+
+/**
+ * @brief 生成写单个寄存器请求
+ *
+ * @param addr 从机地址
+ * @param reg 寄存器
+ * @param value 写入值
+ * @param frame 输出缓冲区, 至少LASER_MB_REQUEST_LEN字节
+ * @return uint8_t 帧长度
+ */
+uint8_t laser_mb_build_write(uint8_t addr, uint16_t reg, uint16_t value, uint8_t *frame);
+
+/**
+ * @brief 复位解码器
+ *
+ * @param decoder 解码器
+ * @param addr 期望的从机地址
+ */
+void laser_mb_decoder_reset(laser_mb_decoder_t *decoder, uint8_t addr);
+
+/**
+ * @brief 喂入一个字节
+ *
+ * @param decoder 解码器
+ * @param byte 串口收到的字节
+ * @param reply 收到完整且校验通过的帧时写入
+ * @return true 得到一帧应答
+ * @return false 尚未收齐或该帧被丢弃
+ */
+bool laser_mb_decoder_feed(laser_mb_decoder_t *decoder, uint8_t byte, laser_mb_reply_t *reply);
+
+/**
+ * @brief 把应答打包成32位通知值: 功能码(含异常位)在高8位, 异常码在次高8位, 低16位为写应答的寄存器
+ *
+ * 串口回调只把这个值交给查询任务(任务通知值, 覆盖写入), 两边不共享应答结构体。
+ * 功能码不为0, 通知值也不为0。
+ *
+ * @param reply 应答
+ * @return uint32_t 通知值
+ */
+uint32_t laser_mb_reply_ack(const laser_mb_reply_t *reply);
+
+/**
+ * @brief 查询任务的平台相关操作
+ *
+ * 板上是传感器串口写入和任务通知(xTaskNotifyWait), 主机测试中是伪终端和条件变量。
+ */
+typedef struct
+{
+    void (*send)(const uint8_t *frame, uint8_t len);  /**< 发送请求帧 */
+    void (*clear)(void);                               /**< 丢弃发送前已到达的应答通知 */
+    bool (*wait)(uint32_t timeout_ms, uint32_t *ack); /**< 等待串口回调交来的通知值, 超时返回false */
+} laser_mb_port_t;
+
+/**
+ * @brief 写一个配置寄存器并等待回显确认, 超时重试LASER_MB_WRITE_RETRY次
+ *
+ * @param port 平台相关操作
+ * @param reg 寄存器
+ * @param value 写入值
+ * @return true 收到该寄存器的正常写应答
+ * @return false 重试后仍未确认
+ */
+bool laser_mb_write_reg(const laser_mb_port_t *port, uint16_t reg, uint16_t value);
+
+/**
+ * @brief 发送一次读请求并等待应答(应答中的距离由串口回调发布)
+ *
+ * @param port 平台相关操作
+ * @param request 读请求帧
+ * @param len 帧长度
+ * @param timeout_ms 等待时间, 一般为查询周期
+ * @return true 收到应答
+ * @return false 超时
+ */
+bool laser_mb_poll(const laser_mb_port_t *port, const uint8_t *request, uint8_t len, uint32_t timeout_ms);
+
+#endif // LASER_MODBUS_H
@@ -0,0 +1,50 @@
+#ifndef LASER_PARSER_H
+#define LASER_PARSER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief 激光传感器ASCII输出的增量解析器
+ *
+ * 逐字节解析"d: XX mm"格式, 数字结束即输出距离, 无需等待整行或整段数据。
+ * 仅包含数字(可带"mm"后缀)的行作为备用格式解析。
+ * 不依赖Arduino, 可直接在主机上编译。
+ */
+
+/** 距离上限(mm), 超出视为无效数据 */
+#define LASER_PARSER_MAX_DISTANCE 10000
+
+/**
+ * @brief 解析器状态
+ */
+typedef struct
+{
+    uint8_t state;        /**< 内部状态 */
+    uint32_t value;       /**< 正在累加的数值 */
+    uint8_t digits;       /**< 当前数值的位数 */
+    bool line_plain;      /**< 当前行是否只包含数字/空格/mm */
+    bool line_has_value;  /**< 当前行是否已输出过距离 */
+    uint32_t samples;     /**< 成功解析的距离个数 */
+    uint32_t errors;      /**< 超出范围或格式错误的个数 */
+} laser_parser_t;
+
+/**
+ * @brief 复位解析器
+ *
+ * @param parser 解析器
+ */
+void laser_parser_reset(laser_parser_t *parser);
+
+/**
+ * @brief 喂入一个字节
+ *
+ * @param parser 解析器
+ * @param byte 串口收到的字节
+ * @param distance 解析出距离时写入(单位:mm)
+ * @return true 得到一个新的距离值
+ * @return false 尚未得到完整数据
+ */
+bool laser_parser_feed(laser_parser_t *parser, uint8_t byte, uint16_t *distance);
+
+#endif // LASER_PARSER_H
@@ -2,6 +2,7 @@
 #define LASER_SENSOR_H
 
 #include <Arduino.h>
+#include "laser_filter.h"
 
 /**
  * @brief 激光传感器错误码定义
@@ -12,20 +13,105 @@
 #define LASER_SENSOR_EINVAL 3   /**< 无效参数 */
 #define LASER_SENSOR_ERANGE 4   /**< 数据超出范围 */
 
+/**
+ * @brief 最新距离超过此时间(ms)未更新视为超时
+ */
+#define LASER_SENSOR_MAX_AGE_MS 300
+
+/**
+ * @brief 激光传感器接口模式
+ */
+#define LASER_SENSOR_MODE_ASCII 0  /**< 传感器主动输出"d: XX mm"文本(默认) */
+#define LASER_SENSOR_MODE_MODBUS 1 /**< Modbus RTU查询, 高速测量, 定长帧+CRC校验 */
+
+/**
+ * @brief Modbus模式下的查询周期(ms)
+ */
+#define LASER_SENSOR_MODBUS_POLL_MS 10
+
+/**
+ * @brief 切换模式时是否写传感器的配置寄存器(工作模式、测量模式、输出频率)
+ * laser_modbus.h中的寄存器地址尚未对照ATK-MS53L2M用户手册核实, 默认不写入:
+ * 传感器需先用厂家上位机设为Modbus接口, 驱动只查询距离寄存器。
+ * 核实地址后在platformio.ini中加入 build_flags = -DLASER_SENSOR_MODBUS_CONFIG=1
+ */
+#ifndef LASER_SENSOR_MODBUS_CONFIG
+#define LASER_SENSOR_MODBUS_CONFIG 0
+#endif
+
+/**
+ * @brief 激光传感器距离样本
+ */
+typedef struct
+{
+    uint16_t distance;  /**< 距离(单位:mm) */
+    uint32_t timestamp; /**< 解析完成时的millis() */
+    uint32_t seq;       /**< 样本序号, 每个新样本加1, 0表示尚无数据 */
+} laser_sample_t;
+
 /**
  * @brief 初始化激光传感器
- * 设置串口和LED指示灯
+ * 设置串口和LED指示灯, 并注册串口接收回调, 之后在后台持续解析。
+ * 提示和错误只写到log, 本模块不使用Serial(任务程序中Serial连接底盘)
+ *
+ * @param log 打印提示的串口, NULL表示不打印
  */
-void laser_sensor_init(void);
+void laser_sensor_init(Stream *log);
 
 /**
- * @brief 读取激光传感器距离
+ * @brief 读取激光传感器距离(非阻塞)
+ * 返回后台解析得到的最新距离, 不再清空串口和等待数据
  *
  * @param distance 存储测量距离的指针(单位:mm)
- * @return uint8_t 错误码(0=成功，非0=错误类型)
+ * @return uint8_t 错误码(0=成功，LASER_SENSOR_ETIMEOUT=最新样本已过期)
  */
 uint8_t laser_sensor_read(uint16_t *distance);
 
+/**
+ * @brief 获取最新距离样本(非阻塞, O(1))
+ *
+ * @param sample 存储样本的指针
+ * @return true 已有样本
+ * @return false 尚未收到任何数据
+ */
+bool laser_sensor_get_latest(laser_sample_t *sample);
+
+/**
+ * @brief 获取滤波后的距离(非阻塞)
+ * 每个原始样本依次经过野值剔除、中值窗口和alpha-beta滤波, 输出带有效/新鲜标志
+ *
+ * @param filtered 存储滤波输出的指针
+ * @return true 输出有效且新鲜
+ * @return false 尚无数据或数据已过期, 不要使用distance
+ */
+bool laser_sensor_get_filtered(laser_filtered_t *filtered);
+
+/**
+ * @brief 修改滤波参数, 在下一个样本到达时重新初始化滤波器
+ *
+ * @param config 滤波参数
+ * @return uint8_t 错误码(0=成功，LASER_SENSOR_EINVAL=参数无效)
+ */
+uint8_t laser_sensor_set_filter(const laser_filter_config_t *config);
+
+/**
+ * @brief 切换传感器接口模式
+ * 切换到Modbus模式时启动后台查询任务, 切回ASCII模式时任务在下一个周期退出;
+ * LASER_SENSOR_MODBUS_CONFIG为1时同时配置传感器为高速测量、最高输出频率, 切回时恢复主动输出。
+ * 可在任务退出之前再次切换, get_mode始终返回最后一次设置的模式。两种模式下读取接口不变。
+ *
+ * @param mode LASER_SENSOR_MODE_ASCII 或 LASER_SENSOR_MODE_MODBUS
+ * @return uint8_t 错误码(0=成功，LASER_SENSOR_EINVAL=模式无效，LASER_SENSOR_ERROR=任务创建失败)
+ */
+uint8_t laser_sensor_set_mode(uint8_t mode);
+
+/**
+ * @brief 获取当前接口模式
+ *
+ * @return uint8_t LASER_SENSOR_MODE_ASCII 或 LASER_SENSOR_MODE_MODBUS
+ */
+uint8_t laser_sensor_get_mode(void);
+
 /**
  * @brief 设置激光传感器LED指示灯状态
  *
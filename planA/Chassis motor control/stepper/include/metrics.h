@@ -0,0 +1,204 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief 运行指标登记表
+ *
+ * 各模块把计数器、瞬时值和固定分桶直方图定义为静态变量, 在初始化时登记名称,
+ * 运行中用原子操作更新(不加锁, 可在串口回调、任务和中断中调用)。
+ * 快照可编码为紧凑的二进制帧(串口输出)或JSON(网页接口)。
+ * 不依赖Arduino, 可直接在主机上编译。
+ *
+ * 二进制帧: A5 5A | 类型(1) | 负载长度(2) | 负载 | CRC16(2)
+ * 多字节字段均为小端, CRC16(CCITT, 初值0xFFFF)覆盖类型、长度和负载。
+ *   结构帧负载: 版本(1) 指标数(1) 每项{类型(1) 分界数(1) 分界(4*n) 名称长度(1) 名称}
+ *   数值帧负载: 版本(1) 结构校验(2) 时间ms(4) 指标数(1) 每项按登记顺序:
+ *               计数器/瞬时值 4字节; 直方图 总数(4) 总和(4) 各桶(4*(n+1))
+ * 结构校验是结构帧负载的CRC16, 主机据此判断手中的结构帧是否与数值帧对应。
+ */
+
+/**
+ * @brief 指标错误码定义
+ */
+#define METRICS_EOK 0    /**< 操作成功 */
+#define METRICS_EINVAL 1 /**< 无效参数 */
+#define METRICS_EFULL 2  /**< 登记表已满 */
+#define METRICS_EEXIST 3 /**< 该指标已登记 */
+#define METRICS_ERROR 4  /**< 操作失败 */
+
+/**
+ * @brief 登记表容量与直方图分界上限
+ */
+#define METRICS_MAX 32
+#define METRICS_HIST_BOUNDS_MAX 8 /**< 分界个数上限, 桶数=分界数+1(最后一桶为溢出) */
+#define METRICS_NAME_MAX 31       /**< 名称最大长度 */
+
+/**
+ * @brief 指标类型
+ */
+#define METRICS_TYPE_COUNTER 0   /**< 单调递增计数 */
+#define METRICS_TYPE_GAUGE 1     /**< 瞬时值 */
+#define METRICS_TYPE_HISTOGRAM 2 /**< 固定分桶直方图 */
+
+/**
+ * @brief 二进制帧
+ */
+#define METRICS_FRAME_SYNC0 0xA5
+#define METRICS_FRAME_SYNC1 0x5A
+#define METRICS_FRAME_SCHEMA 1 /**< 结构帧: 名称、类型和分界 */
+#define METRICS_FRAME_VALUES 2 /**< 数值帧 */
+#define METRICS_FRAME_VERSION 1
+#define METRICS_FRAME_OVERHEAD 7 /**< 同步2+类型1+长度2+CRC2 */
+
+/**
+ * @brief 计数器
+ */
+typedef struct
+{
+    volatile uint32_t value;
+} metrics_counter_t;
+
+/**
+ * @brief 瞬时值
+ */
+typedef struct
+{
+    volatile int32_t value;
+} metrics_gauge_t;
+
+/**
+ * @brief 直方图, 值v落入第一个满足v<=bounds[i]的桶, 都不满足时落入溢出桶
+ * 只允许一个任务(或一个回调)记录, 各字段用普通的32位读写更新, 不需要原子加;
+ * 读取方可以随时快照, 快照与正在进行的一次记录之间可能相差1
+ */
+typedef struct
+{
+    const uint32_t *bounds;                                 /**< 递增的分界, 登记时指定 */
+    uint8_t bound_num;                                      /**< 分界个数 */
+    volatile uint32_t buckets[METRICS_HIST_BOUNDS_MAX + 1]; /**< 各桶计数 */
+    volatile uint32_t count;                                /**< 记录总数 */
+    volatile uint32_t sum;                                  /**< 记录值总和(溢出回绕) */
+} metrics_histogram_t;
+
+/**
+ * @brief 登记计数器, 在模块初始化时调用; 重复登记同一个指标返回METRICS_EEXIST
+ *
+ * @param counter 静态分配的计数器
+ * @param name 名称(静态字符串, 如"laser.parse_errors")
+ * @return uint8_t 错误码(0=成功，METRICS_EFULL=登记表已满)
+ */
+uint8_t metrics_register_counter(metrics_counter_t *counter, const char *name);
+
+/**
+ * @brief 登记瞬时值
+ *
+ * @param gauge 静态分配的瞬时值
+ * @param name 名称(静态字符串)
+ * @return uint8_t 错误码
+ */
+uint8_t metrics_register_gauge(metrics_gauge_t *gauge, const char *name);
+
+/**
+ * @brief 登记直方图
+ *
+ * @param hist 静态分配的直方图
+ * @param name 名称(静态字符串)
+ * @param bounds 递增的分界数组(静态), 单位由名称后缀表示
+ * @param bound_num 分界个数(1~METRICS_HIST_BOUNDS_MAX)
+ * @return uint8_t 错误码
+ */
+uint8_t metrics_register_histogram(metrics_histogram_t *hist, const char *name,
+                                   const uint32_t *bounds, uint8_t bound_num);
+
+/**
+ * @brief 计数器加n
+ *
+ * @param counter 计数器
+ * @param n 增量
+ */
+static inline void metrics_counter_add(metrics_counter_t *counter, uint32_t n)
+{
+    __atomic_fetch_add(&counter->value, n, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 计数器加1
+ *
+ * @param counter 计数器
+ */
+static inline void metrics_counter_inc(metrics_counter_t *counter)
+{
+    __atomic_fetch_add(&counter->value, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 设置瞬时值
+ *
+ * @param gauge 瞬时值
+ * @param value 新值
+ */
+static inline void metrics_gauge_set(metrics_gauge_t *gauge, int32_t value)
+{
+    __atomic_store_n(&gauge->value, value, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 直方图记录一个值(未登记分界时只累计总数和总和), 只能由同一个任务调用
+ *
+ * @param hist 直方图
+ * @param value 记录值
+ */
+void metrics_histogram_observe(metrics_histogram_t *hist, uint32_t value);
+
+/**
+ * @brief 已登记的指标个数
+ *
+ * @return uint8_t 个数
+ */
+uint8_t metrics_count(void);
+
+/**
+ * @brief 编码结构帧(指标名称、类型和直方图分界), 登记完成后只需发送一次或定期重发
+ *
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小
+ * @return size_t 帧长度, 缓冲区不足返回0
+ */
+size_t metrics_encode_schema(uint8_t *buf, size_t size);
+
+/**
+ * @brief 编码数值帧(当前快照)
+ *
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小
+ * @param time_ms 快照时间(ms)
+ * @return size_t 帧长度, 缓冲区不足返回0
+ */
+size_t metrics_encode_values(uint8_t *buf, size_t size, uint32_t time_ms);
+
+/**
+ * @brief 把当前快照格式化为JSON, 供网页接口直接发送
+ * 格式: {"time_ms":t,"metrics":{"名称":值,...,"直方图":{"count":n,"sum":s,"bounds":[...],"buckets":[...]}}}
+ *
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小
+ * @param time_ms 快照时间(ms)
+ * @return size_t 字符串长度(不含结尾0), 缓冲区不足返回0
+ */
+size_t metrics_format_json(char *buf, size_t size, uint32_t time_ms);
+
+/**
+ * @brief 计算CRC16(CCITT, 初值0xFFFF), 与帧校验一致
+ *
+ * @param data 数据
+ * @param len 长度
+ * @param crc 初值, 分段计算时传入上一段结果
+ * @return uint16_t CRC
+ */
+uint16_t metrics_crc16(const uint8_t *data, size_t len, uint16_t crc);
+
+#endif // METRICS_H
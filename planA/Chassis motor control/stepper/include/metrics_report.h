@@ -0,0 +1,39 @@
+#ifndef METRICS_REPORT_H
+#define METRICS_REPORT_H
+
+#include <Arduino.h>
+#include "metrics.h"
+
+/**
+ * @brief 输出格式
+ */
+#define METRICS_REPORT_BINARY 0 /**< 二进制帧(结构帧+数值帧), 用tools/metrics_decode.py解码 */
+#define METRICS_REPORT_JSON 1   /**< 每个快照一行JSON, 可直接在串口监视器中查看 */
+
+/**
+ * @brief 二进制输出时每隔多少个数值帧重发一次结构帧, 主机中途接入也能解码
+ */
+#define METRICS_REPORT_SCHEMA_EVERY 10
+
+/**
+ * @brief metrics_report_stop等待任务退出的最长时间(ms): 任务被通知唤醒, 只需等当前一次写出完成
+ */
+#define METRICS_REPORT_STOP_TIMEOUT_MS 500
+
+/**
+ * @brief 启动指标上报任务, 按固定周期把快照写到指定串口, 启动提示和错误也写到该串口
+ * 注意: 运行任务程序时Serial连接底盘, 上报应使用单独的串口
+ *
+ * @param port 输出串口
+ * @param period_ms 上报周期(ms)
+ * @param format METRICS_REPORT_BINARY/JSON
+ * @return uint8_t 错误码(0=成功，METRICS_EINVAL=参数无效或任务已在运行，METRICS_ERROR=任务创建失败)
+ */
+uint8_t metrics_report_start(Stream *port, uint32_t period_ms, uint8_t format);
+
+/**
+ * @brief 停止指标上报任务, 唤醒任务并等它退出后返回, 之后可用新的参数重新启动
+ */
+void metrics_report_stop(void);
+
+#endif // METRICS_REPORT_H
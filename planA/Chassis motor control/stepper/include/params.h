@@ -0,0 +1,165 @@
+#ifndef PARAMS_H
+#define PARAMS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief 可在线调整的参数登记表
+ *
+ * 各模块把速度、加速度、目标位置、角度等常量定义为全局变量, 初始化时登记名称和范围,
+ * 登记时的值即默认值。运行中直接读取变量本身(不查表, 不加锁: 32位对齐变量的读写是原子的),
+ * 修改通过名称查表、检查范围后写入变量, 下一次读取即生效。
+ * 参数以文本交换, 每行"名称 = 值", #后为注释(与sim场景文件相同), 保存时只写与默认值不同的项。
+ * 文本可保存在NVS(params_store.h)或主机上的文件(params_load_file/params_save_file)。
+ * 不依赖Arduino, 可直接在主机上编译。
+ */
+
+/**
+ * @brief 参数错误码定义
+ */
+#define PARAMS_EOK 0       /**< 操作成功 */
+#define PARAMS_EINVAL 1    /**< 无效参数或格式错误 */
+#define PARAMS_EFULL 2     /**< 登记表已满 */
+#define PARAMS_EEXIST 3    /**< 该参数已登记 */
+#define PARAMS_ENOTFOUND 4 /**< 没有该名称的参数 */
+#define PARAMS_ERANGE 5    /**< 值超出登记的范围 */
+#define PARAMS_ERROR 6     /**< 操作失败(如文件读写错误) */
+
+/**
+ * @brief 容量
+ */
+#define PARAMS_MAX 64      /**< 最多登记的参数数 */
+#define PARAMS_NAME_MAX 31 /**< 名称最大长度 */
+
+/**
+ * @brief 参数类型
+ */
+#define PARAMS_TYPE_INT 0   /**< int32_t */
+#define PARAMS_TYPE_FLOAT 1 /**< float */
+
+/**
+ * @brief params_format_text输出的内容
+ */
+#define PARAMS_TEXT_CHANGED 0 /**< 只输出与默认值不同的参数, 用于保存 */
+#define PARAMS_TEXT_ALL 1     /**< 输出全部参数 */
+#define PARAMS_TEXT_DETAIL 2  /**< 输出全部参数, 每行附注释: 范围和默认值 */
+
+/**
+ * @brief 登记一个整数参数, 在模块初始化时调用; 名称或地址已登记时返回PARAMS_EEXIST且不改变当前值
+ *
+ * @param name 名称(静态字符串, 如"move.hook1_up.speed")
+ * @param ptr 变量地址, 变量当前值记为默认值
+ * @param min 最小值
+ * @param max 最大值
+ * @return uint8_t 错误码(0=成功，PARAMS_ERANGE=当前值不在范围内，PARAMS_EFULL=登记表已满)
+ */
+uint8_t params_register_int(const char *name, volatile int32_t *ptr, int32_t min, int32_t max);
+
+/**
+ * @brief 登记一个浮点参数
+ *
+ * @param name 名称(静态字符串)
+ * @param ptr 变量地址, 变量当前值记为默认值
+ * @param min 最小值
+ * @param max 最大值
+ * @return uint8_t 错误码
+ */
+uint8_t params_register_float(const char *name, volatile float *ptr, float min, float max);
+
+/**
+ * @brief 已登记的参数数
+ *
+ * @return uint8_t 个数
+ */
+uint8_t params_count(void);
+
+/**
+ * @brief 当前值与默认值不同的参数数
+ *
+ * @return uint8_t 个数
+ */
+uint8_t params_changed_count(void);
+
+/**
+ * @brief 按名称设置参数
+ *
+ * @param name 名称
+ * @param value 值的文本(整数参数不接受小数)
+ * @return uint8_t 错误码(PARAMS_ENOTFOUND=没有该参数，PARAMS_EINVAL=值格式错误，PARAMS_ERANGE=超出范围)
+ */
+uint8_t params_set(const char *name, const char *value);
+
+/**
+ * @brief 按名称读取参数, 格式化为文本
+ *
+ * @param name 名称
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小
+ * @return uint8_t 错误码
+ */
+uint8_t params_get(const char *name, char *buf, size_t size);
+
+/**
+ * @brief 恢复默认值
+ *
+ * @param name 名称, NULL表示全部参数
+ * @return uint8_t 错误码
+ */
+uint8_t params_reset(const char *name);
+
+/**
+ * @brief 把参数格式化为"名称 = 值"文本, 每个参数一行
+ *
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小
+ * @param mode PARAMS_TEXT_CHANGED/ALL/DETAIL
+ * @return size_t 字符串长度(不含结尾0), 缓冲区不足返回0
+ */
+size_t params_format_text(char *buf, size_t size, uint8_t mode);
+
+/**
+ * @brief 解析"名称 = 值"文本并逐行设置参数, 出错的行跳过, 其余行照常生效
+ *
+ * @param text 文本(以0结尾)
+ * @param err 输出第一个错误的说明(含行号), 可为NULL
+ * @param err_size err缓冲区大小
+ * @return uint8_t 第一个错误的错误码, 全部成功返回PARAMS_EOK
+ */
+uint8_t params_parse_text(const char *text, char *err, size_t err_size);
+
+/**
+ * @brief 执行一行命令, 串口和网页接口共用
+ *   list               列出全部参数(范围和默认值写在注释中)
+ *   get 名称           读取一个参数
+ *   set 名称 值        设置一个参数, 也可写成"名称 = 值"
+ *   reset [名称]       恢复一个或全部参数的默认值
+ * #后为注释, 空行和只有注释的行不做任何事(回复为空), 参数文件可以逐行发送
+ *
+ * @param line 命令(以0结尾, 可带结尾换行)
+ * @param reply 输出回复文本
+ * @param size 回复缓冲区大小
+ * @return uint8_t 错误码, 出错时回复以"error: "开头
+ */
+uint8_t params_command(const char *line, char *reply, size_t size);
+
+/**
+ * @brief 从文件读取参数(主机上的键值文件, 也可用于固件的SPIFFS等文件系统)
+ *
+ * @param path 文件路径
+ * @param err 输出第一个错误的说明, 可为NULL
+ * @param err_size err缓冲区大小
+ * @return uint8_t 错误码(PARAMS_ERROR=无法打开文件)
+ */
+uint8_t params_load_file(const char *path, char *err, size_t err_size);
+
+/**
+ * @brief 把与默认值不同的参数保存到文件
+ *
+ * @param path 文件路径
+ * @return uint8_t 错误码
+ */
+uint8_t params_save_file(const char *path);
+
+#endif // PARAMS_H
@@ -0,0 +1,60 @@
+#ifndef PARAMS_STORE_H
+#define PARAMS_STORE_H
+
+#include <Arduino.h>
+#include "params.h"
+
+/**
+ * @brief 参数的NVS保存和串口命令
+ *
+ * 与默认值不同的参数以params_format_text的文本形式保存在NVS命名空间"params"的一个
+ * 数据块中(参数名长于NVS键名的15字符上限, 因此不按参数分键保存)。
+ * 上电时在登记完全部参数之后调用params_store_load(), 之前保存的修改即生效;
+ * NVS中有而程序中已不存在的参数跳过并打印提示。
+ * 提示和命令回复只写到调用方传入的串口, 本模块不使用Serial(任务程序中Serial连接底盘)。
+ */
+
+/**
+ * @brief NVS中保存的文本最大长度
+ */
+#define PARAMS_STORE_TEXT_MAX 2048
+
+/**
+ * @brief 串口命令一行的最大长度
+ */
+#define PARAMS_STORE_LINE_MAX 128
+
+/**
+ * @brief 从NVS读取保存的参数, 在全部参数登记之后调用; 读取失败时不改变参数
+ *
+ * @param log 打印提示的串口, NULL表示不打印
+ * @return uint8_t 错误码(0=成功或没有保存过，PARAMS_ERROR=NVS读取失败，其他=文本中第一个错误)
+ */
+uint8_t params_store_load(Stream *log);
+
+/**
+ * @brief 把与默认值不同的参数保存到NVS, 全部为默认值时清除保存的数据
+ *
+ * @return uint8_t 错误码(0=成功，PARAMS_EFULL=文本超过PARAMS_STORE_TEXT_MAX，PARAMS_ERROR=NVS写入失败)
+ */
+uint8_t params_store_save(void);
+
+/**
+ * @brief 读取串口上的命令并回复, 不阻塞; 每收到一行执行一次
+ * 除params_command的list/get/set/reset外, 还支持save(保存到NVS)和load(从NVS重新读取,
+ * 读取成功后才丢弃未保存的修改, 失败时参数不变)
+ *
+ * @param port 命令所在的串口
+ */
+void params_store_poll(Stream *port);
+
+/**
+ * @brief 启动一个低优先级任务, 每20ms调用一次params_store_poll
+ * 注意: 运行任务程序时Serial连接底盘, 命令应使用单独的串口(task.h中为Serial1)
+ *
+ * @param port 命令所在的串口, 启动提示也写到这里
+ * @return uint8_t 错误码(0=成功，PARAMS_EINVAL=参数无效，PARAMS_ERROR=任务创建失败)
+ */
+uint8_t params_store_start(Stream *port);
+
+#endif // PARAMS_STORE_H
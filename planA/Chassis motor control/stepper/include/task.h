@@ -1,6 +1,12 @@
 // #include<sensor.h>
 #include<stepper.h>
 #include<servo.h>
+#include<distance_event.h>
+#include<laser_sensor.h>
+#include<metrics_report.h>
+#include<params.h>
+#include<params_store.h>
+#include<telemetry.h>
 void task_0(void *pvParameters);
 void task_1(void *pvParameters);
 void task_101(void *pvParameters);
@@ -21,18 +27,155 @@ int a = 0;
 int e = 0;
 int amount = 0;
 
+// 物体到位阈值(原chaosheng: <=4cm为0), 10mm回差防止在边界来回触发
+#define MISSION_NEAR_MM 40
+#define MISSION_FAR_MM 50
+uint8_t mission_threshold = 0;
+
+// 参数命令串口(params_store.h): Serial接底盘、Serial2接激光, 参数命令、回复和各模块的提示走Serial1,
+// 接USB转串口模块(模块TX接GPIO25, RX接GPIO26)
+#define MISSION_PARAMS_RX_PIN 25
+#define MISSION_PARAMS_TX_PIN 26
+#define MISSION_PARAMS_BAUD 115200
+
+// 运行指标(metrics_report.h)按此周期以JSON行写到Serial1, 与参数命令的回复共用该串口, 为0时不上报
+#define MISSION_METRICS_PERIOD_MS 5000
+
+// 可在线调整的动作参数(params.h), 初始值即默认值, 登记名称见mission_params_register()
+// 升降/平移一次移动: controlStepper的速度(步/s)、加速度(步/s^2)和目标位置(步)
+typedef struct
+{
+    volatile int32_t speed;
+    volatile int32_t accel;
+    volatile int32_t target;
+} mission_move_t;
+
+// 底盘一条移动命令"命令ID,脉冲数,速度"中的脉冲数和速度, 命令ID(方向)不可调
+typedef struct
+{
+    volatile int32_t pulses;
+    volatile int32_t speed;
+} mission_chassis_t;
+
+mission_move_t move_hook1_up = {950, 1800, 3700};       // task_1 勾1.0后升
+mission_move_t move_place1_down = {2000, 1000, 2000};   // task_first 放1.0
+mission_move_t move_place1_home = {1000, 1000, 0};      // task_first 回零
+mission_move_t move_store_up = {950, 2000, 2900};       // task_101 存储2.0 升
+mission_move_t move_store_slide = {2000, 2000, -2600};  // task_102 平移
+mission_move_t move_store_down = {2000, 2000, 0};       // task_103 降
+mission_move_t move_store_home = {2000, 2000, 0};       // task_104 平移回零
+mission_move_t move_store_lift = {1800, 1800, 2000};    // task_second
+mission_move_t move_hook3_up = {950, 2000, 6000};       // task_third 勾3.0后升
+mission_move_t move_place2_down = {2000, 1000, 4700};   // task_fourth 放2.0
+
+mission_chassis_t chassis_place1_back = {8000, 8};   // task_first 后退
+mission_chassis_t chassis_place1_right = {9200, 15}; // task_first 右
+mission_chassis_t chassis_avoid_left = {4600, 15};   // task_301 左
+mission_chassis_t chassis_avoid_right = {4600, 15};  // task_302 右
+
+volatile int32_t servo_hook_deg = 65;     // 勾住
+volatile int32_t servo_release_deg = 105; // 松开
+
+volatile int32_t wait_place1_servo_ms = 500;  // task_first 松开后到后退
+volatile int32_t wait_place1_back_ms = 2300;  // task_first 后退时间
+volatile int32_t wait_place1_right_ms = 4500; // task_first 右移时间
+volatile int32_t wait_store_slide_ms = 6000;  // task_102 开始平移前
+volatile int32_t wait_place2_servo_ms = 500;  // task_fourth 降到位后到松开
+
+#define MISSION_MOVE_REGISTER(move, prefix)                                    \
+    do                                                                         \
+    {                                                                          \
+        params_register_int(prefix ".speed", &(move).speed, 1, 10000);         \
+        params_register_int(prefix ".accel", &(move).accel, 1, 20000);         \
+        params_register_int(prefix ".target", &(move).target, -20000, 20000);  \
+    } while (0)
+
+#define MISSION_CHASSIS_REGISTER(cmd, prefix)                                  \
+    do                                                                         \
+    {                                                                          \
+        params_register_int(prefix ".pulses", &(cmd).pulses, 0, 100000);       \
+        params_register_int(prefix ".speed", &(cmd).speed, 1, 100);            \
+    } while (0)
+
+// 登记全部动作参数, 重复调用时保留当前值
+void mission_params_register(void)
+{
+    MISSION_MOVE_REGISTER(move_hook1_up, "move.hook1_up");
+    MISSION_MOVE_REGISTER(move_place1_down, "move.place1_down");
+    MISSION_MOVE_REGISTER(move_place1_home, "move.place1_home");
+    MISSION_MOVE_REGISTER(move_store_up, "move.store_up");
+    MISSION_MOVE_REGISTER(move_store_slide, "move.store_slide");
+    MISSION_MOVE_REGISTER(move_store_down, "move.store_down");
+    MISSION_MOVE_REGISTER(move_store_home, "move.store_home");
+    MISSION_MOVE_REGISTER(move_store_lift, "move.store_lift");
+    MISSION_MOVE_REGISTER(move_hook3_up, "move.hook3_up");
+    MISSION_MOVE_REGISTER(move_place2_down, "move.place2_down");
+    MISSION_CHASSIS_REGISTER(chassis_place1_back, "chassis.place1_back");
+    MISSION_CHASSIS_REGISTER(chassis_place1_right, "chassis.place1_right");
+    MISSION_CHASSIS_REGISTER(chassis_avoid_left, "chassis.avoid_left");
+    MISSION_CHASSIS_REGISTER(chassis_avoid_right, "chassis.avoid_right");
+    params_register_int("servo.hook_deg", &servo_hook_deg, 0, 180);
+    params_register_int("servo.release_deg", &servo_release_deg, 0, 180);
+    params_register_int("wait.place1_servo_ms", &wait_place1_servo_ms, 0, 60000);
+    params_register_int("wait.place1_back_ms", &wait_place1_back_ms, 0, 60000);
+    params_register_int("wait.place1_right_ms", &wait_place1_right_ms, 0, 60000);
+    params_register_int("wait.store_slide_ms", &wait_store_slide_ms, 0, 60000);
+    params_register_int("wait.place2_servo_ms", &wait_place2_servo_ms, 0, 60000);
+}
+
+// 遥测(telemetry.h): 升降stepper1和平移stepper2的位置(步)和速度(0.1步/秒)
+// AccelStepper的位置和速度在对象内部, 用读取函数, 速度由读取函数乘10
+int32_t mission_lift_position(void) { return stepper1.currentPosition(); }
+int32_t mission_lift_speed(void) { return (int32_t)lroundf(stepper1.speed() * 10); }
+int32_t mission_slide_position(void) { return stepper2.currentPosition(); }
+int32_t mission_slide_speed(void) { return (int32_t)lroundf(stepper2.speed() * 10); }
+
+// 登记升降和平移的遥测变量, 重复调用时忽略
+void mission_telemetry_register(void)
+{
+    telemetry_register_reader("lift.position", mission_lift_position, 1);
+    telemetry_register_reader("lift.speed", mission_lift_speed, 10);
+    telemetry_register_reader("slide.position", mission_slide_position, 1);
+    telemetry_register_reader("slide.speed", mission_slide_speed, 10);
+}
+
+// 按参数移动, 每次调用时读取当前值, 修改后下一次移动生效
+void mission_move(AccelStepper &stepper, const mission_move_t *move)
+{
+    controlStepper(stepper, move->speed, move->accel, move->target);
+}
+
+// 发送底盘移动命令
+void mission_chassis(int cmd, const mission_chassis_t *chassis)
+{
+    Serial.printf("%d,%ld,%ld", cmd, (long)chassis->pulses, (long)chassis->speed);
+}
+
 void task_00(void *pvParameters){
-    servo1(105);
+    mission_params_register();
+    mission_telemetry_register(); // telemetry_start()之后升降和平移的数据一起发出
+    Serial1.begin(MISSION_PARAMS_BAUD, SERIAL_8N1, MISSION_PARAMS_RX_PIN, MISSION_PARAMS_TX_PIN);
+    params_store_load(&Serial1);  // 之前通过串口/网页保存的修改
+    params_store_start(&Serial1); // 运行中用串口命令调整参数
+    servo1(servo_release_deg);
+    distance_event_init(&Serial1);
+    distance_event_register(DISTANCE_SOURCE_LASER, MISSION_NEAR_MM, MISSION_FAR_MM, &mission_threshold);
+    laser_sensor_init(&Serial1); // 每个样本送入distance_event, task_0才会被唤醒
+#if MISSION_METRICS_PERIOD_MS > 0
+    metrics_report_start(&Serial1, MISSION_METRICS_PERIOD_MS, METRICS_REPORT_JSON); // 各模块的指标已登记
+#endif
     xTaskCreatePinnedToCore(task_0, "Task_0", 2000, NULL, 1, NULL, 0);
     vTaskDelete(NULL);
 }
 
 void task_0(void *pvParameters)
 {
+    uint8_t state;
     while (1)
     {
-        // chaosheng = measureDistanceAndSetState();
-        if (chaosheng == 1)
+        // 阻塞等待距离状态, 传感器每个样本到达时更新, 不再空转占用CPU
+        distance_event_wait(mission_threshold, portMAX_DELAY, &state);
+        if (state == DISTANCE_STATE_FAR)
         {
             // b = tracing();
             if (b = 3)
@@ -41,7 +184,7 @@ void task_0(void *pvParameters)
                 vTaskDelete(NULL);
             }
         }
-        else if (chaosheng == 0) // 假设当value达到10时任务1完成
+        else if (state == DISTANCE_STATE_NEAR) // 物体到位
         {
             switch (a)
             {
@@ -78,6 +221,8 @@ void task_0(void *pvParameters)
                 vTaskDelete(NULL);
                 break;
             default:
+                // 全部步骤完成, 结束任务(原来在这里空转)
+                vTaskDelete(NULL);
                 break;
             }
         }
@@ -110,9 +255,9 @@ void task_001(void *pvParameters)
 
 void task_1(void *pvParameters)
 {
-    servo1(65);
+    servo1(servo_hook_deg);
     delay(30);
-    controlStepper(stepper1, 950, 1800, 3700);
+    mission_move(stepper1, &move_hook1_up);
     xTaskCreatePinnedToCore(task_0, "Task_0", 2000, NULL, 1, NULL, 0);
     vTaskDelete(NULL);
 }
@@ -122,37 +267,37 @@ void task_first(void *pvParameters)
 {
     Serial.print("0,10,10");
     delay(30);
-    controlStepper(stepper1, 2000, 1000, 2000);
-    servo1(105);
-    delay(500);
-    Serial.print("5,8000,8"); // 后退
-    delay(2300);
-    Serial.print("8,9200,15"); // 右
-    delay(4500);
-    controlStepper(stepper1, 1000, 1000, 0);
+    mission_move(stepper1, &move_place1_down);
+    servo1(servo_release_deg);
+    delay(wait_place1_servo_ms);
+    mission_chassis(5, &chassis_place1_back); // 后退
+    delay(wait_place1_back_ms);
+    mission_chassis(8, &chassis_place1_right); // 右
+    delay(wait_place1_right_ms);
+    mission_move(stepper1, &move_place1_home);
     // xTaskCreatePinnedToCore(task_101, "Task1", 4000, NULL, 1, NULL, 0);
     // xTaskCreatePinnedToCore(task_102, "Task2", 4000, NULL, 1, NULL, 1);
     xTaskCreatePinnedToCore(task_0, "Task_0", 2000, NULL, 1, NULL, 0);
     vTaskDelete(NULL);
 }
 void task_101(void *pvParameters){
-    controlStepper(stepper1, 950, 2000, 2900); // up
+    mission_move(stepper1, &move_store_up); // up
     vTaskDelete(NULL);
 }
 void task_102(void *pvParameters)
 {
-    delay(6000);
-    controlStepper(stepper2, 2000, 2000, -2600);
+    delay(wait_store_slide_ms);
+    mission_move(stepper2, &move_store_slide);
     vTaskDelete(NULL);
 }
 void task_103(void *pvParameters)
 {
-    controlStepper(stepper1, 2000, 2000, 0); // down
+    mission_move(stepper1, &move_store_down); // down
     vTaskDelete(NULL);
 }
 void task_104(void *pvParameters)
 {
-    controlStepper(stepper2, 2000, 2000, 0);
+    mission_move(stepper2, &move_store_home);
     vTaskDelete(NULL);
 }
 
@@ -160,13 +305,13 @@ void task_second(void *pvParameters)
 {
     Serial.print("0,10,10");
     delay(30);
-    servo1(65);
+    servo1(servo_hook_deg);
     // controlStepper(stepper1, 950, 1800, 2900);//up
     // controlStepper(stepper2, 1800, 1800, -2600);
     xTaskCreatePinnedToCore(task_101, "Task1", 4000, NULL, 1, NULL, 0);
     xTaskCreatePinnedToCore(task_102, "Task2", 4000, NULL, 1, NULL, 1);
-    controlStepper(stepper1, 1800, 1800, 2000);
-    servo1(105);
+    mission_move(stepper1, &move_store_lift);
+    servo1(servo_release_deg);
     // controlStepper(stepper1, 1800, 1800, 0);//down
     // controlStepper(stepper2, 1800, 1800, 0);
     xTaskCreatePinnedToCore(task_103, "Task3", 4000, NULL, 1, NULL, 0);
@@ -178,27 +323,27 @@ void task_second(void *pvParameters)
 void task_third(void *pvParameters){
     Serial.print("0,10,10");
     delay(30);
-    servo1(105);
-    controlStepper(stepper1, 950, 2000, 6000); // up
+    servo1(servo_release_deg);
+    mission_move(stepper1, &move_hook3_up); // up
 }
 void task_301(void *pvParameters)
 {
-    Serial.print("7,4600,15");
+    mission_chassis(7, &chassis_avoid_left);
     xTaskCreatePinnedToCore(task_0, "Task_0", 2000, NULL, 1, NULL, 1);
     vTaskDelete(NULL);
 }
 void task_302(void *pvParameters)
 {
-    Serial.print("8,4600,15");
+    mission_chassis(8, &chassis_avoid_right);
     xTaskCreatePinnedToCore(task_0, "Task_0", 2000, NULL, 1, NULL, 1);
     vTaskDelete(NULL);
 }
 void task_fourth(void *pvParameters){
     Serial.print("0,10,10");
     delay(30);
-    controlStepper(stepper1, 2000, 1000, 4700); // down
-    delay(500);
-    servo1(105);
+    mission_move(stepper1, &move_place2_down); // down
+    delay(wait_place2_servo_ms);
+    servo1(servo_release_deg);
     xTaskCreatePinnedToCore(task_0, "Task_0", 2000, NULL, 1, NULL, 1);
     vTaskDelete(NULL);
 }
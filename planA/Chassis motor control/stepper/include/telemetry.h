@@ -0,0 +1,191 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief 高速遥测: 变量登记、采样和差分编码
+ *
+ * 各模块登记需要观察的变量(地址+类型, 或读取函数), 采样时全部读出并按登记的比例
+ * 换算为整数; 一批样本编码为一个数据包: 第一个样本为完整值, 之后每个样本只存
+ * 时间差和各变量与上一个样本的差值(zigzag变长整数), 变化缓慢的量每项只占1字节。
+ * 编码和解码都在这里, 固件和主机接收程序(tools/telemetry_recv.cpp)共用。
+ * 不依赖Arduino, 可直接在主机上编译。
+ *
+ * 包格式: A5 54 | 类型(1) | 负载长度(2) | 负载 | CRC16(2), 与metrics帧相同的小端和CRC16
+ *   结构包负载: 版本(1) 变量数(1) 采样率Hz(2) 每个变量{类型(1) 比例(float 4) 名称长度(1) 名称}
+ *   数据包负载: 版本(1) 结构校验(2) 包序号(2) 变量数(1) 样本数(1) 首样本时间us(4)
+ *               首样本各变量值(变长) 之后每个样本{时间差us(变长) 各变量差值(变长)}
+ * 结构校验是结构包负载的CRC16, 接收方据此确认数据包对应的变量表。
+ */
+
+/**
+ * @brief 遥测错误码定义
+ */
+#define TELEMETRY_EOK 0     /**< 操作成功 */
+#define TELEMETRY_EINVAL 1  /**< 无效参数 */
+#define TELEMETRY_EFULL 2   /**< 变量表已满 */
+#define TELEMETRY_EEXIST 3  /**< 该变量已登记 */
+#define TELEMETRY_ERROR 4   /**< 操作失败 */
+#define TELEMETRY_EFORMAT 5 /**< 包格式错误或与结构不符 */
+
+/**
+ * @brief 容量
+ */
+#define TELEMETRY_VARS_MAX 16     /**< 最多登记的变量数 */
+#define TELEMETRY_BATCH 32        /**< 每批样本数(双缓冲每半区的大小) */
+#define TELEMETRY_PACKET_MAX 1400 /**< 单个包的最大长度, 不超过一个UDP报文 */
+#define TELEMETRY_NAME_MAX 31     /**< 变量名最大长度 */
+
+/**
+ * @brief 变量类型
+ */
+#define TELEMETRY_TYPE_I32 0    /**< int32_t / long */
+#define TELEMETRY_TYPE_U32 1    /**< uint32_t / unsigned long(超过int32范围时回绕) */
+#define TELEMETRY_TYPE_I16 2    /**< int16_t */
+#define TELEMETRY_TYPE_U16 3    /**< uint16_t */
+#define TELEMETRY_TYPE_U8 4     /**< uint8_t */
+#define TELEMETRY_TYPE_FLOAT 5  /**< float, 乘以比例后四舍五入 */
+#define TELEMETRY_TYPE_READER 6 /**< 读取函数, 用于对象内部的量(如AccelStepper::currentPosition) */
+
+/**
+ * @brief 包
+ */
+#define TELEMETRY_SYNC0 0xA5
+#define TELEMETRY_SYNC1 0x54
+#define TELEMETRY_PACKET_SCHEMA 1 /**< 结构包 */
+#define TELEMETRY_PACKET_DATA 2   /**< 数据包 */
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_PACKET_OVERHEAD 7 /**< 同步2+类型1+长度2+CRC2 */
+
+/**
+ * @brief 读取函数
+ */
+typedef int32_t (*telemetry_reader_t)(void);
+
+/**
+ * @brief 一个样本, values按登记顺序存放换算后的整数
+ */
+typedef struct
+{
+    uint32_t time_us;
+    int32_t values[TELEMETRY_VARS_MAX];
+} telemetry_sample_t;
+
+/**
+ * @brief 解码用的变量表
+ */
+typedef struct
+{
+    uint16_t id;       /**< 结构校验 */
+    uint16_t rate_hz;  /**< 采样率 */
+    uint8_t count;     /**< 变量数 */
+    uint8_t types[TELEMETRY_VARS_MAX];
+    float scales[TELEMETRY_VARS_MAX];
+    char names[TELEMETRY_VARS_MAX][TELEMETRY_NAME_MAX + 1];
+} telemetry_schema_t;
+
+/**
+ * @brief 登记一个变量, 在模块初始化时调用; 同一地址重复登记返回TELEMETRY_EEXIST
+ * 采样时直接读取该地址, 不加锁: 32位及以下的对齐变量读取是原子的
+ *
+ * @param name 名称(静态字符串, 如"stepper0.position")
+ * @param type TELEMETRY_TYPE_xxx(READER除外)
+ * @param ptr 变量地址
+ * @param scale 换算比例, 采样值=变量值*scale取整(整数变量一般为1, 需要小数时如0.1mm精度取10)
+ * @return uint8_t 错误码(0=成功，TELEMETRY_EFULL=变量表已满)
+ */
+uint8_t telemetry_register(const char *name, uint8_t type, const volatile void *ptr, float scale);
+
+/**
+ * @brief 登记一个读取函数, 采样时调用(应很短, 不能阻塞)
+ * 读取函数自己按比例换算, 返回值*scale取整后的结果(如速度0.1精度返回speed*10, scale取10),
+ * 采样时不再乘比例
+ *
+ * @param name 名称(静态字符串)
+ * @param reader 读取函数
+ * @param scale 读取函数所用的比例, 只写入结构包, 解码时用结果除以它还原
+ * @return uint8_t 错误码
+ */
+uint8_t telemetry_register_reader(const char *name, telemetry_reader_t reader, float scale);
+
+/**
+ * @brief 已登记的变量数
+ *
+ * @return uint8_t 个数
+ */
+uint8_t telemetry_var_count(void);
+
+/**
+ * @brief 读取全部变量到一个样本
+ *
+ * @param sample 输出样本
+ * @param time_us 采样时间(us)
+ */
+void telemetry_sample(telemetry_sample_t *sample, uint32_t time_us);
+
+/**
+ * @brief 编码结构包
+ *
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小
+ * @param rate_hz 采样率
+ * @return size_t 包长度, 缓冲区不足返回0
+ */
+size_t telemetry_encode_schema(uint8_t *buf, size_t size, uint16_t rate_hz);
+
+/**
+ * @brief 把一批样本编码为数据包, 放不下时只编码前面的样本
+ *
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小
+ * @param rate_hz 采样率(用于结构校验, 与结构包一致)
+ * @param seq 包序号, 接收方据此统计丢包
+ * @param samples 样本
+ * @param n 样本数(1~255)
+ * @param encoded 输出实际编码的样本数
+ * @return size_t 包长度, 一个样本都放不下时返回0
+ */
+size_t telemetry_encode_batch(uint8_t *buf, size_t size, uint16_t rate_hz, uint16_t seq,
+                              const telemetry_sample_t *samples, uint8_t n, uint8_t *encoded);
+
+/**
+ * @brief 在字节流中查找一个完整且校验正确的包
+ *
+ * @param buf 数据
+ * @param len 数据长度
+ * @param type 输出包类型
+ * @param payload 输出负载起始位置
+ * @param payload_len 输出负载长度
+ * @return size_t 应从buf中丢弃的字节数(找到包时为包末尾); 0表示数据不足, 需要更多数据
+ */
+size_t telemetry_find_packet(const uint8_t *buf, size_t len, uint8_t *type,
+                             const uint8_t **payload, size_t *payload_len);
+
+/**
+ * @brief 解码结构包负载
+ *
+ * @param payload 负载
+ * @param len 负载长度
+ * @param schema 输出变量表
+ * @return uint8_t 错误码
+ */
+uint8_t telemetry_decode_schema(const uint8_t *payload, size_t len, telemetry_schema_t *schema);
+
+/**
+ * @brief 解码数据包负载
+ *
+ * @param payload 负载
+ * @param len 负载长度
+ * @param schema 变量表
+ * @param samples 输出样本(至少255个)
+ * @param n 输出样本数
+ * @param seq 输出包序号
+ * @return uint8_t 错误码(TELEMETRY_EFORMAT=格式错误或结构校验不符)
+ */
+uint8_t telemetry_decode_batch(const uint8_t *payload, size_t len, const telemetry_schema_t *schema,
+                               telemetry_sample_t *samples, uint8_t *n, uint16_t *seq);
+
+#endif // TELEMETRY_H
@@ -0,0 +1,40 @@
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+#include <Arduino.h>
+#include "telemetry.h"
+
+/**
+ * @brief 接收端口, 电脑连上ESP32的热点后用tools/telemetry_recv接收
+ */
+#define TELEMETRY_UDP_PORT 5005
+
+/**
+ * @brief 每隔多少个数据包重发一次结构包, 接收端中途启动也能解码
+ */
+#define TELEMETRY_SCHEMA_EVERY 20
+
+/**
+ * @brief telemetry_stop等待任务退出的最长时间(ms): 最长采样周期1s加发送任务的100ms通知等待
+ */
+#define TELEMETRY_STOP_TIMEOUT_MS 1200
+
+/**
+ * @brief 启动遥测: 采样任务按固定频率把全部变量写入双缓冲, 一半写满后由发送任务
+ * 差分编码并发出。热点(softAP)已开启时向热点网段广播UDP, 否则写到备用串口
+ * 注意: 串口带宽有限, 115200波特率下只适合几个变量、几十Hz, 高速采样请用UDP
+ *
+ * @param rate_hz 采样率(1~1000Hz, 按1ms节拍取整)
+ * @param fallback 没有热点时使用的串口, 为NULL时必须已开启热点
+ * @return uint8_t 错误码(0=成功，TELEMETRY_EINVAL=参数无效、没有可用的输出或上一次的任务还没有退出，
+ *                 TELEMETRY_ERROR=任务创建失败)
+ */
+uint8_t telemetry_start(uint16_t rate_hz, Stream *fallback);
+
+/**
+ * @brief 停止遥测, 等采样和发送任务退出(最多TELEMETRY_STOP_TIMEOUT_MS)后返回, 之后可以重新启动
+ * 不能在遥测任务中调用
+ */
+void telemetry_stop(void);
+
+#endif // TELEMETRY_STREAM_H
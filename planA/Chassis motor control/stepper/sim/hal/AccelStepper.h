@@ -0,0 +1,67 @@
+#ifndef SIM_ACCELSTEPPER_H
+#define SIM_ACCELSTEPPER_H
+
+/**
+ * 仿真用的AccelStepper: 速度曲线与AccelStepper 1.64相同(David Austin算法),
+ * run()在下一步到期前让出当前任务, 相当于理想的忙等循环。
+ */
+
+#include <stdint.h>
+
+class AccelStepper
+{
+public:
+    typedef enum
+    {
+        FUNCTION = 0,
+        DRIVER = 1,
+        FULL2WIRE = 2,
+        FULL3WIRE = 3,
+        FULL4WIRE = 4,
+        HALF3WIRE = 6,
+        HALF4WIRE = 8
+    } MotorInterfaceType;
+
+    AccelStepper(uint8_t interface = FULL4WIRE, uint8_t pin1 = 2, uint8_t pin2 = 3, uint8_t pin3 = 4,
+                 uint8_t pin4 = 5, bool enable = true);
+
+    void moveTo(long absolute);
+    void move(long relative);
+    bool run(void);
+    bool runSpeed(void);
+    void setMaxSpeed(float speed);
+    float maxSpeed(void) { return _maxSpeed; }
+    void setAcceleration(float acceleration);
+    void setSpeed(float speed);
+    float speed(void) { return _speed; }
+    long distanceToGo(void) { return _targetPos - _currentPos; }
+    long targetPosition(void) { return _targetPos; }
+    long currentPosition(void) { return _currentPos; }
+    void setCurrentPosition(long position);
+    void runToPosition(void);
+    void stop(void);
+    bool isRunning(void) { return !(_speed == 0.0f && _targetPos == _currentPos); }
+
+    uint8_t stepPin(void) { return _pin1; }
+    unsigned long steps(void) { return _steps; } /**< 累计步数(仿真统计) */
+
+private:
+    void computeNewSpeed(void);
+
+    uint8_t _pin1;
+    long _currentPos;
+    long _targetPos;
+    float _speed;
+    float _maxSpeed;
+    float _acceleration;
+    unsigned long _stepInterval;
+    unsigned long _lastStepTime;
+    long _n;
+    float _c0;
+    float _cn;
+    float _cmin;
+    bool _direction; // true = CW
+    unsigned long _steps;
+};
+
+#endif // SIM_ACCELSTEPPER_H
@@ -0,0 +1,97 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+/**
+ * 仿真用的Arduino接口: 时间取自仿真内核的虚拟时间, delay让出当前任务,
+ * 引脚和串口输出交给仿真世界(sim_world.cpp)解释。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::max;
+using std::min;
+
+#define SERIAL_8N1 0x800001c
+
+// 各模块打印提示的端口参数(params_store.h、distance_event.h等), 仿真中不输出
+class Stream
+{
+public:
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        (void)format;
+        return 0;
+    }
+    size_t println(const char *text = "")
+    {
+        (void)text;
+        return 0;
+    }
+};
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+
+/**
+ * 串口0: 板上接底盘驱动板, 每次print的内容作为一帧交给底盘模型
+ */
+class SimSerial
+{
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    size_t print(const char *text);
+    size_t print(int value) { return printf("%d", value); }
+    size_t print(long value) { return printf("%ld", value); }
+    size_t print(unsigned long value) { return printf("%lu", value); }
+    size_t print(double value) { return printf("%.2f", value); }
+    size_t println(const char *text = "") { return printf("%s\n", text); }
+    size_t println(int value) { return printf("%d\n", value); }
+    size_t println(long value) { return printf("%ld\n", value); }
+    size_t println(unsigned long value) { return printf("%lu\n", value); }
+    size_t println(double value) { return printf("%.2f\n", value); }
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern SimSerial Serial;
+
+/**
+ * 串口1: 板上是参数命令串口(task.h), 仿真中没有输入也不输出
+ */
+class SimUart : public Stream
+{
+public:
+    void begin(unsigned long baud, uint32_t config, int8_t rx_pin, int8_t tx_pin)
+    {
+        (void)baud;
+        (void)config;
+        (void)rx_pin;
+        (void)tx_pin;
+    }
+};
+
+extern SimUart Serial1;
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#endif // SIM_ARDUINO_H
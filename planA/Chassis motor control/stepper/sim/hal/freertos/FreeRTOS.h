@@ -0,0 +1,34 @@
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+/**
+ * 仿真用的FreeRTOS类型和宏, 节拍为1ms(与ESP32 Arduino一致)。
+ * 协程不会被抢占, 临界区为空操作。
+ */
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFu)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL 0
+#define pdPASS 1
+
+typedef struct
+{
+    int unused;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+
+#endif // SIM_FREERTOS_H
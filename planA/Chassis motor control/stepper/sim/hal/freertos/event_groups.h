@@ -0,0 +1,16 @@
+#ifndef SIM_FREERTOS_EVENT_GROUPS_H
+#define SIM_FREERTOS_EVENT_GROUPS_H
+
+#include "FreeRTOS.h"
+
+typedef uint32_t EventBits_t;
+typedef struct sim_event_group *EventGroupHandle_t;
+
+EventGroupHandle_t xEventGroupCreate(void);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks);
+
+#endif // SIM_FREERTOS_EVENT_GROUPS_H
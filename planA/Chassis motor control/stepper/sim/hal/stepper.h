@@ -0,0 +1,17 @@
+#ifndef SIM_STEPPER_H
+#define SIM_STEPPER_H
+
+/**
+ * 仿真用的升降/平移步进电机层, 替换include/stepper.h(后者只定义了stepper1,
+ * 并引用未定义的ENABLE_PIN_2, 不能单独编译)。controlStepper与固件相同: 设置速度和
+ * 加速度后移动到绝对位置, 忙等到位; 速度和加速度按仿真参数缩放。
+ */
+
+#include <AccelStepper.h>
+
+extern AccelStepper stepper1; /**< 升降, STEP 14 */
+extern AccelStepper stepper2; /**< 平移, STEP 16 */
+
+void controlStepper(AccelStepper &stepper, float speed, float acceleration, int steps);
+
+#endif // SIM_STEPPER_H
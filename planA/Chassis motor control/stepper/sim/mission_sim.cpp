@@ -0,0 +1,452 @@
+/**
+ * 整车任务仿真: 在主机上运行include/task.h中的任务流程, 传感器、底盘、升降/平移和
+ * 舵机由仿真模型代替(见sim_world.h), 时间是虚拟的, 相同参数每次结果相同。
+ *
+ * 编译(在stepper/sim目录):
+ *   g++ -O2 -std=c++11 -Ihal -I../include -o mission_sim mission_sim.cpp sim_core.cpp sim_hal.cpp \
+ *       sim_world.cpp ../src/distance_event.cpp ../src/distance_threshold.cpp ../src/laser_filter.cpp ../src/metrics.cpp \
+ *       ../src/params.cpp ../src/telemetry.cpp
+ *
+ * 用法:
+ *   ./mission_sim [场景文件] [--params 参数文件] [--set 键=值]... [--trace 记录.csv]
+ *   ./mission_sim [场景文件] [--params 参数文件] [--set 键=值]... --sweep 键=值1,值2,... [--sweep ...] [-j 进程数]
+ *
+ * 不带--sweep时运行一次并打印报告; 带--sweep时对所有取值组合各运行一次(每个组合
+ * 一个子进程, 默认按CPU核数并行), 按组合顺序输出CSV。
+ * --params读取task.h动作参数(params.h)的文件, 格式与固件串口list/save相同;
+ * --set和--sweep的键不在仿真参数表中时按动作参数设置, 如--sweep move.hook1_up.speed=950,1500,2000。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "params.h"
+#include "sim_core.h"
+#include "sim_world.h"
+
+// 与main.cpp相同, task.h依赖之前包含的Arduino.h
+#include <Arduino.h>
+
+// task.h中tracing()的结果, 固件里tracing()已注释掉, 由task_0中的"b = 3"赋值
+int b = 0;
+#include "task.h"
+
+#define MISSION_STEPS 6 // task_0中a的步骤数
+
+// 固件从NVS读取保存的参数并启动串口命令; 仿真中参数已在运行前由--params/--set设置
+uint8_t params_store_load(Stream *log)
+{
+    (void)log;
+    return PARAMS_EOK;
+}
+
+uint8_t params_store_start(Stream *port)
+{
+    (void)port;
+    return PARAMS_EOK;
+}
+
+// 固件启动激光串口和接收回调; 仿真中距离样本由sim_world.cpp送入distance_event
+void laser_sensor_init(Stream *log)
+{
+    (void)log;
+}
+
+// 固件按周期把运行指标写到Serial1; 仿真在结束时打印自己的报告
+uint8_t metrics_report_start(Stream *port, uint32_t period_ms, uint8_t format)
+{
+    (void)port;
+    (void)period_ms;
+    (void)format;
+    return METRICS_EOK;
+}
+
+static const char *const g_end_names[] = {"done", "stalled", "timeout"};
+
+// 所有任务都已结束但任务没有走完全部步骤时为"incomplete", 不报告为done
+static const char *end_name(const sim_result_t *r)
+{
+    if (r->end_reason == SIM_END_DONE && a < MISSION_STEPS)
+        return "incomplete";
+    return g_end_names[r->end_reason];
+}
+
+typedef struct
+{
+    std::string key;
+    std::vector<std::string> values;
+} sweep_t;
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: mission_sim [scenario.cfg] [--params file] [--set key=value]... [--trace trace.csv]\n"
+                    "       mission_sim [scenario.cfg] [--params file] [--set key=value]... --sweep key=v1,v2,... [-j N]\n");
+    exit(2);
+}
+
+// 设置一个仿真参数, 仿真参数表中没有的键按task.h的动作参数设置
+static bool config_set(sim_config_t *cfg, const std::string &line, std::string *err)
+{
+    size_t eq = line.find('=');
+    if (eq != std::string::npos)
+    {
+        std::string key = line.substr(0, eq);
+        key.erase(0, key.find_first_not_of(" \t"));
+        key.erase(key.find_last_not_of(" \t") + 1);
+        if (key != "box" && cfg->values.find(key) == cfg->values.end())
+        {
+            char msg[160];
+            if (params_parse_text(line.c_str(), msg, sizeof(msg)) == PARAMS_EOK)
+                return true;
+            *err = strchr(msg, ':') + 2; // 去掉"line 1: "
+            return false;
+        }
+    }
+    return sim_config_set(cfg, line, err);
+}
+
+static void name_tasks(void)
+{
+    sim_world_name_task(task_00, "task_00");
+    sim_world_name_task(task_0, "task_0");
+    sim_world_name_task(task_001, "task_001");
+    sim_world_name_task(task_1, "task_1");
+    sim_world_name_task(task_101, "task_101");
+    sim_world_name_task(task_102, "task_102");
+    sim_world_name_task(task_103, "task_103");
+    sim_world_name_task(task_104, "task_104");
+    sim_world_name_task(task_301, "task_301");
+    sim_world_name_task(task_302, "task_302");
+    sim_world_name_task(task_first, "task_first");
+    sim_world_name_task(task_second, "task_second");
+    sim_world_name_task(task_third, "task_third");
+    sim_world_name_task(task_fourth, "task_fourth");
+    sim_world_name_task(task_fifth, "task_fifth");
+}
+
+static void run(const sim_config_t *cfg, FILE *trace, sim_result_t *result)
+{
+    name_tasks();
+    sim_world_run(cfg, &a, task_00, trace, result);
+}
+
+static void print_report(const sim_config_t *cfg, const sim_result_t *r)
+{
+    printf("boxes: %zu, seed: %.0f\n", cfg->boxes.size(), cfg->values.at("sim.seed"));
+    printf("end: %s at %.3f s, mission step %d/%d\n\n", end_name(r), r->end_us / 1e6, a, MISSION_STEPS);
+
+    printf("step  %-12s %9s %9s %9s\n", "task", "start_s", "wait_s", "action_s");
+    for (size_t i = 0; i < r->steps.size(); i++)
+    {
+        const sim_step_t *s = &r->steps[i];
+        printf("%4zu  %-12s %9.3f %9.3f ", i + 1, s->task, s->start_us / 1e6, s->wait_us / 1e6);
+        if (s->finished)
+            printf("%9.3f\n", s->action_us / 1e6);
+        else
+            printf("%9s\n", "running");
+    }
+
+    printf("\n%-12s %9s %9s %9s\n", "task", "created", "total_s", "returned");
+    for (size_t i = 0; i < r->tasks.size(); i++)
+    {
+        const sim_task_stat_t *t = &r->tasks[i];
+        printf("%-12s %9u %9.3f %9u\n", t->name, t->count, t->total_us / 1e6, t->returned);
+    }
+
+    printf("\ntasks created: %u\n", r->task_creates);
+    printf("chassis commands: %u, other text on chassis UART: %u, collisions: %u\n", r->chassis_cmds, r->uart_text,
+           r->collisions);
+    printf("lift: %lu steps, %.3f s busy; slide: %lu steps, %.3f s busy\n", r->motor_steps[0],
+           r->motor_busy_us[0] / 1e6, r->motor_steps[1], r->motor_busy_us[1] / 1e6);
+    printf("servo moves: %u\n", r->servo_moves);
+    printf("laser: %u samples, %u outliers\n", r->laser_samples, r->laser_outliers);
+    if (params_changed_count() > 0)
+    {
+        static char text[4096];
+        params_format_text(text, sizeof(text), PARAMS_TEXT_CHANGED);
+        printf("\nmission params changed from default:\n%s", text);
+    }
+}
+
+static void print_csv_header(const std::vector<sweep_t> &sweeps)
+{
+    printf("variant");
+    for (size_t i = 0; i < sweeps.size(); i++)
+        printf(",%s", sweeps[i].key.c_str());
+    printf(",end,total_s,step");
+    for (int k = 1; k <= MISSION_STEPS; k++)
+        printf(",s%d_wait_s,s%d_action_s", k, k);
+    printf(",task_creates,chassis_cmds,collisions,uart_text\n");
+}
+
+static std::string csv_row(size_t index, const std::vector<std::string> &values, const sim_result_t *r)
+{
+    char buf[64];
+    std::string row;
+    snprintf(buf, sizeof(buf), "%zu", index);
+    row = buf;
+    for (size_t i = 0; i < values.size(); i++)
+        row += "," + values[i];
+    snprintf(buf, sizeof(buf), ",%s,%.3f,%d", end_name(r), r->end_us / 1e6, a);
+    row += buf;
+    for (size_t k = 0; k < MISSION_STEPS; k++)
+    {
+        if (k < r->steps.size())
+        {
+            const sim_step_t *s = &r->steps[k];
+            snprintf(buf, sizeof(buf), ",%.3f,", s->wait_us / 1e6);
+            row += buf;
+            if (s->finished)
+            {
+                snprintf(buf, sizeof(buf), "%.3f", s->action_us / 1e6);
+                row += buf;
+            }
+        }
+        else
+        {
+            row += ",,";
+        }
+    }
+    snprintf(buf, sizeof(buf), ",%u,%u,%u,%u\n", r->task_creates, r->chassis_cmds, r->collisions, r->uart_text);
+    return row + buf;
+}
+
+// 第index个取值组合(最后一个--sweep变化最快)
+static std::vector<std::string> variant_values(const std::vector<sweep_t> &sweeps, size_t index)
+{
+    std::vector<std::string> values(sweeps.size());
+    for (size_t i = sweeps.size(); i-- > 0;)
+    {
+        values[i] = sweeps[i].values[index % sweeps[i].values.size()];
+        index /= sweeps[i].values.size();
+    }
+    return values;
+}
+
+typedef struct
+{
+    size_t index;
+    int fd;
+} child_t;
+
+// 等待一个子进程结束并收集其输出
+static void reap(std::map<pid_t, child_t> *children, std::vector<std::string> *rows)
+{
+    int status;
+    pid_t pid = wait(&status);
+    std::map<pid_t, child_t>::iterator it = children->find(pid);
+    if (it == children->end())
+        return;
+
+    std::string out;
+    char buf[512];
+    ssize_t n;
+    while ((n = read(it->second.fd, buf, sizeof(buf))) > 0)
+        out.append(buf, n);
+    close(it->second.fd);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || out.empty())
+    {
+        snprintf(buf, sizeof(buf), "%zu,crashed\n", it->second.index);
+        out = buf;
+    }
+    (*rows)[it->second.index] = out;
+    children->erase(it);
+}
+
+static int run_sweep(const sim_config_t *base, const std::vector<sweep_t> &sweeps, int jobs)
+{
+    size_t total = 1;
+    for (size_t i = 0; i < sweeps.size(); i++)
+        total *= sweeps[i].values.size();
+
+    std::vector<std::string> rows(total);
+    std::map<pid_t, child_t> children;
+    print_csv_header(sweeps);
+    fflush(stdout);
+
+    for (size_t index = 0; index < total; index++)
+    {
+        while ((int)children.size() >= jobs)
+            reap(&children, &rows);
+
+        int fds[2];
+        if (pipe(fds) != 0)
+        {
+            perror("pipe");
+            return 1;
+        }
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            perror("fork");
+            return 1;
+        }
+        if (pid == 0)
+        {
+            // 固件全局变量(a, e, 阈值表)只初始化一次, 每个组合在新进程中运行
+            close(fds[0]);
+            sim_config_t cfg = *base;
+            std::vector<std::string> values = variant_values(sweeps, index);
+            std::string err;
+            for (size_t i = 0; i < sweeps.size(); i++)
+                config_set(&cfg, sweeps[i].key + "=" + values[i], &err);
+            sim_result_t result;
+            run(&cfg, NULL, &result);
+            std::string row = csv_row(index, values, &result);
+            ssize_t written = write(fds[1], row.data(), row.size());
+            _exit(written == (ssize_t)row.size() ? 0 : 1);
+        }
+        close(fds[1]);
+        child_t child = {index, fds[0]};
+        children[pid] = child;
+    }
+    while (!children.empty())
+        reap(&children, &rows);
+
+    // end列在序号和各--sweep取值之后
+    size_t unfinished = 0;
+    for (size_t i = 0; i < total; i++)
+    {
+        fputs(rows[i].c_str(), stdout);
+        size_t pos = 0;
+        for (size_t k = 0; k <= sweeps.size() && pos != std::string::npos; k++)
+            pos = rows[i].find(',', pos + 1);
+        if (pos == std::string::npos || rows[i].compare(pos + 1, 5, "done,") != 0)
+            unfinished++;
+    }
+    if (unfinished > 0)
+        fprintf(stderr, "%zu of %zu variants did not complete the mission (end column not 'done')\n", unfinished,
+                total);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    sim_config_t cfg;
+    std::vector<sweep_t> sweeps;
+    std::vector<std::string> sets;
+    const char *scenario = NULL;
+    const char *trace_path = NULL;
+    const char *params_path = NULL;
+    int jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    std::string err;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--set") == 0 && i + 1 < argc)
+        {
+            sets.push_back(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc)
+        {
+            std::string arg = argv[++i];
+            size_t eq = arg.find('=');
+            if (eq == std::string::npos)
+                usage();
+            sweep_t sweep;
+            sweep.key = arg.substr(0, eq);
+            std::string list = arg.substr(eq + 1);
+            for (size_t pos = 0; pos <= list.size();)
+            {
+                size_t comma = list.find(',', pos);
+                if (comma == std::string::npos)
+                    comma = list.size();
+                sweep.values.push_back(list.substr(pos, comma - pos));
+                pos = comma + 1;
+            }
+            sweeps.push_back(sweep);
+        }
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            jobs = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--params") == 0 && i + 1 < argc)
+        {
+            params_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            trace_path = argv[++i];
+        }
+        else if (argv[i][0] != '-' && scenario == NULL)
+        {
+            scenario = argv[i];
+        }
+        else
+        {
+            usage();
+        }
+    }
+    if (jobs < 1)
+        jobs = 1;
+
+    sim_config_defaults(&cfg);
+    if (scenario != NULL && !sim_config_load(&cfg, scenario, &err))
+    {
+        fprintf(stderr, "%s\n", err.c_str());
+        return 2;
+    }
+    // 先登记动作参数, task_00中再次登记时保留这里设置的值
+    mission_params_register();
+    if (params_path != NULL)
+    {
+        char msg[256];
+        if (params_load_file(params_path, msg, sizeof(msg)) != PARAMS_EOK)
+        {
+            fprintf(stderr, "--params: %s\n", msg);
+            return 2;
+        }
+    }
+    for (size_t i = 0; i < sets.size(); i++)
+    {
+        if (!config_set(&cfg, sets[i], &err))
+        {
+            fprintf(stderr, "--set: %s\n", err.c_str());
+            return 2;
+        }
+    }
+
+    if (!sweeps.empty())
+    {
+        if (trace_path != NULL)
+        {
+            fprintf(stderr, "--trace cannot be combined with --sweep\n");
+            return 2;
+        }
+        // 先检查每个取值, 避免子进程中出错
+        for (size_t i = 0; i < sweeps.size(); i++)
+        {
+            for (size_t j = 0; j < sweeps[i].values.size(); j++)
+            {
+                sim_config_t check = cfg;
+                if (sweeps[i].key == "box" ||
+                    !config_set(&check, sweeps[i].key + "=" + sweeps[i].values[j], &err))
+                {
+                    fprintf(stderr, "--sweep: %s\n",
+                            sweeps[i].key == "box" ? "box cannot be swept" : err.c_str());
+                    return 2;
+                }
+            }
+        }
+        return run_sweep(&cfg, sweeps, jobs);
+    }
+
+    FILE *trace = NULL;
+    if (trace_path != NULL && (trace = fopen(trace_path, "w")) == NULL)
+    {
+        perror(trace_path);
+        return 1;
+    }
+    sim_result_t result;
+    run(&cfg, trace, &result);
+    if (trace != NULL)
+        fclose(trace);
+    print_report(&cfg, &result);
+    return 0;
+}
@@ -0,0 +1,286 @@
+#include "sim_core.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#define SIM_STACK_SIZE (64 * 1024) // 协程栈, 固件任务在主机上用的栈比板上大
+
+typedef struct
+{
+    sim_task_info_t info;
+    int id;
+    void *arg;
+    ucontext_t ctx;
+    char *stack;
+    uint32_t gen;  // 每次挂起加1, 过期的恢复事件按此忽略
+    bool blocked;  // 在sim_block中
+    bool woken;    // 被sim_wake唤醒
+} sim_task_t;
+
+typedef struct
+{
+    uint64_t t;
+    uint64_t seq;
+    std::function<void()> fn;
+} sim_event_t;
+
+// 时间早的先执行, 同一时间按加入顺序
+struct sim_event_later
+{
+    bool operator()(const sim_event_t &a, const sim_event_t &b) const
+    {
+        return a.t != b.t ? a.t > b.t : a.seq > b.seq;
+    }
+};
+
+static std::priority_queue<sim_event_t, std::vector<sim_event_t>, sim_event_later> g_events;
+static std::unordered_map<int, sim_task_t *> g_tasks;
+static std::vector<char *> g_stack_pool;
+static uint64_t g_now = 0;
+static uint64_t g_seq = 0;
+static uint64_t g_last_activity = 0;
+static int g_last_task = -1;
+static int g_pending_wakeups = 0;
+static int g_next_id = 0;
+static sim_task_t *g_current = NULL;
+static ucontext_t g_sched_ctx;
+static sim_task_hook_t g_on_create = NULL;
+static sim_task_hook_t g_on_end = NULL;
+
+static void release(sim_task_t *t)
+{
+    g_stack_pool.push_back(t->stack);
+    delete t;
+}
+
+// 标记任务结束并通知统计, 记录在切回调度器后释放
+static void finish(int id, sim_task_t *t)
+{
+    t->info.alive = false;
+    t->info.ended_us = g_now;
+    if (g_on_end != NULL)
+        g_on_end(id, &t->info);
+    g_tasks.erase(id);
+}
+
+static void resume(int id, uint32_t gen)
+{
+    std::unordered_map<int, sim_task_t *>::iterator it = g_tasks.find(id);
+    if (it == g_tasks.end() || it->second->gen != gen)
+        return;
+
+    sim_task_t *t = it->second;
+    g_current = t;
+    g_last_activity = g_now;
+    g_last_task = id;
+    swapcontext(&g_sched_ctx, &t->ctx);
+    g_current = NULL;
+    if (!t->info.alive)
+        release(t);
+}
+
+// 挂起当前任务, 在时间t恢复
+static void suspend_until(uint64_t t)
+{
+    sim_task_t *task = g_current;
+    int id = task->id;
+    uint32_t gen = ++task->gen;
+    if (t != UINT64_MAX)
+    {
+        g_pending_wakeups++;
+        sim_at(t, [id, gen]() {
+            g_pending_wakeups--;
+            resume(id, gen);
+        });
+    }
+    swapcontext(&task->ctx, &g_sched_ctx);
+}
+
+static void require_task(const char *what)
+{
+    if (g_current == NULL)
+    {
+        fprintf(stderr, "sim: %s called outside a task\n", what);
+        abort();
+    }
+}
+
+static void trampoline(void)
+{
+    sim_task_t *t = g_current;
+    t->info.fn(t->arg);
+    t->info.returned = true; // FreeRTOS任务函数不能返回, 记录下来由统计报告
+    sim_task_exit();
+}
+
+void sim_reset(void)
+{
+    while (!g_events.empty())
+        g_events.pop();
+    for (std::unordered_map<int, sim_task_t *>::iterator it = g_tasks.begin(); it != g_tasks.end(); ++it)
+        release(it->second);
+    g_tasks.clear();
+    g_now = 0;
+    g_seq = 0;
+    g_last_activity = 0;
+    g_last_task = -1;
+    g_pending_wakeups = 0;
+    g_next_id = 0;
+    g_current = NULL;
+}
+
+uint64_t sim_now(void)
+{
+    return g_now;
+}
+
+void sim_at(uint64_t t, std::function<void()> fn)
+{
+    sim_event_t event;
+    event.t = t < g_now ? g_now : t;
+    event.seq = g_seq++;
+    event.fn = fn;
+    g_events.push(event);
+}
+
+int sim_task_create(sim_task_fn_t fn, void *arg, const char *name, int core)
+{
+    sim_task_t *t = new sim_task_t();
+    t->info.fn = fn;
+    t->info.name = name;
+    t->info.core = core;
+    t->info.created_us = g_now;
+    t->info.ended_us = 0;
+    t->info.alive = true;
+    t->info.returned = false;
+    t->arg = arg;
+    t->gen = 0;
+    t->blocked = false;
+    t->woken = false;
+
+    if (g_stack_pool.empty())
+    {
+        t->stack = (char *)malloc(SIM_STACK_SIZE);
+    }
+    else
+    {
+        t->stack = g_stack_pool.back();
+        g_stack_pool.pop_back();
+    }
+    getcontext(&t->ctx);
+    t->ctx.uc_stack.ss_sp = t->stack;
+    t->ctx.uc_stack.ss_size = SIM_STACK_SIZE;
+    t->ctx.uc_link = NULL;
+    makecontext(&t->ctx, trampoline, 0);
+
+    int id = g_next_id++;
+    t->id = id;
+    g_tasks[id] = t;
+    if (g_on_create != NULL)
+        g_on_create(id, &t->info);
+    sim_at(g_now, [id]() { resume(id, 0); });
+    return id;
+}
+
+int sim_task_current(void)
+{
+    return g_current == NULL ? -1 : g_current->id;
+}
+
+void sim_sleep_until(uint64_t t)
+{
+    require_task("sleep");
+    suspend_until(t < g_now ? g_now : t);
+}
+
+bool sim_block(uint64_t deadline)
+{
+    require_task("block");
+    g_current->blocked = true;
+    g_current->woken = false;
+    suspend_until(deadline);
+    g_current->blocked = false;
+    return g_current->woken;
+}
+
+void sim_wake(int id)
+{
+    std::unordered_map<int, sim_task_t *>::iterator it = g_tasks.find(id);
+    if (it == g_tasks.end() || !it->second->blocked || it->second->woken)
+        return;
+
+    sim_task_t *t = it->second;
+    t->woken = true;
+    uint32_t gen = ++t->gen; // 超时事件随之失效
+    sim_at(g_now, [id, gen]() { resume(id, gen); });
+}
+
+void sim_task_exit(void)
+{
+    require_task("task exit");
+    finish(sim_task_current(), g_current);
+    swapcontext(&g_current->ctx, &g_sched_ctx);
+    abort(); // 已结束的任务不会再被恢复
+}
+
+void sim_task_kill(int id)
+{
+    std::unordered_map<int, sim_task_t *>::iterator it = g_tasks.find(id);
+    if (it == g_tasks.end())
+        return;
+    if (it->second == g_current)
+        sim_task_exit();
+
+    sim_task_t *t = it->second;
+    finish(id, t);
+    release(t);
+}
+
+void sim_set_task_hooks(sim_task_hook_t on_create, sim_task_hook_t on_end)
+{
+    g_on_create = on_create;
+    g_on_end = on_end;
+}
+
+const sim_task_info_t *sim_task_info(int id)
+{
+    std::unordered_map<int, sim_task_t *>::iterator it = g_tasks.find(id);
+    return it == g_tasks.end() ? NULL : &it->second->info;
+}
+
+int sim_tasks_alive(void)
+{
+    return (int)g_tasks.size();
+}
+
+uint64_t sim_last_activity(void)
+{
+    return g_last_activity;
+}
+
+int sim_last_task(void)
+{
+    return g_last_task;
+}
+
+int sim_pending_wakeups(void)
+{
+    return g_pending_wakeups;
+}
+
+bool sim_step(uint64_t limit)
+{
+    if (g_events.empty() || g_events.top().t > limit)
+        return false;
+
+    sim_event_t event = g_events.top();
+    g_events.pop();
+    if (event.t > g_now)
+        g_now = event.t;
+    event.fn();
+    return true;
+}
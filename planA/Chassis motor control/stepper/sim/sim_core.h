@@ -0,0 +1,159 @@
+#ifndef SIM_CORE_H
+#define SIM_CORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+
+/**
+ * @brief 离散事件仿真内核
+ *
+ * 虚拟时间(us)加按时间排序的事件队列; 固件任务是协程(ucontext), 只在延时、
+ * 等待事件组或结束时让出, 由调度器在对应的虚拟时间恢复。同一时间的事件按加入
+ * 顺序执行, 相同输入每次运行结果完全一致。
+ * 任务不抢占, 也不区分核心和优先级: 忙等的任务(如AccelStepper::run循环)按理想
+ * 情况计时, 不模拟同核心任务之间的时间片竞争。
+ */
+
+/**
+ * @brief 任务入口, 与FreeRTOS TaskFunction_t相同
+ */
+typedef void (*sim_task_fn_t)(void *);
+
+/**
+ * @brief 任务记录
+ */
+typedef struct
+{
+    sim_task_fn_t fn;    /**< 入口函数 */
+    const char *name;    /**< 创建时的任务名 */
+    int core;            /**< 创建时指定的核心, 只用于统计 */
+    uint64_t created_us; /**< 创建时间 */
+    uint64_t ended_us;   /**< 结束时间 */
+    bool alive;          /**< 是否还在运行或阻塞 */
+    bool returned;       /**< 入口函数直接返回(没有调用vTaskDelete) */
+} sim_task_info_t;
+
+/**
+ * @brief 清空事件队列和任务, 虚拟时间回到0
+ */
+void sim_reset(void);
+
+/**
+ * @brief 当前虚拟时间(us)
+ */
+uint64_t sim_now(void);
+
+/**
+ * @brief 在虚拟时间t执行fn(在调度器上下文中执行, 不能阻塞)
+ *
+ * @param t 时间(us), 早于当前时间时按当前时间处理
+ * @param fn 回调
+ */
+void sim_at(uint64_t t, std::function<void()> fn);
+
+/**
+ * @brief 创建任务, 在当前时间之后开始运行
+ *
+ * @param fn 入口函数
+ * @param arg 参数
+ * @param name 任务名
+ * @param core 核心
+ * @return int 任务id
+ */
+int sim_task_create(sim_task_fn_t fn, void *arg, const char *name, int core);
+
+/**
+ * @brief 当前任务id, 在调度器上下文中为-1
+ */
+int sim_task_current(void);
+
+/**
+ * @brief 当前任务阻塞到时间t
+ *
+ * @param t 时间(us)
+ */
+void sim_sleep_until(uint64_t t);
+
+/**
+ * @brief 当前任务阻塞, 直到被sim_wake唤醒或到达deadline
+ *
+ * @param deadline 超时时间(us), UINT64_MAX表示一直等待
+ * @return true 被唤醒
+ * @return false 超时
+ */
+bool sim_block(uint64_t deadline);
+
+/**
+ * @brief 唤醒sim_block中的任务(在当前时间恢复), 任务不在阻塞时无效果
+ *
+ * @param id 任务id
+ */
+void sim_wake(int id);
+
+/**
+ * @brief 结束当前任务, 不返回
+ */
+void sim_task_exit(void);
+
+/**
+ * @brief 结束其他任务
+ *
+ * @param id 任务id
+ */
+void sim_task_kill(int id);
+
+/**
+ * @brief 任务创建/结束回调
+ *
+ * @param id 任务id
+ * @param info 任务记录, 结束回调返回后记录被释放
+ */
+typedef void (*sim_task_hook_t)(int id, const sim_task_info_t *info);
+
+/**
+ * @brief 设置任务创建和结束回调(用于统计, 回调中不能阻塞)
+ *
+ * @param on_create 创建时调用, 可以为NULL
+ * @param on_end 结束时调用, 可以为NULL
+ */
+void sim_set_task_hooks(sim_task_hook_t on_create, sim_task_hook_t on_end);
+
+/**
+ * @brief 运行中任务的记录
+ *
+ * @param id 任务id
+ * @return const sim_task_info_t* 任务已结束时返回NULL
+ */
+const sim_task_info_t *sim_task_info(int id);
+
+/**
+ * @brief 还在运行或阻塞的任务数
+ */
+int sim_tasks_alive(void);
+
+/**
+ * @brief 最近一次有任务恢复运行的时间(us)
+ */
+uint64_t sim_last_activity(void);
+
+/**
+ * @brief 最近一次恢复运行的任务id
+ */
+int sim_last_task(void);
+
+/**
+ * @brief 带超时的任务挂起个数(延时或限时等待); 为0时所有任务都在无限等待
+ */
+int sim_pending_wakeups(void);
+
+/**
+ * @brief 执行下一个事件
+ *
+ * @param limit 不执行晚于此时间的事件
+ * @return true 执行了一个事件
+ * @return false 队列为空或下一个事件晚于limit
+ */
+bool sim_step(uint64_t limit);
+
+#endif // SIM_CORE_H
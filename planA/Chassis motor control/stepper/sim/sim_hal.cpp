@@ -0,0 +1,426 @@
+// 仿真用的Arduino/FreeRTOS/AccelStepper实现, 接口见hal/目录
+
+#include <Arduino.h>
+#include <AccelStepper.h>
+#include <stepper.h>
+#include <freertos/event_groups.h>
+
+#include <stdint.h>
+#include <vector>
+
+#include "sim_core.h"
+#include "sim_world.h"
+
+#define SIM_PIN_NUM 64
+
+static uint8_t g_pins[SIM_PIN_NUM];
+
+SimSerial Serial;
+SimUart Serial1;
+
+// 升降和平移电机, 引脚与include/stepper.h(及其注释掉的stepper2)相同
+AccelStepper stepper1(AccelStepper::DRIVER, 14, 12);
+AccelStepper stepper2(AccelStepper::DRIVER, 16, 17);
+
+/* ---------------- Arduino ---------------- */
+
+unsigned long millis(void)
+{
+    return (unsigned long)(sim_now() / 1000);
+}
+
+unsigned long micros(void)
+{
+    return (unsigned long)sim_now();
+}
+
+void delay(uint32_t ms)
+{
+    sim_sleep_until(sim_now() + (uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    sim_sleep_until(sim_now() + us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level)
+{
+    if (pin < SIM_PIN_NUM)
+        g_pins[pin] = level;
+    sim_world_pin(pin, level);
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pin < SIM_PIN_NUM ? g_pins[pin] : LOW;
+}
+
+size_t SimSerial::print(const char *text)
+{
+    sim_world_uart(text);
+    return strlen(text);
+}
+
+size_t SimSerial::printf(const char *format, ...)
+{
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    sim_world_uart(buf);
+    return len < 0 ? 0 : (size_t)len;
+}
+
+/* ---------------- FreeRTOS任务 ---------------- */
+
+// 任务句柄为id+1, NULL表示当前任务
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core)
+{
+    (void)stack;
+    (void)priority;
+    int id = sim_task_create(fn, arg, name, core);
+    if (handle != NULL)
+        *handle = (TaskHandle_t)(intptr_t)(id + 1);
+    if (sim_task_current() >= 0)
+        sim_sleep_until(sim_now() + (uint64_t)sim_param("cpu.task_create_us"));
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg, UBaseType_t priority,
+                       TaskHandle_t *handle)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack, arg, priority, handle, -1);
+}
+
+void vTaskDelete(TaskHandle_t handle)
+{
+    if (handle == NULL)
+        sim_task_exit();
+    else
+        sim_task_kill((int)(intptr_t)handle - 1);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    delay(ticks);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return (TaskHandle_t)(intptr_t)(sim_task_current() + 1);
+}
+
+/* ---------------- FreeRTOS事件组 ---------------- */
+
+struct sim_event_group
+{
+    EventBits_t bits;
+    std::vector<int> waiters;
+};
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    return new sim_event_group();
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    group->bits |= bits;
+    // 等待方醒来后自己检查条件
+    std::vector<int> waiters;
+    waiters.swap(group->waiters);
+    for (size_t i = 0; i < waiters.size(); i++)
+        sim_wake(waiters[i]);
+    return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    EventBits_t before = group->bits;
+    group->bits &= ~bits;
+    return before;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group)
+{
+    return group->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks)
+{
+    uint64_t deadline = ticks == portMAX_DELAY ? UINT64_MAX : sim_now() + (uint64_t)ticks * 1000;
+
+    for (;;)
+    {
+        EventBits_t current = group->bits;
+        bool met = wait_for_all ? (current & bits) == bits : (current & bits) != 0;
+        if (met)
+        {
+            if (clear_on_exit)
+                group->bits &= ~bits;
+            return current;
+        }
+        if (ticks == 0 || sim_now() >= deadline)
+            return current;
+
+        int self = sim_task_current();
+        group->waiters.push_back(self);
+        if (!sim_block(deadline))
+        {
+            for (size_t i = 0; i < group->waiters.size(); i++)
+            {
+                if (group->waiters[i] == self)
+                {
+                    group->waiters.erase(group->waiters.begin() + i);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/* ---------------- AccelStepper ---------------- */
+
+AccelStepper::AccelStepper(uint8_t interface, uint8_t pin1, uint8_t pin2, uint8_t pin3, uint8_t pin4, bool enable)
+{
+    (void)interface;
+    (void)pin2;
+    (void)pin3;
+    (void)pin4;
+    (void)enable;
+    _pin1 = pin1;
+    _currentPos = 0;
+    _targetPos = 0;
+    _speed = 0.0f;
+    _maxSpeed = 0.0f;
+    _acceleration = 0.0f;
+    _stepInterval = 0;
+    _lastStepTime = 0;
+    _n = 0;
+    _c0 = 0.0f;
+    _cn = 0.0f;
+    _cmin = 1.0f;
+    _direction = false;
+    _steps = 0;
+    setAcceleration(1);
+    setMaxSpeed(1);
+}
+
+void AccelStepper::moveTo(long absolute)
+{
+    if (_targetPos != absolute)
+    {
+        _targetPos = absolute;
+        computeNewSpeed();
+    }
+}
+
+void AccelStepper::move(long relative)
+{
+    moveTo(_currentPos + relative);
+}
+
+bool AccelStepper::runSpeed(void)
+{
+    if (!_stepInterval)
+        return false;
+
+    unsigned long time = micros();
+    if (time - _lastStepTime >= _stepInterval)
+    {
+        if (_speed > 0)
+            _currentPos += 1;
+        else
+            _currentPos -= 1;
+        _steps++;
+        _lastStepTime = time;
+        return true;
+    }
+    return false;
+}
+
+bool AccelStepper::run(void)
+{
+    // 板上由调用方忙等, 仿真中直接让出到下一步到期的时间
+    if (_stepInterval != 0 && sim_task_current() >= 0)
+    {
+        uint64_t due = (uint64_t)_lastStepTime + _stepInterval;
+        if (sim_now() < due)
+            sim_sleep_until(due);
+    }
+    else if (_targetPos != _currentPos && sim_task_current() >= 0)
+    {
+        sim_sleep_until(sim_now() + 1); // 不会出现, 防止零时间死循环
+    }
+
+    if (runSpeed())
+        computeNewSpeed();
+    return _speed != 0.0f || distanceToGo() != 0;
+}
+
+void AccelStepper::setMaxSpeed(float speed)
+{
+    if (speed < 0.0f)
+        speed = -speed;
+    if (_maxSpeed != speed)
+    {
+        _maxSpeed = speed;
+        _cmin = 1000000.0f / speed;
+        if (_n > 0)
+        {
+            _n = (long)((_speed * _speed) / (2.0f * _acceleration));
+            computeNewSpeed();
+        }
+    }
+}
+
+void AccelStepper::setAcceleration(float acceleration)
+{
+    if (acceleration == 0.0f)
+        return;
+    if (acceleration < 0.0f)
+        acceleration = -acceleration;
+    if (_acceleration != acceleration)
+    {
+        _n = _n * (_acceleration / acceleration);
+        _c0 = 0.676f * sqrtf(2.0f / acceleration) * 1000000.0f;
+        _acceleration = acceleration;
+        computeNewSpeed();
+    }
+}
+
+void AccelStepper::setSpeed(float speed)
+{
+    if (speed == _speed)
+        return;
+    speed = speed < -_maxSpeed ? -_maxSpeed : (speed > _maxSpeed ? _maxSpeed : speed);
+    if (speed == 0.0f)
+    {
+        _stepInterval = 0;
+    }
+    else
+    {
+        _stepInterval = (unsigned long)fabsf(1000000.0f / speed);
+        _direction = speed > 0.0f;
+    }
+    _speed = speed;
+}
+
+void AccelStepper::setCurrentPosition(long position)
+{
+    _targetPos = _currentPos = position;
+    _n = 0;
+    _stepInterval = 0;
+    _speed = 0.0f;
+}
+
+void AccelStepper::runToPosition(void)
+{
+    while (run())
+        ;
+}
+
+void AccelStepper::stop(void)
+{
+    if (_speed != 0.0f)
+    {
+        long stepsToStop = (long)((_speed * _speed) / (2.0f * _acceleration)) + 1;
+        move(_speed > 0 ? stepsToStop : -stepsToStop);
+    }
+}
+
+void AccelStepper::computeNewSpeed(void)
+{
+    long distanceTo = distanceToGo();
+    long stepsToStop = (long)((_speed * _speed) / (2.0f * _acceleration));
+
+    if (distanceTo == 0 && stepsToStop <= 1)
+    {
+        _stepInterval = 0;
+        _speed = 0.0f;
+        _n = 0;
+        return;
+    }
+
+    if (distanceTo > 0)
+    {
+        if (_n > 0)
+        {
+            if ((stepsToStop >= distanceTo) || !_direction)
+                _n = -stepsToStop;
+        }
+        else if (_n < 0)
+        {
+            if ((stepsToStop < distanceTo) && _direction)
+                _n = -_n;
+        }
+    }
+    else if (distanceTo < 0)
+    {
+        if (_n > 0)
+        {
+            if ((stepsToStop >= -distanceTo) || _direction)
+                _n = -stepsToStop;
+        }
+        else if (_n < 0)
+        {
+            if ((stepsToStop < -distanceTo) && !_direction)
+                _n = -_n;
+        }
+    }
+
+    if (_n == 0)
+    {
+        _cn = _c0;
+        _direction = distanceTo > 0;
+    }
+    else
+    {
+        _cn = _cn - ((2.0f * _cn) / ((4.0f * _n) + 1));
+        _cn = _cn > _cmin ? _cn : _cmin;
+    }
+    _n++;
+    _stepInterval = (unsigned long)_cn;
+    _speed = 1000000.0f / _cn;
+    if (!_direction)
+        _speed = -_speed;
+}
+
+/* ---------------- 升降/平移 ---------------- */
+
+void controlStepper(AccelStepper &stepper, float speed, float acceleration, int steps)
+{
+    int motor = &stepper == &stepper1 ? 0 : 1;
+
+    speed *= sim_param("stepper.speed_scale");
+    if (speed > sim_param("stepper.max_speed"))
+        speed = sim_param("stepper.max_speed");
+    acceleration *= sim_param("stepper.accel_scale");
+
+    sim_world_move_begin(motor, stepper.currentPosition(), steps, speed, acceleration);
+    unsigned long before = stepper.steps();
+    stepper.setMaxSpeed(speed);
+    stepper.setAcceleration(acceleration);
+    stepper.moveTo(steps);
+
+    while (stepper.distanceToGo() != 0)
+    {
+        stepper.run();
+    }
+    sim_world_move_end(motor, stepper.currentPosition(), stepper.steps() - before);
+}
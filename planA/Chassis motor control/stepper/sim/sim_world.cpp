@@ -0,0 +1,553 @@
+#include "sim_world.h"
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "distance_event.h"
+#include "laser_filter.h"
+
+// 参数表: 键名, 默认值, 说明
+typedef struct
+{
+    const char *key;
+    double value;
+    const char *desc;
+} sim_param_def_t;
+
+static const sim_param_def_t g_param_defs[] = {
+    {"sim.max_time_s", 300, "最长仿真时间(s)"},
+    {"sim.stall_s", 10, "任务全部无限等待且底盘静止超过此时间(s)判为卡死"},
+    {"sim.seed", 1, "传感器噪声随机种子"},
+    {"cpu.task_create_us", 40, "xTaskCreatePinnedToCore的耗时(us), 计入创建者"},
+    {"chassis.latency_ms", 5, "底盘驱动板收到命令到开始执行(ms)"},
+    {"chassis.us_per_speed", 20, "命令速度字段每1对应的脉冲周期(us)"},
+    {"chassis.mm_per_pulse", 0.05, "每个脉冲的移动距离(mm)"},
+    {"chassis.start_x_mm", 0, "底盘前端初始位置(mm)"},
+    {"chassis.start_y_mm", 0, "底盘中心初始横向位置(mm)"},
+    {"laser.period_ms", 20, "激光采样周期(ms)"},
+    {"laser.noise_mm", 2, "激光噪声幅度(mm, 均匀分布)"},
+    {"laser.max_mm", 2000, "车道内没有箱子时的读数(mm)"},
+    {"ultrasonic.period_ms", 60, "超声波采样周期(ms)"},
+    {"ultrasonic.noise_mm", 5, "超声波噪声幅度(mm)"},
+    {"layout.wall_y_mm", 500, "侧面墙的横向位置(mm)"},
+    {"servo.deg_per_s", 300, "舵机转速(度/s), 用于估计夹爪到位时间"},
+    {"stepper.speed_scale", 1, "controlStepper速度倍率"},
+    {"stepper.accel_scale", 1, "controlStepper加速度倍率"},
+    {"stepper.max_speed", 4000, "缩放后速度上限(步/s)"},
+};
+
+#define SIM_PARAM_NUM (sizeof(g_param_defs) / sizeof(g_param_defs[0]))
+#define SERVO_PIN 15 // include/servo.h中的servoPin1
+
+typedef struct
+{
+    float x0, y0;   // 本段运动起点
+    float vx, vy;   // mm/us
+    uint64_t t0;    // 本段开始时间
+    uint64_t t_end; // 本段结束时间
+    uint32_t gen;   // 每条命令加1, 使过期的碰撞/开始事件失效
+} chassis_t;
+
+static const sim_config_t *g_cfg = NULL;
+static FILE *g_trace = NULL;
+static sim_result_t *g_result = NULL;
+static uint32_t g_rng = 1;
+static chassis_t g_chassis;
+static laser_filter_t g_filter;
+static std::map<sim_task_fn_t, const char *> g_task_names;
+static std::map<sim_task_fn_t, size_t> g_task_stat;   // 任务函数 -> result->tasks下标
+static std::map<int, int> g_last_child;               // 创建者id -> 最近创建的任务id(创建者结束后保留)
+static std::map<int, size_t> g_action_step;           // 动作任务id -> result->steps下标
+static uint64_t g_move_start[2];
+static uint64_t g_servo_high = 0;
+static int g_servo_angle = -1;
+
+/* ---------------- 参数 ---------------- */
+
+static std::string trim(const std::string &s)
+{
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos)
+        return "";
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+static bool parse_number(const std::string &s, double *value)
+{
+    char *end;
+    std::string t = trim(s);
+    *value = strtod(t.c_str(), &end);
+    return !t.empty() && *end == '\0';
+}
+
+static bool parse_box(const std::string &s, sim_box_t *box)
+{
+    double v[3];
+    size_t pos = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        size_t comma = i < 2 ? s.find(',', pos) : std::string::npos;
+        if (i < 2 && comma == std::string::npos)
+            return false;
+        if (!parse_number(s.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos), &v[i]))
+            return false;
+        pos = comma + 1;
+    }
+    box->x_mm = (float)v[0];
+    box->y_mm = (float)v[1];
+    box->width_mm = (float)v[2];
+    return box->width_mm > 0;
+}
+
+void sim_config_defaults(sim_config_t *cfg)
+{
+    cfg->values.clear();
+    for (size_t i = 0; i < SIM_PARAM_NUM; i++)
+        cfg->values[g_param_defs[i].key] = g_param_defs[i].value;
+
+    // 起点正前方30mm一个箱子(开机时已在第一个物体前)
+    sim_box_t box = {30, 0, 300};
+    cfg->boxes.clear();
+    cfg->boxes.push_back(box);
+}
+
+bool sim_config_set(sim_config_t *cfg, const std::string &line, std::string *err)
+{
+    size_t eq = line.find('=');
+    if (eq == std::string::npos)
+    {
+        *err = "missing '=': " + line;
+        return false;
+    }
+    std::string key = trim(line.substr(0, eq));
+    std::string value = line.substr(eq + 1);
+
+    if (key == "box")
+    {
+        sim_box_t box;
+        if (!parse_box(value, &box))
+        {
+            *err = "bad box (x, y, width): " + trim(value);
+            return false;
+        }
+        cfg->boxes.push_back(box);
+        return true;
+    }
+    if (cfg->values.find(key) == cfg->values.end())
+    {
+        *err = "unknown parameter: " + key;
+        return false;
+    }
+    double v;
+    if (!parse_number(value, &v))
+    {
+        *err = "bad value for " + key + ": " + trim(value);
+        return false;
+    }
+    cfg->values[key] = v;
+    return true;
+}
+
+bool sim_config_load(sim_config_t *cfg, const char *path, std::string *err)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+    {
+        *err = std::string("cannot open ") + path;
+        return false;
+    }
+
+    char buf[256];
+    int line_no = 0;
+    bool boxes_cleared = false;
+    bool ok = true;
+    while (ok && fgets(buf, sizeof(buf), f) != NULL)
+    {
+        line_no++;
+        std::string line = buf;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos)
+            line.erase(hash);
+        line = trim(line);
+        if (line.empty())
+            continue;
+
+        if (!boxes_cleared && trim(line.substr(0, line.find('='))) == "box")
+        {
+            cfg->boxes.clear();
+            boxes_cleared = true;
+        }
+        if (!sim_config_set(cfg, line, err))
+        {
+            char where[32];
+            snprintf(where, sizeof(where), ":%d: ", line_no);
+            *err = path + std::string(where) + *err;
+            ok = false;
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+double sim_param(const char *key)
+{
+    std::map<std::string, double>::const_iterator it = g_cfg->values.find(key);
+    if (it == g_cfg->values.end())
+    {
+        fprintf(stderr, "sim: unknown parameter %s\n", key);
+        abort();
+    }
+    return it->second;
+}
+
+/* ---------------- 记录 ---------------- */
+
+void sim_trace(const char *kind, const char *format, ...)
+{
+    if (g_trace == NULL)
+        return;
+
+    char detail[160];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(detail, sizeof(detail), format, args);
+    va_end(args);
+    for (char *p = detail; *p != '\0'; p++)
+    {
+        if (*p == '"' || *p == '\n' || *p == '\r')
+            *p = ' ';
+    }
+    fprintf(g_trace, "%.3f,%s,\"%s\"\n", sim_now() / 1000.0, kind, detail);
+}
+
+void sim_world_name_task(sim_task_fn_t fn, const char *name)
+{
+    g_task_names[fn] = name;
+}
+
+static const char *task_name(const sim_task_info_t *info)
+{
+    std::map<sim_task_fn_t, const char *>::const_iterator it = g_task_names.find(info->fn);
+    return it == g_task_names.end() ? info->name : it->second;
+}
+
+static void on_task_create(int id, const sim_task_info_t *info)
+{
+    g_result->task_creates++;
+    int creator = sim_task_current();
+    if (creator >= 0)
+        g_last_child[creator] = id;
+
+    std::map<sim_task_fn_t, size_t>::iterator it = g_task_stat.find(info->fn);
+    if (it == g_task_stat.end())
+    {
+        sim_task_stat_t stat = {task_name(info), 0, 0, 0};
+        it = g_task_stat.insert(std::make_pair(info->fn, g_result->tasks.size())).first;
+        g_result->tasks.push_back(stat);
+    }
+    g_result->tasks[it->second].count++;
+    sim_trace("task_create", "%s,%d,core %d", task_name(info), id, info->core);
+}
+
+static void on_task_end(int id, const sim_task_info_t *info)
+{
+    sim_task_stat_t *stat = &g_result->tasks[g_task_stat[info->fn]];
+    stat->total_us += info->ended_us - info->created_us;
+    if (info->returned)
+        stat->returned++;
+
+    std::map<int, size_t>::iterator it = g_action_step.find(id);
+    if (it != g_action_step.end())
+    {
+        sim_step_t *step = &g_result->steps[it->second];
+        step->action_us = info->ended_us - info->created_us;
+        step->finished = true;
+        g_action_step.erase(it);
+    }
+    sim_trace("task_end", "%s,%d%s", task_name(info), id, info->returned ? ",returned" : "");
+}
+
+// 任务步骤加1: 动作任务是修改步骤计数的任务最近创建的任务
+static void on_mission_step(int step)
+{
+    sim_step_t s = {"?", sim_now(), 0, 0, false};
+    std::map<int, int>::iterator child = g_last_child.find(sim_last_task());
+    const sim_task_info_t *info = child == g_last_child.end() ? NULL : sim_task_info(child->second);
+    if (info != NULL)
+    {
+        s.task = task_name(info);
+        s.start_us = info->created_us;
+        g_action_step[child->second] = g_result->steps.size();
+    }
+
+    uint64_t ready = 0;
+    if (!g_result->steps.empty())
+    {
+        const sim_step_t *prev = &g_result->steps.back();
+        ready = prev->finished ? prev->start_us + prev->action_us : s.start_us;
+    }
+    s.wait_us = s.start_us > ready ? s.start_us - ready : 0;
+    g_result->steps.push_back(s);
+    sim_trace("step", "%d,%s", step, s.task);
+}
+
+/* ---------------- 底盘 ---------------- */
+
+static void chassis_position(uint64_t t, float *x, float *y)
+{
+    uint64_t end = t < g_chassis.t_end ? t : g_chassis.t_end;
+    float dt = end > g_chassis.t0 ? (float)(end - g_chassis.t0) : 0.0f;
+    *x = g_chassis.x0 + g_chassis.vx * dt;
+    *y = g_chassis.y0 + g_chassis.vy * dt;
+}
+
+static bool chassis_moving(void)
+{
+    return sim_now() < g_chassis.t_end;
+}
+
+// 底盘前方同一车道内最近的箱子表面, 没有时返回NULL
+static const sim_box_t *box_ahead(float x, float y)
+{
+    const sim_box_t *best = NULL;
+    for (size_t i = 0; i < g_cfg->boxes.size(); i++)
+    {
+        const sim_box_t *box = &g_cfg->boxes[i];
+        if (box->x_mm >= x && fabsf(y - box->y_mm) <= box->width_mm / 2 && (best == NULL || box->x_mm < best->x_mm))
+            best = box;
+    }
+    return best;
+}
+
+static void chassis_stop_at(uint64_t t)
+{
+    float x, y;
+    chassis_position(t, &x, &y);
+    g_chassis.x0 = x;
+    g_chassis.y0 = y;
+    g_chassis.vx = 0;
+    g_chassis.vy = 0;
+    g_chassis.t0 = t;
+    g_chassis.t_end = t;
+}
+
+// 协议见上级README: 7前进 8后退 5左移 6右移, 其余(如0)停止
+static void chassis_command(int id, long pulses, int speed, uint32_t gen)
+{
+    if (gen != g_chassis.gen)
+        return;
+
+    uint64_t now = sim_now();
+    chassis_stop_at(now);
+    if (speed <= 0 || pulses <= 0)
+        return;
+
+    float period_us = (float)(speed * sim_param("chassis.us_per_speed"));
+    float v = (float)sim_param("chassis.mm_per_pulse") / period_us;
+    switch (id)
+    {
+    case 7:
+        g_chassis.vx = v;
+        break;
+    case 8:
+        g_chassis.vx = -v;
+        break;
+    case 5:
+        g_chassis.vy = v;
+        break;
+    case 6:
+        g_chassis.vy = -v;
+        break;
+    default:
+        return;
+    }
+    g_chassis.t_end = now + (uint64_t)(pulses * period_us);
+
+    // 只检测前进方向的碰撞
+    if (g_chassis.vx > 0)
+    {
+        const sim_box_t *box = box_ahead(g_chassis.x0, g_chassis.y0);
+        if (box != NULL)
+        {
+            uint64_t t_hit = now + (uint64_t)((box->x_mm - g_chassis.x0) / g_chassis.vx);
+            if (t_hit < g_chassis.t_end)
+            {
+                sim_at(t_hit, [gen, t_hit]() {
+                    if (gen != g_chassis.gen)
+                        return;
+                    chassis_stop_at(t_hit);
+                    g_result->collisions++;
+                    sim_trace("collision", "%.1f,%.1f", g_chassis.x0, g_chassis.y0);
+                });
+            }
+        }
+    }
+}
+
+void sim_world_uart(const char *text)
+{
+    int id, speed, len = 0;
+    long pulses;
+    if (sscanf(text, "%d,%ld,%d%n", &id, &pulses, &speed, &len) != 3 || text[len] != '\0')
+    {
+        // 调试信息同样会发到底盘驱动板
+        g_result->uart_text++;
+        sim_trace("uart", "%s", text);
+        return;
+    }
+
+    g_result->chassis_cmds++;
+    sim_trace("chassis", "%d,%ld,%d", id, pulses, speed);
+    uint32_t gen = ++g_chassis.gen;
+    // 115200 8N1每字节约87us, 加上驱动板响应时间
+    uint64_t start = sim_now() + strlen(text) * 87 + (uint64_t)(sim_param("chassis.latency_ms") * 1000);
+    sim_at(start, [id, pulses, speed, gen]() { chassis_command(id, pulses, speed, gen); });
+}
+
+/* ---------------- 传感器 ---------------- */
+
+// xorshift32, 相同种子得到相同序列
+static float noise(float amplitude)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return amplitude * ((g_rng & 0xFFFF) / 32767.5f - 1.0f);
+}
+
+static void laser_tick(void)
+{
+    float x, y;
+    chassis_position(sim_now(), &x, &y);
+    const sim_box_t *box = box_ahead(x, y);
+    float max = (float)sim_param("laser.max_mm");
+    float d = box != NULL ? box->x_mm - x : max;
+    d += noise((float)sim_param("laser.noise_mm"));
+    d = d < 0 ? 0 : (d > max ? max : d);
+
+    // 与laser_sensor.cpp的publish_sample相同: 滤波后只有被接受的样本参与阈值判断
+    uint32_t now_ms = (uint32_t)(sim_now() / 1000);
+    laser_filtered_t filtered;
+    g_result->laser_samples++;
+    if (laser_filter_update(&g_filter, (uint16_t)lroundf(d), now_ms))
+    {
+        laser_filter_get(&g_filter, now_ms, &filtered);
+        distance_event_feed(DISTANCE_SOURCE_LASER, filtered.distance);
+    }
+    else
+    {
+        g_result->laser_outliers++;
+    }
+
+    sim_at(sim_now() + (uint64_t)(sim_param("laser.period_ms") * 1000), laser_tick);
+}
+
+static void ultrasonic_tick(void)
+{
+    float x, y;
+    chassis_position(sim_now(), &x, &y);
+    float d = (float)sim_param("layout.wall_y_mm") - y + noise((float)sim_param("ultrasonic.noise_mm"));
+    distance_event_feed(DISTANCE_SOURCE_ULTRASONIC, d < 0 ? 0 : d);
+
+    sim_at(sim_now() + (uint64_t)(sim_param("ultrasonic.period_ms") * 1000), ultrasonic_tick);
+}
+
+/* ---------------- 舵机/步进电机 ---------------- */
+
+void sim_world_pin(uint8_t pin, uint8_t level)
+{
+    if (pin != SERVO_PIN)
+        return;
+
+    if (level)
+    {
+        g_servo_high = sim_now();
+        return;
+    }
+    // 脉宽 = 角度 * 11 + 500 (include/servo.h)
+    int angle = (int)lround(((double)(sim_now() - g_servo_high) - 500) / 11.0);
+    if (angle != g_servo_angle)
+    {
+        double travel = g_servo_angle < 0 ? 0 : abs(angle - g_servo_angle) * 1000.0 / sim_param("servo.deg_per_s");
+        g_result->servo_moves++;
+        sim_trace("servo", "%d,%.0f ms", angle, travel);
+        g_servo_angle = angle;
+    }
+}
+
+void sim_world_move_begin(int motor, long from, long to, float speed, float accel)
+{
+    g_move_start[motor] = sim_now();
+    sim_trace(motor == 0 ? "lift" : "slide", "%ld->%ld,%.0f,%.0f", from, to, speed, accel);
+}
+
+void sim_world_move_end(int motor, long position, unsigned long steps)
+{
+    uint64_t busy = sim_now() - g_move_start[motor];
+    g_result->motor_steps[motor] += steps;
+    g_result->motor_busy_us[motor] += busy;
+    sim_trace(motor == 0 ? "lift_done" : "slide_done", "%ld,%lu steps,%.0f ms", position, steps, busy / 1000.0);
+}
+
+/* ---------------- 运行 ---------------- */
+
+void sim_world_run(const sim_config_t *cfg, volatile int *mission_step, sim_task_fn_t entry, FILE *trace,
+                   sim_result_t *result)
+{
+    g_cfg = cfg;
+    g_trace = trace;
+    g_result = result;
+    *result = sim_result_t();
+
+    g_rng = (uint32_t)sim_param("sim.seed");
+    if (g_rng == 0)
+        g_rng = 1;
+    memset(&g_chassis, 0, sizeof(g_chassis));
+    g_chassis.x0 = (float)sim_param("chassis.start_x_mm");
+    g_chassis.y0 = (float)sim_param("chassis.start_y_mm");
+    laser_filter_config_t filter_config;
+    laser_filter_default_config(&filter_config);
+    laser_filter_init(&g_filter, &filter_config);
+    if (trace != NULL)
+        fprintf(trace, "time_ms,kind,detail\n");
+
+    sim_reset();
+    sim_set_task_hooks(on_task_create, on_task_end);
+    sim_at((uint64_t)(sim_param("laser.period_ms") * 1000), laser_tick);
+    sim_at((uint64_t)(sim_param("ultrasonic.period_ms") * 1000), ultrasonic_tick);
+    sim_task_create(entry, NULL, "entry", 1);
+
+    uint64_t limit = (uint64_t)(sim_param("sim.max_time_s") * 1e6);
+    uint64_t stall = (uint64_t)(sim_param("sim.stall_s") * 1e6);
+    int step = *mission_step;
+    for (;;)
+    {
+        if (!sim_step(limit))
+        {
+            result->end_reason = SIM_END_TIMEOUT;
+            result->end_us = limit;
+            break;
+        }
+        if (*mission_step != step)
+        {
+            step = *mission_step;
+            on_mission_step(step);
+        }
+        if (sim_tasks_alive() == 0)
+        {
+            result->end_reason = SIM_END_DONE;
+            result->end_us = sim_now();
+            break;
+        }
+        if (sim_pending_wakeups() == 0 && !chassis_moving() && sim_now() - sim_last_activity() > stall)
+        {
+            result->end_reason = SIM_END_STALLED;
+            result->end_us = sim_last_activity();
+            break;
+        }
+    }
+    sim_trace("end", "%d", result->end_reason);
+}
@@ -0,0 +1,171 @@
+#ifndef SIM_WORLD_H
+#define SIM_WORLD_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "sim_core.h"
+
+/**
+ * @brief 整车仿真模型
+ *
+ * 底盘: 解析串口0上的"命令ID,脉冲数,速度"帧(协议见上级README), 按脉冲周期匀速移动;
+ *       撞到箱子时停在箱子表面并计数。
+ * 激光: 沿底盘前进方向测到同一车道内最近箱子表面的距离, 加噪声后经固件的laser_filter
+ *       滤波, 再送入distance_event(与laser_sensor.cpp相同)。
+ * 超声波: 测底盘到侧面墙的距离, 送入DISTANCE_SOURCE_ULTRASONIC。
+ * 步进电机: 升降(stepper1)和平移(stepper2), 速度曲线见hal/AccelStepper.h。
+ * 舵机: 从GPIO15的脉宽解码角度, 按转速估计夹爪到位时间。
+ */
+
+/**
+ * @brief 箱子: 朝向底盘的表面在x处, 横向中心y, 宽度width(mm)
+ */
+typedef struct
+{
+    float x_mm;
+    float y_mm;
+    float width_mm;
+} sim_box_t;
+
+/**
+ * @brief 仿真参数, 键名和默认值见sim_world.cpp中的参数表
+ */
+typedef struct
+{
+    std::map<std::string, double> values;
+    std::vector<sim_box_t> boxes;
+} sim_config_t;
+
+/**
+ * @brief 结束原因
+ */
+#define SIM_END_DONE 0    /**< 所有任务都已结束 */
+#define SIM_END_STALLED 1 /**< 任务都在无限等待, 底盘静止, stall_s内没有任务运行 */
+#define SIM_END_TIMEOUT 2 /**< 到达max_time_s */
+
+/**
+ * @brief 一个任务步骤(固件中a每加1, task_0创建的动作任务)
+ */
+typedef struct
+{
+    const char *task;  /**< 动作任务 */
+    uint64_t start_us; /**< 动作任务创建时间 */
+    uint64_t wait_us;  /**< 上一个动作结束到本步骤开始(等待物体到位) */
+    uint64_t action_us; /**< 动作任务运行时间, 未结束时为0 */
+    bool finished;      /**< 动作任务已结束 */
+} sim_step_t;
+
+/**
+ * @brief 按任务函数汇总
+ */
+typedef struct
+{
+    const char *name;  /**< 任务函数名 */
+    uint32_t count;    /**< 创建次数 */
+    uint64_t total_us; /**< 运行时间总和(创建到结束) */
+    uint32_t returned; /**< 直接返回而没有vTaskDelete的次数 */
+} sim_task_stat_t;
+
+/**
+ * @brief 一次仿真的结果
+ */
+typedef struct
+{
+    int end_reason;                    /**< SIM_END_xxx */
+    uint64_t end_us;                   /**< 任务总时间: 最后一个任务活动的时间 */
+    std::vector<sim_step_t> steps;     /**< 按顺序的任务步骤 */
+    std::vector<sim_task_stat_t> tasks; /**< 按首次创建顺序 */
+    uint32_t task_creates;             /**< 任务创建次数 */
+    uint32_t chassis_cmds;             /**< 底盘命令帧数 */
+    uint32_t uart_text;                /**< 串口0上不是底盘命令的输出次数(调试信息会发给底盘驱动板) */
+    uint32_t collisions;               /**< 底盘撞到箱子的次数 */
+    uint32_t servo_moves;              /**< 舵机角度变化次数 */
+    uint32_t laser_samples;            /**< 激光样本数 */
+    uint32_t laser_outliers;           /**< 被滤波器判为野值的样本数 */
+    unsigned long motor_steps[2];      /**< 升降/平移累计步数 */
+    uint64_t motor_busy_us[2];         /**< 升降/平移controlStepper忙等时间 */
+} sim_result_t;
+
+/**
+ * @brief 默认参数
+ *
+ * @param cfg 参数
+ */
+void sim_config_defaults(sim_config_t *cfg);
+
+/**
+ * @brief 读取场景文件: 每行"键 = 值", "#"开始为注释; "box = x, y, width"添加一个箱子
+ * 文件中有箱子时替换默认布置
+ *
+ * @param cfg 参数
+ * @param path 文件路径
+ * @param err 出错时的说明
+ * @return true 成功
+ */
+bool sim_config_load(sim_config_t *cfg, const char *path, std::string *err);
+
+/**
+ * @brief 设置一个参数, 格式同场景文件的一行
+ *
+ * @param cfg 参数
+ * @param line "键=值"
+ * @param err 出错时的说明
+ * @return true 成功
+ */
+bool sim_config_set(sim_config_t *cfg, const std::string &line, std::string *err);
+
+/**
+ * @brief 当前仿真的参数值, 键名不存在时终止程序
+ *
+ * @param key 键名
+ */
+double sim_param(const char *key);
+
+/**
+ * @brief 为任务函数登记名字, 用于报告
+ *
+ * @param fn 任务函数
+ * @param name 名字
+ */
+void sim_world_name_task(sim_task_fn_t fn, const char *name);
+
+/**
+ * @brief 运行一次仿真(每个进程只运行一次, 固件全局变量不会被重置)
+ *
+ * @param cfg 参数
+ * @param mission_step 固件的任务步骤计数(task.h中的a)
+ * @param entry 入口任务(task_00)
+ * @param trace 事件记录CSV, 可以为NULL
+ * @param result 结果
+ */
+void sim_world_run(const sim_config_t *cfg, volatile int *mission_step, sim_task_fn_t entry, FILE *trace,
+                   sim_result_t *result);
+
+/**
+ * @brief 串口0输出一帧(由hal调用)
+ */
+void sim_world_uart(const char *text);
+
+/**
+ * @brief 引脚电平变化(由hal调用)
+ */
+void sim_world_pin(uint8_t pin, uint8_t level);
+
+/**
+ * @brief 步进电机开始/结束一次controlStepper(由hal调用)
+ *
+ * @param motor 0=升降, 1=平移
+ */
+void sim_world_move_begin(int motor, long from, long to, float speed, float accel);
+void sim_world_move_end(int motor, long position, unsigned long steps);
+
+/**
+ * @brief 写一行事件记录
+ */
+void sim_trace(const char *kind, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+#endif // SIM_WORLD_H
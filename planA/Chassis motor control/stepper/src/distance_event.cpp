@@ -0,0 +1,127 @@
+#include "distance_event.h"
+#include "metrics.h"
+
+// 阈值表, 注册在setup阶段完成, 之后只由传感器回调读写
+typedef struct
+{
+    uint8_t source;
+    distance_threshold_t threshold;
+} distance_event_entry_t;
+
+static distance_event_entry_t g_entries[DISTANCE_EVENT_MAX];
+static volatile uint8_t g_count = 0;
+static EventGroupHandle_t g_group = NULL;
+static portMUX_TYPE g_mux = portMUX_INITIALIZER_UNLOCKED;
+static Stream *g_log = NULL; // 打印提示的串口, NULL表示不打印
+
+// 运行指标
+static metrics_counter_t g_m_transitions; // 阈值状态切换次数
+static metrics_counter_t g_m_timeouts;    // 等待超时次数
+
+// 初始化距离事件
+void distance_event_init(Stream *log)
+{
+    g_log = log;
+    if (g_group == NULL)
+    {
+        g_group = xEventGroupCreate();
+    }
+    metrics_register_counter(&g_m_transitions, "event.transitions");
+    metrics_register_counter(&g_m_timeouts, "event.wait_timeouts");
+}
+
+// 注册阈值
+uint8_t distance_event_register(uint8_t source, float near, float far, uint8_t *id)
+{
+    if (source >= DISTANCE_SOURCE_NUM || id == NULL || far < near)
+    {
+        return DISTANCE_EVENT_EINVAL;
+    }
+    if (g_group == NULL)
+    {
+        return DISTANCE_EVENT_ERROR;
+    }
+
+    portENTER_CRITICAL(&g_mux);
+    if (g_count >= DISTANCE_EVENT_MAX)
+    {
+        portEXIT_CRITICAL(&g_mux);
+        return DISTANCE_EVENT_EFULL;
+    }
+    distance_event_entry_t *entry = &g_entries[g_count];
+    entry->source = source;
+    distance_threshold_init(&entry->threshold, near, far);
+    *id = g_count;
+    g_count++; // 表项写完后再计数, feed不会读到未初始化的阈值
+    portEXIT_CRITICAL(&g_mux);
+
+    if (g_log != NULL)
+        g_log->printf("[EVENT] Threshold %u: source %u, near %.0f mm, far %.0f mm\n", *id, source, near, far);
+    return DISTANCE_EVENT_EOK;
+}
+
+// 输入距离样本
+void distance_event_feed(uint8_t source, float distance)
+{
+    uint8_t count = g_count;
+
+    for (uint8_t id = 0; id < count; id++)
+    {
+        distance_event_entry_t *entry = &g_entries[id];
+        if (entry->source != source || !distance_threshold_update(&entry->threshold, distance))
+            continue;
+
+        metrics_counter_inc(&g_m_transitions);
+        // 先清另一位再置当前位, 等待方看到的始终是单一状态
+        if (entry->threshold.state == DISTANCE_STATE_NEAR)
+        {
+            xEventGroupClearBits(g_group, DISTANCE_EVENT_FAR_BIT(id));
+            xEventGroupSetBits(g_group, DISTANCE_EVENT_NEAR_BIT(id));
+        }
+        else
+        {
+            xEventGroupClearBits(g_group, DISTANCE_EVENT_NEAR_BIT(id));
+            xEventGroupSetBits(g_group, DISTANCE_EVENT_FAR_BIT(id));
+        }
+    }
+}
+
+// 等待阈值状态
+uint8_t distance_event_wait(uint8_t id, uint32_t timeout_ms, uint8_t *state)
+{
+    if (id >= g_count || state == NULL)
+    {
+        return DISTANCE_EVENT_EINVAL;
+    }
+
+    EventBits_t mask = DISTANCE_EVENT_NEAR_BIT(id) | DISTANCE_EVENT_FAR_BIT(id);
+    TickType_t ticks = timeout_ms == portMAX_DELAY ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    EventBits_t bits = xEventGroupWaitBits(g_group, mask, pdFALSE, pdFALSE, ticks);
+
+    if (bits & DISTANCE_EVENT_NEAR_BIT(id))
+        *state = DISTANCE_STATE_NEAR;
+    else if (bits & DISTANCE_EVENT_FAR_BIT(id))
+        *state = DISTANCE_STATE_FAR;
+    else
+    {
+        metrics_counter_inc(&g_m_timeouts);
+        return DISTANCE_EVENT_ETIMEOUT;
+    }
+    return DISTANCE_EVENT_EOK;
+}
+
+// 获取阈值当前状态
+uint8_t distance_event_get_state(uint8_t id)
+{
+    if (id >= g_count)
+    {
+        return DISTANCE_STATE_UNKNOWN;
+    }
+    return g_entries[id].threshold.state;
+}
+
+// 获取事件组句柄
+EventGroupHandle_t distance_event_group(void)
+{
+    return g_group;
+}
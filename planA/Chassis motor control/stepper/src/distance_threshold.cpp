@@ -0,0 +1,26 @@
+#include "distance_threshold.h"
+
+void distance_threshold_init(distance_threshold_t *threshold, float near, float far)
+{
+    threshold->near = near;
+    threshold->far = far < near ? near : far;
+    threshold->state = DISTANCE_STATE_UNKNOWN;
+    threshold->crossings = 0;
+}
+
+bool distance_threshold_update(distance_threshold_t *threshold, float distance)
+{
+    uint8_t state = threshold->state;
+
+    if (distance <= threshold->near)
+        state = DISTANCE_STATE_NEAR;
+    else if (distance >= threshold->far || state == DISTANCE_STATE_UNKNOWN)
+        state = DISTANCE_STATE_FAR;
+
+    if (state == threshold->state)
+        return false;
+
+    threshold->state = state;
+    threshold->crossings++;
+    return true;
+}
@@ -12,17 +12,18 @@ void laser_init(void) {
 
 /**
  * 获取激光传感器测量的实时距离
- * @return 测量的距离，单位mm
+ * @return 测量的距离，单位mm；没有数据或数据无效时返回-1
  */
 float jiguang(void) {
   if (Serial2.available() > 0) {
     String data = Serial2.readStringUntil('\n');
     // 假设数据格式为纯数字字符串
     float distance = data.toFloat();
-    return distance;
+    if (distance > 0) {
+      return distance;
+    }
   }
-  
-  // 如果没有真实数据，返回模拟数据
-  float fake_distance = random(100, 1000) / 10.0; // 模拟10-100cm的距离
-  return fake_distance;
-} 
\ No newline at end of file
+
+  // 没有真实数据时不能返回模拟值，否则调用方会按假距离动作
+  return -1.0f;
+}
@@ -0,0 +1,140 @@
+#include "laser_filter.h"
+
+#include <string.h>
+
+// 两个样本间隔上限(s), 避免长时间无数据后速度积分发散
+#define MAX_DT 0.5f
+
+void laser_filter_default_config(laser_filter_config_t *config)
+{
+    config->median_window = 5;
+    config->alpha = 0.5f;
+    config->beta = 0.1f;
+    config->outlier_gate = 150.0f;
+    config->outlier_reset = 5;
+    config->stale_ms = 300;
+}
+
+bool laser_filter_config_check(const laser_filter_config_t *config)
+{
+    return config != NULL && config->median_window >= 1 && config->median_window <= LASER_FILTER_MEDIAN_MAX &&
+           config->alpha > 0.0f && config->alpha <= 1.0f && config->beta >= 0.0f && config->beta <= 1.0f &&
+           config->outlier_gate > 0.0f && config->outlier_reset >= LASER_FILTER_OUTLIER_RESET_MIN &&
+           config->stale_ms >= LASER_FILTER_STALE_MIN_MS && config->stale_ms <= LASER_FILTER_STALE_MAX_MS;
+}
+
+void laser_filter_init(laser_filter_t *filter, const laser_filter_config_t *config)
+{
+    memset(filter, 0, sizeof(*filter));
+    if (config != NULL)
+        filter->config = *config;
+    else
+        laser_filter_default_config(&filter->config);
+
+    if (filter->config.median_window < 1)
+        filter->config.median_window = 1;
+    if (filter->config.median_window > LASER_FILTER_MEDIAN_MAX)
+        filter->config.median_window = LASER_FILTER_MEDIAN_MAX;
+    if (filter->config.outlier_reset < LASER_FILTER_OUTLIER_RESET_MIN)
+        filter->config.outlier_reset = LASER_FILTER_OUTLIER_RESET_MIN;
+}
+
+// 从第一个样本重新开始估计
+static void filter_restart(laser_filter_t *filter, uint16_t distance, uint32_t timestamp)
+{
+    filter->window[0] = distance;
+    filter->window_count = 1;
+    filter->window_head = 1 % filter->config.median_window;
+    filter->x = distance;
+    filter->v = 0.0f;
+    filter->timestamp = timestamp;
+    filter->initialized = true;
+    filter->last_outlier = false;
+    filter->rejects = 0;
+}
+
+// 求窗口中值, 窗口最多9个数, 插入排序即可
+static uint16_t window_median(const laser_filter_t *filter)
+{
+    uint16_t sorted[LASER_FILTER_MEDIAN_MAX];
+    uint8_t n = filter->window_count;
+
+    for (uint8_t i = 0; i < n; i++)
+    {
+        uint16_t value = filter->window[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > value)
+        {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+    return sorted[n / 2];
+}
+
+bool laser_filter_update(laser_filter_t *filter, uint16_t distance, uint32_t timestamp)
+{
+    const laser_filter_config_t *cfg = &filter->config;
+
+    if (!filter->initialized)
+    {
+        filter_restart(filter, distance, timestamp);
+        filter->accepted++;
+        return true;
+    }
+
+    float dt = (timestamp - filter->timestamp) / 1000.0f;
+    if (dt > MAX_DT)
+        dt = MAX_DT;
+
+    // 野值剔除: 与预测位置偏差过大的样本丢弃
+    float predicted = filter->x + filter->v * dt;
+    float residual = distance - predicted;
+    if (residual > cfg->outlier_gate || residual < -cfg->outlier_gate)
+    {
+        filter->outliers++;
+        filter->last_outlier = true;
+        if (++filter->rejects < cfg->outlier_reset)
+            return false;
+
+        // 连续野值说明目标确实跳变(例如换了一个箱子), 从这个样本重新开始, 它不再算野值
+        filter_restart(filter, distance, timestamp);
+        return true;
+    }
+    filter->rejects = 0;
+    filter->last_outlier = false;
+
+    // 中值窗口
+    filter->window[filter->window_head] = distance;
+    filter->window_head = (filter->window_head + 1) % cfg->median_window;
+    if (filter->window_count < cfg->median_window)
+        filter->window_count++;
+    float measured = window_median(filter);
+
+    // alpha-beta滤波
+    residual = measured - predicted;
+    filter->x = predicted + cfg->alpha * residual;
+    if (dt > 0.0f)
+        filter->v += cfg->beta * residual / dt;
+    filter->timestamp = timestamp;
+    filter->accepted++;
+    return true;
+}
+
+void laser_filter_get(const laser_filter_t *filter, uint32_t now, laser_filtered_t *out)
+{
+    out->distance = filter->x;
+    out->velocity = filter->v;
+    out->timestamp = filter->timestamp;
+    out->flags = 0;
+
+    if (!filter->initialized)
+        return;
+
+    out->flags |= LASER_FILTER_FLAG_VALID;
+    if (now - filter->timestamp <= filter->config.stale_ms)
+        out->flags |= LASER_FILTER_FLAG_FRESH;
+    if (filter->last_outlier)
+        out->flags |= LASER_FILTER_FLAG_OUTLIER;
+}
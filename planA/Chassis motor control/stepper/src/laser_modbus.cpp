@@ -0,0 +1,219 @@
+#include "laser_modbus.h"
+
+#include <string.h>
+
+// CRC16(多项式0xA001)查表, 每字节一次查表
+static const uint16_t crc_table[256] = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040,
+};
+
+uint16_t laser_mb_crc16(const uint8_t *data, uint16_t len)
+{
+    uint16_t crc = 0xFFFF;
+    while (len--)
+    {
+        crc = (crc >> 8) ^ crc_table[(crc ^ *data++) & 0xFF];
+    }
+    return crc;
+}
+
+// 填写请求帧(地址、功能码、两个16位参数和CRC)
+static uint8_t build_request(uint8_t addr, uint8_t func, uint16_t p1, uint16_t p2, uint8_t *frame)
+{
+    frame[0] = addr;
+    frame[1] = func;
+    frame[2] = (uint8_t)(p1 >> 8);
+    frame[3] = (uint8_t)(p1 & 0xFF);
+    frame[4] = (uint8_t)(p2 >> 8);
+    frame[5] = (uint8_t)(p2 & 0xFF);
+    uint16_t crc = laser_mb_crc16(frame, 6);
+    frame[6] = (uint8_t)(crc & 0xFF);
+    frame[7] = (uint8_t)(crc >> 8);
+    return LASER_MB_REQUEST_LEN;
+}
+
+uint8_t laser_mb_build_read(uint8_t addr, uint16_t reg, uint16_t count, uint8_t *frame)
+{
+    if (count < 1)
+        count = 1;
+    if (count > LASER_MB_MAX_REGS)
+        count = LASER_MB_MAX_REGS;
+    return build_request(addr, LASER_MB_FUNC_READ, reg, count, frame);
+}
+
+uint8_t laser_mb_build_write(uint8_t addr, uint16_t reg, uint16_t value, uint8_t *frame)
+{
+    return build_request(addr, LASER_MB_FUNC_WRITE, reg, value, frame);
+}
+
+void laser_mb_decoder_reset(laser_mb_decoder_t *decoder, uint8_t addr)
+{
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->addr = addr;
+}
+
+// 根据已收到的字节确定帧长度, 返回false表示帧头非法
+static bool frame_length(laser_mb_decoder_t *decoder)
+{
+    uint8_t func = decoder->buf[1];
+
+    if (decoder->cnt == 2)
+    {
+        if (func & LASER_MB_FUNC_ERROR)
+        {
+            func &= ~LASER_MB_FUNC_ERROR;
+            if (func != LASER_MB_FUNC_READ && func != LASER_MB_FUNC_WRITE)
+                return false;
+            decoder->len = 5;
+        }
+        else if (func == LASER_MB_FUNC_WRITE)
+        {
+            decoder->len = 8;
+        }
+        else if (func != LASER_MB_FUNC_READ)
+        {
+            return false;
+        }
+    }
+    else if (decoder->cnt == 3 && func == LASER_MB_FUNC_READ)
+    {
+        uint8_t byte_count = decoder->buf[2];
+        if (byte_count == 0 || (byte_count & 1) || byte_count > 2 * LASER_MB_MAX_REGS)
+            return false;
+        decoder->len = 5 + byte_count;
+    }
+    return true;
+}
+
+// 解析一帧校验通过的应答
+static void frame_decode(const laser_mb_decoder_t *decoder, laser_mb_reply_t *reply)
+{
+    const uint8_t *buf = decoder->buf;
+
+    memset(reply, 0, sizeof(*reply));
+    reply->func = buf[1] & ~LASER_MB_FUNC_ERROR;
+
+    if (buf[1] & LASER_MB_FUNC_ERROR)
+    {
+        reply->exception = buf[2];
+    }
+    else if (reply->func == LASER_MB_FUNC_READ)
+    {
+        reply->count = buf[2] / 2;
+        for (uint8_t i = 0; i < reply->count; i++)
+            reply->values[i] = (uint16_t)((buf[3 + 2 * i] << 8) | buf[4 + 2 * i]);
+    }
+    else
+    {
+        reply->reg = (uint16_t)((buf[2] << 8) | buf[3]);
+        reply->values[0] = (uint16_t)((buf[4] << 8) | buf[5]);
+        reply->count = 1;
+    }
+}
+
+// 丢弃第一个字节, 将剩余字节重新送入解码器以寻找下一个帧头
+static bool decoder_resync(laser_mb_decoder_t *decoder, laser_mb_reply_t *reply)
+{
+    uint8_t pending[sizeof(decoder->buf)];
+    uint8_t n = decoder->cnt - 1;
+    bool got = false;
+
+    memcpy(pending, decoder->buf + 1, n);
+    decoder->cnt = 0;
+    decoder->len = 0;
+    for (uint8_t i = 0; i < n; i++)
+    {
+        if (laser_mb_decoder_feed(decoder, pending[i], reply))
+            got = true;
+    }
+    return got;
+}
+
+bool laser_mb_decoder_feed(laser_mb_decoder_t *decoder, uint8_t byte, laser_mb_reply_t *reply)
+{
+    if (decoder->cnt == 0 && byte != decoder->addr)
+        return false;
+
+    decoder->buf[decoder->cnt++] = byte;
+
+    if (decoder->cnt <= 3 && !frame_length(decoder))
+        return decoder_resync(decoder, reply);
+
+    if (decoder->len == 0 || decoder->cnt < decoder->len)
+        return false;
+
+    uint16_t crc = laser_mb_crc16(decoder->buf, decoder->len - 2);
+    if (decoder->buf[decoder->len - 2] != (crc & 0xFF) || decoder->buf[decoder->len - 1] != (crc >> 8))
+    {
+        decoder->crc_errors++;
+        return decoder_resync(decoder, reply);
+    }
+
+    frame_decode(decoder, reply);
+    decoder->frames++;
+    decoder->cnt = 0;
+    decoder->len = 0;
+    return true;
+}
+
+uint32_t laser_mb_reply_ack(const laser_mb_reply_t *reply)
+{
+    uint8_t func = reply->exception != 0 ? (uint8_t)(reply->func | LASER_MB_FUNC_ERROR) : reply->func;
+    return ((uint32_t)func << 24) | ((uint32_t)reply->exception << 16) | reply->reg;
+}
+
+bool laser_mb_write_reg(const laser_mb_port_t *port, uint16_t reg, uint16_t value)
+{
+    uint8_t frame[LASER_MB_REQUEST_LEN];
+    uint8_t len = laser_mb_build_write(LASER_MB_ADDR_DEFAULT, reg, value, frame);
+    laser_mb_reply_t expect = {LASER_MB_FUNC_WRITE, 0, 0, reg, {value, 0}};
+    uint32_t ack;
+
+    for (uint8_t retry = 0; retry < LASER_MB_WRITE_RETRY; retry++)
+    {
+        port->clear();
+        port->send(frame, len);
+        if (port->wait(LASER_MB_WRITE_TIMEOUT_MS, &ack) && ack == laser_mb_reply_ack(&expect))
+            return true;
+    }
+    return false;
+}
+
+bool laser_mb_poll(const laser_mb_port_t *port, const uint8_t *request, uint8_t len, uint32_t timeout_ms)
+{
+    uint32_t ack;
+    port->clear();
+    port->send(request, len);
+    return port->wait(timeout_ms, &ack);
+}
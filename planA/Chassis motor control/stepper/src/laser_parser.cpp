@@ -0,0 +1,171 @@
+#include "laser_parser.h"
+
+#include <string.h>
+
+// 解析状态
+#define ST_LINE 0      // 行内普通字符
+#define ST_D 1         // 收到'd'
+#define ST_COLON 2     // 收到"d:", 跳过空格
+#define ST_D_VALUE 3   // "d:"之后的数字
+#define ST_PLAIN 4     // 纯数字行中的数字
+#define ST_PLAIN_END 5 // 纯数字行的数字已结束, 等待行尾
+
+#define MAX_DIGITS 6 // 超过此位数直接判为无效
+
+static bool is_digit(uint8_t c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// 纯数字行允许出现的非数字字符
+static bool is_plain_filler(uint8_t c)
+{
+    return c == ' ' || c == '\t' || c == 'm';
+}
+
+// 开始一个新行
+static void line_reset(laser_parser_t *parser)
+{
+    parser->state = ST_LINE;
+    parser->value = 0;
+    parser->digits = 0;
+    parser->line_plain = true;
+    parser->line_has_value = false;
+}
+
+// 累加一位数字
+static void value_push(laser_parser_t *parser, uint8_t c)
+{
+    if (parser->digits < MAX_DIGITS)
+        parser->value = parser->value * 10 + (c - '0');
+    parser->digits++;
+}
+
+// 数值结束, 检查范围并输出
+static bool value_finish(laser_parser_t *parser, uint32_t min_value, uint16_t *distance)
+{
+    bool ok = parser->digits > 0 && parser->digits <= MAX_DIGITS &&
+              parser->value >= min_value && parser->value <= LASER_PARSER_MAX_DISTANCE;
+
+    if (ok)
+    {
+        *distance = (uint16_t)parser->value;
+        parser->samples++;
+        parser->line_has_value = true;
+    }
+    else
+    {
+        parser->errors++;
+    }
+    parser->value = 0;
+    parser->digits = 0;
+    return ok;
+}
+
+// 处理行内普通字符
+static void line_char(laser_parser_t *parser, uint8_t c)
+{
+    if (c == 'd')
+    {
+        parser->line_plain = false;
+        parser->state = ST_D;
+    }
+    else if (is_digit(c) && parser->line_plain && !parser->line_has_value)
+    {
+        parser->value = 0;
+        parser->digits = 0;
+        value_push(parser, c);
+        parser->state = ST_PLAIN;
+    }
+    else
+    {
+        if (!is_plain_filler(c))
+            parser->line_plain = false;
+        parser->state = ST_LINE;
+    }
+}
+
+void laser_parser_reset(laser_parser_t *parser)
+{
+    memset(parser, 0, sizeof(*parser));
+    line_reset(parser);
+}
+
+bool laser_parser_feed(laser_parser_t *parser, uint8_t byte, uint16_t *distance)
+{
+    bool got = false;
+
+    // 行结束: 输出未结束的数值并开始新行
+    if (byte == '\n' || byte == '\r')
+    {
+        if (parser->state == ST_D_VALUE)
+            got = value_finish(parser, 0, distance);
+        else if ((parser->state == ST_PLAIN || parser->state == ST_PLAIN_END) && parser->line_plain)
+            got = value_finish(parser, 1, distance);
+        line_reset(parser);
+        return got;
+    }
+
+    switch (parser->state)
+    {
+    case ST_D:
+        if (byte == ':')
+            parser->state = ST_COLON;
+        else
+            line_char(parser, byte);
+        break;
+
+    case ST_COLON:
+        if (byte == ' ')
+            break;
+        if (is_digit(byte))
+        {
+            parser->value = 0;
+            parser->digits = 0;
+            value_push(parser, byte);
+            parser->state = ST_D_VALUE;
+        }
+        else
+        {
+            line_char(parser, byte);
+        }
+        break;
+
+    case ST_D_VALUE:
+        if (is_digit(byte))
+        {
+            value_push(parser, byte);
+        }
+        else
+        {
+            // 数字结束即输出, 不必等到行尾
+            got = value_finish(parser, 0, distance);
+            line_char(parser, byte);
+        }
+        break;
+
+    case ST_PLAIN:
+        if (is_digit(byte))
+            value_push(parser, byte);
+        else if (is_plain_filler(byte))
+            parser->state = ST_PLAIN_END;
+        else
+            line_char(parser, byte);
+        break;
+
+    case ST_PLAIN_END:
+        if (!is_plain_filler(byte))
+        {
+            // 一行出现多个数字或其他字符, 不是纯数字行
+            parser->line_plain = false;
+            line_char(parser, byte);
+        }
+        break;
+
+    default:
+        line_char(parser, byte);
+        break;
+    }
+
+    return got;
+}
@@ -1,4 +1,10 @@
 #include "laser_sensor.h"
+#include "laser_parser.h"
+#include "laser_modbus.h"
+#include "laser_filter.h"
+#include "distance_event.h"
+#include "metrics.h"
+#include "telemetry.h"
 
 // 引脚定义
 #define RX_PIN 18             // 传感器TXD连接到ESP32S3的RX
@@ -6,11 +12,37 @@
 #define SENSOR_SERIAL Serial2 // 使用ESP32S3的Serial2
 #define LED_PIN 2             // 板载LED引脚
 
-// 缓冲区定义
-#define RX_BUF_SIZE 64 // 减小缓冲区以节省内存
-static char g_rx_buf[RX_BUF_SIZE];
-static uint16_t g_rx_cnt = 0;
+static laser_parser_t g_parser;
 static uint8_t g_last_status = LASER_SENSOR_EOK;
+static Stream *g_log = NULL; // 打印提示的串口, NULL表示不打印
+
+// Modbus模式
+static volatile uint8_t g_mode = LASER_SENSOR_MODE_ASCII;    // 调用方设置的模式
+static volatile uint8_t g_rx_mode = LASER_SENSOR_MODE_ASCII; // 串口回调当前的解析方式, 切换期间可与g_mode不同
+static SemaphoreHandle_t g_mode_mutex = NULL;                // 保护g_mode和g_mb_task的启动/退出
+static laser_mb_decoder_t g_mb_decoder;
+static TaskHandle_t g_mb_task = NULL; // 查询任务, 收到应答时以通知值交给它(laser_mb_reply_ack)
+static uint32_t g_mb_timeouts = 0;    // 查询无应答次数
+
+// 最新样本, 由串口回调写入, 读取方加锁拷贝
+static laser_sample_t g_latest = {0, 0, 0};
+static portMUX_TYPE g_latest_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// 滤波器只在串口回调中更新, 输出快照和最新样本一起加锁发布
+static laser_filter_t g_filter;
+static laser_filtered_t g_filtered = {0, 0, 0, 0};
+static volatile bool g_filter_reset = false; // 参数修改后由回调重新初始化
+static laser_filter_config_t g_filter_config;
+
+// 运行指标
+static metrics_counter_t g_m_samples;      // 发布的样本数
+static metrics_counter_t g_m_parse_errors; // ASCII解析错误
+static metrics_counter_t g_m_crc_errors;   // Modbus应答CRC错误
+static metrics_counter_t g_m_timeouts;     // Modbus查询无应答
+static metrics_counter_t g_m_outliers;     // 被滤波器剔除的野值
+static metrics_gauge_t g_m_distance;       // 滤波后距离(mm)
+static metrics_histogram_t g_m_interval;   // 相邻样本间隔(ms)
+static const uint32_t g_interval_bounds[] = {5, 10, 20, 30, 50, 100, 200, 500};
 
 // 清空接收缓冲区
 static void uart_rx_restart(void)
@@ -19,7 +51,7 @@ static void uart_rx_restart(void)
     {
         SENSOR_SERIAL.read();
     }
-    g_rx_cnt = 0;
+    laser_parser_reset(&g_parser);
 }
 
 // 初始化LED指示灯
@@ -35,9 +67,176 @@ static void led_toggle(void)
     digitalWrite(LED_PIN, !digitalRead(LED_PIN));
 }
 
+// 发布一个新样本
+static void publish_sample(uint16_t distance)
+{
+    static uint32_t last_time = 0;
+    uint32_t now = millis();
+    laser_filtered_t filtered;
+
+    if (g_filter_reset)
+    {
+        g_filter_reset = false;
+        laser_filter_init(&g_filter, &g_filter_config);
+    }
+    bool accepted = laser_filter_update(&g_filter, distance, now);
+    laser_filter_get(&g_filter, now, &filtered);
+
+    portENTER_CRITICAL(&g_latest_mux);
+    g_latest.distance = distance;
+    g_latest.timestamp = now;
+    g_latest.seq++;
+    g_filtered = filtered;
+    portEXIT_CRITICAL(&g_latest_mux);
+
+    metrics_counter_inc(&g_m_samples);
+    if (last_time != 0)
+        metrics_histogram_observe(&g_m_interval, now - last_time);
+    last_time = now;
+
+    // 野值不参与阈值判断
+    if (accepted)
+    {
+        metrics_gauge_set(&g_m_distance, (int32_t)filtered.distance);
+        distance_event_feed(DISTANCE_SOURCE_LASER, filtered.distance);
+    }
+    else
+    {
+        metrics_counter_inc(&g_m_outliers);
+    }
+}
+
+// 处理一帧Modbus应答
+static void modbus_on_reply(const laser_mb_reply_t *reply)
+{
+    if (reply->func == LASER_MB_FUNC_READ && reply->exception == 0 && reply->count >= 1)
+    {
+        if (reply->values[0] <= LASER_PARSER_MAX_DISTANCE)
+        {
+            publish_sample(reply->values[0]);
+            led_toggle();
+        }
+    }
+    if (g_mb_task != NULL)
+        xTaskNotify(g_mb_task, laser_mb_reply_ack(reply), eSetValueWithOverwrite);
+}
+
+// 串口接收回调, 在串口事件任务中运行, 处理已到达的全部字节
+static void uart_rx_callback(void)
+{
+    uint16_t distance;
+    laser_mb_reply_t reply;
+    uint32_t parse_errors = g_parser.errors;
+    uint32_t crc_errors = g_mb_decoder.crc_errors;
+    while (SENSOR_SERIAL.available())
+    {
+        uint8_t byte = (uint8_t)SENSOR_SERIAL.read();
+        if (g_rx_mode == LASER_SENSOR_MODE_MODBUS)
+        {
+            if (laser_mb_decoder_feed(&g_mb_decoder, byte, &reply))
+                modbus_on_reply(&reply);
+        }
+        else if (laser_parser_feed(&g_parser, byte, &distance))
+        {
+            publish_sample(distance);
+            led_toggle(); // 每解析出一个样本切换LED
+        }
+    }
+
+    // 解析器只在本回调中累加错误计数, 差值即为本次新增(切换模式时复位, 差值为负则忽略)
+    if (g_parser.errors > parse_errors)
+        metrics_counter_add(&g_m_parse_errors, g_parser.errors - parse_errors);
+    if (g_mb_decoder.crc_errors > crc_errors)
+        metrics_counter_add(&g_m_crc_errors, g_mb_decoder.crc_errors - crc_errors);
+}
+
+// 查询任务的串口和任务通知
+static void mb_send(const uint8_t *frame, uint8_t len)
+{
+    SENSOR_SERIAL.write(frame, len);
+}
+
+static void mb_clear(void)
+{
+    xTaskNotifyWait(0, UINT32_MAX, NULL, 0);
+}
+
+static bool mb_wait(uint32_t timeout_ms, uint32_t *ack)
+{
+    return xTaskNotifyWait(0, UINT32_MAX, ack, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+static const laser_mb_port_t g_mb_port = {mb_send, mb_clear, mb_wait};
+
+// 写一个配置寄存器并等待回显确认
+static bool modbus_write_reg(uint16_t reg, uint16_t value)
+{
+    if (laser_mb_write_reg(&g_mb_port, reg, value))
+        return true;
+    if (g_log != NULL)
+        g_log->printf("[LASER] Modbus write reg 0x%04X failed\n", reg);
+    return false;
+}
+
+// 配置传感器为Modbus接口、高速测量、最高输出频率
+static void modbus_configure(void)
+{
+#if LASER_SENSOR_MODBUS_CONFIG
+    modbus_write_reg(LASER_MB_REG_WORKMODE, LASER_MB_WORKMODE_MODBUS);
+    modbus_write_reg(LASER_MB_REG_MEASMODE, LASER_MB_MEASMODE_HIGH_SPEED);
+    modbus_write_reg(LASER_MB_REG_OUTFREQ, LASER_MB_OUTFREQ_MAX);
+    if (g_log != NULL)
+        g_log->println("[LASER] Modbus mode configured");
+#endif
+}
+
+// Modbus查询任务: 配置传感器后按固定周期读取距离寄存器, 切回ASCII模式后退出
+static void modbus_task(void *pvParameters)
+{
+    uint8_t request[LASER_MB_REQUEST_LEN];
+    uint8_t len = laser_mb_build_read(LASER_MB_ADDR_DEFAULT, LASER_MB_REG_DISTANCE, 1, request);
+
+    modbus_configure();
+    while (1)
+    {
+        TickType_t last_wake = xTaskGetTickCount();
+        while (g_mode == LASER_SENSOR_MODE_MODBUS)
+        {
+            if (!laser_mb_poll(&g_mb_port, request, len, LASER_SENSOR_MODBUS_POLL_MS))
+            {
+                g_mb_timeouts++;
+                metrics_counter_inc(&g_m_timeouts);
+            }
+            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(LASER_SENSOR_MODBUS_POLL_MS));
+        }
+
+        // 切回ASCII模式: 恢复传感器主动输出, 写配置期间回调仍按Modbus解析应答
+#if LASER_SENSOR_MODBUS_CONFIG
+        modbus_write_reg(LASER_MB_REG_WORKMODE, LASER_MB_WORKMODE_ASCII);
+#endif
+        xSemaphoreTake(g_mode_mutex, portMAX_DELAY);
+        if (g_mode == LASER_SENSOR_MODE_ASCII)
+        {
+            laser_parser_reset(&g_parser);
+            g_rx_mode = LASER_SENSOR_MODE_ASCII;
+            g_mb_task = NULL;
+            xSemaphoreGive(g_mode_mutex);
+            break;
+        }
+        xSemaphoreGive(g_mode_mutex);
+        modbus_configure(); // 恢复期间又切回了Modbus模式
+    }
+
+    if (g_log != NULL)
+        g_log->println("[LASER] ASCII mode restored");
+    vTaskDelete(NULL);
+}
+
 // 初始化激光传感器
-void laser_sensor_init(void)
+void laser_sensor_init(Stream *log)
 {
+    g_log = log;
+
     // 初始化LED
     led_init();
 
@@ -47,6 +246,23 @@ void laser_sensor_init(void)
 
     // 清空可能的缓存数据
     uart_rx_restart();
+    g_mode_mutex = xSemaphoreCreateMutex();
+    laser_filter_default_config(&g_filter_config);
+    laser_filter_init(&g_filter, &g_filter_config);
+
+    metrics_register_counter(&g_m_samples, "laser.samples");
+    metrics_register_counter(&g_m_parse_errors, "laser.parse_errors");
+    metrics_register_counter(&g_m_crc_errors, "laser.crc_errors");
+    metrics_register_counter(&g_m_timeouts, "laser.timeouts");
+    metrics_register_counter(&g_m_outliers, "laser.outliers");
+    metrics_register_gauge(&g_m_distance, "laser.distance_mm");
+    metrics_register_histogram(&g_m_interval, "laser.interval_ms", g_interval_bounds,
+                               sizeof(g_interval_bounds) / sizeof(g_interval_bounds[0]));
+    telemetry_register("laser.raw_mm", TELEMETRY_TYPE_U16, &g_latest.distance, 1);
+    telemetry_register("laser.filtered_mm", TELEMETRY_TYPE_FLOAT, &g_filtered.distance, 10);
+
+    // 数据到达(FIFO阈值或接收空闲超时)时由串口事件任务调用回调
+    SENSOR_SERIAL.onReceive(uart_rx_callback);
 
     // 测试LED指示灯
     for (int i = 0; i < 3; i++)
@@ -57,7 +273,46 @@ void laser_sensor_init(void)
         delay(50);
     }
 
-    Serial.println("[LASER] Initialization complete");
+    if (g_log != NULL)
+        g_log->println("[LASER] Initialization complete");
+}
+
+// 获取最新样本
+bool laser_sensor_get_latest(laser_sample_t *sample)
+{
+    portENTER_CRITICAL(&g_latest_mux);
+    *sample = g_latest;
+    portEXIT_CRITICAL(&g_latest_mux);
+    return sample->seq != 0;
+}
+
+// 获取滤波后的距离
+bool laser_sensor_get_filtered(laser_filtered_t *filtered)
+{
+    portENTER_CRITICAL(&g_latest_mux);
+    *filtered = g_filtered;
+    portEXIT_CRITICAL(&g_latest_mux);
+
+    // 新鲜度按读取时刻重新判断
+    filtered->flags &= ~LASER_FILTER_FLAG_FRESH;
+    if ((filtered->flags & LASER_FILTER_FLAG_VALID) &&
+        millis() - filtered->timestamp <= g_filter_config.stale_ms)
+    {
+        filtered->flags |= LASER_FILTER_FLAG_FRESH;
+    }
+    return (filtered->flags & LASER_FILTER_FLAG_FRESH) != 0;
+}
+
+// 修改滤波参数
+uint8_t laser_sensor_set_filter(const laser_filter_config_t *config)
+{
+    if (!laser_filter_config_check(config))
+    {
+        return LASER_SENSOR_EINVAL;
+    }
+    g_filter_config = *config;
+    g_filter_reset = true; // 下一个样本到达时生效
+    return LASER_SENSOR_EOK;
 }
 
 // 读取传感器距离
@@ -70,110 +325,91 @@ uint8_t laser_sensor_read(uint16_t *distance)
     }
 
     static uint32_t last_success_time = 0;
+    laser_sample_t sample;
 
-    // 清空接收缓冲区
-    uart_rx_restart();
-    memset(g_rx_buf, 0, RX_BUF_SIZE);
-
-    // 减少等待时间，使用更高效的方式接收数据
-    uint32_t start_time = millis();
-    bool data_received = false;
-    g_rx_cnt = 0;
-
-    while ((millis() - start_time) < 300)
-    { // 减少超时时间
-        if (SENSOR_SERIAL.available())
+    // 没有数据或最新样本已过期，返回超时错误
+    if (!laser_sensor_get_latest(&sample) || (millis() - sample.timestamp) > LASER_SENSOR_MAX_AGE_MS)
+    {
+        // 偶尔打印错误信息
+        static uint32_t last_error_time = 0;
+        if (g_log != NULL && millis() - last_error_time > 5000)
         {
-            while (SENSOR_SERIAL.available() && g_rx_cnt < RX_BUF_SIZE - 1)
-            {
-                g_rx_buf[g_rx_cnt++] = SENSOR_SERIAL.read();
-                data_received = true;
-            }
-
-            if (data_received)
-            {
-                // 收到数据后等待短暂时间看是否有更多数据
-                delay(30);
-                if (!SENSOR_SERIAL.available())
-                {
-                    break;
-                }
-            }
+            if (g_mode == LASER_SENSOR_MODE_MODBUS)
+                g_log->printf("[LASER] No fresh data, frames: %u, CRC errors: %u, timeouts: %u\n",
+                              g_mb_decoder.frames, g_mb_decoder.crc_errors, g_mb_timeouts);
+            else
+                g_log->printf("[LASER] No fresh data, samples: %u, parse errors: %u\n",
+                              g_parser.samples, g_parser.errors);
+            last_error_time = millis();
         }
-        delay(2); // 减少循环延迟
+        g_last_status = LASER_SENSOR_ETIMEOUT;
+        return g_last_status;
     }
 
-    // 确保字符串结束
-    g_rx_buf[g_rx_cnt] = '\0';
+    *distance = sample.distance;
 
-    // 如果没有接收到数据，返回超时错误
-    if (g_rx_cnt == 0)
+    // 只在值变化或间隔较长时输出调试信息
+    static uint16_t last_distance = 0;
+    if (*distance != last_distance || (millis() - last_success_time) > 3000)
     {
-        g_last_status = LASER_SENSOR_ETIMEOUT;
-        return g_last_status;
+        if (g_log != NULL)
+            g_log->printf("[LASER] Distance: %u mm\n", *distance);
+        last_distance = *distance;
+        last_success_time = millis();
     }
+    g_last_status = LASER_SENSOR_EOK;
+    return g_last_status;
+}
 
-    // 直接查找"d:"后面的数字
-    char *d_pos = strstr(g_rx_buf, "d:");
-    if (d_pos != NULL)
+// 切换接口模式
+uint8_t laser_sensor_set_mode(uint8_t mode)
+{
+    if (mode != LASER_SENSOR_MODE_ASCII && mode != LASER_SENSOR_MODE_MODBUS)
     {
-        d_pos += 2; // 跳过"d:"
-        while (*d_pos == ' ' && *d_pos != '\0')
-            d_pos++;
-
-        if (isdigit(*d_pos))
-        {
-            *distance = atoi(d_pos);
-
-            // 检查数据范围合理性
-            if (*distance > 10000)
-            {
-                g_last_status = LASER_SENSOR_ERANGE;
-                return g_last_status;
-            }
+        return LASER_SENSOR_EINVAL;
+    }
 
-            // 只在值变化或间隔较长时输出调试信息
-            static uint16_t last_distance = 0;
-            if (*distance != last_distance || (millis() - last_success_time) > 3000)
-            {
-                Serial.printf("[LASER] Distance: %u mm\n", *distance);
-                last_distance = *distance;
-                last_success_time = millis();
-            }
-            led_toggle(); // 成功读取后切换LED
-            g_last_status = LASER_SENSOR_EOK;
-            return g_last_status;
-        }
+    if (g_mode_mutex == NULL)
+    {
+        return LASER_SENSOR_ERROR; // 尚未初始化
     }
 
-    // 备用解析方式
-    char *ptr = g_rx_buf;
-    while (*ptr)
+    uint8_t ret = LASER_SENSOR_EOK;
+    xSemaphoreTake(g_mode_mutex, portMAX_DELAY);
+    if (mode == LASER_SENSOR_MODE_MODBUS && g_mb_task == NULL)
     {
-        if (isdigit(*ptr) && (ptr == g_rx_buf || !isdigit(*(ptr - 1))))
+        laser_mb_decoder_reset(&g_mb_decoder, LASER_MB_ADDR_DEFAULT);
+        g_rx_mode = LASER_SENSOR_MODE_MODBUS;
+        g_mode = LASER_SENSOR_MODE_MODBUS;
+        if (xTaskCreatePinnedToCore(modbus_task, "LaserModbus", 3000, NULL, 2, &g_mb_task, 0) != pdPASS)
         {
-            *distance = atoi(ptr);
-            if (*distance > 0 && *distance < 10000)
-            {
-                Serial.printf("[LASER] Distance (backup method): %u mm\n", *distance);
-                led_toggle();
-                g_last_status = LASER_SENSOR_EOK;
-                return g_last_status;
-            }
+            g_mode = LASER_SENSOR_MODE_ASCII;
+            g_rx_mode = LASER_SENSOR_MODE_ASCII;
+            g_mb_task = NULL;
+            ret = LASER_SENSOR_ERROR;
         }
-        ptr++;
     }
-
-    // 偶尔打印错误信息并显示收到的数据
-    static uint32_t last_error_time = 0;
-    if (millis() - last_error_time > 5000)
+    else
+    {
+        // 查询任务还在运行时只修改请求的模式: 任务在下一个周期切回ASCII,
+        // 或在恢复ASCII配置后发现又切回了Modbus而继续查询
+        g_mode = mode;
+    }
+    xSemaphoreGive(g_mode_mutex);
+    if (ret != LASER_SENSOR_EOK)
     {
-        Serial.printf("[LASER] Parse error, data: %s\n", g_rx_buf);
-        last_error_time = millis();
+        return ret;
     }
 
-    g_last_status = LASER_SENSOR_ERROR;
-    return g_last_status;
+    if (g_log != NULL)
+        g_log->printf("[LASER] Mode set to: %s\n", mode == LASER_SENSOR_MODE_MODBUS ? "Modbus" : "ASCII");
+    return LASER_SENSOR_EOK;
+}
+
+// 获取当前接口模式
+uint8_t laser_sensor_get_mode(void)
+{
+    return g_mode;
 }
 
 // 设置LED状态
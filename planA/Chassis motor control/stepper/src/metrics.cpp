@@ -0,0 +1,322 @@
+#include "metrics.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+// 登记表项, 先占位再填写, 填写完成后置ready, 读取方跳过未就绪的表项
+typedef struct
+{
+    uint8_t type;
+    const char *name;
+    void *metric;
+    volatile bool ready;
+} metrics_entry_t;
+
+static metrics_entry_t g_entries[METRICS_MAX];
+static volatile uint8_t g_reserved = 0; // 已占用的表项数
+
+// 计算CRC16
+uint16_t metrics_crc16(const uint8_t *data, size_t len, uint16_t crc)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// 登记一个指标
+static uint8_t metrics_register(uint8_t type, void *metric, const char *name)
+{
+    if (metric == NULL || name == NULL || name[0] == '\0' || strlen(name) > METRICS_NAME_MAX)
+    {
+        return METRICS_EINVAL;
+    }
+
+    uint8_t count = __atomic_load_n(&g_reserved, __ATOMIC_ACQUIRE);
+    for (uint8_t i = 0; i < count && i < METRICS_MAX; i++)
+    {
+        if (g_entries[i].metric == metric)
+            return METRICS_EEXIST;
+    }
+
+    // 原子占位, 多个任务同时登记时各自得到不同的表项
+    uint8_t index = __atomic_fetch_add(&g_reserved, 1, __ATOMIC_ACQ_REL);
+    if (index >= METRICS_MAX)
+    {
+        __atomic_store_n(&g_reserved, METRICS_MAX, __ATOMIC_RELEASE);
+        return METRICS_EFULL;
+    }
+    g_entries[index].type = type;
+    g_entries[index].name = name;
+    g_entries[index].metric = metric;
+    __atomic_store_n(&g_entries[index].ready, true, __ATOMIC_RELEASE);
+    return METRICS_EOK;
+}
+
+// 登记计数器
+uint8_t metrics_register_counter(metrics_counter_t *counter, const char *name)
+{
+    return metrics_register(METRICS_TYPE_COUNTER, counter, name);
+}
+
+// 登记瞬时值
+uint8_t metrics_register_gauge(metrics_gauge_t *gauge, const char *name)
+{
+    return metrics_register(METRICS_TYPE_GAUGE, gauge, name);
+}
+
+// 登记直方图
+uint8_t metrics_register_histogram(metrics_histogram_t *hist, const char *name,
+                                   const uint32_t *bounds, uint8_t bound_num)
+{
+    if (hist == NULL || bounds == NULL || bound_num < 1 || bound_num > METRICS_HIST_BOUNDS_MAX)
+    {
+        return METRICS_EINVAL;
+    }
+    for (uint8_t i = 1; i < bound_num; i++)
+    {
+        if (bounds[i] <= bounds[i - 1])
+            return METRICS_EINVAL;
+    }
+    hist->bounds = bounds;
+    hist->bound_num = bound_num;
+    return metrics_register(METRICS_TYPE_HISTOGRAM, hist, name);
+}
+
+// 单写者递增: 只有一个任务写, 读改写不会丢失, 32位存储对读取方是原子的
+static inline void single_writer_add(volatile uint32_t *value, uint32_t n)
+{
+    __atomic_store_n(value, __atomic_load_n(value, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+}
+
+// 直方图记录一个值
+void metrics_histogram_observe(metrics_histogram_t *hist, uint32_t value)
+{
+    uint8_t bucket = 0;
+    while (bucket < hist->bound_num && value > hist->bounds[bucket])
+    {
+        bucket++;
+    }
+    single_writer_add(&hist->buckets[bucket], 1);
+    single_writer_add(&hist->sum, value);
+    single_writer_add(&hist->count, 1);
+}
+
+// 已登记的指标个数(只计算连续就绪的表项, 保证编码顺序稳定)
+uint8_t metrics_count(void)
+{
+    uint8_t reserved = __atomic_load_n(&g_reserved, __ATOMIC_ACQUIRE);
+    uint8_t count = 0;
+    while (count < reserved && count < METRICS_MAX && __atomic_load_n(&g_entries[count].ready, __ATOMIC_ACQUIRE))
+    {
+        count++;
+    }
+    return count;
+}
+
+// 帧编码: 写入位置超出缓冲区后只记录长度和CRC, 结束时判断是否放得下
+typedef struct
+{
+    uint8_t *buf;
+    size_t size;
+    size_t pos;
+    uint16_t crc; // 写入字节的累计CRC, 用于计算结构校验
+} frame_writer_t;
+
+static void put_u8(frame_writer_t *w, uint8_t value)
+{
+    if (w->pos < w->size)
+        w->buf[w->pos] = value;
+    w->pos++;
+    w->crc = metrics_crc16(&value, 1, w->crc);
+}
+
+static void put_u16(frame_writer_t *w, uint16_t value)
+{
+    put_u8(w, (uint8_t)value);
+    put_u8(w, (uint8_t)(value >> 8));
+}
+
+static void put_u32(frame_writer_t *w, uint32_t value)
+{
+    put_u16(w, (uint16_t)value);
+    put_u16(w, (uint16_t)(value >> 16));
+}
+
+// 写帧头, 负载长度在结束时回填
+static void frame_begin(frame_writer_t *w, uint8_t *buf, size_t size, uint8_t kind)
+{
+    w->buf = buf;
+    w->size = size;
+    w->pos = 0;
+    w->crc = 0xFFFF;
+    put_u8(w, METRICS_FRAME_SYNC0);
+    put_u8(w, METRICS_FRAME_SYNC1);
+    put_u8(w, kind);
+    put_u16(w, 0);
+}
+
+// 回填长度并追加CRC, 返回帧长度
+static size_t frame_end(frame_writer_t *w)
+{
+    size_t payload = w->pos - 5;
+    if (w->pos + 2 > w->size || payload > 0xFFFF)
+        return 0;
+    w->buf[3] = (uint8_t)payload;
+    w->buf[4] = (uint8_t)(payload >> 8);
+    put_u16(w, metrics_crc16(w->buf + 2, w->pos - 2, 0xFFFF));
+    return w->pos;
+}
+
+// 编码结构帧负载
+static void write_schema(frame_writer_t *w, uint8_t count)
+{
+    put_u8(w, METRICS_FRAME_VERSION);
+    put_u8(w, count);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const metrics_entry_t *entry = &g_entries[i];
+        uint8_t bound_num = 0;
+        const uint32_t *bounds = NULL;
+        if (entry->type == METRICS_TYPE_HISTOGRAM)
+        {
+            bounds = ((const metrics_histogram_t *)entry->metric)->bounds;
+            bound_num = ((const metrics_histogram_t *)entry->metric)->bound_num;
+        }
+        put_u8(w, entry->type);
+        put_u8(w, bound_num);
+        for (uint8_t b = 0; b < bound_num; b++)
+            put_u32(w, bounds[b]);
+
+        uint8_t len = (uint8_t)strlen(entry->name);
+        put_u8(w, len);
+        for (uint8_t c = 0; c < len; c++)
+            put_u8(w, (uint8_t)entry->name[c]);
+    }
+}
+
+// 结构帧负载的CRC, 登记完成后不再变化, 按指标数缓存
+static uint16_t schema_id(uint8_t count)
+{
+    static uint8_t cached_count = 0xFF;
+    static uint16_t cached_id = 0;
+    if (count != cached_count)
+    {
+        frame_writer_t w = {NULL, 0, 0, 0xFFFF}; // 只计算CRC, 不写入
+        write_schema(&w, count);
+        cached_id = w.crc;
+        cached_count = count;
+    }
+    return cached_id;
+}
+
+// 编码结构帧
+size_t metrics_encode_schema(uint8_t *buf, size_t size)
+{
+    frame_writer_t w;
+    if (buf == NULL)
+        return 0;
+    frame_begin(&w, buf, size, METRICS_FRAME_SCHEMA);
+    write_schema(&w, metrics_count());
+    return frame_end(&w);
+}
+
+// 编码数值帧
+size_t metrics_encode_values(uint8_t *buf, size_t size, uint32_t time_ms)
+{
+    frame_writer_t w;
+    uint8_t count = metrics_count();
+    if (buf == NULL)
+        return 0;
+
+    frame_begin(&w, buf, size, METRICS_FRAME_VALUES);
+    put_u8(&w, METRICS_FRAME_VERSION);
+    put_u16(&w, schema_id(count));
+    put_u32(&w, time_ms);
+    put_u8(&w, count);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const metrics_entry_t *entry = &g_entries[i];
+        if (entry->type == METRICS_TYPE_HISTOGRAM)
+        {
+            metrics_histogram_t *hist = (metrics_histogram_t *)entry->metric;
+            put_u32(&w, __atomic_load_n(&hist->count, __ATOMIC_RELAXED));
+            put_u32(&w, __atomic_load_n(&hist->sum, __ATOMIC_RELAXED));
+            for (uint8_t b = 0; b <= hist->bound_num; b++)
+                put_u32(&w, __atomic_load_n(&hist->buckets[b], __ATOMIC_RELAXED));
+        }
+        else
+        {
+            // 计数器和瞬时值都是4字节, 按位原样输出
+            put_u32(&w, __atomic_load_n((volatile uint32_t *)entry->metric, __ATOMIC_RELAXED));
+        }
+    }
+    return frame_end(&w);
+}
+
+// 追加格式化文本, 超出缓冲区后只累计长度
+static void json_append(char *buf, size_t size, size_t *pos, const char *format, ...)
+    __attribute__((format(printf, 4, 5)));
+
+static void json_append(char *buf, size_t size, size_t *pos, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(*pos < size ? buf + *pos : NULL, *pos < size ? size - *pos : 0, format, args);
+    va_end(args);
+    if (len > 0)
+        *pos += (size_t)len;
+}
+
+// 格式化JSON
+size_t metrics_format_json(char *buf, size_t size, uint32_t time_ms)
+{
+    size_t pos = 0;
+    uint8_t count = metrics_count();
+    if (buf == NULL || size == 0)
+        return 0;
+
+    json_append(buf, size, &pos, "{\"time_ms\":%lu,\"metrics\":{", (unsigned long)time_ms);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const metrics_entry_t *entry = &g_entries[i];
+        json_append(buf, size, &pos, "%s\"%s\":", i ? "," : "", entry->name);
+        if (entry->type == METRICS_TYPE_COUNTER)
+        {
+            json_append(buf, size, &pos, "%lu",
+                        (unsigned long)__atomic_load_n(&((metrics_counter_t *)entry->metric)->value, __ATOMIC_RELAXED));
+        }
+        else if (entry->type == METRICS_TYPE_GAUGE)
+        {
+            json_append(buf, size, &pos, "%ld",
+                        (long)__atomic_load_n(&((metrics_gauge_t *)entry->metric)->value, __ATOMIC_RELAXED));
+        }
+        else
+        {
+            metrics_histogram_t *hist = (metrics_histogram_t *)entry->metric;
+            json_append(buf, size, &pos, "{\"count\":%lu,\"sum\":%lu,\"bounds\":[",
+                        (unsigned long)__atomic_load_n(&hist->count, __ATOMIC_RELAXED),
+                        (unsigned long)__atomic_load_n(&hist->sum, __ATOMIC_RELAXED));
+            for (uint8_t b = 0; b < hist->bound_num; b++)
+                json_append(buf, size, &pos, "%s%lu", b ? "," : "", (unsigned long)hist->bounds[b]);
+            json_append(buf, size, &pos, "],\"buckets\":[");
+            for (uint8_t b = 0; b <= hist->bound_num; b++)
+                json_append(buf, size, &pos, "%s%lu", b ? "," : "",
+                            (unsigned long)__atomic_load_n(&hist->buckets[b], __ATOMIC_RELAXED));
+            json_append(buf, size, &pos, "]}");
+        }
+    }
+    json_append(buf, size, &pos, "}}");
+
+    if (pos >= size)
+    {
+        buf[0] = '\0';
+        return 0;
+    }
+    return pos;
+}
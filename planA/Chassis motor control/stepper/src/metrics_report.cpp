@@ -0,0 +1,106 @@
+#include "metrics_report.h"
+
+#define METRICS_REPORT_BUF_SIZE 2048 // 最长的JSON快照
+
+static Stream *g_port = NULL;
+static uint32_t g_period_ms = 1000;
+static uint8_t g_format = METRICS_REPORT_BINARY;
+static TaskHandle_t g_task = NULL; // 任务退出前在g_task_mux内清空, 之后不再通知它
+static portMUX_TYPE g_task_mux = portMUX_INITIALIZER_UNLOCKED;
+static volatile bool g_running = false;
+static uint8_t g_buf[METRICS_REPORT_BUF_SIZE]; // 只由上报任务使用
+
+// 上报任务: 按周期编码快照并写出
+static void metrics_report_task(void *pvParameters)
+{
+    uint32_t frames = 0;
+    TickType_t next_wake = xTaskGetTickCount();
+
+    while (g_running)
+    {
+        size_t len;
+        if (g_format == METRICS_REPORT_JSON)
+        {
+            len = metrics_format_json((char *)g_buf, sizeof(g_buf) - 1, millis());
+            if (len > 0)
+                g_buf[len++] = '\n';
+        }
+        else
+        {
+            if (frames % METRICS_REPORT_SCHEMA_EVERY == 0)
+            {
+                len = metrics_encode_schema(g_buf, sizeof(g_buf));
+                if (len > 0)
+                    g_port->write(g_buf, len);
+            }
+            len = metrics_encode_values(g_buf, sizeof(g_buf), millis());
+        }
+
+        if (len > 0)
+            g_port->write(g_buf, len);
+        else if (frames == 0)
+            g_port->println("[METRICS] Report buffer too small");
+        frames++;
+
+        // 等到下一个周期; metrics_report_stop的通知可提前唤醒, 不必等满一个周期
+        next_wake += pdMS_TO_TICKS(g_period_ms);
+        TickType_t now = xTaskGetTickCount();
+        if ((int32_t)(next_wake - now) > 0)
+            ulTaskNotifyTake(pdTRUE, next_wake - now);
+        else
+            next_wake = now; // 写出太慢, 不补发错过的周期
+    }
+
+    portENTER_CRITICAL(&g_task_mux);
+    g_task = NULL;
+    portEXIT_CRITICAL(&g_task_mux);
+    vTaskDelete(NULL);
+}
+
+// 启动指标上报
+uint8_t metrics_report_start(Stream *port, uint32_t period_ms, uint8_t format)
+{
+    if (port == NULL || period_ms == 0 || (format != METRICS_REPORT_BINARY && format != METRICS_REPORT_JSON))
+    {
+        return METRICS_EINVAL;
+    }
+
+    // 已在运行, 或上一次停止超时、任务还没有退出时不能再建一个
+    if (g_running || g_task != NULL)
+    {
+        return METRICS_EINVAL;
+    }
+
+    // 提示在第一帧之前写出, 不与二进制帧交错
+    port->printf("[METRICS] Reporting %u metrics every %lu ms (%s)\n", metrics_count(),
+                 (unsigned long)period_ms, format == METRICS_REPORT_JSON ? "JSON" : "binary");
+    g_port = port;
+    g_period_ms = period_ms;
+    g_format = format;
+    g_running = true;
+    // 句柄在任务开始运行前写入g_task
+    if (xTaskCreatePinnedToCore(metrics_report_task, "Metrics", 3000, NULL, 1, &g_task, 0) != pdPASS)
+    {
+        g_running = false;
+        g_task = NULL;
+        return METRICS_ERROR;
+    }
+    return METRICS_EOK;
+}
+
+// 停止指标上报: 唤醒任务并等它退出, 返回后可以重新启动
+void metrics_report_stop(void)
+{
+    g_running = false;
+    for (uint32_t waited = 0; waited < METRICS_REPORT_STOP_TIMEOUT_MS; waited++)
+    {
+        portENTER_CRITICAL(&g_task_mux);
+        TaskHandle_t task = g_task;
+        if (task != NULL)
+            xTaskNotifyGive(task);
+        portEXIT_CRITICAL(&g_task_mux);
+        if (task == NULL)
+            return;
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+}
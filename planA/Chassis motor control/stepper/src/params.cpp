@@ -0,0 +1,506 @@
+#include "params.h"
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PARAMS_LINE_MAX 128 // 文本中一行的最大长度
+
+// 登记表, 先占位再填写, 填写完成后置ready(与metrics登记表相同)
+// 范围和默认值用double保存, int32和float都能精确表示
+typedef struct
+{
+    const char *name;
+    uint8_t type;
+    volatile void *ptr;
+    double min;
+    double max;
+    double def;
+    volatile bool ready;
+} params_entry_t;
+
+static params_entry_t g_params[PARAMS_MAX];
+static volatile uint8_t g_reserved = 0;
+
+// 已登记的参数数(只计算连续就绪的表项)
+uint8_t params_count(void)
+{
+    uint8_t reserved = __atomic_load_n(&g_reserved, __ATOMIC_ACQUIRE);
+    uint8_t count = 0;
+    while (count < reserved && count < PARAMS_MAX && __atomic_load_n(&g_params[count].ready, __ATOMIC_ACQUIRE))
+    {
+        count++;
+    }
+    return count;
+}
+
+static params_entry_t *find(const char *name)
+{
+    uint8_t count = params_count();
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (strcmp(g_params[i].name, name) == 0)
+            return &g_params[i];
+    }
+    return NULL;
+}
+
+static double read_value(const params_entry_t *p)
+{
+    if (p->type == PARAMS_TYPE_INT)
+        return *(volatile int32_t *)p->ptr;
+    return *(volatile float *)p->ptr;
+}
+
+static void write_value(params_entry_t *p, double value)
+{
+    if (p->type == PARAMS_TYPE_INT)
+        *(volatile int32_t *)p->ptr = (int32_t)value;
+    else
+        *(volatile float *)p->ptr = (float)value;
+}
+
+// 与默认值不同的参数数
+uint8_t params_changed_count(void)
+{
+    uint8_t count = params_count();
+    uint8_t changed = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (read_value(&g_params[i]) != g_params[i].def)
+            changed++;
+    }
+    return changed;
+}
+
+// 登记参数
+static uint8_t params_add(const char *name, uint8_t type, volatile void *ptr, double min, double max, double value)
+{
+    if (name == NULL || name[0] == '\0' || strlen(name) > PARAMS_NAME_MAX || ptr == NULL || !(min <= max))
+    {
+        return PARAMS_EINVAL;
+    }
+    for (const char *c = name; *c != '\0'; c++)
+    {
+        if (isspace((unsigned char)*c) || *c == '=' || *c == '#')
+            return PARAMS_EINVAL; // 文本格式中的分隔符
+    }
+
+    uint8_t count = __atomic_load_n(&g_reserved, __ATOMIC_ACQUIRE);
+    for (uint8_t i = 0; i < count && i < PARAMS_MAX; i++)
+    {
+        if (g_params[i].ptr == ptr || (g_params[i].name != NULL && strcmp(g_params[i].name, name) == 0))
+            return PARAMS_EEXIST;
+    }
+    if (value < min || value > max)
+    {
+        return PARAMS_ERANGE;
+    }
+
+    uint8_t index = __atomic_fetch_add(&g_reserved, 1, __ATOMIC_ACQ_REL);
+    if (index >= PARAMS_MAX)
+    {
+        __atomic_store_n(&g_reserved, PARAMS_MAX, __ATOMIC_RELEASE);
+        return PARAMS_EFULL;
+    }
+    g_params[index].name = name;
+    g_params[index].type = type;
+    g_params[index].ptr = ptr;
+    g_params[index].min = min;
+    g_params[index].max = max;
+    g_params[index].def = value;
+    __atomic_store_n(&g_params[index].ready, true, __ATOMIC_RELEASE);
+    return PARAMS_EOK;
+}
+
+// 登记整数参数
+uint8_t params_register_int(const char *name, volatile int32_t *ptr, int32_t min, int32_t max)
+{
+    return params_add(name, PARAMS_TYPE_INT, ptr, min, max, ptr != NULL ? *ptr : 0);
+}
+
+// 登记浮点参数
+uint8_t params_register_float(const char *name, volatile float *ptr, float min, float max)
+{
+    return params_add(name, PARAMS_TYPE_FLOAT, ptr, min, max, ptr != NULL ? *ptr : 0.0f);
+}
+
+// 解析值的文本, 整数参数要求整个文本是整数
+static uint8_t parse_value(const params_entry_t *p, const char *text, double *value)
+{
+    char *end;
+    errno = 0;
+    if (p->type == PARAMS_TYPE_INT)
+        *value = (double)strtol(text, &end, 10);
+    else
+        *value = (float)strtod(text, &end); // 与登记的范围(float)在同一精度上比较
+    while (isspace((unsigned char)*end))
+        end++;
+    if (end == text || *end != '\0' || errno == ERANGE || *value != *value)
+    {
+        return errno == ERANGE ? PARAMS_ERANGE : PARAMS_EINVAL;
+    }
+    return *value < p->min || *value > p->max ? PARAMS_ERANGE : PARAMS_EOK;
+}
+
+// 按名称设置参数
+uint8_t params_set(const char *name, const char *value)
+{
+    if (name == NULL || value == NULL)
+    {
+        return PARAMS_EINVAL;
+    }
+    params_entry_t *p = find(name);
+    if (p == NULL)
+    {
+        return PARAMS_ENOTFOUND;
+    }
+    double v;
+    uint8_t ret = parse_value(p, value, &v);
+    if (ret == PARAMS_EOK)
+        write_value(p, v);
+    return ret;
+}
+
+static int format_value(const params_entry_t *p, double value, char *buf, size_t size)
+{
+    if (p->type == PARAMS_TYPE_INT)
+        return snprintf(buf, size, "%ld", (long)value);
+    return snprintf(buf, size, "%.7g", value);
+}
+
+// 按名称读取参数
+uint8_t params_get(const char *name, char *buf, size_t size)
+{
+    const params_entry_t *p = name != NULL ? find(name) : NULL;
+    if (p == NULL)
+    {
+        return PARAMS_ENOTFOUND;
+    }
+    int n = format_value(p, read_value(p), buf, size);
+    return n >= 0 && (size_t)n < size ? PARAMS_EOK : PARAMS_EINVAL;
+}
+
+// 恢复默认值
+uint8_t params_reset(const char *name)
+{
+    if (name == NULL)
+    {
+        uint8_t count = params_count();
+        for (uint8_t i = 0; i < count; i++)
+            write_value(&g_params[i], g_params[i].def);
+        return PARAMS_EOK;
+    }
+    params_entry_t *p = find(name);
+    if (p == NULL)
+    {
+        return PARAMS_ENOTFOUND;
+    }
+    write_value(p, p->def);
+    return PARAMS_EOK;
+}
+
+// 格式化一个参数为一行, 返回长度, 缓冲区不足返回-1
+static int format_line(const params_entry_t *p, uint8_t mode, char *buf, size_t size)
+{
+    char value[24], min[24], max[24], def[24];
+    format_value(p, read_value(p), value, sizeof(value));
+    int n;
+    if (mode == PARAMS_TEXT_DETAIL)
+    {
+        format_value(p, p->min, min, sizeof(min));
+        format_value(p, p->max, max, sizeof(max));
+        format_value(p, p->def, def, sizeof(def));
+        n = snprintf(buf, size, "%s = %s # %s..%s, default %s\n", p->name, value, min, max, def);
+    }
+    else
+    {
+        n = snprintf(buf, size, "%s = %s\n", p->name, value);
+    }
+    return n >= 0 && (size_t)n < size ? n : -1;
+}
+
+// 格式化全部参数
+size_t params_format_text(char *buf, size_t size, uint8_t mode)
+{
+    if (buf == NULL || size == 0 || mode > PARAMS_TEXT_DETAIL)
+    {
+        return 0;
+    }
+    size_t len = 0;
+    uint8_t count = params_count();
+    buf[0] = '\0';
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const params_entry_t *p = &g_params[i];
+        if (mode == PARAMS_TEXT_CHANGED && read_value(p) == p->def)
+            continue;
+        int n = format_line(p, mode, buf + len, size - len);
+        if (n < 0)
+            return 0;
+        len += n;
+    }
+    return len;
+}
+
+// 去掉首尾空白, 原地修改
+static char *trim(char *s)
+{
+    while (isspace((unsigned char)*s))
+        s++;
+    char *e = s + strlen(s);
+    while (e > s && isspace((unsigned char)e[-1]))
+        e--;
+    *e = '\0';
+    return s;
+}
+
+// 去掉#后的注释
+static void strip_comment(char *s)
+{
+    char *hash = strchr(s, '#');
+    if (hash != NULL)
+        *hash = '\0';
+}
+
+static const char *error_text(uint8_t err)
+{
+    switch (err)
+    {
+    case PARAMS_EINVAL:
+        return "bad value";
+    case PARAMS_ENOTFOUND:
+        return "unknown parameter";
+    case PARAMS_ERANGE:
+        return "out of range";
+    default:
+        return "failed";
+    }
+}
+
+// 解析一行"名称 = 值"(已去掉注释)
+static uint8_t parse_line(char *line, char *err, size_t err_size)
+{
+    char *eq = strchr(line, '=');
+    if (eq == NULL)
+    {
+        snprintf(err, err_size, "missing '=': %s", line);
+        return PARAMS_EINVAL;
+    }
+    *eq = '\0';
+    char *name = trim(line);
+    char *value = trim(eq + 1);
+    uint8_t ret = params_set(name, value);
+    if (ret != PARAMS_EOK)
+    {
+        snprintf(err, err_size, "%s: %s", error_text(ret), name);
+    }
+    return ret;
+}
+
+// 解析文本并设置参数
+uint8_t params_parse_text(const char *text, char *err, size_t err_size)
+{
+    char dummy[1];
+    if (err == NULL || err_size == 0)
+    {
+        err = dummy;
+        err_size = sizeof(dummy);
+    }
+    err[0] = '\0';
+    if (text == NULL)
+    {
+        return PARAMS_EINVAL;
+    }
+
+    uint8_t first = PARAMS_EOK;
+    int line_no = 0;
+    while (*text != '\0')
+    {
+        const char *end = strchr(text, '\n');
+        size_t len = end != NULL ? (size_t)(end - text) : strlen(text);
+        char line[PARAMS_LINE_MAX];
+        char msg[PARAMS_LINE_MAX + 32];
+        uint8_t ret = PARAMS_EOK;
+        line_no++;
+
+        if (len >= sizeof(line))
+        {
+            snprintf(msg, sizeof(msg), "line too long");
+            ret = PARAMS_EINVAL;
+        }
+        else
+        {
+            memcpy(line, text, len);
+            line[len] = '\0';
+            strip_comment(line);
+            char *content = trim(line);
+            if (content[0] != '\0')
+                ret = parse_line(content, msg, sizeof(msg));
+        }
+        if (ret != PARAMS_EOK && first == PARAMS_EOK)
+        {
+            first = ret;
+            snprintf(err, err_size, "line %d: %s", line_no, msg);
+        }
+        text += len;
+        if (*text == '\n')
+            text++;
+    }
+    return first;
+}
+
+// 执行一行命令
+uint8_t params_command(const char *line, char *reply, size_t size)
+{
+    char buf[PARAMS_LINE_MAX];
+    if (line == NULL || reply == NULL || size == 0)
+    {
+        return PARAMS_EINVAL;
+    }
+    if (strlen(line) >= sizeof(buf))
+    {
+        snprintf(reply, size, "error: line too long\n");
+        return PARAMS_EINVAL;
+    }
+    strcpy(buf, line);
+    strip_comment(buf); // 与参数文件相同, #后为注释, 参数文件可以逐行粘贴
+    bool assign = strchr(buf, '=') != NULL;
+    char *cmd = trim(buf);
+    if (cmd[0] == '\0')
+    {
+        reply[0] = '\0'; // 空行或只有注释
+        return PARAMS_EOK;
+    }
+    char *arg = cmd;
+    while (*arg != '\0' && !isspace((unsigned char)*arg))
+        arg++;
+    if (*arg != '\0')
+        *arg++ = '\0';
+    arg = trim(arg);
+
+    uint8_t ret;
+    const char *name = arg;
+    if (strcmp(cmd, "list") == 0)
+    {
+        if (params_format_text(reply, size, PARAMS_TEXT_DETAIL) > 0 || params_count() == 0)
+            return PARAMS_EOK;
+        snprintf(reply, size, "error: reply buffer too small\n");
+        return PARAMS_EINVAL;
+    }
+    else if (strcmp(cmd, "get") == 0)
+    {
+        ret = find(arg) != NULL ? PARAMS_EOK : PARAMS_ENOTFOUND;
+    }
+    else if (strcmp(cmd, "set") == 0)
+    {
+        char *value = arg;
+        while (*value != '\0' && !isspace((unsigned char)*value) && *value != '=')
+            value++;
+        if (*value != '\0')
+            *value++ = '\0';
+        value = trim(value);
+        if (*value == '=')
+            value = trim(value + 1);
+        ret = params_set(name, value);
+    }
+    else if (strcmp(cmd, "reset") == 0)
+    {
+        ret = params_reset(arg[0] != '\0' ? arg : NULL);
+        if (ret == PARAMS_EOK && arg[0] == '\0')
+        {
+            snprintf(reply, size, "all parameters reset\n");
+            return ret;
+        }
+    }
+    else if (assign)
+    {
+        // "名称 = 值", 与参数文件的一行相同
+        strcpy(buf, line);
+        strip_comment(buf);
+        char *eq = strchr(buf, '=');
+        *eq = '\0';
+        name = trim(buf);
+        ret = params_set(name, trim(eq + 1));
+    }
+    else
+    {
+        snprintf(reply, size, "error: unknown command '%s' (list, get, set, reset)\n", cmd);
+        return PARAMS_EINVAL;
+    }
+
+    if (ret != PARAMS_EOK)
+    {
+        snprintf(reply, size, "error: %s: %s\n", error_text(ret), name);
+        return ret;
+    }
+    const params_entry_t *p = find(name);
+    if (format_line(p, PARAMS_TEXT_DETAIL, reply, size) < 0)
+        reply[0] = '\0';
+    return PARAMS_EOK;
+}
+
+// 从文件读取参数
+uint8_t params_load_file(const char *path, char *err, size_t err_size)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+    {
+        if (err != NULL && err_size > 0)
+            snprintf(err, err_size, "cannot open %s", path);
+        return PARAMS_ERROR;
+    }
+    char line[PARAMS_LINE_MAX + 2];
+    char msg[PARAMS_LINE_MAX + 48];
+    uint8_t first = PARAMS_EOK;
+    int line_no = 0;
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        uint8_t ret;
+        size_t len = strlen(line);
+        line_no++;
+        if (len > 0 && line[len - 1] != '\n' && !feof(f))
+        {
+            // 一行比缓冲区长: 与params_parse_text相同按"line too long"报错,
+            // 并跳过本行剩余部分, 不把后半段当作新的一行解析
+            int c;
+            while ((c = fgetc(f)) != EOF && c != '\n')
+                ;
+            snprintf(msg, sizeof(msg), "line 1: line too long");
+            ret = PARAMS_EINVAL;
+        }
+        else
+        {
+            ret = params_parse_text(line, msg, sizeof(msg));
+        }
+        if (ret != PARAMS_EOK && first == PARAMS_EOK)
+        {
+            first = ret;
+            // 逐行解析时行号总是1, 换成文件中的行号
+            if (err != NULL && err_size > 0)
+                snprintf(err, err_size, "%s:%d: %s", path, line_no, strchr(msg, ':') + 2);
+        }
+    }
+    fclose(f);
+    return first;
+}
+
+// 保存与默认值不同的参数到文件
+uint8_t params_save_file(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL)
+    {
+        return PARAMS_ERROR;
+    }
+    char line[PARAMS_NAME_MAX + 32];
+    uint8_t count = params_count();
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const params_entry_t *p = &g_params[i];
+        if (read_value(p) != p->def && format_line(p, PARAMS_TEXT_CHANGED, line, sizeof(line)) > 0)
+            fputs(line, f);
+    }
+    return fclose(f) == 0 ? PARAMS_EOK : PARAMS_ERROR;
+}
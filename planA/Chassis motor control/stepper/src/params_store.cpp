@@ -0,0 +1,176 @@
+#include "params_store.h"
+#include <Preferences.h>
+
+#define PARAMS_STORE_NAMESPACE "params"
+#define PARAMS_STORE_KEY "text"
+#define PARAMS_STORE_REPLY_MAX 4096 // list的回复, 64个参数每行约60字符
+
+static char g_text[PARAMS_STORE_TEXT_MAX];   // 读写NVS用, 调用方不并发读写
+static char g_reply[PARAMS_STORE_REPLY_MAX]; // 只由命令处理使用
+static char g_line[PARAMS_STORE_LINE_MAX];
+static size_t g_line_len = 0;
+static bool g_line_overflow = false;
+static Stream *g_port = NULL;
+static TaskHandle_t g_task = NULL;
+
+// 从NVS读取保存的文本到g_text, 从未保存过时长度为0; 不改变参数
+static uint8_t params_store_read(size_t *len)
+{
+    *len = 0;
+    Preferences prefs;
+    if (!prefs.begin(PARAMS_STORE_NAMESPACE, true))
+    {
+        return PARAMS_EOK; // 命名空间不存在: 从未保存过
+    }
+    size_t n = prefs.getBytesLength(PARAMS_STORE_KEY);
+    uint8_t ret = PARAMS_EOK;
+    if (n >= sizeof(g_text) || (n > 0 && prefs.getBytes(PARAMS_STORE_KEY, g_text, n) != n))
+    {
+        ret = PARAMS_ERROR;
+    }
+    else
+    {
+        g_text[n] = '\0';
+        *len = n;
+    }
+    prefs.end();
+    return ret;
+}
+
+// 应用g_text中读出的参数
+static uint8_t params_store_apply(Stream *log)
+{
+    char err[96];
+    uint8_t ret = params_parse_text(g_text, err, sizeof(err));
+    if (ret != PARAMS_EOK && log != NULL)
+    {
+        log->printf("[PARAMS] Saved parameters partly applied, %s\n", err);
+    }
+    return ret;
+}
+
+// 从NVS读取保存的参数
+uint8_t params_store_load(Stream *log)
+{
+    size_t len;
+    if (params_store_read(&len) != PARAMS_EOK)
+    {
+        if (log != NULL)
+            log->println("[PARAMS] Failed to read saved parameters");
+        return PARAMS_ERROR;
+    }
+    return len > 0 ? params_store_apply(log) : PARAMS_EOK;
+}
+
+// 保存与默认值不同的参数到NVS
+uint8_t params_store_save(void)
+{
+    size_t len = params_format_text(g_text, sizeof(g_text), PARAMS_TEXT_CHANGED);
+    if (len == 0 && params_changed_count() > 0)
+    {
+        return PARAMS_EFULL;
+    }
+    Preferences prefs;
+    if (!prefs.begin(PARAMS_STORE_NAMESPACE, false))
+    {
+        return PARAMS_ERROR;
+    }
+    bool ok;
+    if (len == 0)
+        ok = !prefs.isKey(PARAMS_STORE_KEY) || prefs.remove(PARAMS_STORE_KEY);
+    else
+        ok = prefs.putBytes(PARAMS_STORE_KEY, g_text, len) == len;
+    prefs.end();
+    return ok ? PARAMS_EOK : PARAMS_ERROR;
+}
+
+// 执行一行命令, save和load在这里处理, 其余交给params_command
+static void handle_line(Stream *port, const char *line)
+{
+    char cmd[8];
+    if (sscanf(line, " %7s", cmd) != 1)
+    {
+        return;
+    }
+    if (strcmp(cmd, "save") == 0)
+    {
+        uint8_t ret = params_store_save();
+        port->println(ret == PARAMS_EOK ? "saved" : ret == PARAMS_EFULL ? "error: too many changes to save"
+                                                                          : "error: NVS write failed");
+    }
+    else if (strcmp(cmd, "load") == 0)
+    {
+        // 先读出保存的文本, 读取失败时保留当前参数; 成功后才恢复默认值再应用保存的修改
+        size_t len;
+        if (params_store_read(&len) != PARAMS_EOK)
+        {
+            port->println("error: NVS read failed, parameters unchanged");
+            return;
+        }
+        params_reset(NULL);
+        port->println(len == 0 || params_store_apply(port) == PARAMS_EOK ? "loaded"
+                                                                        : "error: saved parameters partly applied");
+    }
+    else
+    {
+        params_command(line, g_reply, sizeof(g_reply));
+        port->print(g_reply);
+    }
+}
+
+// 读取串口命令
+void params_store_poll(Stream *port)
+{
+    while (port->available() > 0)
+    {
+        int c = port->read();
+        if (c == '\n' || c == '\r')
+        {
+            if (g_line_overflow)
+                port->println("error: line too long");
+            else if (g_line_len > 0)
+            {
+                g_line[g_line_len] = '\0';
+                handle_line(port, g_line);
+            }
+            g_line_len = 0;
+            g_line_overflow = false;
+        }
+        else if (g_line_len < sizeof(g_line) - 1)
+        {
+            g_line[g_line_len++] = (char)c;
+        }
+        else
+        {
+            g_line_overflow = true;
+        }
+    }
+}
+
+// 命令任务
+static void params_store_task(void *pvParameters)
+{
+    while (1)
+    {
+        params_store_poll(g_port);
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
+}
+
+// 启动命令任务
+uint8_t params_store_start(Stream *port)
+{
+    if (port == NULL)
+    {
+        return PARAMS_EINVAL;
+    }
+    g_port = port;
+    if (g_task == NULL &&
+        xTaskCreatePinnedToCore(params_store_task, "Params", 4000, NULL, 1, &g_task, 0) != pdPASS)
+    {
+        g_task = NULL;
+        return PARAMS_ERROR;
+    }
+    port->printf("[PARAMS] %u parameters, commands: list, get, set, reset, save, load\n", params_count());
+    return PARAMS_EOK;
+}
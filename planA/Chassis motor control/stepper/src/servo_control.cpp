@@ -1,5 +1,7 @@
 #include "servo_control.h"
 #include <ESP32Servo.h>
+#include "metrics.h"
+#include "telemetry.h"
 
 // 舵机对象与变量
 static Servo myservo;
@@ -10,6 +12,12 @@ static uint8_t sweep_speed = 5;
 static bool is_sweeping = false;
 static unsigned long last_sweep_time = 0;
 static unsigned long last_status_time = 0;
+static unsigned long sweep_start_time = 0;
+
+// 运行指标
+static metrics_counter_t g_m_commands; // 角度命令数
+static metrics_histogram_t g_m_sweep;  // 平滑转动从开始到到达目标的时间(ms)
+static const uint32_t g_sweep_bounds[] = {100, 200, 500, 1000, 2000, 5000};
 
 // 初始化舵机 - 优化初始化参数
 void servo_init(uint8_t pin)
@@ -26,6 +34,10 @@ void servo_init(uint8_t pin)
     // 初始位置
     myservo.write(current_angle);
 
+    metrics_register_counter(&g_m_commands, "servo.commands");
+    metrics_register_histogram(&g_m_sweep, "servo.sweep_ms", g_sweep_bounds,
+                               sizeof(g_sweep_bounds) / sizeof(g_sweep_bounds[0]));
+    telemetry_register("servo.angle", TELEMETRY_TYPE_U8, &current_angle, 1);
     Serial.printf("[SERVO] Initialization complete, pin: %u\n", servo_pin);
 }
 
@@ -38,6 +50,7 @@ void servo_set_angle(uint8_t angle)
     current_angle = angle;
     target_angle = angle;
     is_sweeping = false;
+    metrics_counter_inc(&g_m_commands);
 
     myservo.write(angle);
 
@@ -62,6 +75,8 @@ void servo_sweep_to(uint8_t angle, uint8_t speed)
     sweep_speed = speed;
     is_sweeping = true;
     last_status_time = 0; // 确保初始状态能打印
+    sweep_start_time = millis();
+    metrics_counter_inc(&g_m_commands);
 
     Serial.printf("[SERVO] Moving to: %u deg, speed: %u\n", angle, speed);
 }
@@ -106,6 +121,7 @@ void servo_loop()
         {
             // 到达目标
             is_sweeping = false;
+            metrics_histogram_observe(&g_m_sweep, now - sweep_start_time);
             Serial.printf("[SERVO] Target angle reached: %u deg\n", current_angle);
         }
     }
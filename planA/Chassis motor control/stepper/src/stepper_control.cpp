@@ -1,4 +1,6 @@
 #include "stepper_control.h"
+#include "metrics.h"
+#include "telemetry.h"
 
 // 步进电机结构体定义
 typedef struct
@@ -9,14 +11,15 @@ typedef struct
     uint8_t enable_pin; // 使能引脚
 
     // 控制变量
-    int32_t current_position;     // 当前位置
-    int32_t target_position;      // 目标位置
-    float current_speed;          // 当前速度
-    float max_speed;              // 最大速度 (步/秒)
-    float acceleration;           // 加速度 (步/秒^2)
-    bool is_moving;               // 是否正在移动
-    unsigned long last_step_time; // 上次步进时间
-    bool is_configured;           // 是否已配置
+    int32_t current_position;      // 当前位置
+    int32_t target_position;       // 目标位置
+    float current_speed;           // 当前速度
+    float max_speed;               // 最大速度 (步/秒)
+    float acceleration;            // 加速度 (步/秒^2)
+    bool is_moving;                // 是否正在移动
+    unsigned long last_step_time;  // 上次步进时间
+    unsigned long move_start_time; // 本次运动开始时间(ms)
+    bool is_configured;            // 是否已配置
 } stepper_t;
 
 // 步进电机控制变量
@@ -30,6 +33,43 @@ static uint8_t current_stepper = 0;        // 当前使用的步进电机
 #define DEFAULT_STEP_PIN 14   // 步进脉冲引脚
 #define DEFAULT_ENABLE_PIN 13 // 使能引脚
 
+// 运行指标
+static metrics_counter_t g_m_steps;      // 输出的步进脉冲数
+static metrics_counter_t g_m_moves;      // 运动命令数
+static metrics_counter_t g_m_overruns;   // 循环间隔超过步进间隔(实际速度跟不上设定速度)的次数
+static metrics_histogram_t g_m_loop_gap; // 相邻两次控制循环的间隔(us)
+static metrics_histogram_t g_m_move;     // 运动命令到到达目标的时间(ms)
+static const uint32_t g_loop_gap_bounds[] = {50, 100, 200, 500, 1000, 2000, 5000, 10000};
+static const uint32_t g_move_bounds[] = {100, 200, 500, 1000, 2000, 5000, 10000, 20000};
+
+// 登记运行指标, 重复登记会被忽略
+static void stepper_metrics_register(void)
+{
+    metrics_register_counter(&g_m_steps, "stepper.steps");
+    metrics_register_counter(&g_m_moves, "stepper.moves");
+    metrics_register_counter(&g_m_overruns, "stepper.overruns");
+    metrics_register_histogram(&g_m_loop_gap, "stepper.loop_gap_us", g_loop_gap_bounds,
+                               sizeof(g_loop_gap_bounds) / sizeof(g_loop_gap_bounds[0]));
+    metrics_register_histogram(&g_m_move, "stepper.move_ms", g_move_bounds,
+                               sizeof(g_move_bounds) / sizeof(g_move_bounds[0]));
+}
+
+// 登记遥测变量: 位置(步)和速度(0.1步/秒)
+static void stepper_telemetry_register(uint8_t id)
+{
+    static const char *const names[][2] = {
+        {"stepper0.position", "stepper0.speed"},
+        {"stepper1.position", "stepper1.speed"},
+        {"stepper2.position", "stepper2.speed"},
+        {"stepper3.position", "stepper3.speed"},
+    };
+    if (id < sizeof(names) / sizeof(names[0]))
+    {
+        telemetry_register(names[id][0], TELEMETRY_TYPE_I32, &steppers[id].current_position, 1);
+        telemetry_register(names[id][1], TELEMETRY_TYPE_FLOAT, &steppers[id].current_speed, 10);
+    }
+}
+
 // 初始化步进电机
 void stepper_init(void)
 {
@@ -55,6 +95,8 @@ void stepper_init(void)
     digitalWrite(steppers[0].step_pin, LOW);
     digitalWrite(steppers[0].enable_pin, HIGH); // 高电平禁用
 
+    stepper_metrics_register();
+    stepper_telemetry_register(0);
     Serial.println("[STEPPER] Initialization complete");
     Serial.printf("[STEPPER] ID:0 Pins - DIR:%d, STEP:%d, ENABLE:%d\n",
                   steppers[0].dir_pin, steppers[0].step_pin, steppers[0].enable_pin);
@@ -95,6 +137,8 @@ void stepper_config_pins(uint8_t stepper_id, uint8_t step_pin, uint8_t dir_pin,
     digitalWrite(steppers[stepper_id].step_pin, LOW);
     digitalWrite(steppers[stepper_id].enable_pin, HIGH); // 高电平禁用
 
+    stepper_metrics_register();
+    stepper_telemetry_register(stepper_id);
     Serial.printf("[STEPPER] ID:%d configuration complete\n", stepper_id);
     Serial.printf("[STEPPER] ID:%d Pins - DIR:%d, STEP:%d, ENABLE:%d\n",
                   stepper_id, steppers[stepper_id].dir_pin,
@@ -147,6 +191,8 @@ void stepper_move_to(int32_t position)
 {
     steppers[current_stepper].target_position = position;
     steppers[current_stepper].is_moving = true;
+    steppers[current_stepper].move_start_time = millis();
+    metrics_counter_inc(&g_m_moves);
 
     // 使能电机
     digitalWrite(steppers[current_stepper].enable_pin, LOW);
@@ -209,6 +255,7 @@ static void step_motor(uint8_t id)
 
     // 更新位置
     steppers[id].current_position += direction;
+    metrics_counter_inc(&g_m_steps);
 }
 
 // 计算下一个速度
@@ -268,6 +315,8 @@ bool stepper_run(uint8_t stepper_id, uint16_t max_speed, float accel, int32_t po
     steppers[stepper_id].acceleration = accel;
     steppers[stepper_id].target_position = position;
     steppers[stepper_id].is_moving = true;
+    steppers[stepper_id].move_start_time = millis();
+    metrics_counter_inc(&g_m_moves);
 
     // 使能电机
     digitalWrite(steppers[stepper_id].enable_pin, LOW);
@@ -290,6 +339,7 @@ void stepper_loop(void)
         last_micros = current_micros;
         return;
     }
+    unsigned long loop_gap = current_micros - last_micros;
     last_micros = current_micros;
 
     // 周期性输出状态
@@ -311,12 +361,14 @@ void stepper_loop(void)
     }
 
     // 处理每个电机
+    bool any_moving = false;
     for (uint8_t i = 0; i < MAX_STEPPER_NUM; i++)
     {
         if (!steppers[i].is_configured || !steppers[i].is_moving)
         {
             continue;
         }
+        any_moving = true;
 
         // 检查是否到达目标位置
         if (steppers[i].current_position == steppers[i].target_position)
@@ -324,6 +376,7 @@ void stepper_loop(void)
             steppers[i].is_moving = false;
             steppers[i].current_speed = 0.0;
             digitalWrite(steppers[i].enable_pin, HIGH); // 禁用电机
+            metrics_histogram_observe(&g_m_move, millis() - steppers[i].move_start_time);
             Serial.printf("[STEPPER] ID:%d Target position reached\n", i);
             continue;
         }
@@ -351,6 +404,10 @@ void stepper_loop(void)
         if (steppers[i].current_speed != 0.0)
         {
             float step_interval_micros = 1000000.0 / abs(steppers[i].current_speed);
+            if (loop_gap > step_interval_micros)
+            {
+                metrics_counter_inc(&g_m_overruns);
+            }
 
             // 判断是否应该执行步进
             if (current_micros - steppers[i].last_step_time >= step_interval_micros)
@@ -360,4 +417,10 @@ void stepper_loop(void)
             }
         }
     }
+
+    // 只统计有电机运动时的循环间隔, 空闲时不增加开销
+    if (any_moving)
+    {
+        metrics_histogram_observe(&g_m_loop_gap, loop_gap);
+    }
 }
\ No newline at end of file
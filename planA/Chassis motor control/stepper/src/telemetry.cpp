@@ -0,0 +1,450 @@
+#include "telemetry.h"
+#include "metrics.h"
+#include <math.h>
+#include <string.h>
+
+// 变量表, 先占位再填写, 填写完成后置ready(与metrics登记表相同)
+typedef struct
+{
+    const char *name;
+    uint8_t type;
+    const volatile void *ptr;
+    telemetry_reader_t reader;
+    float scale;
+    volatile bool ready;
+} telemetry_var_t;
+
+static telemetry_var_t g_vars[TELEMETRY_VARS_MAX];
+static volatile uint8_t g_reserved = 0;
+
+// 登记变量
+static uint8_t telemetry_add(const char *name, uint8_t type, const volatile void *ptr,
+                             telemetry_reader_t reader, float scale)
+{
+    if (name == NULL || name[0] == '\0' || strlen(name) > TELEMETRY_NAME_MAX || !(scale > 0.0f))
+    {
+        return TELEMETRY_EINVAL;
+    }
+
+    const void *key = ptr != NULL ? (const void *)ptr : (const void *)reader;
+    uint8_t count = __atomic_load_n(&g_reserved, __ATOMIC_ACQUIRE);
+    for (uint8_t i = 0; i < count && i < TELEMETRY_VARS_MAX; i++)
+    {
+        if ((g_vars[i].ptr != NULL ? (const void *)g_vars[i].ptr : (const void *)g_vars[i].reader) == key)
+            return TELEMETRY_EEXIST;
+    }
+
+    uint8_t index = __atomic_fetch_add(&g_reserved, 1, __ATOMIC_ACQ_REL);
+    if (index >= TELEMETRY_VARS_MAX)
+    {
+        __atomic_store_n(&g_reserved, TELEMETRY_VARS_MAX, __ATOMIC_RELEASE);
+        return TELEMETRY_EFULL;
+    }
+    g_vars[index].name = name;
+    g_vars[index].type = type;
+    g_vars[index].ptr = ptr;
+    g_vars[index].reader = reader;
+    g_vars[index].scale = scale;
+    __atomic_store_n(&g_vars[index].ready, true, __ATOMIC_RELEASE);
+    return TELEMETRY_EOK;
+}
+
+// 登记变量地址
+uint8_t telemetry_register(const char *name, uint8_t type, const volatile void *ptr, float scale)
+{
+    if (ptr == NULL || type >= TELEMETRY_TYPE_READER)
+    {
+        return TELEMETRY_EINVAL;
+    }
+    return telemetry_add(name, type, ptr, NULL, scale);
+}
+
+// 登记读取函数
+uint8_t telemetry_register_reader(const char *name, telemetry_reader_t reader, float scale)
+{
+    if (reader == NULL)
+    {
+        return TELEMETRY_EINVAL;
+    }
+    return telemetry_add(name, TELEMETRY_TYPE_READER, NULL, reader, scale);
+}
+
+// 已登记的变量数(只计算连续就绪的表项)
+uint8_t telemetry_var_count(void)
+{
+    uint8_t reserved = __atomic_load_n(&g_reserved, __ATOMIC_ACQUIRE);
+    uint8_t count = 0;
+    while (count < reserved && count < TELEMETRY_VARS_MAX && __atomic_load_n(&g_vars[count].ready, __ATOMIC_ACQUIRE))
+    {
+        count++;
+    }
+    return count;
+}
+
+// 读取一个变量并换算为整数, 比例为1的整数变量和读取函数的结果直接返回
+static int32_t read_var(const telemetry_var_t *var)
+{
+    int32_t raw;
+    float value;
+    switch (var->type)
+    {
+    case TELEMETRY_TYPE_I32:
+        raw = *(const volatile int32_t *)var->ptr;
+        break;
+    case TELEMETRY_TYPE_U32:
+        raw = (int32_t)*(const volatile uint32_t *)var->ptr;
+        break;
+    case TELEMETRY_TYPE_I16:
+        raw = *(const volatile int16_t *)var->ptr;
+        break;
+    case TELEMETRY_TYPE_U16:
+        raw = *(const volatile uint16_t *)var->ptr;
+        break;
+    case TELEMETRY_TYPE_U8:
+        raw = *(const volatile uint8_t *)var->ptr;
+        break;
+    case TELEMETRY_TYPE_FLOAT:
+        value = *(const volatile float *)var->ptr * var->scale;
+        if (!(value > -2147483520.0f)) // 同时处理NaN
+            return INT32_MIN;
+        if (value > 2147483520.0f)
+            return INT32_MAX;
+        return (int32_t)lroundf(value);
+    default:
+        return var->reader(); // 读取函数返回已按比例换算的整数
+    }
+    if (var->scale == 1.0f)
+        return raw;
+    return (int32_t)lroundf((float)raw * var->scale);
+}
+
+// 读取全部变量
+void telemetry_sample(telemetry_sample_t *sample, uint32_t time_us)
+{
+    uint8_t count = telemetry_var_count();
+    sample->time_us = time_us;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        sample->values[i] = read_var(&g_vars[i]);
+    }
+}
+
+// 包编码: 超出缓冲区后只记录长度和CRC
+typedef struct
+{
+    uint8_t *buf;
+    size_t size;
+    size_t pos;
+    uint16_t crc;
+} packet_writer_t;
+
+static void put_u8(packet_writer_t *w, uint8_t value)
+{
+    if (w->pos < w->size)
+        w->buf[w->pos] = value;
+    w->pos++;
+    w->crc = metrics_crc16(&value, 1, w->crc);
+}
+
+static void put_u16(packet_writer_t *w, uint16_t value)
+{
+    put_u8(w, (uint8_t)value);
+    put_u8(w, (uint8_t)(value >> 8));
+}
+
+static void put_u32(packet_writer_t *w, uint32_t value)
+{
+    put_u16(w, (uint16_t)value);
+    put_u16(w, (uint16_t)(value >> 16));
+}
+
+// 变长整数: 每字节7位, 最高位表示后面还有字节
+static void put_varint(packet_writer_t *w, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        put_u8(w, (uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    put_u8(w, (uint8_t)value);
+}
+
+// zigzag: 把有符号数映射为无符号数, 绝对值小的差值编码后也小
+static void put_svarint(packet_writer_t *w, int32_t value)
+{
+    put_varint(w, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+static void packet_begin(packet_writer_t *w, uint8_t *buf, size_t size, uint8_t type)
+{
+    w->buf = buf;
+    w->size = size;
+    w->pos = 0;
+    w->crc = 0xFFFF;
+    put_u8(w, TELEMETRY_SYNC0);
+    put_u8(w, TELEMETRY_SYNC1);
+    put_u8(w, type);
+    put_u16(w, 0);
+}
+
+// 回填长度并追加CRC, 返回包长度
+static size_t packet_end(packet_writer_t *w)
+{
+    size_t payload = w->pos - 5;
+    if (w->pos + 2 > w->size || payload > 0xFFFF)
+        return 0;
+    w->buf[3] = (uint8_t)payload;
+    w->buf[4] = (uint8_t)(payload >> 8);
+    put_u16(w, metrics_crc16(w->buf + 2, w->pos - 2, 0xFFFF));
+    return w->pos;
+}
+
+// 结构包负载
+static void write_schema(packet_writer_t *w, uint8_t count, uint16_t rate_hz)
+{
+    put_u8(w, TELEMETRY_VERSION);
+    put_u8(w, count);
+    put_u16(w, rate_hz);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint32_t scale_bits;
+        memcpy(&scale_bits, &g_vars[i].scale, sizeof(scale_bits));
+        put_u8(w, g_vars[i].type);
+        put_u32(w, scale_bits);
+
+        uint8_t len = (uint8_t)strlen(g_vars[i].name);
+        put_u8(w, len);
+        for (uint8_t c = 0; c < len; c++)
+            put_u8(w, (uint8_t)g_vars[i].name[c]);
+    }
+}
+
+// 结构校验, 变量数和采样率不变时使用缓存
+static uint16_t schema_id(uint8_t count, uint16_t rate_hz)
+{
+    static uint8_t cached_count = 0xFF;
+    static uint16_t cached_rate = 0;
+    static uint16_t cached_id = 0;
+    if (count != cached_count || rate_hz != cached_rate)
+    {
+        packet_writer_t w = {NULL, 0, 0, 0xFFFF}; // 只计算CRC, 不写入
+        write_schema(&w, count, rate_hz);
+        cached_id = w.crc;
+        cached_count = count;
+        cached_rate = rate_hz;
+    }
+    return cached_id;
+}
+
+// 编码结构包
+size_t telemetry_encode_schema(uint8_t *buf, size_t size, uint16_t rate_hz)
+{
+    packet_writer_t w;
+    if (buf == NULL)
+        return 0;
+    packet_begin(&w, buf, size, TELEMETRY_PACKET_SCHEMA);
+    write_schema(&w, telemetry_var_count(), rate_hz);
+    return packet_end(&w);
+}
+
+// 编码数据包
+size_t telemetry_encode_batch(uint8_t *buf, size_t size, uint16_t rate_hz, uint16_t seq,
+                              const telemetry_sample_t *samples, uint8_t n, uint8_t *encoded)
+{
+    packet_writer_t w;
+    uint8_t count = telemetry_var_count();
+    *encoded = 0;
+    if (buf == NULL || samples == NULL || n == 0 || size < TELEMETRY_PACKET_OVERHEAD)
+        return 0;
+
+    packet_begin(&w, buf, size - 2, TELEMETRY_PACKET_DATA); // 预留CRC
+    put_u8(&w, TELEMETRY_VERSION);
+    put_u16(&w, schema_id(count, rate_hz));
+    put_u16(&w, seq);
+    put_u8(&w, count);
+    size_t count_pos = w.pos;
+    put_u8(&w, 0); // 样本数, 结束时回填
+    put_u32(&w, samples[0].time_us);
+
+    uint8_t done = 0;
+    for (uint8_t s = 0; s < n; s++)
+    {
+        size_t sample_start = w.pos;
+        if (s == 0)
+        {
+            for (uint8_t i = 0; i < count; i++)
+                put_svarint(&w, samples[0].values[i]);
+        }
+        else
+        {
+            put_varint(&w, samples[s].time_us - samples[s - 1].time_us);
+            for (uint8_t i = 0; i < count; i++)
+                put_svarint(&w, (int32_t)((uint32_t)samples[s].values[i] - (uint32_t)samples[s - 1].values[i]));
+        }
+        if (w.pos > w.size)
+        {
+            w.pos = sample_start; // 放不下的样本留给下一个包
+            break;
+        }
+        done++;
+    }
+    if (done == 0)
+        return 0;
+
+    w.size = size;
+    buf[count_pos] = done;
+    *encoded = done;
+    return packet_end(&w);
+}
+
+// 查找一个完整的包
+size_t telemetry_find_packet(const uint8_t *buf, size_t len, uint8_t *type,
+                             const uint8_t **payload, size_t *payload_len)
+{
+    size_t start = 0;
+    while (start + 1 < len)
+    {
+        if (buf[start] != TELEMETRY_SYNC0 || buf[start + 1] != TELEMETRY_SYNC1)
+        {
+            start++;
+            continue;
+        }
+        if (len - start < 5)
+            break;
+        size_t body = (size_t)buf[start + 3] | ((size_t)buf[start + 4] << 8);
+        if (body > TELEMETRY_PACKET_MAX)
+        {
+            start++; // 长度不合理, 是数据中碰巧出现的同步字节
+            continue;
+        }
+        if (len - start < body + TELEMETRY_PACKET_OVERHEAD)
+            break;
+        uint16_t crc = (uint16_t)buf[start + 5 + body] | ((uint16_t)buf[start + 6 + body] << 8);
+        if (crc != metrics_crc16(buf + start + 2, body + 3, 0xFFFF))
+        {
+            start++;
+            continue;
+        }
+        *type = buf[start + 2];
+        *payload = buf + start + 5;
+        *payload_len = body;
+        return start + body + TELEMETRY_PACKET_OVERHEAD;
+    }
+    // 没有找到完整的包: 丢弃同步字节之前的数据, 保留可能是包开头的部分
+    if (type != NULL)
+        *type = 0;
+    return start;
+}
+
+// 包解码
+typedef struct
+{
+    const uint8_t *buf;
+    size_t len;
+    size_t pos;
+    bool error;
+} packet_reader_t;
+
+static uint8_t get_u8(packet_reader_t *r)
+{
+    if (r->pos >= r->len)
+    {
+        r->error = true;
+        return 0;
+    }
+    return r->buf[r->pos++];
+}
+
+static uint16_t get_u16(packet_reader_t *r)
+{
+    uint16_t low = get_u8(r);
+    return (uint16_t)(low | ((uint16_t)get_u8(r) << 8));
+}
+
+static uint32_t get_u32(packet_reader_t *r)
+{
+    uint32_t low = get_u16(r);
+    return low | ((uint32_t)get_u16(r) << 16);
+}
+
+static uint32_t get_varint(packet_reader_t *r)
+{
+    uint32_t value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7)
+    {
+        uint8_t byte = get_u8(r);
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    r->error = true;
+    return 0;
+}
+
+static int32_t get_svarint(packet_reader_t *r)
+{
+    uint32_t value = get_varint(r);
+    return (int32_t)((value >> 1) ^ (0 - (value & 1)));
+}
+
+// 解码结构包
+uint8_t telemetry_decode_schema(const uint8_t *payload, size_t len, telemetry_schema_t *schema)
+{
+    packet_reader_t r = {payload, len, 0, false};
+    if (payload == NULL || schema == NULL || get_u8(&r) != TELEMETRY_VERSION)
+        return TELEMETRY_EFORMAT;
+
+    schema->count = get_u8(&r);
+    schema->rate_hz = get_u16(&r);
+    if (schema->count > TELEMETRY_VARS_MAX)
+        return TELEMETRY_EFORMAT;
+    for (uint8_t i = 0; i < schema->count; i++)
+    {
+        uint32_t scale_bits;
+        schema->types[i] = get_u8(&r);
+        scale_bits = get_u32(&r);
+        memcpy(&schema->scales[i], &scale_bits, sizeof(scale_bits));
+
+        uint8_t name_len = get_u8(&r);
+        if (name_len > TELEMETRY_NAME_MAX)
+            return TELEMETRY_EFORMAT;
+        for (uint8_t c = 0; c < name_len; c++)
+            schema->names[i][c] = (char)get_u8(&r);
+        schema->names[i][name_len] = '\0';
+    }
+    if (r.error || r.pos != len)
+        return TELEMETRY_EFORMAT;
+    schema->id = metrics_crc16(payload, len, 0xFFFF);
+    return TELEMETRY_EOK;
+}
+
+// 解码数据包
+uint8_t telemetry_decode_batch(const uint8_t *payload, size_t len, const telemetry_schema_t *schema,
+                               telemetry_sample_t *samples, uint8_t *n, uint16_t *seq)
+{
+    packet_reader_t r = {payload, len, 0, false};
+    if (payload == NULL || schema == NULL || samples == NULL || get_u8(&r) != TELEMETRY_VERSION)
+        return TELEMETRY_EFORMAT;
+    if (get_u16(&r) != schema->id)
+        return TELEMETRY_EFORMAT;
+
+    *seq = get_u16(&r);
+    uint8_t count = get_u8(&r);
+    uint8_t num = get_u8(&r);
+    if (count != schema->count || num == 0)
+        return TELEMETRY_EFORMAT;
+
+    samples[0].time_us = get_u32(&r);
+    for (uint8_t i = 0; i < count; i++)
+        samples[0].values[i] = get_svarint(&r);
+    for (uint8_t s = 1; s < num; s++)
+    {
+        samples[s].time_us = samples[s - 1].time_us + get_varint(&r);
+        for (uint8_t i = 0; i < count; i++)
+            samples[s].values[i] = (int32_t)((uint32_t)samples[s - 1].values[i] + (uint32_t)get_svarint(&r));
+    }
+    if (r.error || r.pos != len)
+        return TELEMETRY_EFORMAT;
+    *n = num;
+    return TELEMETRY_EOK;
+}
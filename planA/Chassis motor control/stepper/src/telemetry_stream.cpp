@@ -0,0 +1,166 @@
+#include "telemetry_stream.h"
+#include "metrics.h"
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+// 双缓冲: 采样任务写一半, 写满后交给发送任务, 发送任务还没发完上一半时丢弃本批
+static telemetry_sample_t g_batches[2][TELEMETRY_BATCH];
+static volatile uint8_t g_fill = 0;     // 采样任务正在写的一半
+static volatile bool g_sending = false; // 发送任务持有另一半
+static uint8_t g_packet[TELEMETRY_PACKET_MAX];
+
+// 任务退出前自己清为NULL; 两个都为NULL时才能重新启动, 否则旧任务会和新任务同时运行
+static TaskHandle_t volatile g_sample_task = NULL;
+static TaskHandle_t volatile g_send_task = NULL;
+static volatile bool g_running = false;
+static uint16_t g_rate_hz = 0;
+static Stream *g_serial = NULL; // 为NULL时使用UDP
+static WiFiUDP g_udp;
+static IPAddress g_udp_target;
+
+// 运行指标
+static metrics_counter_t g_m_packets; // 发出的数据包
+static metrics_counter_t g_m_dropped; // 因发送跟不上而丢弃的样本
+
+// 发出一个包, 串口写满时阻塞的只是发送任务, 跟不上时由采样任务丢弃整批
+static void telemetry_send(const uint8_t *data, size_t len)
+{
+    if (g_serial != NULL)
+    {
+        g_serial->write(data, len);
+    }
+    else
+    {
+        g_udp.beginPacket(g_udp_target, TELEMETRY_UDP_PORT);
+        g_udp.write(data, len);
+        g_udp.endPacket();
+    }
+    metrics_counter_inc(&g_m_packets);
+}
+
+// 采样任务: 按固定节拍采样, 一半写满后通知发送任务
+static void telemetry_sample_task(void *pvParameters)
+{
+    uint8_t count = 0;
+    TickType_t period = pdMS_TO_TICKS(1000 / g_rate_hz);
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (g_running)
+    {
+        telemetry_sample(&g_batches[g_fill][count], micros());
+        if (++count == TELEMETRY_BATCH)
+        {
+            count = 0;
+            if (g_sending)
+            {
+                metrics_counter_add(&g_m_dropped, TELEMETRY_BATCH); // 覆盖本批
+            }
+            else
+            {
+                g_sending = true;
+                g_fill ^= 1;
+                xTaskNotifyGive(g_send_task);
+            }
+        }
+        vTaskDelayUntil(&last_wake, period);
+    }
+
+    g_sample_task = NULL;
+    vTaskDelete(NULL);
+}
+
+// 发送任务: 编码并发出采样任务交来的一半
+static void telemetry_send_task(void *pvParameters)
+{
+    uint16_t seq = 0;
+    while (g_running)
+    {
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100)) == 0)
+            continue;
+
+        if (seq % TELEMETRY_SCHEMA_EVERY == 0)
+        {
+            size_t len = telemetry_encode_schema(g_packet, sizeof(g_packet), g_rate_hz);
+            if (len > 0)
+                telemetry_send(g_packet, len);
+        }
+
+        const telemetry_sample_t *batch = g_batches[g_fill ^ 1];
+        uint8_t done = 0;
+        while (done < TELEMETRY_BATCH)
+        {
+            uint8_t encoded;
+            size_t len = telemetry_encode_batch(g_packet, sizeof(g_packet), g_rate_hz, seq, batch + done,
+                                                TELEMETRY_BATCH - done, &encoded);
+            if (len == 0)
+                break;
+            telemetry_send(g_packet, len);
+            seq++;
+            done += encoded;
+        }
+        g_sending = false;
+    }
+
+    g_send_task = NULL;
+    vTaskDelete(NULL);
+}
+
+// 启动遥测
+uint8_t telemetry_start(uint16_t rate_hz, Stream *fallback)
+{
+    if (rate_hz == 0 || rate_hz > 1000 || g_running || g_sample_task != NULL || g_send_task != NULL)
+    {
+        return TELEMETRY_EINVAL;
+    }
+
+    if (WiFi.getMode() & WIFI_MODE_AP)
+    {
+        g_serial = NULL;
+        g_udp_target = WiFi.softAPBroadcastIP();
+    }
+    else if (fallback != NULL)
+    {
+        g_serial = fallback;
+    }
+    else
+    {
+        return TELEMETRY_EINVAL;
+    }
+
+    metrics_register_counter(&g_m_packets, "telemetry.packets");
+    metrics_register_counter(&g_m_dropped, "telemetry.dropped");
+
+    g_rate_hz = 1000 / (1000 / rate_hz); // 按1ms节拍取整后的实际采样率
+    g_fill = 0;
+    g_sending = false;
+    g_running = true;
+    // 采样任务优先级高于控制任务, 节拍准确; 发送任务最低, 只用空闲时间
+    TaskHandle_t send_task = NULL, sample_task = NULL;
+    if (xTaskCreatePinnedToCore(telemetry_send_task, "TmSend", 4096, NULL, 1, &send_task, 0) != pdPASS)
+    {
+        g_running = false;
+        return TELEMETRY_ERROR;
+    }
+    g_send_task = send_task;
+    if (xTaskCreatePinnedToCore(telemetry_sample_task, "TmSample", 2048, NULL, 3, &sample_task, 0) != pdPASS)
+    {
+        telemetry_stop(); // 发送任务已创建, 等它退出
+        return TELEMETRY_ERROR;
+    }
+    g_sample_task = sample_task;
+
+    Serial.printf("[TELEMETRY] %u variables at %u Hz via %s\n", telemetry_var_count(), g_rate_hz,
+                  g_serial != NULL ? "serial" : "UDP");
+    return TELEMETRY_EOK;
+}
+
+// 停止遥测, 等两个任务在当前周期结束后退出
+void telemetry_stop(void)
+{
+    g_running = false;
+    for (uint32_t waited = 0; (g_sample_task != NULL || g_send_task != NULL) && waited < TELEMETRY_STOP_TIMEOUT_MS;
+         waited++)
+    {
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+}
@@ -0,0 +1,129 @@
+// 距离阈值(回差)的主机端测试: 用合成的距离序列检查状态变化
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../../include -I../../../../test -o distance_threshold_test distance_threshold_test.cpp ../../src/distance_threshold.cpp
+//   ./distance_threshold_test [随机种子]
+//
+// 序列按激光(20ms)和超声波(60ms)两种采样间隔合成, 距离带高斯噪声。检查:
+//   - 带噪声接近并停在near附近: 回差大于噪声时只变化一次, near==far时反复抖动
+//   - 多次接近/离开: 状态变化次数等于越过次数, 每次在第一个越过的样本上变化
+//   - 第一个样本的状态划分, far<near时按near处理
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "distance_threshold.h"
+#include "test_util.h"
+
+// [0, 1)内的均匀分布
+static double rng_unit(void)
+{
+    return (rng_next() >> 8) / 16777216.0;
+}
+
+// Box-Muller
+static double rng_gauss(double sigma)
+{
+    double u1 = rng_unit() + 1e-12, u2 = rng_unit();
+    return sigma * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+// 从start以speed(mm/s)移动到end后停住, 共duration_ms, 每period_ms一个样本
+static std::vector<float> ramp(double start, double end, double speed, int duration_ms, int period_ms, double noise)
+{
+    std::vector<float> trace;
+    for (int t = 0; t < duration_ms; t += period_ms)
+    {
+        double d = start + (end > start ? 1 : -1) * speed * t / 1000.0;
+        if ((end > start && d > end) || (end < start && d < end))
+            d = end;
+        trace.push_back((float)(d + rng_gauss(noise)));
+    }
+    return trace;
+}
+
+static uint32_t count_crossings(const std::vector<float> &trace, float near, float far)
+{
+    distance_threshold_t th;
+    distance_threshold_init(&th, near, far);
+    for (float d : trace)
+        distance_threshold_update(&th, d);
+    return th.crossings;
+}
+
+// 接近后停在near附近, 噪声在near上下来回
+static void test_settle_at_threshold(const char *name, int period_ms, double noise)
+{
+    std::vector<float> trace = ramp(600, 100, 150, 10000, period_ms, noise);
+    uint32_t with = count_crossings(trace, 100, 100 + 6 * (float)noise);
+    uint32_t without = count_crossings(trace, 100, 100);
+    // 第一个样本划为FAR算一次, 接近时FAR->NEAR算一次
+    CHECK(with == 2, "%s: %u state changes with hysteresis, expected 2", name, with);
+    CHECK(without > 10, "%s: only %u state changes without hysteresis", name, without);
+    printf("%-11s settle at near: %u changes with %.0f mm hysteresis, %u without\n", name, with, 6 * noise,
+           without);
+}
+
+// 反复接近/离开, 每次在第一个越过的样本上变化
+static void test_cycles(const char *name, int period_ms, double noise)
+{
+    const float near = 150, far = 250;
+    distance_threshold_t th;
+    distance_threshold_init(&th, near, far);
+    int cycles = 20, late = 0;
+    for (int c = 0; c < cycles; c++)
+    {
+        std::vector<float> in = ramp(500, 50, 300, 2000, period_ms, noise);
+        std::vector<float> out = ramp(50, 500, 300, 2000, period_ms, noise);
+        for (int pass = 0; pass < 2; pass++)
+        {
+            const std::vector<float> &trace = pass ? out : in;
+            uint8_t want = pass ? DISTANCE_STATE_FAR : DISTANCE_STATE_NEAR;
+            bool changed = false;
+            for (float d : trace)
+            {
+                bool crossed = pass ? d >= far : d <= near;
+                bool ch = distance_threshold_update(&th, d);
+                if (crossed && !changed)
+                {
+                    late += !ch && th.state != want;
+                    changed = true;
+                }
+            }
+            CHECK(th.state == want, "%s: cycle %d pass %d ends in state %u", name, c, pass, th.state);
+        }
+    }
+    CHECK(th.crossings == (uint32_t)(1 + 2 * cycles), "%s: %u changes for %d cycles", name, (unsigned)th.crossings,
+          cycles);
+    CHECK(late == 0, "%s: %d changes later than the first crossing sample", name, late);
+    printf("%-11s %d approach/leave cycles: %u changes\n", name, cycles, (unsigned)th.crossings);
+}
+
+static void test_first_sample(void)
+{
+    distance_threshold_t th;
+    distance_threshold_init(&th, 100, 200);
+    CHECK(th.state == DISTANCE_STATE_UNKNOWN, "initial state");
+    CHECK(distance_threshold_update(&th, 150) && th.state == DISTANCE_STATE_FAR, "first sample between near/far");
+    distance_threshold_init(&th, 100, 200);
+    CHECK(distance_threshold_update(&th, 100) && th.state == DISTANCE_STATE_NEAR, "first sample at near");
+    distance_threshold_init(&th, 200, 100);
+    CHECK(th.far == 200, "far < near not clamped");
+    CHECK(distance_threshold_update(&th, 199) && th.state == DISTANCE_STATE_NEAR, "clamped near");
+    CHECK(distance_threshold_update(&th, 201) && th.state == DISTANCE_STATE_FAR, "clamped far");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        rng_seed(argv[1]);
+    test_first_sample();
+    test_settle_at_threshold("laser", 20, 4.0);
+    test_settle_at_threshold("ultrasonic", 60, 10.0);
+    test_cycles("laser", 20, 4.0);
+    test_cycles("ultrasonic", 60, 10.0);
+    return test_summary();
+}
@@ -0,0 +1,178 @@
+// 激光距离滤波的主机端测试: 用距离序列(fixtures/*.csv)检查滤波效果和参数检查
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../../include -I../../../../test -o laser_filter_test laser_filter_test.cpp ../../src/laser_filter.cpp
+//   ./laser_filter_test [序列文件.csv]
+//
+// 序列文件每行"时间ms,原始距离mm,真实距离mm", #开头为注释。默认的fixtures/laser_approach.csv
+// 按ASCII模式20ms一个样本合成: 以150mm/s从820mm接近到120mm, 噪声4mm, 约每37个样本一个野值
+// (远处反射、8190溢出值、近处误测), 中途500ms无数据, 最后目标跳变到640mm。检查:
+//   - 野值全部被剔除; 静止时误差小于原始噪声; 运动中的最大误差(含中值窗口滞后)小于40mm
+//   - 跳变后在outlier_reset个样本内重新初始化, 重新初始化后清除野值标志
+//   - 无数据期间清除新鲜标志
+//   - laser_filter_config_check拒绝无效参数(outlier_reset<2, stale_ms超出范围)
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "laser_filter.h"
+#include "test_util.h"
+
+typedef struct
+{
+    uint32_t time;
+    uint16_t raw;
+    uint16_t truth;
+} trace_sample_t;
+
+static bool load_trace(const char *path, std::vector<trace_sample_t> &trace)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+        return false;
+    char line[128];
+    while (fgets(line, sizeof(line), f))
+    {
+        unsigned t, raw, truth;
+        if (line[0] == '#')
+            continue;
+        if (sscanf(line, "%u,%u,%u", &t, &raw, &truth) == 3)
+            trace.push_back({t, (uint16_t)raw, (uint16_t)truth});
+    }
+    fclose(f);
+    return !trace.empty();
+}
+
+static void test_config_check(void)
+{
+    laser_filter_config_t cfg;
+    laser_filter_default_config(&cfg);
+    CHECK(laser_filter_config_check(&cfg), "default config rejected");
+    CHECK(!laser_filter_config_check(NULL), "NULL accepted");
+
+    laser_filter_config_t bad = cfg;
+    bad.outlier_reset = 0;
+    CHECK(!laser_filter_config_check(&bad), "outlier_reset=0 accepted");
+    bad.outlier_reset = 1;
+    CHECK(!laser_filter_config_check(&bad), "outlier_reset=1 accepted");
+    bad = cfg;
+    bad.stale_ms = 0;
+    CHECK(!laser_filter_config_check(&bad), "stale_ms=0 accepted");
+    bad.stale_ms = LASER_FILTER_STALE_MAX_MS + 1;
+    CHECK(!laser_filter_config_check(&bad), "stale_ms too large accepted");
+    bad = cfg;
+    bad.median_window = LASER_FILTER_MEDIAN_MAX + 1;
+    CHECK(!laser_filter_config_check(&bad), "median_window too large accepted");
+    bad = cfg;
+    bad.alpha = 0.0f;
+    CHECK(!laser_filter_config_check(&bad), "alpha=0 accepted");
+
+    // 未经检查直接初始化时, outlier_reset按最小值处理: 单个野值不会重新初始化
+    laser_filter_t filter;
+    bad = cfg;
+    bad.outlier_reset = 0;
+    laser_filter_init(&filter, &bad);
+    laser_filter_update(&filter, 500, 0);
+    CHECK(!laser_filter_update(&filter, 2000, 20), "outlier accepted with outlier_reset=0");
+    CHECK(laser_filter_update(&filter, 501, 40), "good sample after outlier rejected");
+}
+
+static void test_trace(const char *path)
+{
+    std::vector<trace_sample_t> trace;
+    if (!load_trace(path, trace))
+    {
+        CHECK(false, "cannot read %s", path);
+        return;
+    }
+
+    laser_filter_config_t cfg;
+    laser_filter_default_config(&cfg);
+    laser_filter_t filter;
+    laser_filter_init(&filter, &cfg);
+
+    unsigned spikes = 0, spikes_accepted = 0, fresh_in_gap = 0;
+    double hold_sq = 0.0, hold_raw_sq = 0.0, max_err = 0.0;
+    unsigned hold = 0;
+    int jump_at = -1, reinit_at = -1;
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+        const trace_sample_t &s = trace[i];
+        bool spike = fabs((double)s.raw - s.truth) > cfg.outlier_gate;
+        bool jump = i > 0 && abs((int)s.truth - (int)trace[i - 1].truth) > (int)cfg.outlier_gate;
+
+        // 无数据期间每10ms检查一次新鲜标志
+        if (i > 0 && s.time - trace[i - 1].time > cfg.stale_ms)
+        {
+            for (uint32_t t = trace[i - 1].time + cfg.stale_ms + 10; t < s.time; t += 10)
+            {
+                laser_filtered_t out;
+                laser_filter_get(&filter, t, &out);
+                fresh_in_gap += (out.flags & LASER_FILTER_FLAG_FRESH) != 0;
+            }
+        }
+
+        if (jump)
+            jump_at = (int)i;
+        bool accepted = laser_filter_update(&filter, s.raw, s.time);
+        if (jump_at >= 0 && reinit_at < 0 && accepted)
+        {
+            // 重新初始化所用的样本被接受, 不应再带野值标志
+            laser_filtered_t out;
+            laser_filter_get(&filter, s.time, &out);
+            CHECK(!(out.flags & LASER_FILTER_FLAG_OUTLIER), "OUTLIER still set after re-init at sample %u",
+                  (unsigned)i);
+            reinit_at = (int)i;
+        }
+        if (spike && jump_at < 0)
+        {
+            spikes++;
+            spikes_accepted += accepted;
+        }
+
+        // 启动和跳变之后留出收敛时间; 之后的最大误差包括运动中中值窗口带来的滞后
+        laser_filtered_t out;
+        laser_filter_get(&filter, s.time, &out);
+        bool settling = i < 10 || (jump_at >= 0 && (int)i < jump_at + cfg.outlier_reset + 10);
+        if (settling || spike)
+            continue;
+        double err = out.distance - s.truth;
+        if (fabs(err) > max_err)
+            max_err = fabs(err);
+
+        // 静止段(前后10个样本真实距离不变): 滤波应减小噪声
+        bool still = i >= 10 && i + 10 < trace.size() && trace[i - 10].truth == s.truth &&
+                     trace[i + 10].truth == s.truth;
+        if (still)
+        {
+            hold_sq += err * err;
+            hold_raw_sq += ((double)s.raw - s.truth) * ((double)s.raw - s.truth);
+            hold++;
+        }
+    }
+
+    double rms = sqrt(hold_sq / hold), raw_rms = sqrt(hold_raw_sq / hold);
+    CHECK(spikes > 0 && spikes_accepted == 0, "%u of %u outliers accepted", spikes_accepted, spikes);
+    CHECK(hold > 0 && rms < raw_rms, "stationary RMS error %.2f mm, raw %.2f mm", rms, raw_rms);
+    CHECK(max_err < 40.0, "max tracking error %.1f mm", max_err);
+    CHECK(fresh_in_gap == 0, "FRESH set %u times during data gap", fresh_in_gap);
+    if (jump_at >= 0)
+        CHECK(reinit_at >= 0 && reinit_at - jump_at < cfg.outlier_reset,
+              "jump at sample %d, re-initialised at %d", jump_at, reinit_at);
+
+    printf("%s: %u samples, %u outliers rejected, stationary RMS error %.2f mm (raw %.2f), max %.1f mm, "
+           "jump re-init after %d samples\n",
+           path, (unsigned)trace.size(), spikes - spikes_accepted, rms, raw_rms, max_err,
+           jump_at >= 0 ? reinit_at - jump_at + 1 : 0);
+}
+
+int main(int argc, char **argv)
+{
+    test_config_check();
+    test_trace(argc > 1 ? argv[1] : "fixtures/laser_approach.csv");
+    return test_summary();
+}
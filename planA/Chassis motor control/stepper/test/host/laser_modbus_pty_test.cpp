@@ -0,0 +1,461 @@
+// 激光传感器Modbus模式的主机端测试: 在伪终端(pty)上模拟传感器, 用驱动的查询流程读取距离
+//
+// 编译并运行(在本目录, Linux/macOS):
+//   g++ -O2 -std=c++11 -pthread -I../../include -I../../../../test -o laser_modbus_pty_test laser_modbus_pty_test.cpp ../../src/laser_modbus.cpp ../../src/laser_parser.cpp
+//   ./laser_modbus_pty_test [查询秒数] [随机种子]
+//
+// 模拟传感器在pty主端应答0x03/0x06请求, 应答分成随机的小段写出, 并按比例注入:
+// 应答丢失、单字节错误(CRC失败)、应答前的垃圾字节; 工作模式寄存器为ASCII时改为主动输出"d: XX mm"。
+// 驱动端与板上的结构相同: 接收线程代替串口回调(解码应答、发布距离、把通知值交给查询方),
+// 主线程代替modbus_task, 调用同一份laser_mb_write_reg/laser_mb_poll写配置寄存器、按查询周期读取距离,
+// 最后写回ASCII模式并用laser_parser解析主动输出。
+// 等待应答用虚拟时钟: 传感器处理完请求、写出的字节全部被接收线程读完仍没有应答, 才算超时,
+// 结果与机器快慢无关, 同一个随机种子每次相同。检查:
+//   - 解码出的每个距离都是传感器发出过的值, 且顺序不乱
+//   - 超时数等于注入的丢失和错误应答数(垃圾字节不造成样本丢失), 样本数加超时数等于请求数
+//   - 切回ASCII模式后能解析出主动输出的距离
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "laser_modbus.h"
+#include "laser_parser.h"
+#include "test_util.h"
+
+#define POLL_MS 10          // 与LASER_SENSOR_MODBUS_POLL_MS相同
+#define STALL_MS 1000       // 虚拟时钟等不到结果时的真实时间上限, 只在测试本身出错时触发
+
+static uint64_t now_ms(void)
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// 把pty设为原始模式, 不做换行转换和回显
+static bool set_raw(int fd)
+{
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0)
+        return false;
+    cfmakeraw(&tio);
+    cfsetspeed(&tio, B115200);
+    return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+static void write_all(int fd, const uint8_t *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(fd, data, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return;
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+/**
+ * 模拟传感器: 在pty主端运行
+ */
+class SimSensor
+{
+public:
+    // 故障注入比例(每多少个应答注入一次)
+    static const uint32_t DROP_EVERY = 37;
+    static const uint32_t CORRUPT_EVERY = 29;
+    static const uint32_t GARBAGE_EVERY = 11;
+
+    explicit SimSensor(int fd) : fd_(fd) {}
+
+    void start() { thread_ = std::thread(&SimSensor::run, this); }
+
+    void stop()
+    {
+        stop_ = true;
+        thread_.join();
+    }
+
+    std::vector<uint16_t> sent;     // 发出的距离(含被丢弃/损坏的应答)
+    uint32_t dropped = 0;           // 不应答的读请求
+    uint32_t corrupted = 0;         // 注入单字节错误的应答
+    uint32_t garbage = 0;           // 应答前插入垃圾字节的次数
+    uint32_t ascii_lines = 0;       // ASCII模式下主动输出的行数
+    std::atomic<uint32_t> written{0}; // 写出的字节数(含垃圾字节和ASCII输出)
+    std::atomic<uint32_t> handled{0}; // 处理完的请求数(含不应答的)
+    uint16_t regs[8] = {0, 0, 0, LASER_MB_WORKMODE_ASCII, 0, 0, 0, 0};
+    std::mutex lock;
+
+private:
+    int fd_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+    uint8_t req_[LASER_MB_REQUEST_LEN];
+    size_t req_len_ = 0;
+    uint32_t replies_ = 0;
+    uint16_t distance_ = 500;
+
+    // 距离缓慢变化, 每次读取都不同, 以便检查顺序
+    uint16_t next_distance()
+    {
+        distance_ = (uint16_t)(300 + (distance_ - 300 + 1 + rng_next() % 3) % 2000);
+        return distance_;
+    }
+
+    void out(const uint8_t *data, size_t len)
+    {
+        write_all(fd_, data, len);
+        written += (uint32_t)len;
+    }
+
+    // 应答分成1-4字节的小段写出, 模拟串口FIFO和空闲超时造成的分段
+    void send(const uint8_t *frame, size_t len)
+    {
+        if (++replies_ % GARBAGE_EVERY == 0)
+        {
+            uint8_t junk[3] = {(uint8_t)rng_next(), LASER_MB_ADDR_DEFAULT, (uint8_t)rng_next()};
+            out(junk, sizeof(junk));
+            garbage++;
+        }
+        size_t pos = 0;
+        while (pos < len)
+        {
+            size_t n = 1 + rng_next() % 4;
+            if (n > len - pos)
+                n = len - pos;
+            out(frame + pos, n);
+            pos += n;
+            if (rng_next() % 4 == 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    void handle(const uint8_t *req)
+    {
+        reply_to(req);
+        handled++;
+    }
+
+    void reply_to(const uint8_t *req)
+    {
+        uint8_t reply[5 + 2 * LASER_MB_MAX_REGS];
+        size_t len;
+        uint16_t reg = (uint16_t)((req[2] << 8) | req[3]);
+        uint16_t value = (uint16_t)((req[4] << 8) | req[5]);
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (req[1] == LASER_MB_FUNC_READ && reg == LASER_MB_REG_DISTANCE && value == 1)
+        {
+            uint16_t d = next_distance();
+            sent.push_back(d);
+            if ((uint32_t)sent.size() % DROP_EVERY == 0)
+            {
+                dropped++;
+                return;
+            }
+            reply[0] = req[0];
+            reply[1] = LASER_MB_FUNC_READ;
+            reply[2] = 2;
+            reply[3] = (uint8_t)(d >> 8);
+            reply[4] = (uint8_t)d;
+            len = 5;
+        }
+        else if (req[1] == LASER_MB_FUNC_WRITE && reg < 8)
+        {
+            regs[reg] = value;
+            memcpy(reply, req, 6); // 写应答回显请求
+            len = 6;
+        }
+        else
+        {
+            reply[0] = req[0];
+            reply[1] = req[1] | LASER_MB_FUNC_ERROR;
+            reply[2] = 0x02; // 非法数据地址
+            len = 3;
+        }
+        uint16_t crc = laser_mb_crc16(reply, (uint16_t)len);
+        reply[len++] = (uint8_t)crc;
+        reply[len++] = (uint8_t)(crc >> 8);
+        if (req[1] == LASER_MB_FUNC_READ && (uint32_t)sent.size() % CORRUPT_EVERY == 0)
+        {
+            reply[3 + rng_next() % 2] ^= (uint8_t)(1 + rng_next() % 255);
+            corrupted++;
+        }
+        send(reply, len);
+    }
+
+    // 收齐8字节且CRC正确即为一个请求, 否则丢弃第一个字节重新对齐
+    void feed(uint8_t byte)
+    {
+        req_[req_len_++] = byte;
+        while (req_len_ == LASER_MB_REQUEST_LEN)
+        {
+            uint16_t crc = laser_mb_crc16(req_, 6);
+            if (req_[0] == LASER_MB_ADDR_DEFAULT && req_[6] == (uint8_t)crc && req_[7] == (uint8_t)(crc >> 8))
+            {
+                handle(req_);
+                req_len_ = 0;
+            }
+            else
+            {
+                memmove(req_, req_ + 1, --req_len_);
+            }
+        }
+    }
+
+    void run()
+    {
+        uint64_t next_line = now_ms();
+        while (!stop_)
+        {
+            struct pollfd pfd = {fd_, POLLIN, 0};
+            if (poll(&pfd, 1, 2) > 0 && (pfd.revents & POLLIN))
+            {
+                uint8_t buf[64];
+                ssize_t n = read(fd_, buf, sizeof(buf));
+                for (ssize_t i = 0; i < n; i++)
+                    feed(buf[i]);
+            }
+            // ASCII模式: 约每20ms主动输出一行
+            bool ascii;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                ascii = regs[LASER_MB_REG_WORKMODE] == LASER_MB_WORKMODE_ASCII;
+            }
+            if (ascii && now_ms() >= next_line)
+            {
+                char line[32];
+                int len = snprintf(line, sizeof(line), "d: %u mm\r\n", next_distance());
+                out((const uint8_t *)line, (size_t)len);
+                ascii_lines++;
+                next_line = now_ms() + 20;
+            }
+        }
+    }
+};
+
+/**
+ * 驱动端: 接收线程代替串口回调, 主线程代替modbus_task
+ */
+static int g_fd = -1;
+static std::mutex g_rx_lock; // 保护下面的解码状态和通知值, 接收线程每处理一批字节持有一次
+static std::condition_variable g_rx_cond;
+static laser_mb_decoder_t g_decoder;
+static laser_parser_t g_parser;
+static bool g_rx_modbus = true;      // 与g_rx_mode相同: 写回ASCII模式确认后才改按ASCII解析
+static std::vector<uint16_t> g_samples; // 发布的距离
+static uint32_t g_ascii_samples = 0;
+static bool g_ack_pending = false;   // 任务通知: 覆盖写入的通知值
+static uint32_t g_ack = 0;
+static std::atomic<uint32_t> g_read{0}; // 接收线程处理完的字节数
+static std::atomic<bool> g_rx_stop{false};
+static SimSensor *g_sensor = NULL;
+static uint32_t g_requests = 0; // 发出的请求数
+static uint32_t g_stalls = 0;   // 虚拟时钟没有结束的等待
+
+// 与laser_sensor.cpp的uart_rx_callback相同: 解码, 读应答发布距离, 应答打包成通知值交给查询方
+static void rx_thread(void)
+{
+    while (!g_rx_stop)
+    {
+        struct pollfd pfd = {g_fd, POLLIN, 0};
+        if (poll(&pfd, 1, 2) <= 0 || !(pfd.revents & POLLIN))
+            continue;
+        uint8_t buf[64];
+        ssize_t n = read(g_fd, buf, sizeof(buf));
+        if (n <= 0)
+            continue;
+        {
+            std::lock_guard<std::mutex> guard(g_rx_lock);
+            for (ssize_t i = 0; i < n; i++)
+            {
+                laser_mb_reply_t reply;
+                uint16_t d;
+                if (!g_rx_modbus)
+                {
+                    g_ascii_samples += laser_parser_feed(&g_parser, buf[i], &d);
+                }
+                else if (laser_mb_decoder_feed(&g_decoder, buf[i], &reply))
+                {
+                    if (reply.func == LASER_MB_FUNC_READ && reply.exception == 0 && reply.count >= 1)
+                        g_samples.push_back(reply.values[0]);
+                    g_ack = laser_mb_reply_ack(&reply);
+                    g_ack_pending = true;
+                }
+            }
+        }
+        // 字节处理完(通知值已交出)后才计入, 查询方看到全部读完时不会漏掉应答
+        g_read += (uint32_t)n;
+        g_rx_cond.notify_all();
+    }
+}
+
+static void port_send(const uint8_t *frame, uint8_t len)
+{
+    write_all(g_fd, frame, len);
+    g_requests++;
+}
+
+static void port_clear(void)
+{
+    std::lock_guard<std::mutex> guard(g_rx_lock);
+    g_ack_pending = false;
+}
+
+// 虚拟时钟: 传感器处理完全部请求、写出的字节全部读完时仍没有通知, 即为超时(timeout_ms不用真实时间)
+static bool port_wait(uint32_t timeout_ms, uint32_t *ack)
+{
+    (void)timeout_ms;
+    std::unique_lock<std::mutex> guard(g_rx_lock);
+    std::chrono::steady_clock::time_point stall = std::chrono::steady_clock::now() + std::chrono::milliseconds(STALL_MS);
+    while (true)
+    {
+        if (g_ack_pending)
+        {
+            g_ack_pending = false;
+            *ack = g_ack;
+            return true;
+        }
+        if (g_sensor->handled == g_requests && g_read == g_sensor->written)
+            return false;
+        if (std::chrono::steady_clock::now() >= stall)
+        {
+            g_stalls++;
+            return false;
+        }
+        g_rx_cond.wait_for(guard, std::chrono::milliseconds(1));
+    }
+}
+
+static const laser_mb_port_t g_port = {port_send, port_clear, port_wait};
+
+int main(int argc, char **argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 3.0;
+    if (argc > 2)
+        rng_seed(argv[2]);
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        perror("posix_openpt");
+        return 1;
+    }
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (slave < 0 || !set_raw(master) || !set_raw(slave))
+    {
+        perror("pty");
+        return 1;
+    }
+    fcntl(master, F_SETFL, O_NONBLOCK);
+
+    SimSensor sensor(master);
+    g_sensor = &sensor;
+    g_fd = slave;
+    laser_mb_decoder_reset(&g_decoder, LASER_MB_ADDR_DEFAULT);
+    laser_parser_reset(&g_parser);
+    sensor.start();
+    std::thread rx(rx_thread);
+
+    // 切换到Modbus模式: 写三个配置寄存器
+    CHECK(laser_mb_write_reg(&g_port, LASER_MB_REG_WORKMODE, LASER_MB_WORKMODE_MODBUS), "write work mode");
+    CHECK(laser_mb_write_reg(&g_port, LASER_MB_REG_MEASMODE, LASER_MB_MEASMODE_HIGH_SPEED), "write measure mode");
+    CHECK(laser_mb_write_reg(&g_port, LASER_MB_REG_OUTFREQ, LASER_MB_OUTFREQ_MAX), "write output frequency");
+    {
+        std::lock_guard<std::mutex> guard(sensor.lock);
+        CHECK(sensor.regs[LASER_MB_REG_WORKMODE] == LASER_MB_WORKMODE_MODBUS &&
+                  sensor.regs[LASER_MB_REG_MEASMODE] == LASER_MB_MEASMODE_HIGH_SPEED &&
+                  sensor.regs[LASER_MB_REG_OUTFREQ] == LASER_MB_OUTFREQ_MAX,
+              "sensor registers not configured");
+    }
+    // 配置前的ASCII输出可能被当作帧头造成CRC错误, 只统计查询期间的
+    uint32_t crc_before;
+    {
+        std::lock_guard<std::mutex> guard(g_rx_lock);
+        crc_before = g_decoder.crc_errors;
+    }
+
+    // 与modbus_task相同的查询循环, 按虚拟时钟运行seconds秒的查询次数
+    uint8_t request[LASER_MB_REQUEST_LEN];
+    uint8_t len = laser_mb_build_read(LASER_MB_ADDR_DEFAULT, LASER_MB_REG_DISTANCE, 1, request);
+    uint32_t polls = (uint32_t)(seconds * 1000 / POLL_MS);
+    uint32_t first_request = g_requests;
+    uint32_t timeouts = 0;
+    for (uint32_t i = 0; i < polls; i++)
+    {
+        if (!laser_mb_poll(&g_port, request, len, POLL_MS))
+            timeouts++;
+    }
+    uint32_t requests = g_requests - first_request;
+    size_t samples;
+    uint32_t crc_errors;
+    {
+        std::lock_guard<std::mutex> guard(g_rx_lock);
+        samples = g_samples.size();
+        crc_errors = g_decoder.crc_errors - crc_before;
+    }
+
+    // 切回ASCII模式, 确认后改按ASCII解析主动输出
+    CHECK(laser_mb_write_reg(&g_port, LASER_MB_REG_WORKMODE, LASER_MB_WORKMODE_ASCII), "restore ASCII mode");
+    {
+        std::lock_guard<std::mutex> guard(g_rx_lock);
+        laser_parser_reset(&g_parser);
+        g_rx_modbus = false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    g_rx_stop = true;
+    rx.join();
+    sensor.stop();
+
+    // 解码出的距离必须是传感器按顺序发出的值的子序列
+    std::lock_guard<std::mutex> guard(sensor.lock);
+    size_t pos = 0;
+    bool ordered = true;
+    for (uint16_t d : g_samples)
+    {
+        while (pos < sensor.sent.size() && sensor.sent[pos] != d)
+            pos++;
+        if (pos == sensor.sent.size())
+        {
+            ordered = false;
+            break;
+        }
+        pos++;
+    }
+    uint32_t faults = sensor.dropped + sensor.corrupted;
+    CHECK(ordered, "decoded distances are not a subsequence of the sent ones");
+    CHECK(g_stalls == 0, "%u waits did not settle within %d ms", (unsigned)g_stalls, STALL_MS);
+    // 垃圾字节中的地址字节可能被当作帧头, 凑成一个CRC错误的帧后重新对齐
+    CHECK(crc_errors >= sensor.corrupted && crc_errors <= faults + sensor.garbage,
+          "crc errors %u, injected %u corrupted + %u garbage", (unsigned)crc_errors, (unsigned)sensor.corrupted,
+          (unsigned)sensor.garbage);
+    CHECK(timeouts == faults, "timeouts %u, injected drops+corruptions %u", (unsigned)timeouts, (unsigned)faults);
+    CHECK(requests == polls && samples + timeouts == requests, "samples %u + timeouts %u != requests %u",
+          (unsigned)samples, (unsigned)timeouts, (unsigned)requests);
+    CHECK(samples >= 0.85 * polls, "only %u of %u polls answered", (unsigned)samples, (unsigned)polls);
+    CHECK(g_ascii_samples > 0, "no ASCII samples after switching back");
+
+    printf("modbus: %u requests (%.1f s at %d ms), %u samples, %u dropped, %u corrupted, %u garbage -> "
+           "%u CRC errors, %u timeouts\n",
+           (unsigned)requests, seconds, POLL_MS, (unsigned)samples, (unsigned)sensor.dropped,
+           (unsigned)sensor.corrupted, (unsigned)sensor.garbage, (unsigned)crc_errors, (unsigned)timeouts);
+    printf("ascii after switch back: %u samples\n", (unsigned)g_ascii_samples);
+    close(slave);
+    close(master);
+    return test_summary();
+}
@@ -0,0 +1,117 @@
+// 激光传感器ASCII解析器的主机端测试: 用fixtures中的字节流检查解析结果
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../../include -I../../../../test -o laser_parser_test laser_parser_test.cpp ../../src/laser_parser.cpp
+//   ./laser_parser_test [fixtures目录]
+//
+// fixtures/<名称>.bin 是串口收到的原始字节, <名称>.expected 每行一个应解析出的距离(mm),
+// 最后一行"errors N"为应计入的错误数。每个字节流检查:
+//   - 从头解析, 距离和错误数与expected完全一致
+//   - 从任意字节开始解析(上电时串口已在发送), 去掉开头最多一个残缺值后, 结果是expected的一个后缀
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "laser_parser.h"
+#include "test_util.h"
+
+static bool read_file(const std::string &path, std::vector<uint8_t> &data)
+{
+    FILE *f = fopen(path.c_str(), "rb");
+    if (f == NULL)
+        return false;
+    int c;
+    while ((c = fgetc(f)) != EOF)
+        data.push_back((uint8_t)c);
+    fclose(f);
+    return true;
+}
+
+static bool read_expected(const std::string &path, std::vector<uint16_t> &values, unsigned &errors)
+{
+    FILE *f = fopen(path.c_str(), "r");
+    if (f == NULL)
+        return false;
+    char line[64];
+    errors = 0;
+    while (fgets(line, sizeof(line), f))
+    {
+        unsigned v;
+        if (sscanf(line, "errors %u", &errors) == 1)
+            continue;
+        if (sscanf(line, "%u", &v) == 1)
+            values.push_back((uint16_t)v);
+    }
+    fclose(f);
+    return true;
+}
+
+// 从offset开始解析
+static std::vector<uint16_t> parse(const std::vector<uint8_t> &data, size_t offset, laser_parser_t *parser)
+{
+    std::vector<uint16_t> out;
+    laser_parser_reset(parser);
+    for (size_t i = offset; i < data.size(); i++)
+    {
+        uint16_t d;
+        if (laser_parser_feed(parser, data[i], &d))
+            out.push_back(d);
+    }
+    return out;
+}
+
+// got[skip:]是否为expected的后缀
+static bool is_suffix(const std::vector<uint16_t> &got, size_t skip, const std::vector<uint16_t> &expected)
+{
+    size_t n = got.size() - skip;
+    return n <= expected.size() && std::equal(got.begin() + skip, got.end(), expected.end() - n);
+}
+
+static std::string join(const std::vector<uint16_t> &v)
+{
+    std::string s;
+    for (uint16_t x : v)
+        s += (s.empty() ? "" : " ") + std::to_string(x);
+    return s;
+}
+
+static void test_fixture(const std::string &dir, const char *name)
+{
+    std::vector<uint8_t> data;
+    std::vector<uint16_t> expected;
+    unsigned errors;
+    if (!read_file(dir + "/" + name + ".bin", data) || !read_expected(dir + "/" + name + ".expected", expected, errors))
+    {
+        CHECK(false, "%s: missing fixture in %s", name, dir.c_str());
+        return;
+    }
+
+    laser_parser_t parser;
+    std::vector<uint16_t> got = parse(data, 0, &parser);
+    CHECK(got == expected, "%s: got [%s], expected [%s]", name, join(got).c_str(), join(expected).c_str());
+    CHECK(parser.errors == errors, "%s: %u errors, expected %u", name, (unsigned)parser.errors, errors);
+    CHECK(parser.samples == got.size(), "%s: samples=%u", name, (unsigned)parser.samples);
+
+    // 从中途开始: 第一行可能解析出一个残缺值, 去掉它之后应是expected的一个后缀
+    for (size_t offset = 1; offset < data.size(); offset++)
+    {
+        got = parse(data, offset, &parser);
+        bool suffix = is_suffix(got, 0, expected) || (!got.empty() && is_suffix(got, 1, expected));
+        CHECK(suffix, "%s: offset %u gives [%s]", name, (unsigned)offset, join(got).c_str());
+    }
+    printf("%-12s %4u bytes, %2u values, %u errors\n", name, (unsigned)data.size(), (unsigned)expected.size(), errors);
+}
+
+int main(int argc, char **argv)
+{
+    std::string dir = argc > 1 ? argv[1] : "fixtures";
+    test_fixture(dir, "laser_ascii");
+    test_fixture(dir, "laser_plain");
+    test_fixture(dir, "laser_noise");
+    return test_summary();
+}
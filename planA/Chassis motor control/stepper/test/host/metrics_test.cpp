@@ -0,0 +1,190 @@
+// 运行指标编码的主机端测试: metrics_report上报的结构帧、数值帧和JSON, 以及经tools/metrics_decode.py的往返
+//
+// 编译并运行(在本目录, 需要python3):
+//   g++ -O2 -std=c++11 -I../../include -I../../../../test -o metrics_test metrics_test.cpp ../../src/metrics.cpp
+//   ./metrics_test [随机种子]
+//
+// 登记计数器、瞬时值(含负值)和直方图(含溢出桶), 按随机的更新生成若干快照。检查:
+//   - 结构帧和数值帧的同步字节、帧类型、长度和CRC; 缓冲区不足时编码和JSON格式化都返回0
+//   - 像metrics_report的二进制输出一样拼成字节流(结构帧每METRICS_REPORT_SCHEMA_EVERY帧重发一次),
+//     前面加一个没有结构帧的数值帧, 中间插入垃圾字节(含同步字节)和损坏一个字节的帧,
+//     用metrics_decode.py解码后每行与同一快照的metrics_format_json输出逐字节相同, 损坏的帧和没有结构帧的数值帧被跳过,
+//     垃圾中的同步字节不会让解码工具按错误的长度吞掉后面的帧
+// 全部通过时返回0, 否则打印失败项并返回1。没有python3时跳过往返检查并打印提示。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <string>
+#include <vector>
+
+#include "metrics.h"
+#include "test_util.h"
+
+#define METRICS_REPORT_SCHEMA_EVERY 10 // 与metrics_report.h相同(该头文件依赖Arduino)
+#define SNAPSHOTS 25
+#define DECODE_CMD "python3 ../../../tools/metrics_decode.py "
+
+static metrics_counter_t g_samples;
+static metrics_gauge_t g_temperature;
+static metrics_histogram_t g_latency;
+static metrics_counter_t g_errors;
+static const uint32_t g_latency_bounds[] = {5, 10, 50, 200};
+
+static void register_metrics(void)
+{
+    CHECK(metrics_register_counter(&g_samples, "test.samples") == METRICS_EOK, "register counter");
+    CHECK(metrics_register_gauge(&g_temperature, "test.temperature_c") == METRICS_EOK, "register gauge");
+    CHECK(metrics_register_histogram(&g_latency, "test.latency_ms", g_latency_bounds,
+                                     sizeof(g_latency_bounds) / sizeof(g_latency_bounds[0])) == METRICS_EOK,
+          "register histogram");
+    CHECK(metrics_register_counter(&g_errors, "test.errors") == METRICS_EOK, "register counter");
+    CHECK(metrics_register_counter(&g_errors, "test.errors") == METRICS_EEXIST, "duplicate registration");
+    CHECK(metrics_count() == 4, "count %u", metrics_count());
+}
+
+// 随机更新: 计数器增加, 瞬时值在正负之间变化, 直方图的值覆盖各桶和溢出桶
+static void update_metrics(void)
+{
+    metrics_counter_add(&g_samples, 1 + rng_next() % 200);
+    if (rng_next() % 4 == 0)
+        metrics_counter_inc(&g_errors);
+    metrics_gauge_set(&g_temperature, (int32_t)(rng_next() % 121) - 40);
+    for (uint32_t n = rng_next() % 20; n > 0; n--)
+        metrics_histogram_observe(&g_latency, rng_next() % 300);
+}
+
+// 帧头、长度和CRC
+static void check_frame(const uint8_t *frame, size_t len, uint8_t type, const char *what)
+{
+    CHECK(len >= METRICS_FRAME_OVERHEAD, "%s: length %u", what, (unsigned)len);
+    if (len < METRICS_FRAME_OVERHEAD)
+        return;
+    uint16_t payload = (uint16_t)(frame[3] | (frame[4] << 8));
+    uint16_t crc = (uint16_t)(frame[len - 2] | (frame[len - 1] << 8));
+    CHECK(frame[0] == METRICS_FRAME_SYNC0 && frame[1] == METRICS_FRAME_SYNC1, "%s: sync", what);
+    CHECK(frame[2] == type, "%s: type %u", what, frame[2]);
+    CHECK((size_t)payload + METRICS_FRAME_OVERHEAD == len, "%s: payload %u in a %u-byte frame", what, payload,
+          (unsigned)len);
+    CHECK(crc == metrics_crc16(frame + 2, len - 4, 0xFFFF), "%s: crc", what);
+}
+
+static void append(std::vector<uint8_t> *stream, const uint8_t *data, size_t len)
+{
+    stream->insert(stream->end(), data, data + len);
+}
+
+// 垃圾字节, 有时带一个同步字节对
+static void append_garbage(std::vector<uint8_t> *stream)
+{
+    for (uint32_t n = 1 + rng_next() % 8; n > 0; n--)
+        stream->push_back((uint8_t)rng_next());
+    if (rng_next() % 2)
+    {
+        stream->push_back(METRICS_FRAME_SYNC0);
+        stream->push_back(METRICS_FRAME_SYNC1);
+        stream->push_back(METRICS_FRAME_VALUES);
+    }
+}
+
+static bool run_decoder(const char *path, std::vector<std::string> *lines, int *status)
+{
+    std::string cmd = std::string(DECODE_CMD) + path + " 2>/dev/null";
+    FILE *p = popen(cmd.c_str(), "r");
+    if (p == NULL)
+        return false;
+    char line[4096];
+    while (fgets(line, sizeof(line), p) != NULL)
+    {
+        line[strcspn(line, "\n")] = '\0';
+        lines->push_back(line);
+    }
+    *status = pclose(p);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        rng_seed(argv[1]);
+    register_metrics();
+
+    uint8_t frame[1024];
+    char json[2048];
+    std::vector<uint8_t> stream;
+    std::vector<std::string> expected;
+
+    // 接入时先收到的数值帧没有结构帧, 解码工具应跳过
+    update_metrics();
+    size_t len = metrics_encode_values(frame, sizeof(frame), 1);
+    check_frame(frame, len, METRICS_FRAME_VALUES, "values");
+    append(&stream, frame, len);
+    append_garbage(&stream);
+
+    size_t schema_len = 0, values_len = 0;
+    for (uint32_t i = 0; i < SNAPSHOTS; i++)
+    {
+        if (i % METRICS_REPORT_SCHEMA_EVERY == 0)
+        {
+            schema_len = metrics_encode_schema(frame, sizeof(frame));
+            check_frame(frame, schema_len, METRICS_FRAME_SCHEMA, "schema");
+            append(&stream, frame, schema_len);
+        }
+        update_metrics();
+        uint32_t time_ms = 1000 + i * 1000 + rng_next() % 7;
+        values_len = metrics_encode_values(frame, sizeof(frame), time_ms);
+        check_frame(frame, values_len, METRICS_FRAME_VALUES, "values");
+        CHECK(metrics_format_json(json, sizeof(json), time_ms) > 0, "json");
+
+        if (i % 7 == 3)
+        {
+            // 损坏一个字节的帧被跳过, 不产生输出
+            frame[METRICS_FRAME_OVERHEAD + rng_next() % (values_len - METRICS_FRAME_OVERHEAD)] ^= 0x10;
+            append(&stream, frame, values_len);
+        }
+        else
+        {
+            append(&stream, frame, values_len);
+            expected.push_back(json);
+        }
+        if (rng_next() % 3 == 0)
+            append_garbage(&stream);
+    }
+
+    // 缓冲区不足
+    CHECK(metrics_encode_schema(frame, schema_len - 1) == 0, "schema into a short buffer");
+    CHECK(metrics_encode_values(frame, values_len - 1, 0) == 0, "values into a short buffer");
+    size_t json_len = metrics_format_json(json, sizeof(json), 42);
+    CHECK(json_len > 0 && metrics_format_json(json, json_len, 42) == 0, "json into a short buffer");
+    CHECK(metrics_format_json(json, json_len + 1, 42) == json_len, "json into an exact buffer");
+
+    // 经metrics_decode.py往返
+    const char *path = "metrics_test.tmp";
+    FILE *f = fopen(path, "wb");
+    CHECK(f != NULL && fwrite(stream.data(), 1, stream.size(), f) == stream.size(), "write %s", path);
+    if (f != NULL)
+        fclose(f);
+    std::vector<std::string> lines;
+    int status = 0;
+    bool ran = run_decoder(path, &lines, &status);
+    remove(path);
+    if (ran && WIFEXITED(status) && WEXITSTATUS(status) == 127)
+    {
+        printf("python3 not found, metrics_decode.py round trip skipped\n");
+    }
+    else
+    {
+        CHECK(ran && WIFEXITED(status) && WEXITSTATUS(status) == 0, "metrics_decode.py failed (status %d)", status);
+        CHECK(lines.size() == expected.size(), "decoded %u snapshots, expected %u", (unsigned)lines.size(),
+              (unsigned)expected.size());
+        for (size_t i = 0; i < lines.size() && i < expected.size(); i++)
+            CHECK(lines[i] == expected[i], "snapshot %u:\n  decoded  %s\n  expected %s", (unsigned)i,
+                  lines[i].c_str(), expected[i].c_str());
+        printf("round trip: %u bytes, %u snapshots decoded\n", (unsigned)stream.size(), (unsigned)lines.size());
+    }
+
+    printf("frames: schema %u bytes, values %u bytes, json %u chars\n", (unsigned)schema_len, (unsigned)values_len,
+           (unsigned)json_len);
+    return test_summary();
+}
@@ -0,0 +1,169 @@
+// 参数命令的主机端测试: 把tools/motion_optimize.py输出的参数文件逐行当作串口命令执行
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../../include -I../../../../test -o params_test params_test.cpp ../../src/params.cpp
+//   ./params_test
+//
+// 检查:
+//   - 参数文件逐行交给params_command(与params_store_start的串口命令相同): 注释行和空行回复为空、不报错,
+//     "名称 = 值"行生效, 结果与params_parse_text解析整个文件相同
+//   - 行尾的#注释被去掉: "名称 = 值 # 说明"、"set 名称 值 # 说明"、"get 名称 # 说明"都正常执行
+//   - 注释中的'='不会让未知命令被当作赋值; 错误的值和未登记的名称仍然报错
+//   - params_load_file: 超过缓冲区的行按"line too long"报错(带文件行号), 其后半段不会被当作一行赋值;
+//     最后一行没有换行时照常生效
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "params.h"
+#include "test_util.h"
+
+static volatile int32_t g_hook_speed = 1500;
+static volatile int32_t g_hook_accel = 2000;
+static volatile int32_t g_slide_speed = 1800;
+static volatile float g_margin = 0.5f;
+
+// 与motion_optimize.py的输出格式相同: 说明单独成行, 下一行是"名称 = 值"
+static const char OPTIMIZED[] = "# motion_optimize.py: margin 0.80, limits motion_limits.cfg\n"
+                                "# 预计每次任务节省 12.539 s (只计升降/平移动作本身)\n"
+                                "# hook1_up: torque\n"
+                                "move.hook1_up.speed = 2300\n"
+                                "move.hook1_up.accel = 2933\n"
+                                "\n"
+                                "# store_slide: speed limit\n"
+                                "move.store_slide.speed = 2390\n";
+
+static void register_params(void)
+{
+    CHECK(params_register_int("move.hook1_up.speed", &g_hook_speed, 100, 4000) == PARAMS_EOK, "register");
+    CHECK(params_register_int("move.hook1_up.accel", &g_hook_accel, 100, 8000) == PARAMS_EOK, "register");
+    CHECK(params_register_int("move.store_slide.speed", &g_slide_speed, 100, 4000) == PARAMS_EOK, "register");
+    CHECK(params_register_float("test.margin", &g_margin, 0.0f, 1.0f) == PARAMS_EOK, "register");
+}
+
+static void expect_optimized(const char *what)
+{
+    CHECK(g_hook_speed == 2300 && g_hook_accel == 2933 && g_slide_speed == 2390, "%s: %d %d %d", what,
+          (int)g_hook_speed, (int)g_hook_accel, (int)g_slide_speed);
+}
+
+// 逐行发送参数文件, 像串口终端粘贴一样
+static void test_paste_lines(void)
+{
+    char reply[256];
+    char line[128];
+    const char *p = OPTIMIZED;
+    int lines = 0, silent = 0;
+    while (*p != '\0')
+    {
+        const char *end = strchr(p, '\n');
+        size_t len = end != NULL ? (size_t)(end - p + 1) : strlen(p);
+        memcpy(line, p, len);
+        line[len] = '\0';
+        p += len;
+        lines++;
+
+        strcpy(reply, "unchanged");
+        uint8_t ret = params_command(line, reply, sizeof(reply));
+        CHECK(ret == PARAMS_EOK, "line %d '%.*s' -> %u: %s", lines, (int)strcspn(line, "\n"), line, ret, reply);
+        if (line[strspn(line, " \t\r\n")] == '#' || line[strspn(line, " \t\r\n")] == '\0')
+        {
+            CHECK(reply[0] == '\0', "comment line %d replied '%s'", lines, reply);
+            silent++;
+        }
+    }
+    expect_optimized("pasted lines");
+    printf("paste: %d lines, %d comment/blank lines silent\n", lines, silent);
+
+    // 整个文件解析的结果相同
+    params_reset(NULL);
+    char err[128] = "";
+    CHECK(params_parse_text(OPTIMIZED, err, sizeof(err)) == PARAMS_EOK, "parse_text: %s", err);
+    expect_optimized("parse_text");
+    params_reset(NULL);
+}
+
+static void test_trailing_comments(void)
+{
+    char reply[256];
+    CHECK(params_command("move.hook1_up.speed = 2300   # torque\n", reply, sizeof(reply)) == PARAMS_EOK &&
+              g_hook_speed == 2300,
+          "assignment with comment: %s", reply);
+    CHECK(params_command("set move.hook1_up.accel 2933 # torque\r\n", reply, sizeof(reply)) == PARAMS_EOK &&
+              g_hook_accel == 2933,
+          "set with comment: %s", reply);
+    CHECK(params_command("set test.margin = 0.8#margin\n", reply, sizeof(reply)) == PARAMS_EOK && g_margin == 0.8f,
+          "set = with comment: %s", reply);
+    CHECK(params_command("get move.hook1_up.speed # check\n", reply, sizeof(reply)) == PARAMS_EOK &&
+              strstr(reply, "2300") != NULL,
+          "get with comment: %s", reply);
+    CHECK(params_command("reset move.hook1_up.speed # back\n", reply, sizeof(reply)) == PARAMS_EOK &&
+              g_hook_speed == 1500,
+          "reset with comment: %s", reply);
+    CHECK(params_command("   # 只有注释\n", reply, sizeof(reply)) == PARAMS_EOK && reply[0] == '\0', "comment: %s",
+          reply);
+    CHECK(params_command("\r\n", reply, sizeof(reply)) == PARAMS_EOK && reply[0] == '\0', "blank: %s", reply);
+
+    // 错误仍然报告
+    CHECK(params_command("frobnicate # a = b\n", reply, sizeof(reply)) == PARAMS_EINVAL &&
+              strstr(reply, "unknown command") != NULL,
+          "'=' in comment made an assignment: %s", reply);
+    CHECK(params_command("move.hook1_up.speed = # 2300\n", reply, sizeof(reply)) == PARAMS_EINVAL &&
+              g_hook_speed == 1500,
+          "value only in comment: %s", reply);
+    CHECK(params_command("move.nothing = 1 # x\n", reply, sizeof(reply)) == PARAMS_ENOTFOUND, "unknown name: %s",
+          reply);
+    CHECK(params_command("move.hook1_up.speed = 9999 # too fast\n", reply, sizeof(reply)) == PARAMS_ERANGE &&
+              g_hook_speed == 1500,
+          "out of range: %s", reply);
+    params_reset(NULL);
+    printf("trailing comments: ok\n");
+}
+
+static void write_file(const char *path, const char *text)
+{
+    FILE *f = fopen(path, "w");
+    CHECK(f != NULL, "cannot create %s", path);
+    if (f == NULL)
+        return;
+    fputs(text, f);
+    fclose(f);
+}
+
+static void test_load_file(void)
+{
+    const char *path = "params_test.tmp";
+    char text[512];
+    char err[256] = "";
+
+    // 第2行长于缓冲区: 注释占满fgets的一次读取, 后半段恰好是一个赋值
+    int n = snprintf(text, sizeof(text), "move.store_slide.speed = 2390\n# ");
+    memset(text + n, 'x', 127);
+    snprintf(text + n + 127, sizeof(text) - n - 127, "move.hook1_up.speed = 3999\nmove.hook1_up.accel = 2933");
+    write_file(path, text);
+    CHECK(params_load_file(path, err, sizeof(err)) == PARAMS_EINVAL, "long line accepted: %s", err);
+    CHECK(strstr(err, ":2: line too long") != NULL, "error message: %s", err);
+    CHECK(g_hook_speed == 1500, "tail of the long line applied: %d", (int)g_hook_speed);
+    CHECK(g_slide_speed == 2390 && g_hook_accel == 2933, "other lines not applied: %d %d", (int)g_slide_speed,
+          (int)g_hook_accel);
+    params_reset(NULL);
+
+    // 正好能放下的行和没有结尾换行的最后一行
+    write_file(path, "move.hook1_up.speed = 2300\nmove.hook1_up.accel = 2933");
+    CHECK(params_load_file(path, err, sizeof(err)) == PARAMS_EOK && g_hook_speed == 2300 && g_hook_accel == 2933,
+          "last line without newline: %s", err);
+    params_reset(NULL);
+    remove(path);
+    printf("load file: ok\n");
+}
+
+int main(void)
+{
+    register_params();
+    test_paste_lines();
+    test_trailing_comments();
+    test_load_file();
+    return test_summary();
+}
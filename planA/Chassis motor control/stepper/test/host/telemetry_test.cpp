@@ -0,0 +1,229 @@
+// 遥测编码的主机端测试: 登记变量采样、差分编码成包, 再像tools/telemetry_recv一样解码还原
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../../include -I../../../../test -o telemetry_test telemetry_test.cpp ../../src/telemetry.cpp ../../src/metrics.cpp
+//   ./telemetry_test [随机种子]
+//
+// 登记与task.h相同的升降读取函数(位置比例1, 速度由读取函数乘10、比例10), 以及整数、float和uint16变量,
+// 按随机的加减速曲线采样并编码。检查:
+//   - 还原值(整数原样, 其他除以比例)与变量值一致: 读取函数的结果不再乘比例, 速度123.4还原为123.4而不是1234
+//   - 连续的字节流中每个包都能找到并解码, 包序号和样本数与发送的一致; 损坏一个字节的包被跳过
+//   - 同一地址或读取函数重复登记返回TELEMETRY_EEXIST, 比例不大于0返回TELEMETRY_EINVAL
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "telemetry.h"
+#include "test_util.h"
+
+// 模拟的升降轴, 对应task.h中的stepper1
+static long g_lift_position = 0;
+static float g_lift_speed = 0.0f;
+
+// 与task.h的读取函数相同
+static int32_t lift_position(void) { return g_lift_position; }
+static int32_t lift_speed(void) { return (int32_t)lroundf(g_lift_speed * 10); }
+
+static volatile int32_t g_pulses = 0;
+static volatile float g_distance = 0.0f;
+static volatile uint16_t g_raw_mm = 0;
+
+#define RATE_HZ 1000
+#define VARS 5
+
+// 一个样本对应的变量值, 用于和解码结果比较
+typedef struct
+{
+    double values[VARS];
+} expected_t;
+
+static void test_register(void)
+{
+    CHECK(telemetry_register_reader("lift.position", lift_position, 1) == TELEMETRY_EOK, "register lift.position");
+    CHECK(telemetry_register_reader("lift.speed", lift_speed, 10) == TELEMETRY_EOK, "register lift.speed");
+    CHECK(telemetry_register("chassis.pulses", TELEMETRY_TYPE_I32, &g_pulses, 1) == TELEMETRY_EOK, "register pulses");
+    CHECK(telemetry_register("laser.filtered_mm", TELEMETRY_TYPE_FLOAT, &g_distance, 10) == TELEMETRY_EOK,
+          "register float");
+    CHECK(telemetry_register("laser.raw_mm", TELEMETRY_TYPE_U16, &g_raw_mm, 1) == TELEMETRY_EOK, "register u16");
+
+    CHECK(telemetry_register_reader("lift.speed2", lift_speed, 10) == TELEMETRY_EEXIST, "reader registered twice");
+    CHECK(telemetry_register("pulses2", TELEMETRY_TYPE_I32, &g_pulses, 1) == TELEMETRY_EEXIST,
+          "address registered twice");
+    CHECK(telemetry_register("bad.scale", TELEMETRY_TYPE_I32, &g_raw_mm, 0) == TELEMETRY_EINVAL, "zero scale");
+    CHECK(telemetry_var_count() == VARS, "%u variables", telemetry_var_count());
+}
+
+// 与tools/telemetry_recv相同: 比例为1时原样, 否则除以比例
+static double restore(const telemetry_schema_t *schema, uint8_t i, int32_t value)
+{
+    return schema->scales[i] == 1.0f ? (double)value : value / (double)schema->scales[i];
+}
+
+static void test_reader_scale(void)
+{
+    uint8_t buf[TELEMETRY_PACKET_MAX];
+    telemetry_sample_t sample;
+    g_lift_position = 2900;
+    g_lift_speed = 123.4f;
+    telemetry_sample(&sample, 0);
+
+    telemetry_schema_t schema;
+    const uint8_t *payload;
+    size_t payload_len;
+    uint8_t type;
+    size_t len = telemetry_encode_schema(buf, sizeof(buf), RATE_HZ);
+    CHECK(telemetry_find_packet(buf, len, &type, &payload, &payload_len) == len && type == TELEMETRY_PACKET_SCHEMA,
+          "schema packet not found");
+    CHECK(telemetry_decode_schema(payload, payload_len, &schema) == TELEMETRY_EOK, "schema not decoded");
+
+    uint8_t encoded, n;
+    uint16_t seq;
+    static telemetry_sample_t out[255];
+    len = telemetry_encode_batch(buf, sizeof(buf), RATE_HZ, 7, &sample, 1, &encoded);
+    CHECK(telemetry_find_packet(buf, len, &type, &payload, &payload_len) == len && type == TELEMETRY_PACKET_DATA,
+          "data packet not found");
+    CHECK(telemetry_decode_batch(payload, payload_len, &schema, out, &n, &seq) == TELEMETRY_EOK && n == 1 && seq == 7,
+          "data packet not decoded");
+    double speed = restore(&schema, 1, out[0].values[1]);
+    CHECK(fabs(speed - 123.4) < 0.051, "lift.speed 123.4 decoded as %g", speed);
+    CHECK(restore(&schema, 0, out[0].values[0]) == 2900, "lift.position decoded as %g",
+          restore(&schema, 0, out[0].values[0]));
+    printf("reader scale: lift.speed 123.4 -> %g\n", speed);
+}
+
+static void test_stream(void)
+{
+    const int batches = 500;
+    std::vector<uint8_t> stream;
+    std::vector<expected_t> expected;
+    std::vector<uint16_t> batch_sizes;
+    uint8_t buf[TELEMETRY_PACKET_MAX];
+    telemetry_sample_t samples[TELEMETRY_BATCH];
+    uint32_t time_us = 0xFFFFFFFFu - 100000; // 中途经过32位回绕
+    float accel = 0.0f;
+    uint16_t seq = 0;
+    int corrupted = -1;
+
+    size_t len = telemetry_encode_schema(buf, sizeof(buf), RATE_HZ);
+    stream.insert(stream.end(), buf, buf + len);
+
+    for (int b = 0; b < batches; b++)
+    {
+        for (int s = 0; s < TELEMETRY_BATCH; s++)
+        {
+            // 随机的加减速曲线
+            if (rng_next() % 200 == 0)
+                accel = rng_uniform(-4000, 4000);
+            g_lift_speed = fmaxf(-3000.0f, fminf(3000.0f, g_lift_speed + accel / RATE_HZ));
+            g_lift_position += lroundf(g_lift_speed / RATE_HZ);
+            g_pulses = g_pulses + (int32_t)(rng_next() % 5);
+            g_distance = rng_uniform(100, 2000);
+            g_raw_mm = (uint16_t)(rng_next() % 8191);
+            time_us += 1000 + rng_next() % 20;
+            telemetry_sample(&samples[s], time_us);
+
+            expected_t e;
+            e.values[0] = g_lift_position;
+            e.values[1] = lroundf(g_lift_speed * 10) / 10.0;
+            e.values[2] = g_pulses;
+            e.values[3] = lroundf(g_distance * 10) / 10.0;
+            e.values[4] = g_raw_mm;
+            expected.push_back(e);
+        }
+        uint8_t done = 0;
+        while (done < TELEMETRY_BATCH)
+        {
+            uint8_t encoded;
+            len = telemetry_encode_batch(buf, sizeof(buf), RATE_HZ, seq++, samples + done, TELEMETRY_BATCH - done,
+                                         &encoded);
+            CHECK(len > 0, "batch %d not encoded", b);
+            if (len == 0)
+                return;
+            if (b == batches / 2 && corrupted < 0)
+            {
+                buf[len / 2] ^= 0x40; // 损坏一个包, 接收端应跳过
+                corrupted = (int)batch_sizes.size();
+            }
+            stream.insert(stream.end(), buf, buf + len);
+            batch_sizes.push_back(encoded);
+            done += encoded;
+        }
+        if (rng_next() % 10 == 0)
+        {
+            // 包之间的垃圾字节
+            for (int k = 0; k < 5; k++)
+                stream.push_back((uint8_t)rng_next());
+        }
+    }
+
+    // 解码
+    telemetry_schema_t schema;
+    bool have_schema = false;
+    static telemetry_sample_t out[255];
+    size_t pos = 0, sample_index = 0, packets = 0, max_err_index = 0;
+    double max_err = 0;
+    int expected_seq = 0;
+    while (pos < stream.size())
+    {
+        uint8_t type = 0;
+        const uint8_t *payload = NULL;
+        size_t payload_len = 0;
+        size_t used = telemetry_find_packet(&stream[pos], stream.size() - pos, &type, &payload, &payload_len);
+        if (used == 0)
+            break;
+        pos += used;
+        if (type == 0)
+            continue; // 只是丢弃的字节
+        if (type == TELEMETRY_PACKET_SCHEMA)
+        {
+            have_schema = telemetry_decode_schema(payload, payload_len, &schema) == TELEMETRY_EOK;
+            continue;
+        }
+        uint8_t n;
+        uint16_t s;
+        CHECK(have_schema && telemetry_decode_batch(payload, payload_len, &schema, out, &n, &s) == TELEMETRY_EOK,
+              "packet %u not decoded", (unsigned)packets);
+        if (expected_seq == corrupted)
+        {
+            sample_index += batch_sizes[expected_seq++]; // 损坏的包应被跳过
+        }
+        CHECK(s == expected_seq && n == batch_sizes[expected_seq], "packet seq %u (%u samples), expected %d (%u)", s, n,
+              expected_seq, batch_sizes[expected_seq]);
+        expected_seq++;
+        packets++;
+        for (uint8_t k = 0; k < n; k++, sample_index++)
+        {
+            for (uint8_t i = 0; i < VARS; i++)
+            {
+                double err = fabs(restore(&schema, i, out[k].values[i]) - expected[sample_index].values[i]);
+                if (err > max_err)
+                {
+                    max_err = err;
+                    max_err_index = sample_index;
+                }
+            }
+        }
+    }
+    CHECK(corrupted >= 0 && expected_seq == (int)batch_sizes.size(), "decoded %d of %u packets", expected_seq,
+          (unsigned)batch_sizes.size());
+    CHECK(sample_index == expected.size(), "%u of %u samples decoded", (unsigned)sample_index,
+          (unsigned)expected.size());
+    CHECK(max_err < 1e-3, "max error %g at sample %u", max_err, (unsigned)max_err_index);
+    printf("stream: %u packets, %u samples, %.2f bytes/sample, max error %g, 1 corrupted packet skipped\n",
+           (unsigned)packets, (unsigned)sample_index, (double)stream.size() / expected.size(), max_err);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        rng_seed(argv[1]);
+    printf("seed %u\n", (unsigned)g_rng);
+    test_register();
+    test_reader_scale();
+    test_stream();
+    return test_summary();
+}
@@ -0,0 +1,126 @@
+# 网页资源嵌入工具: 把HTML/JS/CSS压缩(去缩进、注释和空行)后gzip, 生成存放在Flash中的constexpr字节数组头文件
+#
+# 生成的头文件中每个文件对应:
+#   constexpr uint8_t WEB_<NAME>_GZ[] PROGMEM = {...};  gzip数据
+#   constexpr size_t WEB_<NAME>_GZ_LEN = ...;
+#   #define WEB_<NAME>_ETAG "\"xxxxxxxx\""              内容的CRC32, 用于浏览器缓存校验
+#   #define WEB_<NAME>_TYPE "text/html"
+# 处理函数用send_P直接发送这些数组, 加上Content-Encoding: gzip和ETag头, 不在堆上复制页面。
+#
+# 命令行(Arduino工程, 修改网页后手动运行并提交生成的头文件):
+#   python embed_web.py -o ../激光传感器/web_assets.h ../激光传感器/web/index.html
+# PlatformIO工程在platformio.ini中加入(编译前自动生成, 源文件没有变化时不改写头文件):
+#   extra_scripts = pre:../tools/embed_web.py
+#   custom_web_dir = web
+#   custom_web_header = include/web_assets.h
+import argparse
+import gzip
+import io
+import os
+import re
+import zlib
+
+CONTENT_TYPES = {
+    '.html': 'text/html',
+    '.htm': 'text/html',
+    '.js': 'application/javascript',
+    '.css': 'text/css',
+    '.json': 'application/json',
+    '.svg': 'image/svg+xml',
+}
+
+
+def minify(text):
+    # 只做不改变语义的处理: 删除HTML注释、行首尾空白、整行//注释和空行, 保留换行(JS自动分号)
+    text = re.sub(r'<!--.*?-->', '', text, flags=re.S)
+    lines = []
+    for line in text.splitlines():
+        line = line.strip()
+        if not line or line.startswith('//'):
+            continue
+        lines.append(line)
+    return '\n'.join(lines) + '\n'
+
+
+def gzip_bytes(data):
+    # mtime固定为0, 相同内容生成相同的字节, 头文件不会无故变化
+    buf = io.BytesIO()
+    with gzip.GzipFile(fileobj=buf, mode='wb', compresslevel=9, mtime=0) as f:
+        f.write(data)
+    return buf.getvalue()
+
+
+def symbol_name(path):
+    name = os.path.basename(path).upper()
+    return 'WEB_' + re.sub(r'[^A-Z0-9]', '_', name)
+
+
+def render(paths):
+    out = ['// 由tools/embed_web.py生成, 不要手动修改, 修改对应的网页源文件后重新生成',
+           '#ifndef WEB_ASSETS_H',
+           '#define WEB_ASSETS_H',
+           '',
+           '#include <stdint.h>',
+           '#include <stddef.h>',
+           '#ifndef PROGMEM',
+           '#define PROGMEM',
+           '#endif',
+           '']
+    for path in paths:
+        with open(path, 'r', encoding='utf-8') as f:
+            source = f.read()
+        ext = os.path.splitext(path)[1].lower()
+        text = minify(source) if ext in ('.html', '.htm', '.js', '.css') else source
+        data = gzip_bytes(text.encode('utf-8'))
+        name = symbol_name(path)
+        etag = '%08x' % (zlib.crc32(data) & 0xFFFFFFFF)
+
+        out.append('// %s: %d -> %d -> %d bytes (source, minified, gzip)' % (
+            os.path.basename(path), len(source.encode('utf-8')), len(text.encode('utf-8')), len(data)))
+        out.append('#define %s_TYPE "%s"' % (name, CONTENT_TYPES.get(ext, 'application/octet-stream')))
+        out.append('#define %s_ETAG "\\"%s\\""' % (name, etag))
+        out.append('constexpr size_t %s_GZ_LEN = %d;' % (name, len(data)))
+        out.append('constexpr uint8_t %s_GZ[] PROGMEM = {' % name)
+        for i in range(0, len(data), 16):
+            out.append('    ' + ', '.join('0x%02x' % b for b in data[i:i + 16]) + ',')
+        out.append('};')
+        out.append('')
+    out.append('#endif // WEB_ASSETS_H')
+    return '\n'.join(out) + '\n'
+
+
+def write_if_changed(header, content):
+    if os.path.exists(header):
+        with open(header, 'r', encoding='utf-8') as f:
+            if f.read() == content:
+                return False
+    with open(header, 'w', encoding='utf-8', newline='\n') as f:
+        f.write(content)
+    return True
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Minify and gzip web assets into a C header')
+    parser.add_argument('-o', '--output', required=True, help='header to generate')
+    parser.add_argument('files', nargs='+', help='html/js/css files')
+    args = parser.parse_args()
+    changed = write_if_changed(args.output, render(args.files))
+    print('%s %s' % (args.output, 'updated' if changed else 'unchanged'))
+
+
+def platformio_pre_build(env):
+    project = env.subst('$PROJECT_DIR')
+    web_dir = os.path.join(project, env.GetProjectOption('custom_web_dir', 'web'))
+    header = os.path.join(project, env.GetProjectOption('custom_web_header', 'include/web_assets.h'))
+    files = sorted(os.path.join(web_dir, f) for f in os.listdir(web_dir)
+                   if os.path.splitext(f)[1].lower() in CONTENT_TYPES)
+    if write_if_changed(header, render(files)):
+        print('embed_web: generated %s' % os.path.relpath(header, project))
+
+
+if __name__ == '__main__':
+    main()
+else:
+    # 作为PlatformIO extra_scripts加载
+    Import('env')  # noqa: F821
+    platformio_pre_build(env)  # noqa: F821
@@ -0,0 +1,144 @@
+# 运行指标二进制帧解码工具: 把metrics_report输出的结构帧+数值帧还原成和网页接口相同格式的JSON
+#
+# 帧格式见stepper/include/metrics.h。数值帧只含数值, 需要先收到结构帧(上报任务每10帧重发一次)
+# 才能解码; 结构校验不匹配(固件重新登记了指标)的数值帧会被跳过, 直到收到新的结构帧。
+#
+# 用法(在电脑上运行):
+#   python metrics_decode.py capture.bin                  解码串口抓包文件, 每个快照输出一行JSON
+#   python metrics_decode.py --port COM5                  直接读串口(需要pyserial), Ctrl+C结束
+#   python metrics_decode.py capture.bin --name laser.    只输出名称以laser.开头的指标
+import argparse
+import itertools
+import json
+import struct
+import sys
+
+SYNC = b'\xa5\x5a'
+FRAME_SCHEMA = 1
+FRAME_VALUES = 2
+# 最长的合法负载: METRICS_MAX(32)个直方图, 每个8个分界、31字符名称的结构帧
+MAX_PAYLOAD = 2 + 32 * (2 + 4 * 8 + 1 + 31)
+TYPE_COUNTER, TYPE_GAUGE, TYPE_HISTOGRAM = 0, 1, 2
+
+
+def crc16(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def frames(chunks):
+    """从字节流中切出校验通过的(类型, 负载), 丢弃同步错误和CRC错误的数据"""
+    buf = b''
+    # 输入结束后再处理一遍剩余数据: 等待中的不完整帧不会再收齐, 跳过它继续找后面的帧
+    for chunk in itertools.chain(chunks, [None]):
+        eof = chunk is None
+        if not eof:
+            buf += chunk
+        while True:
+            start = buf.find(SYNC)
+            if start < 0:
+                buf = buf[-1:]
+                break
+            buf = buf[start:]
+            if len(buf) < 5:
+                break
+            kind, length = buf[2], struct.unpack_from('<H', buf, 3)[0]
+            # 垃圾中的同步字节: 类型或长度不可能时立即跳过, 不等待按错误长度收齐后面的帧
+            if kind not in (FRAME_SCHEMA, FRAME_VALUES) or length > MAX_PAYLOAD or (eof and len(buf) < 7 + length):
+                buf = buf[1:]
+                continue
+            if len(buf) < 7 + length:
+                break
+            body = buf[2:5 + length]
+            if struct.unpack_from('<H', buf, 5 + length)[0] == crc16(body):
+                yield kind, bytes(body[3:])
+                buf = buf[7 + length:]
+            else:
+                buf = buf[1:]  # 错位的同步字节, 从下一个字节继续找
+
+
+def parse_schema(payload):
+    count = payload[1]
+    pos = 2
+    schema = []
+    for _ in range(count):
+        kind, bound_num = payload[pos], payload[pos + 1]
+        pos += 2
+        bounds = list(struct.unpack_from('<%dI' % bound_num, payload, pos))
+        pos += 4 * bound_num
+        name_len = payload[pos]
+        name = payload[pos + 1:pos + 1 + name_len].decode('ascii', 'replace')
+        pos += 1 + name_len
+        schema.append((name, kind, bounds))
+    return crc16(payload), schema
+
+
+def parse_values(payload, schema):
+    _, time_ms, count = struct.unpack_from('<HIB', payload, 1)
+    pos = 8
+    metrics = {}
+    for name, kind, bounds in schema[:count]:
+        if kind == TYPE_HISTOGRAM:
+            values = struct.unpack_from('<%dI' % (len(bounds) + 3), payload, pos)
+            pos += 4 * len(values)
+            metrics[name] = {'count': values[0], 'sum': values[1], 'bounds': bounds, 'buckets': list(values[2:])}
+        else:
+            metrics[name] = struct.unpack_from('<i' if kind == TYPE_GAUGE else '<I', payload, pos)[0]
+            pos += 4
+    return {'time_ms': time_ms, 'metrics': metrics}
+
+
+def read_file(path):
+    with open(path, 'rb') as f:
+        while True:
+            chunk = f.read(4096)
+            if not chunk:
+                return
+            yield chunk
+
+
+def read_port(port, baud):
+    import serial  # 只有读串口时需要
+    with serial.Serial(port, baud, timeout=0.1) as ser:
+        while True:
+            yield ser.read(ser.in_waiting or 1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='decode metrics binary frames to JSON lines')
+    parser.add_argument('input', nargs='?', help='capture file (omit with --port)')
+    parser.add_argument('--port', help='serial port to read instead of a file')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--name', default='', help='only print metrics whose name starts with this prefix')
+    args = parser.parse_args()
+    if not args.input and not args.port:
+        parser.error('give a capture file or --port')
+
+    chunks = read_port(args.port, args.baud) if args.port else read_file(args.input)
+    schema_id, schema = None, None
+    skipped = 0
+    try:
+        for kind, payload in frames(chunks):
+            if kind == FRAME_SCHEMA:
+                schema_id, schema = parse_schema(payload)
+            elif kind == FRAME_VALUES:
+                if schema is None or struct.unpack_from('<H', payload, 1)[0] != schema_id:
+                    skipped += 1
+                    continue
+                snapshot = parse_values(payload, schema)
+                if args.name:
+                    snapshot['metrics'] = {k: v for k, v in snapshot['metrics'].items() if k.startswith(args.name)}
+                print(json.dumps(snapshot, separators=(',', ':')))
+                sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    if skipped:
+        print('skipped %d value frame(s) without a matching schema' % skipped, file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,262 @@
+# 动作参数离线优化工具: 按各轴的速度/加速度/加加速度/扭矩限值, 为task.h中每个升降/平移动作
+# 计算用时最短的controlStepper速度和加速度, 输出节省的时间和可直接加载的参数文件
+#
+# 输入:
+#   限值文件(默认motion_limits.cfg): 每轴的max_speed、max_accel、max_jerk、torque_curve, 安全系数margin,
+#                                    以及每个动作的起点位置(start.<动作> = 步数)
+#   task.h: 各动作当前的速度/加速度/目标位置(mission_move_t move_xxx = {...})和所用的电机
+#   --params: 车上当前的参数(串口list或save的输出), 覆盖task.h中的默认值
+#
+# 约束(均先乘以margin):
+#   速度 <= max_speed
+#   加速度 <= max_accel, 且 <= torque_curve在峰值速度处的值(扭矩随转速下降, 整个加速段都要满足)
+#   加速度 <= sqrt(max_jerk * 峰值速度): AccelStepper是梯形曲线, 不能直接限制加加速度;
+#       按加加速度受限时在达到峰值速度之前能升到的加速度估计, 避免短行程用过大的加速度
+# 在满足约束的速度中取用时最短的; 行程太短达不到的速度不会缩短时间, 此时取能达到的峰值速度。
+# 用时按AccelStepper 1.64的离散步间隔逐步计算(与sim中的模型相同)。
+#
+# 用法(在tools目录):
+#   python motion_optimize.py                                  打印当前参数和优化结果对比
+#   python motion_optimize.py -o fast.params                   同时输出参数文件
+#   python motion_optimize.py --params car.params --margin 0.7 以车上当前参数为基准, 更保守的安全系数
+# 参数文件可用仿真验证整个任务的时间(../stepper/sim: ./mission_sim --params fast.params),
+# 也可逐行粘贴到串口命令(params_store_start)中, 确认后发送save保存。
+import argparse
+import math
+import os
+import re
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_TASK = os.path.join(HERE, '..', 'stepper', 'include', 'task.h')
+DEFAULT_LIMITS = os.path.join(HERE, 'motion_limits.cfg')
+
+AXES = {'stepper1': 'lift', 'stepper2': 'slide'}  # 与sim报告中的名称相同
+PARAM_SPEED_MAX = 10000  # task.h中move参数登记的范围
+PARAM_ACCEL_MAX = 20000
+SPEED_STEP = 10  # 搜索速度的间隔(步/s)
+
+
+def read_kv(path):
+    """读取"键 = 值"文本, #后为注释, 返回[(行号, 键, 值)]"""
+    items = []
+    with open(path, encoding='utf-8') as f:
+        for no, line in enumerate(f, 1):
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            if '=' not in line:
+                raise ValueError("%s:%d: missing '='" % (path, no))
+            key, value = line.split('=', 1)
+            items.append((no, key.strip(), value.strip()))
+    return items
+
+
+def parse_curve(text):
+    """'速度:加速度, ...' -> 按速度排序的点"""
+    points = []
+    for item in text.split(','):
+        v, a = item.split(':')
+        points.append((float(v), float(a)))
+    return sorted(points)
+
+
+def curve_at(points, v):
+    """分段线性插值, 超出两端取端点值"""
+    if v <= points[0][0]:
+        return points[0][1]
+    for (v0, a0), (v1, a1) in zip(points, points[1:]):
+        if v <= v1:
+            return a0 + (a1 - a0) * (v - v0) / (v1 - v0)
+    return points[-1][1]
+
+
+def load_limits(path, margin_override):
+    axes = {}
+    starts = {}
+    margin = 1.0
+    for no, key, value in read_kv(path):
+        try:
+            if key == 'margin':
+                margin = float(value)
+            elif key.startswith('start.'):
+                starts[key[6:]] = int(value)
+            elif '.' in key:
+                axis, field = key.split('.', 1)
+                if field not in ('max_speed', 'max_accel', 'max_jerk', 'torque_curve'):
+                    raise ValueError('unknown key')
+                axes.setdefault(axis, {})[field] = parse_curve(value) if field == 'torque_curve' else float(value)
+            else:
+                raise ValueError('unknown key')
+        except ValueError:
+            sys.exit('%s:%d: bad line: %s = %s' % (path, no, key, value))
+    if margin_override is not None:
+        margin = margin_override
+    for axis, lim in axes.items():
+        missing = [k for k in ('max_speed', 'max_accel') if k not in lim]
+        if missing:
+            sys.exit('%s: %s needs %s' % (path, axis, ', '.join(missing)))
+    return axes, starts, margin
+
+
+def load_moves(task_path, params_path):
+    """从task.h读取各动作的默认参数和电机, --params中的值覆盖默认值"""
+    with open(task_path, encoding='utf-8') as f:
+        text = f.read()
+    moves = {}
+    for name, speed, accel, target in re.findall(
+            r'mission_move_t\s+move_(\w+)\s*=\s*\{\s*(-?\d+)\s*,\s*(-?\d+)\s*,\s*(-?\d+)\s*\}', text):
+        moves[name] = {'speed': int(speed), 'accel': int(accel), 'target': int(target)}
+    for stepper, name in re.findall(r'mission_move\(\s*(\w+)\s*,\s*&move_(\w+)\s*\)', text):
+        if name in moves and stepper in AXES:
+            moves[name]['axis'] = AXES[stepper]
+    if params_path:
+        for no, key, value in read_kv(params_path):
+            m = re.match(r'move\.(\w+)\.(speed|accel|target)$', key)
+            if m and m.group(1) in moves:
+                moves[m.group(1)][m.group(2)] = int(value)
+    return moves
+
+
+def move_time_us(distance, speed, accel):
+    """AccelStepper从静止移动distance步的用时(us): 第一步立即发出, 到最后一步为止"""
+    distance = abs(distance)
+    if distance == 0:
+        return 0
+    c0 = 0.676 * math.sqrt(2.0 / accel) * 1000000.0
+    cmin = 1000000.0 / speed
+    pos, n, cn, current = 0, 0, 0.0, 0.0
+    total = 0
+    while True:
+        # computeNewSpeed(只有正方向)
+        to_go = distance - pos
+        to_stop = int(current * current / (2.0 * accel))
+        if to_go == 0:
+            return total  # controlStepper在到位时退出
+        if n > 0 and to_stop >= to_go:
+            n = -to_stop
+        elif n < 0 and to_stop < to_go:
+            n = -n
+        if n == 0:
+            cn = c0
+        else:
+            cn = max(cn - 2.0 * cn / (4.0 * n + 1), cmin)
+        n += 1
+        current = 1000000.0 / cn
+        if pos > 0:
+            total += int(cn)
+        pos += 1  # runSpeed: 间隔到期后走一步
+
+
+def accel_limit(lim, margin, v):
+    """峰值速度为v时允许的加速度及起作用的约束"""
+    limits = [(lim['max_accel'] * margin, 'accel')]
+    if 'torque_curve' in lim:
+        limits.append((curve_at(lim['torque_curve'], v) * margin, 'torque'))
+    if 'max_jerk' in lim:
+        limits.append((math.sqrt(lim['max_jerk'] * margin * v), 'jerk'))
+    limits.append((PARAM_ACCEL_MAX, 'param range'))
+    return min(limits)
+
+
+def optimise(distance, lim, margin):
+    """返回(速度, 加速度, 起作用的约束), 按连续梯形曲线搜索, 取整后由调用方按离散模型计算用时"""
+    d = abs(distance)
+    v_max = min(lim['max_speed'] * margin, PARAM_SPEED_MAX)
+    best = None
+    v = min(SPEED_STEP, v_max)
+    while v <= v_max + 1e-9:
+        a, reason = accel_limit(lim, margin, v)
+        t = d / v + v / a if v * v <= a * d else 2.0 * math.sqrt(d / a)
+        if best is None or t < best[0] - 1e-9:
+            best = (t, v, a, reason)
+        v += SPEED_STEP
+    _, v, a, reason = best
+    if v * v > a * d:
+        v = math.sqrt(a * d)  # 行程太短达不到更高的速度, 速度设为实际峰值
+        limits = [reason, 'distance']
+    elif v + SPEED_STEP > v_max:
+        limits = ['speed', reason]
+    else:
+        limits = [reason]  # 再提高速度, 可用加速度下降带来的损失大于匀速段的收益
+    return max(1, int(v)), max(1, int(a)), '+'.join(limits)
+
+
+def violations(move, lim):
+    """当前参数超出的限值(未乘margin, 只检查硬限值)"""
+    over = []
+    if move['speed'] > lim['max_speed']:
+        over.append('speed')
+    peak = min(move['speed'], math.sqrt(move['accel'] * abs(move['distance'])))
+    if move['accel'] > lim['max_accel'] or (
+            'torque_curve' in lim and move['accel'] > curve_at(lim['torque_curve'], peak)):
+        over.append('accel')
+    return over
+
+
+def main():
+    parser = argparse.ArgumentParser(description='compute time-optimal speed/accel for mission moves')
+    parser.add_argument('--limits', default=DEFAULT_LIMITS, help='axis limits and move start positions')
+    parser.add_argument('--task', default=DEFAULT_TASK, help='task.h with the mission_move_t defaults')
+    parser.add_argument('--params', help='current car parameters (list/save output), override task.h defaults')
+    parser.add_argument('--margin', type=float, help='safety factor applied to all limits (overrides the file)')
+    parser.add_argument('-o', '--output', help='write optimised speed/accel as a params file')
+    args = parser.parse_args()
+
+    try:
+        axes, starts, margin = load_limits(args.limits, args.margin)
+        moves = load_moves(args.task, args.params)
+    except (OSError, ValueError) as e:
+        sys.exit(str(e))
+    if not 0 < margin <= 1:
+        parser.error('margin must be in (0, 1]')
+    if not moves:
+        sys.exit('no mission_move_t definitions in %s' % args.task)
+
+    rows = []
+    skipped = []
+    for name, move in moves.items():
+        if name not in starts or move.get('axis') not in axes:
+            skipped.append(name)
+            continue
+        move['distance'] = move['target'] - starts[name]
+        if move['distance'] == 0:
+            skipped.append(name)
+            continue
+        lim = axes[move['axis']]
+        speed, accel, reason = optimise(move['distance'], lim, margin)
+        t_now = move_time_us(move['distance'], move['speed'], move['accel']) / 1e6
+        t_opt = move_time_us(move['distance'], speed, accel) / 1e6
+        if t_opt >= t_now:
+            speed, accel, t_opt, reason = move['speed'], move['accel'], t_now, 'kept'  # 当前已不慢于优化结果
+        rows.append((name, move, speed, accel, t_now, t_opt, reason, violations(move, lim)))
+
+    print('margin %.2f, limits from %s' % (margin, os.path.relpath(args.limits)))
+    print('%-14s %-5s %6s | %6s %6s %7s | %6s %6s %7s | %7s  %s' % (
+        'move', 'axis', 'steps', 'speed', 'accel', 'time_s', 'speed', 'accel', 'time_s', 'saved_s', 'limit'))
+    total_now = total_opt = 0.0
+    for name, move, speed, accel, t_now, t_opt, reason, over in rows:
+        total_now += t_now
+        total_opt += t_opt
+        note = reason + (' (current exceeds %s limit)' % '/'.join(over) if over else '')
+        print('%-14s %-5s %6d | %6d %6d %7.3f | %6d %6d %7.3f | %7.3f  %s' % (
+            name, move['axis'], abs(move['distance']), move['speed'], move['accel'], t_now,
+            speed, accel, t_opt, t_now - t_opt, note))
+    print('%-27s | %21.3f | %21.3f | %7.3f' % ('total', total_now, total_opt, total_now - total_opt))
+    if skipped:
+        print('skipped (no start position, no axis limits or zero distance): %s' % ', '.join(skipped), file=sys.stderr)
+
+    if args.output:
+        with open(args.output, 'w', encoding='utf-8') as f:
+            f.write('# motion_optimize.py: margin %.2f, limits %s\n' % (margin, os.path.basename(args.limits)))
+            f.write('# 预计每次任务节省 %.3f s (只计升降/平移动作本身)\n' % (total_now - total_opt))
+            for name, move, speed, accel, t_now, t_opt, reason, over in rows:
+                f.write('# %s: %s\n' % (name, reason))
+                f.write('move.%s.speed = %d\n' % (name, speed))
+                f.write('move.%s.accel = %d\n' % (name, accel))
+        print('wrote %s' % args.output)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,258 @@
+// 遥测接收工具: 接收固件telemetry_start()发出的UDP广播(或读取串口抓包文件), 解码为CSV
+//
+// 编译(在tools目录, Windows下用MinGW时末尾加 -lws2_32):
+//   g++ -O2 -std=c++11 -I../stepper/include -o telemetry_recv telemetry_recv.cpp ../stepper/src/telemetry.cpp ../stepper/src/metrics.cpp
+//
+// 用法:
+//   ./telemetry_recv -o run.csv                     电脑连上ESP32热点, 接收UDP 5005端口, Ctrl+C结束
+//   ./telemetry_recv --port 6000 --seconds 10       指定端口, 收到10秒数据后结束
+//   ./telemetry_recv --file capture.bin -o run.csv  解码串口输出的抓包文件
+//
+// CSV第一列是相对第一个样本的时间(秒), 之后每列一个变量, 已按登记的比例还原;
+// 变量表变化(固件重新登记)时重新输出表头。结束时在stderr打印包数、样本数和丢包数。
+
+#include "telemetry.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+typedef int socklen_t;
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#define closesocket close
+#endif
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    g_stop = 1;
+}
+
+struct receiver_t
+{
+    FILE *out;
+    double max_seconds;
+    telemetry_schema_t schema;
+    bool have_schema;
+    uint16_t header_id;   // 已输出表头对应的结构校验
+    bool have_header;
+    bool have_seq;
+    uint16_t last_seq;
+    bool have_time;
+    uint32_t last_time_us;
+    unsigned long long elapsed_us; // 展开32位回绕后的相对时间
+    unsigned long packets, samples, lost, unmatched;
+};
+
+static void print_header(receiver_t *rx)
+{
+    fprintf(rx->out, "time_s");
+    for (uint8_t i = 0; i < rx->schema.count; i++)
+        fprintf(rx->out, ",%s", rx->schema.names[i]);
+    fprintf(rx->out, "\n");
+    rx->header_id = rx->schema.id;
+    rx->have_header = true;
+}
+
+// 处理一个包, 返回false表示已达到--seconds
+static bool handle_packet(receiver_t *rx, uint8_t type, const uint8_t *payload, size_t len)
+{
+    static telemetry_sample_t samples[255];
+
+    if (type == TELEMETRY_PACKET_SCHEMA)
+    {
+        telemetry_schema_t schema;
+        if (telemetry_decode_schema(payload, len, &schema) == TELEMETRY_EOK)
+        {
+            rx->schema = schema;
+            rx->have_schema = true;
+        }
+        return true;
+    }
+    if (type != TELEMETRY_PACKET_DATA)
+        return true;
+
+    uint8_t n;
+    uint16_t seq;
+    if (!rx->have_schema || telemetry_decode_batch(payload, len, &rx->schema, samples, &n, &seq) != TELEMETRY_EOK)
+    {
+        rx->unmatched++; // 还没收到结构包, 或变量表已变化
+        return true;
+    }
+    if (!rx->have_header || rx->header_id != rx->schema.id)
+        print_header(rx);
+
+    if (rx->have_seq)
+        rx->lost += (uint16_t)(seq - rx->last_seq - 1);
+    rx->have_seq = true;
+    rx->last_seq = seq;
+    rx->packets++;
+
+    for (uint8_t s = 0; s < n; s++)
+    {
+        if (rx->have_time)
+            rx->elapsed_us += (uint32_t)(samples[s].time_us - rx->last_time_us);
+        rx->have_time = true;
+        rx->last_time_us = samples[s].time_us;
+
+        double t = rx->elapsed_us / 1e6;
+        if (rx->max_seconds > 0 && t > rx->max_seconds)
+            return false;
+        fprintf(rx->out, "%.6f", t);
+        for (uint8_t i = 0; i < rx->schema.count; i++)
+        {
+            if (rx->schema.scales[i] == 1.0f)
+                fprintf(rx->out, ",%ld", (long)samples[s].values[i]);
+            else
+                fprintf(rx->out, ",%g", samples[s].values[i] / rx->schema.scales[i]);
+        }
+        fprintf(rx->out, "\n");
+        rx->samples++;
+    }
+    return true;
+}
+
+// 处理缓冲区中的全部完整包, 返回已消耗的字节数
+static size_t handle_stream(receiver_t *rx, const uint8_t *buf, size_t len, bool *done)
+{
+    size_t used = 0;
+    while (used < len)
+    {
+        uint8_t type;
+        const uint8_t *payload;
+        size_t payload_len;
+        size_t skip = telemetry_find_packet(buf + used, len - used, &type, &payload, &payload_len);
+        if (skip == 0)
+            break;
+        used += skip;
+        if (type != 0 && !handle_packet(rx, type, payload, payload_len))
+        {
+            *done = true;
+            break;
+        }
+    }
+    return used;
+}
+
+static int run_file(receiver_t *rx, const char *path)
+{
+    FILE *in = fopen(path, "rb");
+    if (in == NULL)
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+
+    std::vector<uint8_t> buf;
+    uint8_t chunk[4096];
+    bool done = false;
+    size_t n;
+    while (!done && !g_stop && (n = fread(chunk, 1, sizeof(chunk), in)) > 0)
+    {
+        buf.insert(buf.end(), chunk, chunk + n);
+        size_t used = handle_stream(rx, buf.data(), buf.size(), &done);
+        buf.erase(buf.begin(), buf.begin() + used);
+    }
+    fclose(in);
+    return 0;
+}
+
+static int run_udp(receiver_t *rx, int port)
+{
+#ifdef _WIN32
+    WSADATA wsa;
+    WSAStartup(MAKEWORD(2, 2), &wsa);
+#endif
+    int sock = (int)socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        fprintf(stderr, "cannot create socket\n");
+        return 1;
+    }
+    int yes = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (const char *)&yes, sizeof(yes));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+    if (bind(sock, (sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        fprintf(stderr, "cannot bind UDP port %d\n", port);
+        closesocket(sock);
+        return 1;
+    }
+
+    // 接收超时, 以便检查Ctrl+C
+#ifdef _WIN32
+    DWORD timeout = 200;
+#else
+    timeval timeout = {0, 200000};
+#endif
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+    fprintf(stderr, "listening on UDP %d\n", port);
+
+    uint8_t datagram[TELEMETRY_PACKET_MAX + TELEMETRY_PACKET_OVERHEAD];
+    bool done = false;
+    while (!done && !g_stop)
+    {
+        int n = (int)recv(sock, (char *)datagram, sizeof(datagram), 0);
+        if (n > 0)
+            handle_stream(rx, datagram, (size_t)n, &done);
+    }
+    closesocket(sock);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *file = NULL;
+    const char *output = NULL;
+    int port = 5005;
+    receiver_t rx;
+    memset(&rx, 0, sizeof(rx));
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--file") == 0 && i + 1 < argc)
+            file = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+            port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            rx.max_seconds = atof(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [--file capture.bin | --port 5005] [--seconds N] [-o out.csv]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    rx.out = output != NULL ? fopen(output, "w") : stdout;
+    if (rx.out == NULL)
+    {
+        fprintf(stderr, "cannot write %s\n", output);
+        return 1;
+    }
+    signal(SIGINT, on_signal);
+
+    int ret = file != NULL ? run_file(&rx, file) : run_udp(&rx, port);
+
+    if (rx.out != stdout)
+        fclose(rx.out);
+    fprintf(stderr, "packets: %lu, samples: %lu, lost packets: %lu, packets without schema: %lu\n",
+            rx.packets, rx.samples, rx.lost, rx.unmatched);
+    return ret;
+}
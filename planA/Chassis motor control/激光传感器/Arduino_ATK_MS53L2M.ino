@@ -11,6 +11,10 @@
 // 引入必要的库
 #include <WiFi.h>
 #include <WebServer.h>
+#include <lwip/sockets.h>
+#include <errno.h>
+#include "web_assets.h" /* 由web/index.html生成: python ../tools/embed_web.py -o web_assets.h web/index.html */
+#include "distance_history.h"
 
 /* 引脚定义 - 根据ESP32S3板子实际情况调整 */
 #define RX_PIN 18             /* 传感器TXD连接到ESP32S3的RX */
@@ -18,6 +22,22 @@
 #define SENSOR_SERIAL Serial2 /* 使用ESP32S3的Serial2 */
 #define LED_PIN 2             /* 板载LED引脚 */
 
+/* 采样任务轮询串口的周期(ms) */
+#define SAMPLER_PERIOD_MS 2
+
+/* 距离推送(Server-Sent Events)设置 */
+#define SSE_PORT 81             /* 推送专用端口, 不占用网页服务器 */
+#define SSE_MAX_CLIENTS 4       /* 同时连接的网页数 */
+#define SSE_STALL_MS 3000       /* 客户端连续这么久发不出去则断开 */
+#define SSE_KEEPALIVE_MS 15000  /* 没有新数据时发送注释行, 检测断开的连接 */
+#define SSE_MSG_SIZE 48         /* 单条消息最大长度 */
+
+/* 距离历史设置 */
+#define HISTORY_LEN_PSRAM 65536 /* 有PSRAM时保存的样本数(384KB) */
+#define HISTORY_LEN_RAM 4096    /* 没有PSRAM时保存的样本数(24KB) */
+#define HISTORY_GUARD 64        /* 查询时跳过最旧的样本数, 避免读到正在被覆盖的数据 */
+#define HISTORY_MAX_POINTS 1000 /* /history一次最多返回的点数 */
+
 /* WiFi设置 */
 #define WIFI_SSID "LaserSensor_AP" // WiFi名称
 #define WIFI_PASSWORD "12345678"   // WiFi密码(至少8位)
@@ -27,16 +47,76 @@
 #define ATK_MS53L2M_ERROR 1    /* 操作失败 */
 #define ATK_MS53L2M_ETIMEOUT 2 /* 超时错误 */
 
-/* 缓冲区定义 */
-#define RX_BUF_SIZE 128 /* 接收缓冲区大小 */
-char g_rx_buf[RX_BUF_SIZE];
-uint16_t g_rx_cnt = 0;
+/* 最新距离超过此时间(ms)未更新视为超时 */
+#define ATK_MS53L2M_MAX_AGE_MS 300
+
+/* 增量解析状态 */
+#define PARSE_IDLE 0  /* 等待'd' */
+#define PARSE_D 1     /* 收到'd' */
+#define PARSE_COLON 2 /* 收到"d:", 跳过空格 */
+#define PARSE_VALUE 3 /* 累加数字 */
+uint8_t g_parse_state = PARSE_IDLE;
+uint32_t g_parse_value = 0;
+uint8_t g_parse_digits = 0;
 
-// 当前距离值
-uint16_t current_distance = 0;
+/* 最新距离样本, 由采样任务写入, loop读取 */
+typedef struct
+{
+  uint16_t distance; /* 距离(mm) */
+  bool valid;        /* false: 尚无数据或已超时 */
+  uint32_t time;     /* 采样时间(ms) */
+  uint32_t seq;      /* 每次更新加1, loop据此判断有无新样本 */
+} distance_sample_t;
+
+distance_sample_t g_sample = {0, false, 0, 0};
+portMUX_TYPE g_sample_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/* 推送客户端, 每个客户端只缓存一条没发完的消息 */
+typedef struct
+{
+  WiFiClient client;
+  bool used;
+  char pending[SSE_MSG_SIZE]; /* 上次只发出一部分的消息 */
+  uint8_t pending_len;
+  uint8_t pending_off;
+  uint32_t stall_since; /* 开始发不出去的时间(ms) */
+  uint32_t sent;        /* 发出的样本数 */
+  uint32_t dropped;     /* 因发送缓冲区满丢弃的样本数 */
+} sse_client_t;
+
+sse_client_t g_sse_clients[SSE_MAX_CLIENTS];
+uint32_t g_sse_seq = 0;     /* 已广播的样本序号 */
+uint32_t g_sse_last_tx = 0; /* 最近一次广播的时间(ms) */
+
+/* 距离历史, 由采样任务写入, /history读取 */
+distance_history_t g_history;
+bool g_history_ready = false;
+uint32_t g_history_idx[HISTORY_MAX_POINTS]; /* 降采样选中的样本序号 */
 
 // 创建网页服务器对象
 WebServer server(80);
+WiFiServer event_server(SSE_PORT);
+
+/**
+ * @brief       初始化LED指示灯
+ * @param       无
+ * @retval      无
+ */
+void led_init(void)
+{
+  pinMode(LED_PIN, OUTPUT);
+  digitalWrite(LED_PIN, LOW);
+}
+
+/**
+ * @brief       LED指示灯切换状态
+ * @param       无
+ * @retval      无
+ */
+void led_toggle(void)
+{
+  digitalWrite(LED_PIN, !digitalRead(LED_PIN));
+}
 
 /**
  * @brief       清空接收缓冲区
@@ -49,114 +129,177 @@ void atk_ms53l2m_uart_rx_restart(void)
   {
     SENSOR_SERIAL.read();
   }
-  g_rx_cnt = 0;
+  g_parse_state = PARSE_IDLE;
 }
 
 /**
- * @brief       读取传感器距离
- * @param       distance: 指向距离存储变量的指针
- * @retval      ATK_MS53L2M_EOK或错误码
+ * @brief       逐字节解析"d: XX mm", 数字结束即得到一个距离
+ * @param       c: 串口收到的字节
+ * @param       distance: 解析出距离时写入
+ * @retval      true: 得到新的距离
  */
-uint8_t atk_ms53l2m_get_distance(uint16_t *distance)
+bool atk_ms53l2m_parse_byte(char c, uint16_t *distance)
 {
-  /* 清空接收缓冲区 */
-  atk_ms53l2m_uart_rx_restart();
-  memset(g_rx_buf, 0, RX_BUF_SIZE);
+  bool got = false;
 
-  /* 等待接收数据 */
-  uint32_t start_time = millis();
-  g_rx_cnt = 0;
-  bool data_received = false;
-
-  /* 接收一段时间内的所有数据 */
-  while (millis() - start_time < 1000)
+  switch (g_parse_state)
   {
-    while (SENSOR_SERIAL.available() && g_rx_cnt < RX_BUF_SIZE - 1)
+  case PARSE_D:
+    g_parse_state = (c == ':') ? PARSE_COLON : PARSE_IDLE;
+    break;
+
+  case PARSE_COLON:
+    if (isdigit(c))
     {
-      char c = SENSOR_SERIAL.read();
-      g_rx_buf[g_rx_cnt++] = c;
-      data_received = true;
+      g_parse_value = c - '0';
+      g_parse_digits = 1;
+      g_parse_state = PARSE_VALUE;
     }
+    else if (c != ' ')
+    {
+      g_parse_state = PARSE_IDLE;
+    }
+    break;
 
-    /* 如果已经收到一些数据并且停止接收一段时间，认为一帧结束 */
-    if (data_received && !SENSOR_SERIAL.available())
+  case PARSE_VALUE:
+    if (isdigit(c))
     {
-      delay(50);
-      if (!SENSOR_SERIAL.available())
+      if (++g_parse_digits <= 5)
       {
-        break;
+        g_parse_value = g_parse_value * 10 + (c - '0');
       }
+      break;
+    }
+    /* 数字结束, 检查合理范围 */
+    if (g_parse_digits <= 5 && g_parse_value < 10000)
+    {
+      *distance = g_parse_value;
+      got = true;
     }
+    g_parse_state = PARSE_IDLE;
+    break;
 
-    delay(5);
+  default:
+    break;
   }
 
-  /* 确保字符串结束 */
-  g_rx_buf[g_rx_cnt] = '\0';
-
-  /* 如果没有接收到数据，返回超时错误 */
-  if (g_rx_cnt == 0)
+  if (g_parse_state == PARSE_IDLE && c == 'd')
   {
-    return ATK_MS53L2M_ETIMEOUT;
+    g_parse_state = PARSE_D;
   }
+  return got;
+}
 
-  /* 专门查找"d:"后面的数字 */
-  char *d_pos = strstr(g_rx_buf, "d:");
-  if (d_pos != NULL)
-  {
-    d_pos += 2; // 跳过"d:"
-
-    /* 跳过空格 */
-    while (*d_pos == ' ' && *d_pos != '\0')
-    {
-      d_pos++;
-    }
+/**
+ * @brief       读取最新样本
+ * @param       sample: 样本拷贝
+ * @retval      无
+ */
+void atk_ms53l2m_get_sample(distance_sample_t *sample)
+{
+  portENTER_CRITICAL(&g_sample_mux);
+  *sample = g_sample;
+  portEXIT_CRITICAL(&g_sample_mux);
+}
 
-    /* 读取数字 */
-    if (isdigit(*d_pos))
-    {
-      *distance = atoi(d_pos);
-      return ATK_MS53L2M_EOK;
-    }
-  }
+/**
+ * @brief       读取传感器距离(非阻塞)
+ * @note        只读取采样任务保存的最新样本, 不访问串口
+ * @param       distance: 指向距离存储变量的指针
+ * @retval      ATK_MS53L2M_EOK: 最新距离有效
+ *              ATK_MS53L2M_ETIMEOUT: 尚无数据或最新距离已过期
+ */
+uint8_t atk_ms53l2m_get_distance(uint16_t *distance)
+{
+  distance_sample_t sample;
 
-  /* 如果没有找到"d:"，尝试直接查找数字 */
-  char *ptr = g_rx_buf;
-  while (*ptr)
+  atk_ms53l2m_get_sample(&sample);
+  if (!sample.valid || millis() - sample.time > ATK_MS53L2M_MAX_AGE_MS)
   {
-    if (isdigit(*ptr) && (ptr == g_rx_buf || !isdigit(*(ptr - 1))))
-    {
-      *distance = atoi(ptr);
-      if (*distance > 0 && *distance < 10000) // 合理的距离范围
-      {
-        return ATK_MS53L2M_EOK;
-      }
-    }
-    ptr++;
+    return ATK_MS53L2M_ETIMEOUT;
   }
 
-  return ATK_MS53L2M_ERROR;
+  *distance = sample.distance;
+  return ATK_MS53L2M_EOK;
 }
 
 /**
- * @brief       初始化LED指示灯
- * @param       无
+ * @brief       采样任务: 独占传感器串口, 解析出的每个距离都作为新样本发布
+ * @note        距离超过ATK_MS53L2M_MAX_AGE_MS未更新时发布一次无效样本, 网页显示"--"
+ * @param       arg: 未使用
  * @retval      无
  */
-void led_init(void)
+void sensor_sampler_task(void *arg)
 {
-  pinMode(LED_PIN, OUTPUT);
-  digitalWrite(LED_PIN, LOW);
+  uint16_t value;
+
+  for (;;)
+  {
+    while (SENSOR_SERIAL.available())
+    {
+      if (atk_ms53l2m_parse_byte(SENSOR_SERIAL.read(), &value))
+      {
+        uint32_t now = millis();
+        portENTER_CRITICAL(&g_sample_mux);
+        g_sample.distance = value;
+        g_sample.valid = true;
+        g_sample.time = now;
+        g_sample.seq++;
+        portEXIT_CRITICAL(&g_sample_mux);
+        if (g_history_ready)
+        {
+          history_push(&g_history, now, value);
+        }
+        led_toggle(); /* 成功读取一次数据则切换LED状态 */
+      }
+    }
+
+    uint32_t now = millis();
+    portENTER_CRITICAL(&g_sample_mux);
+    if (g_sample.valid && now - g_sample.time > ATK_MS53L2M_MAX_AGE_MS)
+    {
+      g_sample.valid = false;
+      g_sample.seq++;
+    }
+    portEXIT_CRITICAL(&g_sample_mux);
+
+    vTaskDelay(pdMS_TO_TICKS(SAMPLER_PERIOD_MS));
+  }
 }
 
 /**
- * @brief       LED指示灯切换状态
+ * @brief       分配距离历史缓冲区
+ * @note        有PSRAM时放在PSRAM中保存更长时间, 否则在内部RAM中保存约80秒(50Hz)
  * @param       无
  * @retval      无
  */
-void led_toggle(void)
+void history_setup(void)
 {
-  digitalWrite(LED_PIN, !digitalRead(LED_PIN));
+  uint32_t capacity = psramFound() ? HISTORY_LEN_PSRAM : HISTORY_LEN_RAM;
+  uint32_t *time_buf;
+  uint16_t *dist_buf;
+
+  if (psramFound())
+  {
+    time_buf = (uint32_t *)ps_malloc(capacity * sizeof(uint32_t));
+    dist_buf = (uint16_t *)ps_malloc(capacity * sizeof(uint16_t));
+  }
+  else
+  {
+    time_buf = (uint32_t *)malloc(capacity * sizeof(uint32_t));
+    dist_buf = (uint16_t *)malloc(capacity * sizeof(uint16_t));
+  }
+  if (time_buf == NULL || dist_buf == NULL)
+  {
+    free(time_buf);
+    free(dist_buf);
+    Serial.println("距离历史缓冲区分配失败");
+    return;
+  }
+
+  history_init(&g_history, time_buf, dist_buf, capacity);
+  g_history_ready = true;
+  Serial.printf("距离历史: %lu个样本(%s)\r\n", (unsigned long)capacity, psramFound() ? "PSRAM" : "RAM");
 }
 
 /**
@@ -189,6 +332,29 @@ void initWiFi()
   Serial.println(WiFi.softAPIP());
 }
 
+/**
+ * @brief       发送Flash中的gzip网页资源
+ * @note        页面由web/index.html经tools/embed_web.py生成到web_assets.h, 直接从Flash发送不在堆上复制;
+ *              浏览器缓存的ETag一致时只回复304
+ * @param       data: gzip数据
+ * @param       len: 数据长度
+ * @param       type: Content-Type
+ * @param       etag: ETag(带引号)
+ * @retval      无
+ */
+void send_web_asset(const uint8_t *data, size_t len, const char *type, const char *etag)
+{
+  if (server.header("If-None-Match") == etag)
+  {
+    server.send(304);
+    return;
+  }
+  server.sendHeader("Content-Encoding", "gzip");
+  server.sendHeader("ETag", etag);
+  server.sendHeader("Cache-Control", "no-cache");
+  server.send_P(200, type, (PGM_P)data, len);
+}
+
 /**
  * @brief       处理网页根路径请求
  * @param       无
@@ -196,50 +362,7 @@ void initWiFi()
  */
 void handleRoot()
 {
-  String html = "<!DOCTYPE HTML><html>";
-  html += "<head>";
-  html += "<meta charset='UTF-8'>";
-  html += "<meta name='viewport' content='width=device-width, initial-scale=1.0'>";
-  html += "<title>激光传感器监控</title>";
-  html += "<style>";
-  html += "body { font-family: Arial, sans-serif; margin: 0; padding: 0; background-color: #f0f2f5; color: #333; }";
-  html += ".container { max-width: 800px; margin: 0 auto; padding: 20px; }";
-  html += ".header { text-align: center; padding: 20px 0; background-color: #1890ff; color: white; border-radius: 8px 8px 0 0; box-shadow: 0 2px 10px rgba(0,0,0,0.1); }";
-  html += ".card { background-color: white; border-radius: 0 0 8px 8px; padding: 20px; box-shadow: 0 2px 10px rgba(0,0,0,0.1); margin-bottom: 20px; }";
-  html += ".value-box { font-size: 72px; text-align: center; margin: 30px 0; color: #1890ff; font-weight: bold; }";
-  html += ".unit { font-size: 24px; color: #888; }";
-  html += ".footer { text-align: center; margin-top: 20px; color: #888; font-size: 14px; }";
-  html += ".status { display: inline-block; width: 10px; height: 10px; border-radius: 50%; background-color: #52c41a; margin-right: 5px; }";
-  html += ".status-text { font-size: 16px; color: #555; text-align: center; margin-bottom: 20px; }";
-  html += "</style>";
-  html += "<script>";
-  html += "function updateDistance() {";
-  html += "  fetch('/distance')";
-  html += "    .then(response => response.text())";
-  html += "    .then(data => {";
-  html += "      document.getElementById('distance').innerText = data;";
-  html += "    });";
-  html += "}";
-  html += "setInterval(updateDistance, 500);"; // 每500ms更新一次
-  html += "</script>";
-  html += "</head>";
-  html += "<body>";
-  html += "<div class='container'>";
-  html += "<div class='header'>";
-  html += "<h1>ATK-MS53L2M 激光传感器</h1>";
-  html += "</div>";
-  html += "<div class='card'>";
-  html += "<div class='status-text'><span class='status'></span>系统状态: 正常</div>";
-  html += "<div class='value-box'><span id='distance'>";
-  html += current_distance;
-  html += "</span> <span class='unit'>mm</span></div>";
-  html += "</div>";
-  html += "<div class='footer'>ESP32S3 + ATK-MS53L2M &copy; 2024</div>";
-  html += "</div>";
-  html += "</body>";
-  html += "</html>";
-
-  server.send(200, "text/html", html);
+  send_web_asset(WEB_INDEX_HTML_GZ, WEB_INDEX_HTML_GZ_LEN, WEB_INDEX_HTML_TYPE, WEB_INDEX_HTML_ETAG);
 }
 
 /**
@@ -249,7 +372,318 @@ void handleRoot()
  */
 void handleDistance()
 {
-  server.send(200, "text/plain", String(current_distance));
+  uint16_t distance;
+
+  if (atk_ms53l2m_get_distance(&distance) == ATK_MS53L2M_EOK)
+  {
+    server.send(200, "text/plain", String(distance));
+  }
+  else
+  {
+    server.send(200, "text/plain", "--");
+  }
+}
+
+/**
+ * @brief       非阻塞发送
+ * @param       c: 推送客户端
+ * @param       data: 数据
+ * @param       len: 长度
+ * @retval      已发送的字节数(发送缓冲区满时为0), -1: 连接已断开
+ */
+int sse_send(sse_client_t *c, const char *data, int len)
+{
+  int n = send(c->client.fd(), data, len, MSG_DONTWAIT);
+  if (n < 0)
+  {
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+  }
+  return n;
+}
+
+/**
+ * @brief       关闭推送客户端
+ * @param       c: 推送客户端
+ * @retval      无
+ */
+void sse_close(sse_client_t *c)
+{
+  Serial.printf("推送客户端断开, 已发送%lu条, 丢弃%lu条\r\n", (unsigned long)c->sent, (unsigned long)c->dropped);
+  c->client.stop();
+  c->client = WiFiClient();
+  c->used = false;
+}
+
+/**
+ * @brief       继续发送上次没发完的消息
+ * @param       c: 推送客户端
+ * @retval      true: 已没有待发送数据
+ */
+bool sse_flush(sse_client_t *c)
+{
+  if (c->pending_off >= c->pending_len)
+  {
+    return true;
+  }
+
+  int n = sse_send(c, c->pending + c->pending_off, c->pending_len - c->pending_off);
+  if (n < 0)
+  {
+    sse_close(c);
+    return false;
+  }
+  c->pending_off += n;
+  if (c->pending_off < c->pending_len)
+  {
+    return false;
+  }
+  c->pending_len = c->pending_off = 0;
+  c->stall_since = 0;
+  return true;
+}
+
+/**
+ * @brief       向一个客户端发送消息, 发送缓冲区满时丢弃本条
+ * @note        网络慢的客户端只会丢样本, 不会让loop等待, 也不影响其他客户端;
+ *              只发出一部分的消息保存下来, 下次先发完, 保证事件流格式完整
+ * @param       c: 推送客户端
+ * @param       msg: 消息
+ * @param       len: 长度(<= SSE_MSG_SIZE)
+ * @param       sample: true: 距离样本(计入统计), false: 保活注释
+ * @retval      无
+ */
+void sse_push(sse_client_t *c, const char *msg, int len, bool sample)
+{
+  if (!sse_flush(c))
+  {
+    if (c->used && sample)
+    {
+      c->dropped++;
+    }
+    return;
+  }
+
+  int n = sse_send(c, msg, len);
+  if (n < 0)
+  {
+    sse_close(c);
+    return;
+  }
+  if (n == 0)
+  {
+    if (sample)
+    {
+      c->dropped++;
+    }
+    if (c->stall_since == 0)
+    {
+      c->stall_since = millis() | 1;
+    }
+    return;
+  }
+  if (n < len)
+  {
+    memcpy(c->pending, msg + n, len - n);
+    c->pending_len = len - n;
+    c->pending_off = 0;
+    c->stall_since = millis() | 1;
+  }
+  else
+  {
+    c->stall_since = 0;
+  }
+  if (sample)
+  {
+    c->sent++;
+  }
+}
+
+/**
+ * @brief       广播消息给所有推送客户端
+ * @param       msg: 消息
+ * @param       len: 长度
+ * @param       sample: true: 距离样本, false: 保活注释
+ * @retval      无
+ */
+void sse_broadcast(const char *msg, int len, bool sample)
+{
+  for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++)
+  {
+    if (g_sse_clients[i].used)
+    {
+      sse_push(&g_sse_clients[i], msg, len, sample);
+    }
+  }
+  g_sse_last_tx = millis();
+}
+
+/**
+ * @brief       把样本格式化为一条事件: "id: 序号\ndata: 距离\n\n", 无效样本的距离为"--"
+ * @param       sample: 样本
+ * @param       buf: 输出缓冲区(SSE_MSG_SIZE)
+ * @retval      消息长度
+ */
+int sse_format(const distance_sample_t *sample, char *buf)
+{
+  if (sample->valid)
+  {
+    return snprintf(buf, SSE_MSG_SIZE, "id: %lu\ndata: %u\n\n", (unsigned long)sample->seq, sample->distance);
+  }
+  return snprintf(buf, SSE_MSG_SIZE, "id: %lu\ndata: --\n\n", (unsigned long)sample->seq);
+}
+
+/**
+ * @brief       接受新的推送连接
+ * @note        端口81只用于推送, 不解析请求内容, 连接后直接回复事件流头和当前样本
+ * @param       无
+ * @retval      无
+ */
+void sse_accept(void)
+{
+  WiFiClient client = event_server.available();
+  if (!client)
+  {
+    return;
+  }
+
+  sse_client_t *c = NULL;
+  for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++)
+  {
+    if (!g_sse_clients[i].used)
+    {
+      c = &g_sse_clients[i];
+      break;
+    }
+  }
+  if (c == NULL)
+  {
+    client.print("HTTP/1.1 503 Service Unavailable\r\nAccess-Control-Allow-Origin: *\r\nConnection: close\r\n\r\n");
+    client.stop();
+    Serial.println("推送客户端已满, 拒绝连接");
+    return;
+  }
+
+  /* 新连接的发送缓冲区是空的, 响应头可以直接写入 */
+  client.setNoDelay(true);
+  client.print("HTTP/1.1 200 OK\r\n"
+               "Content-Type: text/event-stream\r\n"
+               "Cache-Control: no-cache\r\n"
+               "Access-Control-Allow-Origin: *\r\n"
+               "Connection: keep-alive\r\n\r\n"
+               "retry: 1000\n\n");
+
+  c->client = client;
+  c->used = true;
+  c->pending_len = c->pending_off = 0;
+  c->stall_since = 0;
+  c->sent = c->dropped = 0;
+  Serial.print("推送客户端连接: ");
+  Serial.println(client.remoteIP());
+
+  distance_sample_t sample;
+  char msg[SSE_MSG_SIZE];
+  atk_ms53l2m_get_sample(&sample);
+  sse_push(c, msg, sse_format(&sample, msg), true);
+}
+
+/**
+ * @brief       推送处理, 在loop中调用
+ * @note        接受新连接、补发未完成的消息、广播新样本, 断开长时间发不出去的客户端
+ * @param       无
+ * @retval      无
+ */
+void sse_poll(void)
+{
+  distance_sample_t sample;
+  char msg[SSE_MSG_SIZE];
+  uint32_t now = millis();
+
+  sse_accept();
+
+  for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++)
+  {
+    sse_client_t *c = &g_sse_clients[i];
+    if (!c->used)
+    {
+      continue;
+    }
+    /* 丢弃客户端发来的请求内容 */
+    while (c->client.available())
+    {
+      c->client.read();
+    }
+    if (!sse_flush(c) && !c->used)
+    {
+      continue;
+    }
+    if (c->stall_since != 0 && now - c->stall_since > SSE_STALL_MS)
+    {
+      sse_close(c);
+    }
+  }
+
+  atk_ms53l2m_get_sample(&sample);
+  if (sample.seq != g_sse_seq)
+  {
+    g_sse_seq = sample.seq;
+    sse_broadcast(msg, sse_format(&sample, msg), true);
+  }
+  else if (now - g_sse_last_tx > SSE_KEEPALIVE_MS)
+  {
+    sse_broadcast(": keepalive\n\n", 13, false);
+  }
+}
+
+/**
+ * @brief       处理距离历史请求: /history?window=10000&points=300&end=
+ * @note        返回(end - window, end]内的样本, 超过points个时用LTTB降采样到points个点,
+ *              窗口再长返回的点数也固定; end默认为当前时间。分块发送, 不在堆上拼接整个响应。
+ *              返回{"end":E,"raw":原始样本数,"points":[[相对end的时间ms,距离mm],...]}
+ * @param       无
+ * @retval      无
+ */
+void handleHistory()
+{
+  uint32_t now = millis();
+  uint32_t window = server.hasArg("window") ? strtoul(server.arg("window").c_str(), NULL, 10) : 10000;
+  uint32_t points = server.hasArg("points") ? strtoul(server.arg("points").c_str(), NULL, 10) : 300;
+  uint32_t end = server.hasArg("end") ? strtoul(server.arg("end").c_str(), NULL, 10) : now;
+  uint32_t first, last;
+  char buf[512];
+  int len;
+
+  if (!g_history_ready)
+  {
+    server.send(503, "application/json", "{\"status\":\"error\",\"message\":\"history unavailable\"}");
+    return;
+  }
+  if (window == 0 || window > 0x7FFFFFFF || points < 2 || points > HISTORY_MAX_POINTS)
+  {
+    server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"bad window or points\"}");
+    return;
+  }
+
+  uint32_t raw = history_window(&g_history, end - window, end, HISTORY_GUARD, &first, &last);
+  uint32_t count = history_lttb(&g_history, first, last, points, g_history_idx);
+
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/json", "");
+  len = snprintf(buf, sizeof(buf), "{\"end\":%lu,\"raw\":%lu,\"points\":[", (unsigned long)end, (unsigned long)raw);
+  for (uint32_t i = 0; i < count; i++)
+  {
+    uint32_t time_ms;
+    uint16_t dist;
+    history_get(&g_history, g_history_idx[i], &time_ms, &dist);
+    len += snprintf(buf + len, sizeof(buf) - len, "%s[%ld,%u]", i ? "," : "", (long)(int32_t)(time_ms - end), dist);
+    if (len > (int)sizeof(buf) - 32)
+    {
+      server.sendContent(buf, len);
+      len = 0;
+    }
+  }
+  len += snprintf(buf + len, sizeof(buf) - len, "]}");
+  server.sendContent(buf, len);
+  server.sendContent("");
 }
 
 /**
@@ -261,10 +695,17 @@ void initWebServer()
 {
   server.on("/", handleRoot);
   server.on("/distance", handleDistance);
+  server.on("/history", handleHistory);
+
+  /* 只需要缓存校验头 */
+  const char *header_keys[] = {"If-None-Match"};
+  server.collectHeaders(header_keys, 1);
 
   server.begin();
+  event_server.begin();
   Serial.println("Web服务器已启动");
   Serial.println("访问地址: http://192.168.4.1");
+  Serial.printf("距离推送端口: %d\r\n", SSE_PORT);
 }
 
 void setup()
@@ -284,6 +725,12 @@ void setup()
   /* 清空可能的缓存数据 */
   atk_ms53l2m_uart_rx_restart();
 
+  /* 距离历史缓冲区, 在采样任务启动前分配 */
+  history_setup();
+
+  /* 采样任务与loop同在核心1, 优先级更高, 串口数据到达后尽快解析 */
+  xTaskCreatePinnedToCore(sensor_sampler_task, "Sampler", 3072, NULL, 2, NULL, 1);
+
   /* 初始化WiFi AP */
   initWiFi();
 
@@ -295,27 +742,12 @@ void setup()
 
 void loop()
 {
-  static unsigned long last_read_time = 0;
-  uint16_t distance;
-  uint8_t ret;
-
   /* 处理Web服务器请求 */
   server.handleClient();
 
-  /* 每200ms读取一次距离 */
-  if (millis() - last_read_time > 200)
-  {
-    last_read_time = millis();
+  /* 推送新样本给已连接的网页 */
+  sse_poll();
 
-    /* 读取距离 */
-    ret = atk_ms53l2m_get_distance(&distance);
-    if (ret == ATK_MS53L2M_EOK)
-    {
-      current_distance = distance;
-      led_toggle(); /* 成功读取一次数据则切换LED状态 */
-    }
-  }
-
-  /* 小延迟，避免占用过多CPU */
-  delay(10);
-}
\ No newline at end of file
+  /* 让出CPU */
+  delay(1);
+}
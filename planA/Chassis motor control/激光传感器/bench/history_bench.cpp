@@ -0,0 +1,155 @@
+// 距离历史降采样主机端测试
+//
+// 用合成的靠近-过冲-回稳距离曲线(50Hz, 带噪声和采样抖动)填满历史缓冲区,
+// 对不同时间窗口和输出点数测量history_window和history_lttb的耗时, 检查输出
+// (点数、序号递增、首尾保留), 并与同样点数的等间隔抽点比较折线的最大误差。
+//
+// 编译(在本目录):
+//   g++ -O2 -std=c++11 -I.. -o history_bench history_bench.cpp ../distance_history.cpp
+//
+// 用法:
+//   ./history_bench                 默认65536个样本(有PSRAM时的容量)
+//   ./history_bench 4096 200        4096个样本, 每项重复200次
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+#include "distance_history.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+// 每6秒一次: 先用1秒从停止位置匀速后退到2000mm, 再靠近并衰减振荡到300mm, 第一次过冲约到240mm
+static uint16_t approach_profile(uint32_t t_ms, uint32_t *seed)
+{
+    double t = (t_ms % 6000) / 1000.0;
+    double stop = 300 + 1700 * exp(-2.5 * 5) * cos(2.4 * 5);
+    double d = t < 1 ? stop + (2000 - stop) * t : 300 + 1700 * exp(-2.5 * (t - 1)) * cos(2.4 * (t - 1));
+    *seed = *seed * 1103515245u + 12345u;
+    double noise = ((*seed >> 16) % 21) - 10.0; // ±10mm
+    d += noise;
+    return d < 0 ? 0 : (uint16_t)d;
+}
+
+static double elapsed_us(bench_clock::time_point start, uint32_t repeat)
+{
+    return std::chrono::duration<double, std::micro>(bench_clock::now() - start).count() / repeat;
+}
+
+// 用选中的点做折线, 与窗口内全部原始样本比较的最大误差(mm)
+static double max_error(const distance_history_t *h, const uint32_t *idx, uint32_t n)
+{
+    double worst = 0;
+    for (uint32_t k = 0; k + 1 < n; k++)
+    {
+        uint32_t t0, t1, t;
+        uint16_t d0, d1, d;
+        history_get(h, idx[k], &t0, &d0);
+        history_get(h, idx[k + 1], &t1, &d1);
+        for (uint32_t i = idx[k]; i <= idx[k + 1]; i++)
+        {
+            history_get(h, i, &t, &d);
+            double line = t1 == t0 ? d0 : d0 + (double)(d1 - d0) * (uint32_t)(t - t0) / (uint32_t)(t1 - t0);
+            double err = fabs(line - d);
+            if (err > worst)
+                worst = err;
+        }
+    }
+    return worst;
+}
+
+static bool check_output(uint32_t first, uint32_t last, uint32_t threshold,
+                         const uint32_t *out, uint32_t count)
+{
+    uint32_t expect = last - first < threshold ? last - first : threshold;
+    if (count != expect)
+        return false;
+    if (count > 0 && out[count - 1] != last - 1)
+        return false;
+    if (count > 1 && out[0] != first)
+        return false;
+    for (uint32_t i = 1; i < count; i++)
+    {
+        if (out[i] <= out[i - 1])
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t capacity = argc > 1 ? (uint32_t)atoi(argv[1]) : 65536;
+    uint32_t repeat = argc > 2 ? (uint32_t)atoi(argv[2]) : 50;
+    if (capacity < 16 || repeat == 0)
+    {
+        fprintf(stderr, "usage: %s [capacity] [repeat]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<uint32_t> time_buf(capacity);
+    std::vector<uint16_t> dist_buf(capacity);
+    distance_history_t h;
+    history_init(&h, time_buf.data(), dist_buf.data(), capacity);
+
+    // 写入1.5倍容量, 让缓冲区回绕; 起点靠近32位回绕, 同时检查时间比较
+    uint32_t seed = 1;
+    uint32_t t = 0xFFFFFFFFu - 30000;
+    uint32_t pushes = capacity + capacity / 2;
+    bench_clock::time_point start = bench_clock::now();
+    for (uint32_t i = 0; i < pushes; i++)
+    {
+        t += 18 + (seed >> 20) % 5; // 18-22ms
+        history_push(&h, t, approach_profile(t, &seed));
+    }
+    double push_ns = elapsed_us(start, pushes) * 1000;
+    uint32_t now = t;
+
+    printf("samples: %u (capacity %u, %.1f ns/push), span %.1f s\n", pushes, capacity, push_ns,
+           (capacity - 1) * 20 / 1000.0);
+    printf("%-10s %8s %8s %12s %12s %10s %10s %s\n", "window", "raw", "points", "window_us", "lttb_us",
+           "err_lttb", "err_stride", "check");
+
+    const uint32_t windows_ms[] = {10000, 60000, 300000, 0xFFFFFFu};
+    const uint32_t thresholds[] = {2, 3, 300, 1000}; // 2和3检查没有或只有一个中间桶的情况
+    std::vector<uint32_t> out(1000), stride(1000);
+    bool ok = true;
+
+    for (uint32_t w : windows_ms)
+    {
+        for (uint32_t threshold : thresholds)
+        {
+            uint32_t first = 0, last = 0, raw = 0;
+            start = bench_clock::now();
+            for (uint32_t r = 0; r < repeat; r++)
+                raw = history_window(&h, now - w, now, 64, &first, &last);
+            double window_us = elapsed_us(start, repeat);
+            if (raw < 2)
+                continue;
+
+            uint32_t count = 0;
+            start = bench_clock::now();
+            for (uint32_t r = 0; r < repeat; r++)
+                count = history_lttb(&h, first, last, threshold, out.data());
+            double lttb_us = elapsed_us(start, repeat);
+
+            // 同样点数的等间隔抽点
+            uint32_t stride_count = raw < threshold ? raw : threshold;
+            for (uint32_t i = 0; i < stride_count; i++)
+                stride[i] = first + (uint32_t)((uint64_t)i * (raw - 1) / (stride_count > 1 ? stride_count - 1 : 1));
+
+            bool pass = check_output(first, last, threshold, out.data(), count);
+            ok = ok && pass;
+            char name[16];
+            if (w == 0xFFFFFFu)
+                snprintf(name, sizeof(name), "all");
+            else
+                snprintf(name, sizeof(name), "%us", w / 1000);
+            printf("%-10s %8u %8u %12.1f %12.1f %10.0f %10.0f %s\n", name, raw, count, window_us, lttb_us,
+                   max_error(&h, out.data(), count), max_error(&h, stride.data(), stride_count),
+                   pass ? "ok" : "FAIL");
+        }
+    }
+    return ok ? 0 : 1;
+}
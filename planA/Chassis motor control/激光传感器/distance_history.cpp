@@ -0,0 +1,135 @@
+#include "distance_history.h"
+
+void history_init(distance_history_t *h, uint32_t *time_buf, uint16_t *dist_buf, uint32_t capacity)
+{
+    h->time = time_buf;
+    h->dist = dist_buf;
+    h->capacity = capacity;
+    h->total = 0;
+}
+
+void history_push(distance_history_t *h, uint32_t time_ms, uint16_t dist)
+{
+    uint32_t slot = h->total % h->capacity;
+    h->time[slot] = time_ms;
+    h->dist[slot] = dist;
+    __sync_synchronize(); // 样本写完后才对读取者可见
+    h->total = h->total + 1;
+}
+
+void history_get(const distance_history_t *h, uint32_t index, uint32_t *time_ms, uint16_t *dist)
+{
+    uint32_t slot = index % h->capacity;
+    *time_ms = h->time[slot];
+    *dist = h->dist[slot];
+}
+
+// 时间a是否在b之后(处理32位回绕)
+static bool time_after(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) > 0;
+}
+
+// [lo, hi)中第一个时间在t之后的样本序号
+static uint32_t lower_bound(const distance_history_t *h, uint32_t lo, uint32_t hi, uint32_t t)
+{
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (time_after(h->time[mid % h->capacity], t))
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+uint32_t history_window(const distance_history_t *h, uint32_t start_ms, uint32_t end_ms, uint32_t guard,
+                        uint32_t *first, uint32_t *last)
+{
+    uint32_t total = h->total;
+    uint32_t oldest = total > h->capacity ? total - h->capacity : 0;
+    if (total > h->capacity)
+        oldest = total - oldest > guard ? oldest + guard : total;
+
+    *first = lower_bound(h, oldest, total, start_ms);
+    *last = lower_bound(h, *first, total, end_ms);
+    return *last - *first;
+}
+
+uint32_t history_lttb(const distance_history_t *h, uint32_t first, uint32_t last, uint32_t threshold,
+                      uint32_t *out)
+{
+    uint32_t n = last - first;
+    if (n <= threshold)
+    {
+        for (uint32_t i = 0; i < n; i++)
+            out[i] = first + i;
+        return n;
+    }
+    if (threshold < 3)
+    {
+        // 没有中间的桶: 2个点时只保留首尾, 1个点时保留最新的样本
+        if (threshold == 0)
+            return 0;
+        if (threshold == 2)
+            out[0] = first;
+        out[threshold - 1] = last - 1;
+        return threshold;
+    }
+
+    // 时间相对第一个样本计算, 避免大数值丢失float精度
+    uint32_t t0 = h->time[first % h->capacity];
+    float bucket = (float)(n - 2) / (threshold - 2);
+    uint32_t count = 0;
+    uint32_t a = first; // 上一个选中的点
+    out[count++] = a;
+
+    for (uint32_t b = 0; b < threshold - 2; b++)
+    {
+        // 当前桶[lo, hi)
+        uint32_t lo = first + 1 + (uint32_t)(b * bucket);
+        uint32_t hi = first + 1 + (uint32_t)((b + 1) * bucket);
+        if (hi > last - 1)
+            hi = last - 1;
+
+        // 下一个桶的平均点, 最后一个桶用末尾样本
+        uint32_t next_lo = hi;
+        uint32_t next_hi = first + 1 + (uint32_t)((b + 2) * bucket);
+        if (next_hi > last - 1 || b == threshold - 3)
+            next_hi = last;
+        if (next_hi <= next_lo)
+            next_hi = next_lo + 1;
+        float avg_t = 0, avg_d = 0;
+        for (uint32_t i = next_lo; i < next_hi; i++)
+        {
+            avg_t += h->time[i % h->capacity] - t0;
+            avg_d += h->dist[i % h->capacity];
+        }
+        avg_t /= next_hi - next_lo;
+        avg_d /= next_hi - next_lo;
+
+        float at = h->time[a % h->capacity] - t0;
+        float ad = h->dist[a % h->capacity];
+        float best_area = -1;
+        uint32_t best = lo;
+        for (uint32_t i = lo; i < hi; i++)
+        {
+            // 三角形面积的2倍
+            float area = (at - avg_t) * (h->dist[i % h->capacity] - ad) -
+                         (at - (h->time[i % h->capacity] - t0)) * (avg_d - ad);
+            if (area < 0)
+                area = -area;
+            if (area > best_area)
+            {
+                best_area = area;
+                best = i;
+            }
+        }
+        out[count++] = best;
+        a = best;
+    }
+
+    out[count++] = last - 1;
+    return count;
+}
@@ -0,0 +1,88 @@
+#ifndef DISTANCE_HISTORY_H
+#define DISTANCE_HISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief 距离历史环形缓冲区
+ *
+ * 按时间顺序保存最近capacity个有效样本, 满了以后覆盖最旧的。样本用写入以来的
+ * 绝对序号访问, 序号[oldest, total)有效。时间、距离分两个数组保存(每个样本6字节),
+ * 缓冲区由调用方提供, 可以放在内部RAM或PSRAM。
+ * 不依赖Arduino, 可直接在主机上编译。
+ *
+ * 只有一个写入者; 读取者先取total再读取, 写入者在样本写完后才增加total。
+ * 读取期间最旧的样本可能被覆盖, 读取者应避开最旧的一段(见history_window)。
+ */
+typedef struct
+{
+    uint32_t *time;          /**< 采样时间(ms) */
+    uint16_t *dist;          /**< 距离(mm) */
+    uint32_t capacity;       /**< 缓冲区样本数 */
+    volatile uint32_t total; /**< 写入过的样本总数 */
+} distance_history_t;
+
+/**
+ * @brief 初始化
+ *
+ * @param h 历史缓冲区
+ * @param time_buf 时间数组, capacity个元素
+ * @param dist_buf 距离数组, capacity个元素
+ * @param capacity 样本数
+ */
+void history_init(distance_history_t *h, uint32_t *time_buf, uint16_t *dist_buf, uint32_t capacity);
+
+/**
+ * @brief 写入一个样本, 时间应单调递增
+ *
+ * @param h 历史缓冲区
+ * @param time_ms 采样时间(ms)
+ * @param dist 距离(mm)
+ */
+void history_push(distance_history_t *h, uint32_t time_ms, uint16_t dist);
+
+/**
+ * @brief 读取一个样本
+ *
+ * @param h 历史缓冲区
+ * @param index 绝对序号
+ * @param time_ms 时间
+ * @param dist 距离
+ */
+void history_get(const distance_history_t *h, uint32_t index, uint32_t *time_ms, uint16_t *dist);
+
+/**
+ * @brief 查找时间窗口(start_ms, end_ms]内的样本
+ *
+ * 时间比较按32位回绕处理, 窗口长度应小于2^31 ms。
+ *
+ * @param h 历史缓冲区
+ * @param start_ms 窗口起点(不含)
+ * @param end_ms 窗口终点(含)
+ * @param guard 跳过最旧的guard个样本, 避免读到正在被覆盖的数据
+ * @param first 第一个样本的绝对序号
+ * @param last 最后一个样本之后的绝对序号
+ * @return uint32_t 窗口内的样本数
+ */
+uint32_t history_window(const distance_history_t *h, uint32_t start_ms, uint32_t end_ms, uint32_t guard,
+                        uint32_t *first, uint32_t *last);
+
+/**
+ * @brief Largest-Triangle-Three-Buckets降采样
+ *
+ * 保留首尾两点, 中间的样本平均分成threshold-2个桶, 每个桶选出与上一个选中点和
+ * 下一个桶平均点组成三角形面积最大的点, 保留峰值和拐点。O(n), 不分配内存。
+ * 样本数不超过threshold时原样输出全部序号; threshold为2时只输出首尾两点, 为1时只输出最后一点。
+ *
+ * @param h 历史缓冲区
+ * @param first 第一个样本的绝对序号
+ * @param last 最后一个样本之后的绝对序号
+ * @param threshold 输出点数
+ * @param out 选中样本的绝对序号, 至少threshold个元素
+ * @return uint32_t 输出的点数
+ */
+uint32_t history_lttb(const distance_history_t *h, uint32_t first, uint32_t last, uint32_t threshold,
+                      uint32_t *out);
+
+#endif // DISTANCE_HISTORY_H
@@ -0,0 +1,123 @@
+// 由tools/embed_web.py生成, 不要手动修改, 修改对应的网页源文件后重新生成
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+// index.html: 4771 -> 4007 -> 1674 bytes (source, minified, gzip)
+#define WEB_INDEX_HTML_TYPE "text/html"
+#define WEB_INDEX_HTML_ETAG "\"ee80fdbd\""
+constexpr size_t WEB_INDEX_HTML_GZ_LEN = 1674;
+constexpr uint8_t WEB_INDEX_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0x8d, 0x57, 0xff, 0x8b, 0xd4, 0x46,
+    0x14, 0xff, 0x7d, 0xff, 0x8a, 0x29, 0x52, 0x93, 0xd5, 0xcd, 0x6e, 0xb2, 0x7b, 0x6b, 0xd7, 0xfd,
+    0x26, 0x56, 0xaf, 0x28, 0xf5, 0x5a, 0xe1, 0xae, 0x48, 0x11, 0x29, 0x73, 0xc9, 0x64, 0x33, 0x5e,
+    0x92, 0x09, 0xc9, 0xec, 0xb7, 0xca, 0x15, 0x0b, 0xfd, 0x0e, 0x0a, 0x15, 0x5a, 0x29, 0x15, 0x15,
+    0x4a, 0x51, 0x4a, 0x95, 0x42, 0xc1, 0x0a, 0x16, 0xfc, 0x67, 0xbc, 0xbd, 0xfa, 0x5f, 0xf4, 0xcd,
+    0x4c, 0x92, 0xcd, 0xee, 0xed, 0x9d, 0x72, 0x1c, 0x9b, 0xcc, 0x7b, 0xef, 0xf3, 0xde, 0xfb, 0xbc,
+    0x37, 0x6f, 0x26, 0xdd, 0x77, 0xce, 0x7f, 0x7c, 0x6e, 0xeb, 0xd3, 0xcb, 0xeb, 0xe8, 0xc2, 0xd6,
+    0xc6, 0xa5, 0x7e, 0xa9, 0xeb, 0xf1, 0xc0, 0x17, 0x3f, 0x04, 0x3b, 0xf0, 0x13, 0x10, 0x8e, 0x91,
+    0xed, 0xe1, 0x38, 0x21, 0xbc, 0xa7, 0x7d, 0xb2, 0xf5, 0x81, 0xd1, 0xd2, 0xb2, 0xe5, 0x10, 0x07,
+    0xa4, 0xa7, 0x8d, 0x28, 0x19, 0x47, 0x2c, 0xe6, 0x1a, 0xb2, 0x59, 0xc8, 0x49, 0x08, 0x6a, 0x63,
+    0xea, 0x70, 0xaf, 0xe7, 0x90, 0x11, 0xb5, 0x89, 0x21, 0x5f, 0x2a, 0x88, 0x86, 0x94, 0x53, 0xec,
+    0x1b, 0x89, 0x8d, 0x7d, 0xd2, 0xb3, 0xaa, 0xa6, 0x80, 0xe1, 0x94, 0xfb, 0xa4, 0x3f, 0x7b, 0x79,
+    0x73, 0xef, 0xeb, 0xef, 0x5f, 0xfd, 0xfb, 0x70, 0xf6, 0xd5, 0x83, 0xbd, 0x5f, 0x1e, 0xef, 0xff,
+    0xfa, 0xe3, 0xec, 0xf6, 0xa3, 0x6e, 0x4d, 0x09, 0x4b, 0xdd, 0x84, 0x4f, 0xc5, 0xef, 0x36, 0x73,
+    0xa6, 0xe8, 0x06, 0x72, 0xc1, 0x89, 0xe1, 0xe2, 0x80, 0xfa, 0xd3, 0x36, 0x3a, 0x1b, 0x03, 0x64,
+    0x05, 0x25, 0x38, 0x4c, 0x8c, 0x84, 0xc4, 0xd4, 0xed, 0xa0, 0x00, 0xc7, 0x03, 0x1a, 0xb6, 0x91,
+    0xd9, 0x41, 0x11, 0x76, 0x1c, 0x1a, 0x0e, 0xe4, 0xf3, 0x36, 0xb6, 0x77, 0x06, 0x31, 0x1b, 0x86,
+    0x8e, 0x61, 0x33, 0x9f, 0xc5, 0x6d, 0x74, 0xcc, 0x35, 0xdd, 0xba, 0xdb, 0xec, 0xa0, 0xec, 0xbd,
+    0xd1, 0x68, 0x74, 0xd0, 0x6e, 0xa9, 0x2a, 0xd2, 0xc0, 0x34, 0x24, 0x31, 0x78, 0x0b, 0xf0, 0x44,
+    0x25, 0xd0, 0x46, 0x2d, 0xd3, 0x8c, 0x26, 0x05, 0x7c, 0x84, 0x87, 0x9c, 0x15, 0x9c, 0xd4, 0xa5,
+    0x18, 0xec, 0x05, 0x73, 0xd2, 0x98, 0x93, 0x09, 0x37, 0xb0, 0x4f, 0x07, 0xa0, 0x6e, 0x03, 0x31,
+    0x24, 0x5e, 0x52, 0x3f, 0x24, 0x30, 0xab, 0x75, 0xda, 0x74, 0xdd, 0x3c, 0xb0, 0xb1, 0x47, 0x39,
+    0x01, 0x45, 0x16, 0x03, 0xac, 0x11, 0x63, 0x87, 0x0e, 0x13, 0x08, 0x07, 0xcc, 0xc5, 0xbf, 0x29,
+    0x41, 0xd8, 0xc4, 0x48, 0x3c, 0xec, 0xb0, 0xb1, 0x08, 0xac, 0x0e, 0xcb, 0x96, 0x80, 0x8f, 0x07,
+    0xdb, 0x58, 0x37, 0x2b, 0xf2, 0xaf, 0x6a, 0x95, 0x55, 0x76, 0x38, 0x76, 0x20, 0xb6, 0x83, 0x6e,
+    0x57, 0xbb, 0x01, 0xf8, 0xcc, 0xd5, 0x81, 0x5c, 0xdf, 0xd6, 0xab, 0xa2, 0xcc, 0xd8, 0x66, 0x9c,
+    0xb3, 0xa0, 0x40, 0xd4, 0x08, 0xfb, 0x43, 0x02, 0xcb, 0x93, 0xac, 0xac, 0x09, 0xfd, 0x9c, 0xb4,
+    0xd1, 0x7b, 0x75, 0x21, 0x5f, 0x45, 0x5e, 0xc6, 0x7d, 0x23, 0xe5, 0x6e, 0x99, 0x30, 0x09, 0x32,
+    0x26, 0x74, 0xe0, 0xf1, 0x36, 0x44, 0xe7, 0x3b, 0xd2, 0xcd, 0x10, 0x3a, 0x6f, 0xd1, 0x43, 0x7d,
+    0x4d, 0x78, 0xc8, 0xac, 0x5b, 0xad, 0x96, 0xd4, 0x73, 0x19, 0xe3, 0x87, 0xd6, 0x2d, 0xcd, 0x81,
+    0xb3, 0x28, 0x4b, 0x60, 0xc1, 0xbc, 0x00, 0x6e, 0xad, 0xa5, 0xe9, 0x25, 0x1c, 0xf3, 0x61, 0x02,
+    0x78, 0x0e, 0x4d, 0x22, 0x1f, 0x43, 0xbb, 0xd2, 0xd0, 0x87, 0xbe, 0x32, 0xb6, 0x7d, 0x66, 0xef,
+    0x74, 0x50, 0xda, 0x57, 0x96, 0x44, 0xf3, 0xd2, 0xa8, 0xad, 0x94, 0xd9, 0x85, 0x22, 0x34, 0xcd,
+    0x77, 0x57, 0x36, 0x4a, 0xb3, 0x6e, 0xaf, 0x59, 0x38, 0x0f, 0x2e, 0x56, 0x10, 0xcd, 0x05, 0xff,
+    0x55, 0xe6, 0xba, 0x2b, 0xeb, 0x7d, 0xcc, 0x75, 0xd7, 0x9c, 0x35, 0xb7, 0xa0, 0x6a, 0x88, 0xc4,
+    0x17, 0x99, 0xb2, 0x4e, 0x15, 0x53, 0x6d, 0x36, 0x9b, 0x47, 0x15, 0xe6, 0x60, 0x85, 0xc5, 0xe0,
+    0xe0, 0x86, 0xd8, 0x10, 0x45, 0x1a, 0x5c, 0x9f, 0x80, 0xf8, 0xfa, 0x30, 0xe1, 0xd4, 0x9d, 0x1a,
+    0xe9, 0xd4, 0x68, 0xa3, 0x24, 0xc2, 0x30, 0x2e, 0xb6, 0x09, 0x1f, 0x13, 0x12, 0x76, 0x90, 0x74,
+    0x61, 0x40, 0x4f, 0x06, 0xc9, 0xa1, 0x8e, 0x2c, 0xf3, 0x40, 0x78, 0xbb, 0x25, 0x1b, 0x87, 0x23,
+    0x2c, 0x78, 0xcf, 0x09, 0x16, 0xf4, 0x65, 0x04, 0xd7, 0xd3, 0xde, 0x5d, 0xc1, 0x07, 0x16, 0x7f,
+    0x07, 0xc8, 0x4f, 0xcb, 0xd9, 0xad, 0xa5, 0x73, 0xa8, 0x9b, 0xd8, 0x31, 0x8d, 0x78, 0xbf, 0xe4,
+    0x0e, 0x43, 0x9b, 0x53, 0x16, 0xa2, 0xc4, 0x63, 0xe3, 0xf3, 0x14, 0x38, 0x0c, 0x6d, 0xa2, 0x3b,
+    0x98, 0xe3, 0x32, 0xba, 0x51, 0x72, 0x98, 0x3d, 0x0c, 0x20, 0xea, 0xea, 0x80, 0xf0, 0x75, 0x9f,
+    0x88, 0xc7, 0xf7, 0xa7, 0x17, 0x1d, 0x5d, 0x73, 0x52, 0x4d, 0xad, 0x5c, 0xa5, 0x21, 0x4c, 0x99,
+    0x2d, 0x41, 0x7a, 0x0f, 0x09, 0xbb, 0x4e, 0x69, 0x77, 0x11, 0x75, 0x53, 0xd6, 0x45, 0x67, 0x3b,
+    0x47, 0x22, 0xaa, 0xea, 0x01, 0x9e, 0xed, 0xe3, 0x24, 0xf9, 0x08, 0xa6, 0x32, 0xe0, 0xb1, 0x1d,
+    0x74, 0x06, 0x65, 0x22, 0xd4, 0xce, 0x1e, 0x11, 0xb4, 0x83, 0xd6, 0x79, 0x13, 0x96, 0xec, 0x84,
+    0xa5, 0x00, 0x15, 0xe0, 0xde, 0xd3, 0xfb, 0xb3, 0xbb, 0xcf, 0x24, 0xe0, 0x7f, 0x2f, 0xef, 0xcf,
+    0x6e, 0xff, 0xfe, 0xea, 0xf9, 0x93, 0xd9, 0xcf, 0x4f, 0x2a, 0x68, 0xf6, 0xe4, 0xb7, 0xbd, 0x7b,
+    0x8f, 0x5f, 0x7f, 0x7b, 0x0b, 0x96, 0xb5, 0x85, 0x44, 0x86, 0x11, 0xe4, 0x46, 0x72, 0x82, 0x44,
+    0x2a, 0x2e, 0xe1, 0xb6, 0xa7, 0x6b, 0xb5, 0x39, 0x17, 0xa5, 0x2a, 0xf7, 0x48, 0xa8, 0xc7, 0x24,
+    0x89, 0x58, 0x98, 0x40, 0x02, 0x7d, 0x94, 0x3d, 0x57, 0x45, 0x30, 0x7a, 0x39, 0x53, 0x29, 0xb2,
+    0x5d, 0x5e, 0x70, 0xe4, 0xc4, 0x78, 0x7c, 0x01, 0x24, 0x2c, 0x9e, 0xe6, 0x65, 0x18, 0xe1, 0x18,
+    0xa5, 0x0d, 0x01, 0x1c, 0x1f, 0x96, 0xb5, 0xec, 0x53, 0x0d, 0xd0, 0xa4, 0x3a, 0x9f, 0x80, 0xae,
+    0x32, 0x12, 0x9a, 0xe7, 0x44, 0x83, 0x42, 0x04, 0x5a, 0xdd, 0xc9, 0x54, 0xc6, 0x73, 0x05, 0xd9,
+    0x64, 0xf3, 0x57, 0xdb, 0xa7, 0x80, 0x7a, 0x45, 0x9d, 0x79, 0x85, 0x75, 0xd5, 0x7e, 0xcb, 0x7a,
+    0x17, 0xe4, 0x6a, 0x8a, 0x49, 0x43, 0x98, 0xa4, 0x9f, 0x05, 0x22, 0xd0, 0x93, 0x87, 0x46, 0xaa,
+    0xb4, 0xa0, 0x34, 0x72, 0x78, 0x2a, 0xcb, 0x88, 0x27, 0x69, 0x03, 0x55, 0x23, 0x46, 0x43, 0x9e,
+    0x54, 0x90, 0xcf, 0x60, 0xc5, 0x22, 0xa7, 0x21, 0x06, 0x0a, 0x4f, 0x06, 0x3c, 0x76, 0x4a, 0xa0,
+    0x07, 0x43, 0x2e, 0x5e, 0xc7, 0xc0, 0x7d, 0x46, 0x9a, 0x1e, 0x01, 0x4b, 0x4a, 0x7d, 0x03, 0x73,
+    0xaf, 0x1a, 0xd0, 0x50, 0xf7, 0x59, 0x05, 0x45, 0x57, 0xad, 0x6b, 0x30, 0xba, 0xa5, 0xb5, 0x12,
+    0xe0, 0x89, 0xee, 0xd1, 0x5c, 0xb0, 0x5b, 0x3e, 0xa2, 0x89, 0x62, 0x1c, 0x0e, 0x96, 0xfb, 0x5b,
+    0x38, 0xf7, 0x49, 0x38, 0x00, 0xb2, 0xce, 0x08, 0x7f, 0x27, 0x91, 0x86, 0xbe, 0x80, 0xff, 0x93,
+    0xc2, 0x87, 0x78, 0x09, 0x82, 0x8a, 0x7c, 0x95, 0x79, 0x40, 0x25, 0xc5, 0xe2, 0xab, 0xe7, 0x7f,
+    0xcc, 0x1e, 0xfe, 0x33, 0xbb, 0xf7, 0xa7, 0x6c, 0xb8, 0xd9, 0xdd, 0x87, 0xb3, 0x9f, 0xfe, 0x9a,
+    0xdd, 0x7a, 0x0a, 0xfd, 0x45, 0x5d, 0xa4, 0x17, 0x20, 0xbb, 0xa8, 0x5e, 0x86, 0x86, 0xe1, 0xc3,
+    0x38, 0x4c, 0x39, 0x81, 0x91, 0x53, 0x88, 0xdc, 0x32, 0x2b, 0x08, 0xc2, 0x47, 0x06, 0xb8, 0x2e,
+    0xa3, 0x13, 0x48, 0x1e, 0x4c, 0x25, 0x08, 0xc3, 0xe8, 0x09, 0x55, 0x99, 0xe8, 0x49, 0xf5, 0x58,
+    0x82, 0xfa, 0xc3, 0x40, 0x8c, 0xd9, 0x0e, 0xd9, 0x14, 0x3b, 0x1e, 0x60, 0xb4, 0xf4, 0x84, 0xd1,
+    0x94, 0x50, 0x0c, 0xf1, 0x2b, 0x69, 0xd9, 0xad, 0x6a, 0x53, 0x2d, 0x6e, 0x13, 0x18, 0x4c, 0x97,
+    0xc1, 0x9f, 0x5e, 0x3e, 0x8c, 0x69, 0xb8, 0x04, 0x65, 0x2d, 0x29, 0x3a, 0x4c, 0x8f, 0xae, 0x9a,
+    0xd7, 0x20, 0xcb, 0xbc, 0xf0, 0x65, 0x54, 0x2b, 0x74, 0xc1, 0x09, 0x34, 0xae, 0xa0, 0x29, 0xe8,
+    0x79, 0x10, 0xb5, 0x2e, 0x68, 0x4f, 0xa3, 0xaf, 0x2d, 0x64, 0xe2, 0x29, 0x2e, 0x00, 0x39, 0x0b,
+    0x6d, 0x8b, 0xe9, 0x13, 0xb0, 0x84, 0x22, 0x11, 0x1f, 0x76, 0x92, 0x58, 0x0e, 0xd8, 0x68, 0xbe,
+    0x5c, 0x12, 0xb5, 0x9b, 0x27, 0xa9, 0x97, 0x57, 0xec, 0xd6, 0x6c, 0x1b, 0x89, 0x78, 0x05, 0x7c,
+    0x5e, 0x6a, 0x8f, 0x3a, 0x0e, 0x09, 0x97, 0xb8, 0x96, 0xfd, 0x97, 0xb7, 0x0f, 0xcc, 0x5b, 0x60,
+    0xfb, 0x4d, 0x7b, 0xad, 0xb8, 0x53, 0x20, 0x82, 0x6c, 0x22, 0x78, 0xca, 0xf1, 0x19, 0xc5, 0x43,
+    0x4f, 0x36, 0xc4, 0xdb, 0xed, 0x05, 0xd1, 0x2f, 0xc7, 0x55, 0xff, 0x4b, 0x33, 0x88, 0xea, 0xc8,
+    0xa9, 0x72, 0x3d, 0x81, 0x9a, 0xe4, 0x53, 0xa5, 0x30, 0x3b, 0x24, 0x1f, 0x0a, 0xbb, 0xca, 0x42,
+    0x9f, 0xc9, 0x4e, 0xca, 0xab, 0x28, 0x18, 0x59, 0xe2, 0xa8, 0x53, 0x82, 0xcb, 0xf1, 0x45, 0x71,
+    0x40, 0x41, 0x20, 0xfa, 0x82, 0xb0, 0x22, 0x4e, 0x1f, 0xb3, 0xac, 0x6a, 0x94, 0x62, 0xae, 0x8f,
+    0x20, 0x83, 0x4d, 0x36, 0x8c, 0x61, 0x7e, 0xa5, 0xed, 0x40, 0xc4, 0x92, 0x20, 0x31, 0x24, 0x63,
+    0x54, 0x90, 0xeb, 0x9a, 0xc7, 0x79, 0xd4, 0xae, 0xd5, 0x44, 0x42, 0x70, 0x6b, 0xc0, 0x22, 0x84,
+    0xaa, 0xc7, 0x12, 0x2e, 0xee, 0xde, 0x22, 0xe3, 0x76, 0xcb, 0xaa, 0x89, 0xa9, 0xa4, 0x10, 0x20,
+    0xde, 0x80, 0x24, 0x09, 0x1e, 0x90, 0x62, 0xc8, 0xc2, 0xcd, 0xe2, 0x21, 0x45, 0xaa, 0x72, 0x3e,
+    0xc2, 0x36, 0x2e, 0x58, 0xb2, 0x88, 0x84, 0x4b, 0x99, 0x16, 0x0f, 0x21, 0x1e, 0x0f, 0xc9, 0x92,
+    0x05, 0x89, 0x63, 0x16, 0x1f, 0x61, 0xe2, 0x62, 0x68, 0x40, 0x65, 0xb3, 0xab, 0x9a, 0x31, 0xe3,
+    0x6e, 0x7e, 0x1a, 0xac, 0x22, 0x2f, 0x93, 0x56, 0xe0, 0xe6, 0x63, 0xca, 0x72, 0x00, 0x02, 0x1c,
+    0xc0, 0xe9, 0xc1, 0xdb, 0xad, 0xa5, 0x1f, 0x27, 0xe2, 0x93, 0x00, 0x7e, 0x1c, 0x3a, 0x42, 0xf2,
+    0xe8, 0xeb, 0x69, 0xf9, 0xdd, 0x5d, 0x5b, 0x5c, 0x57, 0x77, 0x72, 0xb1, 0xe8, 0x59, 0xfd, 0xb3,
+    0x5b, 0x1f, 0x1a, 0x1b, 0x9b, 0xcd, 0xc6, 0xa5, 0xfa, 0x06, 0x5a, 0xfa, 0xf6, 0x00, 0x68, 0x4b,
+    0x38, 0x00, 0xd3, 0x25, 0x60, 0xb8, 0x36, 0x2f, 0x61, 0x16, 0x8f, 0xca, 0x7e, 0x17, 0x6e, 0x2f,
+    0x21, 0xa2, 0x4e, 0x2f, 0x3f, 0x72, 0x17, 0xb4, 0x40, 0xa1, 0x26, 0x34, 0xfa, 0xfb, 0x7f, 0xbf,
+    0xd8, 0x7f, 0xf1, 0x60, 0xff, 0x87, 0x67, 0xb3, 0x9b, 0x5f, 0xb6, 0xd1, 0xb2, 0x55, 0x0a, 0x96,
+    0x9f, 0xac, 0xa9, 0xd1, 0x8a, 0x78, 0xf2, 0xbb, 0x73, 0xd1, 0x75, 0x7e, 0x9c, 0xf6, 0x0d, 0x23,
+    0x35, 0x4d, 0x5d, 0xa4, 0x56, 0xe2, 0x2a, 0xac, 0xf5, 0x83, 0x60, 0x09, 0xf7, 0xad, 0xd2, 0x9d,
+    0xdf, 0xe5, 0x84, 0x20, 0xf7, 0xa9, 0x66, 0xfd, 0xdc, 0x21, 0x88, 0x88, 0x4f, 0x6c, 0x2e, 0x85,
+    0xe9, 0x0e, 0x45, 0x2c, 0x04, 0x6b, 0xd0, 0x83, 0x08, 0x16, 0xb7, 0x8e, 0x80, 0x62, 0x91, 0x1c,
+    0x3c, 0x32, 0xa3, 0x9e, 0x26, 0xf6, 0x0b, 0x7c, 0x1b, 0x5a, 0xe6, 0xfe, 0xa3, 0x3b, 0xdd, 0x9a,
+    0x92, 0x1d, 0x50, 0x3a, 0x95, 0x2a, 0xed, 0x7d, 0xf7, 0xcd, 0xeb, 0x3b, 0x0f, 0x0e, 0x55, 0x6b,
+    0x98, 0x4a, 0xaf, 0xf9, 0x06, 0x3d, 0xab, 0x95, 0x2a, 0x36, 0xcc, 0x03, 0x9a, 0x35, 0x95, 0xce,
+    0x9c, 0xa5, 0xf4, 0x36, 0x21, 0xd2, 0x53, 0xa3, 0x0c, 0x68, 0x54, 0x6b, 0x2b, 0x99, 0x54, 0x5f,
+    0x15, 0x5a, 0x7f, 0x7d, 0xf3, 0x72, 0xa3, 0xbe, 0xd9, 0x80, 0x3d, 0x5b, 0x6c, 0xbf, 0xe3, 0x36,
+    0x8b, 0xa6, 0x1d, 0xb8, 0x30, 0xd7, 0xd7, 0x96, 0x8a, 0x51, 0x4b, 0x9b, 0xbb, 0xa6, 0xbe, 0xc7,
+    0xff, 0x07, 0x8e, 0x99, 0x92, 0x3e, 0xa7, 0x0f, 0x00, 0x00,
+};
+
+#endif // WEB_ASSETS_H
@@ -0,0 +1,66 @@
+# 比较两次firmware_bench的JSON结果, 标出变慢的项
+#
+# 每项按所选指标计算 新/基准 的比值, 超过阈值记为回退(SLOWER), 低于阈值的倒数记为改进(faster)。
+# 两次的[ns_min, ns_max]范围有重叠时在结果后加"~", 表示差异可能只是测量波动, 可以加大--repeat再测。
+#
+# 用法(在电脑上运行):
+#   python bench_compare.py base.json new.json                  变慢超过10%算回退
+#   python bench_compare.py base.json new.json --threshold 5    阈值5%
+#   python bench_compare.py base.json new.json --metric ns_min  按最小值比较(受主机负载影响较小)
+# 有回退时退出码为1, 可以放在修改后的检查脚本中。
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path, encoding='utf-8') as f:
+        data = json.load(f)
+    return data.get('context', {}), {b['name']: b for b in data['benchmarks']}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='compare two firmware_bench JSON results')
+    parser.add_argument('base')
+    parser.add_argument('new')
+    parser.add_argument('--threshold', type=float, default=10.0, help='regression threshold in percent')
+    parser.add_argument('--metric', default='ns_median', choices=('ns_median', 'ns_min'))
+    args = parser.parse_args()
+
+    base_ctx, base = load(args.base)
+    new_ctx, new = load(args.new)
+    if base_ctx.get('compiler') != new_ctx.get('compiler'):
+        print('warning: compiled with different compilers (%s / %s)' % (base_ctx.get('compiler'), new_ctx.get('compiler')))
+
+    limit = 1 + args.threshold / 100.0
+    regressions = 0
+    print('%-28s %8s %12s %12s %9s' % ('benchmark', 'item', 'base', 'new', 'change'))
+    for name in list(base) + [n for n in new if n not in base]:
+        if name not in new:
+            print('%-28s %8s %12.2f %12s' % (name, base[name]['item'], base[name][args.metric], 'removed'))
+            continue
+        if name not in base:
+            print('%-28s %8s %12s %12.2f' % (name, new[name]['item'], 'new', new[name][args.metric]))
+            continue
+
+        b, n = base[name], new[name]
+        ratio = n[args.metric] / b[args.metric] if b[args.metric] > 0 else 1.0
+        overlap = n['ns_min'] <= b['ns_max'] and b['ns_min'] <= n['ns_max']
+        if ratio > limit:
+            verdict = 'SLOWER'
+            regressions += 1
+        elif ratio < 1 / limit:
+            verdict = 'faster'
+        else:
+            verdict = ''
+        print('%-28s %8s %12.2f %12.2f %+8.1f%% %s%s' % (name, b['item'], b[args.metric], n[args.metric],
+                                                       (ratio - 1) * 100, verdict, ' ~' if verdict and overlap else ''))
+
+    if regressions:
+        print('%d regression(s) above %.1f%%' % (regressions, args.threshold))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,614 @@
+// 固件热点代码主机端基准测试
+//
+// 直接编译固件源文件, 在主机上测量每次调用的耗时:
+//   stepper_loop     步进电机控制循环(含calculate_speed), 运动中/空闲
+//   laser_parser     激光传感器ASCII解析(laser_sensor_read的数据来源)
+//   laser_filter     激光距离滤波: 野值剔除 + 中值窗口 + alpha-beta, 每个样本一次
+//   k210_parser      K210文本检测结果解析, 逗号/冒号两种格式, 以及混有状态消息/错误/超长行的数据
+//   k210_frame       K210二进制帧解码(含CRC)
+//   target_tracks    多目标关联: 8个同类别成对交叉的框, 带漏检和误检
+//   track_object     trackObject(): 多目标关联 + 锁定目标 + 云台检测更新
+//   track_update     云台控制器10ms周期
+//   servo_loop       舵机平滑转动的步进
+//   chassis_command  底盘遥控命令: 解包 + 链路检查 + 应答编码 + 差速混控
+// 时间相关的函数使用hal/中的虚拟时钟, 由测试推进, 结果与主机负载无关的部分可重复。
+// 主机与ESP32的绝对耗时不同, 用于比较同一台机器上修改前后的相对变化。
+//
+// 编译(在本目录, 一行):
+//   g++ -O2 -std=c++11 -Ihal -I"../Chassis motor control/stepper/src" -I"../Chassis motor control/stepper/include" -I"../Chassis motor control/qzj/include" -I"../visual  contural/ESP32_Number_Tracker" -o firmware_bench firmware_bench.cpp "../Chassis motor control/stepper/src/"{stepper_control,servo_control,laser_parser,laser_filter,metrics,telemetry}.cpp "../Chassis motor control/qzj/src/"{teleop_protocol,drive_mixer}.cpp "../visual  contural/ESP32_Number_Tracker/"{k210_parser,k210_frame,target_tracks,track_control}.cpp
+//
+// 用法:
+//   ./firmware_bench                          运行全部, 打印表格
+//   ./firmware_bench --json base.json         同时输出JSON, 供bench_compare.py比较
+//   ./firmware_bench --filter k210            只运行名字包含k210的项
+//   ./firmware_bench --repeat 9 --min-time 500  每项重复9次, 每次至少运行500ms
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <Arduino.h>
+#include "stepper_control.h"
+#include "servo_control.h"
+#include "laser_parser.h"
+#include "laser_filter.h"
+#include "k210_parser.h"
+#include "k210_frame.h"
+#include "target_tracks.h"
+#include "track_control.h"
+#include "teleop_protocol.h"
+#include "drive_mixer.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+unsigned long bench_clock_us = 1;
+unsigned long bench_pin_writes = 0;
+BenchSerial Serial;
+
+// 结果累加到这里, 防止被编译器优化掉
+static volatile uint64_t g_sink = 0;
+
+/**
+ * 一个测试项: setup在每次计时前调用(不计时), run执行n次被测操作并返回校验值
+ */
+typedef struct
+{
+    const char *name;
+    const char *item; // 一次操作的含义
+    void (*setup)(void);
+    uint64_t (*run)(uint64_t n);
+} bench_t;
+
+typedef struct
+{
+    const bench_t *bench;
+    uint64_t iterations;
+    std::vector<double> ns; // 每次重复的ns/次
+} bench_result_t;
+
+/* ---------------- 步进电机 ---------------- */
+
+#define STEPPER_LOOP_PERIOD_US 25 // 主循环周期
+
+static void stepper_setup_moving(void)
+{
+    stepper_init();
+    stepper_run(0, 2000, 4000, 1000000);
+}
+
+static void stepper_setup_idle(void)
+{
+    stepper_init();
+}
+
+static uint64_t stepper_loop_run(uint64_t n)
+{
+    for (uint64_t i = 0; i < n; i++)
+    {
+        bench_clock_us += STEPPER_LOOP_PERIOD_US;
+        stepper_loop();
+    }
+    return stepper_get_position() + bench_pin_writes;
+}
+
+/* ---------------- 激光解析 ---------------- */
+
+static char g_laser_stream[64 * 16];
+static size_t g_laser_len = 0;
+static laser_parser_t g_laser_parser;
+
+// 64行"d: XXXX mm\r\n", 距离变化
+static void laser_setup(void)
+{
+    g_laser_len = 0;
+    for (int i = 0; i < 64; i++)
+        g_laser_len += sprintf(g_laser_stream + g_laser_len, "d: %d mm\r\n", 80 + i * 37);
+    laser_parser_reset(&g_laser_parser);
+}
+
+static uint64_t laser_run(uint64_t n)
+{
+    uint64_t sum = 0;
+    uint16_t distance;
+    for (uint64_t i = 0; i < n; i += 64)
+    {
+        for (size_t j = 0; j < g_laser_len; j++)
+        {
+            if (laser_parser_feed(&g_laser_parser, (uint8_t)g_laser_stream[j], &distance))
+                sum += distance;
+        }
+    }
+    return sum;
+}
+
+/* ---------------- 激光滤波 ---------------- */
+
+static uint16_t g_filter_input[256];
+static laser_filter_t g_laser_filter;
+
+// 以150mm/s接近, 20ms一个样本, 噪声±4mm, 每37个样本一个野值; median_window为中值窗口长度
+static void filter_setup_window(uint8_t median_window)
+{
+    uint32_t rng = 29;
+    for (int i = 0; i < 256; i++)
+    {
+        rng = rng * 1103515245u + 12345u;
+        int noise = (int)((rng >> 16) % 9) - 4;
+        g_filter_input[i] = (uint16_t)(800 - i * 3 + noise);
+        if (i % 37 == 17)
+            g_filter_input[i] = 8190;
+    }
+    laser_filter_config_t config;
+    laser_filter_default_config(&config);
+    config.median_window = median_window;
+    laser_filter_init(&g_laser_filter, &config);
+}
+
+static void filter_setup_median5(void)
+{
+    filter_setup_window(5);
+}
+
+static void filter_setup_median9(void)
+{
+    filter_setup_window(LASER_FILTER_MEDIAN_MAX);
+}
+
+static uint64_t filter_run(uint64_t n)
+{
+    uint64_t accepted = 0;
+    uint32_t t = 0;
+    laser_filtered_t out;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        // 每256个样本距离跳回起点, 滤波器经过outlier_reset个野值后重新初始化, 也计入耗时
+        t += 20;
+        accepted += laser_filter_update(&g_laser_filter, g_filter_input[i & 255], t);
+        laser_filter_get(&g_laser_filter, t, &out);
+    }
+    return accepted + (uint64_t)out.distance;
+}
+
+/* ---------------- K210文本解析 ---------------- */
+
+static char g_k210_stream[64 * (K210_PARSER_LINE_MAX + 8)];
+static size_t g_k210_len = 0;
+static k210_parser_t g_k210_parser;
+
+static void k210_setup_comma(void)
+{
+    g_k210_len = 0;
+    for (int i = 0; i < 64; i++)
+        g_k210_len += sprintf(g_k210_stream + g_k210_len, "%d,%d,%d,%d,%d\n", i % 8 + 1, 60 + i, 70 + i / 2, 40, 52);
+    k210_parser_reset(&g_k210_parser);
+}
+
+static void k210_setup_colon(void)
+{
+    g_k210_len = 0;
+    for (int i = 0; i < 64; i++)
+        g_k210_len +=
+            sprintf(g_k210_stream + g_k210_len, "%d:%d:%d:%d:%d:0.%02d:%d\n", 60 + i, 70 + i / 2, 40, 52, i % 8, 60 + i % 40, i % 8 + 1);
+    k210_parser_reset(&g_k210_parser);
+}
+
+// 带噪声的串口: 状态消息、格式错误和超长行混在检测结果中, 覆盖解析器的拒绝路径
+static void k210_setup_mixed(void)
+{
+    g_k210_len = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        char *p = g_k210_stream + g_k210_len;
+        if (i % 16 == 5)
+            g_k210_len += sprintf(p, "%0*d\n", K210_PARSER_LINE_MAX - 2 + i % 4, i); // 超长行
+        else if (i % 8 == 3)
+            g_k210_len += sprintf(p, "%d,%d,x%d,40\n", i, 60 + i, i); // 格式错误
+        else if (i % 4 == 1)
+            g_k210_len += sprintf(p, "Detection running, fps %d\n", 20 + i % 5);
+        else
+            g_k210_len += sprintf(p, "%d:%d:%d:%d:%d:0.%02d:%d\n", 60 + i, 70 + i / 2, 40, 52, i % 8, 60 + i % 40, i % 8 + 1);
+    }
+    k210_parser_reset(&g_k210_parser);
+}
+
+static uint64_t k210_text_run(uint64_t n)
+{
+    uint64_t sum = 0;
+    k210_detection_t det;
+    for (uint64_t i = 0; i < n; i += 64)
+    {
+        for (size_t j = 0; j < g_k210_len; j++)
+        {
+            if (k210_parser_feed(&g_k210_parser, (uint8_t)g_k210_stream[j], &det) == K210_PARSE_DETECTION)
+                sum += det.x + det.number;
+        }
+    }
+    return sum;
+}
+
+/* ---------------- K210二进制帧 ---------------- */
+
+static uint8_t g_frame_stream[16 * K210_FRAME_MAX_LEN];
+static size_t g_frame_len = 0;
+static k210_frame_decoder_t g_frame_decoder;
+
+// 模拟一帧三个目标的场景
+static void fill_frame(k210_frame_t *frame, uint32_t seq)
+{
+    memset(frame, 0, sizeof(*frame));
+    frame->count = 3;
+    frame->frame_id = (uint16_t)seq;
+    frame->capture_ms = seq * 33u;
+    frame->latency_ms = 45;
+    for (uint8_t d = 0; d < frame->count; d++)
+    {
+        k210_frame_det_t *det = &frame->dets[d];
+        det->class_id = d;
+        det->number = d + 1;
+        det->confidence = 200 - d * 20;
+        det->x = 20 + d * 70 + (seq % 30);
+        det->y = 60 + d * 10;
+        det->width = 40;
+        det->height = 52;
+    }
+}
+
+static void frame_setup(void)
+{
+    k210_frame_t frame;
+    g_frame_len = 0;
+    for (uint16_t i = 0; i < 16; i++)
+    {
+        fill_frame(&frame, i);
+        g_frame_len += k210_frame_encode(&frame, g_frame_stream + g_frame_len);
+    }
+    k210_frame_decoder_reset(&g_frame_decoder);
+}
+
+static uint64_t frame_run(uint64_t n)
+{
+    uint64_t sum = 0;
+    k210_frame_t frame;
+    for (uint64_t i = 0; i < n; i += 16)
+    {
+        for (size_t j = 0; j < g_frame_len; j++)
+        {
+            if (k210_frame_decoder_feed(&g_frame_decoder, g_frame_stream[j], &frame))
+                sum += frame.count + frame.dets[0].x;
+        }
+    }
+    return sum;
+}
+
+/* ---------------- 目标跟踪 ---------------- */
+
+#define CENTER_X 112 // 与ESP32_Number_Tracker.ino一致
+#define CENTER_Y 112
+
+static target_tracks_t g_tracks;
+static track_controller_t g_tracker;
+static uint8_t g_locked_id = 0;
+
+static void track_setup(void)
+{
+    target_tracks_init(&g_tracks, NULL);
+    track_init(&g_tracker, NULL, 90, 90);
+    g_locked_id = 0;
+}
+
+// updateTargets() + trackObject(), 每帧三个缓慢移动的目标
+static uint64_t track_object_run(uint64_t n)
+{
+    k210_frame_t frame;
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        fill_frame(&frame, (uint32_t)i);
+        target_tracks_update(&g_tracks, frame.dets, frame.count, frame.capture_ms);
+        const target_track_t *track = target_tracks_lock(&g_tracks, &g_locked_id);
+        if (track != NULL && track->last_seen == frame.capture_ms)
+        {
+            track_measure(&g_tracker, track->x + track->width / 2 - CENTER_X, track->y + track->height / 2 - CENTER_Y,
+                          frame.capture_ms);
+            sum += track->id;
+        }
+        else if (track == NULL)
+        {
+            track_lost(&g_tracker);
+        }
+    }
+    return sum + (uint64_t)g_tracker.cmd_pan;
+}
+
+// 预先生成的拥挤场景: 8个框(4个类别, 每类两个)在画面内反弹移动, 约10%漏检, 偶尔出现误检
+#define SCENE_FRAMES 256
+
+static k210_frame_t g_scene[SCENE_FRAMES];
+
+static void tracks_setup_crowded(void)
+{
+    uint32_t rng = 12345;
+    float x[8], y[8], vx[8], vy[8];
+    for (int k = 0; k < 8; k++)
+    {
+        x[k] = 10 + k * 22;
+        y[k] = 20 + (k % 4) * 40;
+        vx[k] = (k % 2 ? -1 : 1) * (40 + k * 10);
+        vy[k] = (k % 3 ? 1 : -1) * (30 + k * 5);
+    }
+    for (uint32_t f = 0; f < SCENE_FRAMES; f++)
+    {
+        k210_frame_t *frame = &g_scene[f];
+        memset(frame, 0, sizeof(*frame));
+        frame->capture_ms = f * 66u;
+        for (int k = 0; k < 8; k++)
+        {
+            x[k] += vx[k] * 0.066f;
+            y[k] += vy[k] * 0.066f;
+            if (x[k] < 0 || x[k] > 184)
+                vx[k] = -vx[k];
+            if (y[k] < 0 || y[k] > 174)
+                vy[k] = -vy[k];
+            rng = rng * 1103515245u + 12345u;
+            if ((rng >> 16) % 10 == 0)
+                continue;
+            k210_frame_det_t *det = &frame->dets[frame->count++];
+            det->class_id = k % 4;
+            det->number = k % 4;
+            det->confidence = 180;
+            det->x = (int16_t)x[k];
+            det->y = (int16_t)y[k];
+            det->width = 40;
+            det->height = 50;
+        }
+        rng = rng * 1103515245u + 12345u;
+        if ((rng >> 16) % 16 == 0 && frame->count > 0)
+            frame->dets[frame->count - 1].x = (int16_t)((rng >> 8) % 224); // 误检: 最后一个框跳到随机位置
+    }
+    target_tracks_init(&g_tracks, NULL);
+}
+
+static uint64_t tracks_crowded_run(uint64_t n)
+{
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        const k210_frame_t *frame = &g_scene[i % SCENE_FRAMES];
+        // 场景循环播放时时间继续增加
+        uint32_t now = frame->capture_ms + (uint32_t)(i / SCENE_FRAMES) * SCENE_FRAMES * 66u;
+        target_tracks_update(&g_tracks, frame->dets, frame->count, now);
+        sum += g_tracks.created;
+    }
+    return sum;
+}
+
+static void track_update_setup(void)
+{
+    track_setup();
+    track_object_run(8);
+}
+
+static uint64_t track_update_run(uint64_t n)
+{
+    for (uint64_t i = 0; i < n; i++)
+        track_update(&g_tracker, 300 + (uint32_t)(i % 100) * 10, 0.01f);
+    return (uint64_t)(g_tracker.cmd_pan * 1000);
+}
+
+/* ---------------- 舵机 ---------------- */
+
+static void servo_setup(void)
+{
+    servo_init(15);
+    servo_sweep_to(180, 5);
+}
+
+// 每次调用推进1ms, 到达目标后反向
+static uint64_t servo_run(uint64_t n)
+{
+    for (uint64_t i = 0; i < n; i++)
+    {
+        bench_clock_us += 1000;
+        servo_loop();
+        uint8_t angle = servo_get_angle();
+        if (angle == 180 || angle == 0)
+            servo_sweep_to(angle == 180 ? 0 : 180, 5);
+    }
+    return servo_get_angle();
+}
+
+/* ---------------- 底盘命令 ---------------- */
+
+static uint8_t g_teleop_packets[64][TELEOP_PACKET_LEN];
+static teleop_link_t g_link;
+static drive_mixer_t g_mixer;
+
+static void chassis_setup(void)
+{
+    teleop_cmd_t cmd;
+    for (int i = 0; i < 64; i++)
+    {
+        cmd.type = TELEOP_TYPE_DRIVE;
+        cmd.sync = i == 0;
+        cmd.seq = (uint16_t)i;
+        cmd.speed = (int16_t)(i * 31 - 1000);
+        cmd.turn = (int16_t)(500 - i * 17);
+        cmd.client_ms = (uint32_t)i * 20;
+        teleop_encode(&cmd, g_teleop_packets[i]);
+    }
+    teleop_link_init(&g_link, TELEOP_DEADMAN_MS);
+    drive_mixer_init(&g_mixer, NULL);
+}
+
+// 一个50Hz命令包: 解包, 链路检查, 编码应答, 设置混控并更新一个20ms周期
+static uint64_t chassis_run(uint64_t n)
+{
+    uint64_t sum = 0;
+    uint8_t ack[TELEOP_ACK_LEN];
+    teleop_cmd_t cmd;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        if (teleop_decode(g_teleop_packets[i % 64], TELEOP_PACKET_LEN, &cmd) != TELEOP_EOK)
+            continue;
+        // 序号按包序号递增, 每轮重新开始时链路视为新连接
+        if (i % 64 == 0)
+            teleop_link_init(&g_link, TELEOP_DEADMAN_MS);
+        teleop_link_accept(&g_link, &cmd, (uint32_t)i * 20);
+        teleop_encode_ack(&g_link, &cmd, ack);
+        drive_mixer_set(&g_mixer, cmd.speed / (float)TELEOP_VALUE_MAX, cmd.turn / (float)TELEOP_VALUE_MAX);
+        drive_mixer_update(&g_mixer, 0.02f);
+        sum += ack[4] + (int)g_mixer.duty[DRIVE_WHEEL_LEFT];
+    }
+    return sum;
+}
+
+/* ---------------- 运行 ---------------- */
+
+static const bench_t g_benches[] = {
+    {"stepper_loop/moving", "call", stepper_setup_moving, stepper_loop_run},
+    {"stepper_loop/idle", "call", stepper_setup_idle, stepper_loop_run},
+    {"laser_parser/ascii_line", "line", laser_setup, laser_run},
+    {"laser_filter/median5", "sample", filter_setup_median5, filter_run},
+    {"laser_filter/median9", "sample", filter_setup_median9, filter_run},
+    {"k210_parser/comma_line", "line", k210_setup_comma, k210_text_run},
+    {"k210_parser/colon_line", "line", k210_setup_colon, k210_text_run},
+    {"k210_parser/mixed_line", "line", k210_setup_mixed, k210_text_run},
+    {"k210_frame/decode_3dets", "frame", frame_setup, frame_run},
+    {"target_tracks/crowded_8", "frame", tracks_setup_crowded, tracks_crowded_run},
+    {"track_object/3targets", "frame", track_setup, track_object_run},
+    {"track_update/tick", "tick", track_update_setup, track_update_run},
+    {"servo_loop/sweep", "call", servo_setup, servo_run},
+    {"chassis_command/teleop_mix", "packet", chassis_setup, chassis_run},
+};
+
+#define BENCH_NUM (sizeof(g_benches) / sizeof(g_benches[0]))
+
+// 批量处理的测试项按整批运行, 次数取整
+static uint64_t batch_of(const bench_t *b)
+{
+    if (b->run == laser_run || b->run == k210_text_run)
+        return 64;
+    if (b->run == frame_run)
+        return 16;
+    return 1;
+}
+
+static double time_run(const bench_t *b, uint64_t n)
+{
+    b->setup();
+    bench_clock::time_point t0 = bench_clock::now();
+    g_sink += b->run(n);
+    return std::chrono::duration<double, std::nano>(bench_clock::now() - t0).count();
+}
+
+// 增加次数直到一次运行超过min_time_ns
+static uint64_t calibrate(const bench_t *b, double min_time_ns)
+{
+    uint64_t batch = batch_of(b);
+    uint64_t n = batch;
+    for (;;)
+    {
+        double ns = time_run(b, n);
+        if (ns >= min_time_ns)
+            return n;
+        double scale = ns > 0 ? min_time_ns * 1.2 / ns : 10;
+        scale = scale < 2 ? 2 : (scale > 10 ? 10 : scale);
+        n = (uint64_t)(n * scale + batch - 1) / batch * batch;
+    }
+}
+
+static double median(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    size_t m = v.size() / 2;
+    return v.size() % 2 ? v[m] : (v[m - 1] + v[m]) / 2;
+}
+
+static void write_json(FILE *f, const std::vector<bench_result_t> &results, int repeat, int min_time_ms)
+{
+    char date[32];
+    time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    fprintf(f, "{\n  \"context\": {\"date\": \"%s\", \"compiler\": \"%s\", \"repeat\": %d, \"min_time_ms\": %d},\n",
+            date, __VERSION__, repeat, min_time_ms);
+    fprintf(f, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const bench_result_t *r = &results[i];
+        fprintf(f,
+                "    {\"name\": \"%s\", \"item\": \"%s\", \"iterations\": %llu, \"ns_median\": %.3f, "
+                "\"ns_min\": %.3f, \"ns_max\": %.3f}%s\n",
+                r->bench->name, r->bench->item, (unsigned long long)r->iterations, median(r->ns),
+                *std::min_element(r->ns.begin(), r->ns.end()), *std::max_element(r->ns.begin(), r->ns.end()),
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *json_path = NULL;
+    const char *filter = NULL;
+    int repeat = 5;
+    int min_time_ms = 200;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            json_path = argv[++i];
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+            min_time_ms = atoi(argv[++i]);
+        else
+            repeat = 0;
+    }
+    if (repeat < 1 || min_time_ms < 1)
+    {
+        fprintf(stderr, "usage: %s [--json out.json] [--filter text] [--repeat n] [--min-time ms]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<bench_result_t> results;
+    printf("%-28s %8s %12s %12s %12s %8s\n", "benchmark", "item", "iterations", "ns_median", "ns_min", "spread");
+    for (size_t i = 0; i < BENCH_NUM; i++)
+    {
+        const bench_t *b = &g_benches[i];
+        if (filter != NULL && strstr(b->name, filter) == NULL)
+            continue;
+
+        bench_result_t r;
+        r.bench = b;
+        r.iterations = calibrate(b, min_time_ms * 1e6 / repeat);
+        for (int k = 0; k < repeat; k++)
+            r.ns.push_back(time_run(b, r.iterations) / r.iterations);
+        results.push_back(r);
+
+        double med = median(r.ns);
+        double lo = *std::min_element(r.ns.begin(), r.ns.end());
+        double hi = *std::max_element(r.ns.begin(), r.ns.end());
+        printf("%-28s %8s %12llu %12.2f %12.2f %7.1f%%\n", b->name, b->item, (unsigned long long)r.iterations, med,
+               lo, med > 0 ? (hi - lo) * 100 / med : 0);
+        fflush(stdout);
+    }
+
+    if (json_path != NULL)
+    {
+        FILE *f = fopen(json_path, "w");
+        if (f == NULL)
+        {
+            fprintf(stderr, "cannot write %s\n", json_path);
+            return 1;
+        }
+        write_json(f, results, repeat, min_time_ms);
+        fclose(f);
+    }
+    return 0;
+}
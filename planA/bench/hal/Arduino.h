@@ -0,0 +1,55 @@
+#ifndef BENCH_ARDUINO_H
+#define BENCH_ARDUINO_H
+
+/**
+ * 基准测试用的Arduino接口: millis/micros读取由测试推进的虚拟时钟,
+ * delayMicroseconds只推进时钟不等待, 引脚写入只计数;
+ * Serial.printf照常格式化到丢弃缓冲区, 保留状态输出的格式化开销。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+using std::max;
+using std::min;
+
+extern unsigned long bench_clock_us; /**< 虚拟时钟(us) */
+extern unsigned long bench_pin_writes; /**< digitalWrite次数 */
+
+static inline unsigned long micros(void) { return bench_clock_us; }
+static inline unsigned long millis(void) { return bench_clock_us / 1000; }
+static inline void delayMicroseconds(uint32_t us) { bench_clock_us += us; }
+static inline void delay(uint32_t ms) { bench_clock_us += ms * 1000UL; }
+static inline void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+static inline void digitalWrite(uint8_t pin, uint8_t level) { (void)pin; (void)level; bench_pin_writes++; }
+
+class BenchSerial
+{
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    size_t println(const char *text) { return strlen(text) + 1; }
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        char buf[128];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        return len < 0 ? 0 : (size_t)len;
+    }
+};
+
+extern BenchSerial Serial;
+
+#endif // BENCH_ARDUINO_H
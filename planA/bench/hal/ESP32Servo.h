@@ -0,0 +1,37 @@
+#ifndef BENCH_ESP32SERVO_H
+#define BENCH_ESP32SERVO_H
+
+/**
+ * 基准测试用的ESP32Servo: write只记录角度和次数
+ */
+
+#include <stdint.h>
+
+class ESP32PWM
+{
+public:
+    static void allocateTimer(int timer) { (void)timer; }
+};
+
+class Servo
+{
+public:
+    void setPeriodHertz(int hz) { (void)hz; }
+    int attach(int pin, int min_us, int max_us)
+    {
+        (void)pin;
+        (void)min_us;
+        (void)max_us;
+        return 1;
+    }
+    void write(int angle)
+    {
+        last_angle = angle;
+        writes++;
+    }
+
+    int last_angle = 0;
+    unsigned long writes = 0;
+};
+
+#endif // BENCH_ESP32SERVO_H
@@ -0,0 +1,73 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+/**
+ * 主机端测试程序共用的检查宏和伪随机数, 各项目的test/host(视觉为test)中的测试都包含本文件。
+ * 每个测试程序只有一个源文件包含它, 计数和随机数状态在该文件内。
+ * 编译时加 -I 指向本目录: 在底盘各项目的test/host中为 -I../../../../test, 在视觉的test中为 -I../../test
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** 失败次数超过该值时直接退出, 避免随机测试刷屏 */
+#ifndef TEST_MAX_FAILURES
+#define TEST_MAX_FAILURES 20
+#endif
+
+static int g_failures = 0;
+
+/**
+ * @brief 条件不成立时打印位置和printf格式的说明, 计入失败次数
+ */
+#define CHECK(cond, ...)                                \
+    do                                                  \
+    {                                                   \
+        if (!(cond))                                    \
+        {                                               \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__);                        \
+            printf("\n");                               \
+            if (++g_failures > TEST_MAX_FAILURES)       \
+                exit(1);                                \
+        }                                               \
+    } while (0)
+
+/** xorshift32状态, 不能为0 */
+static uint32_t g_rng = 1;
+
+/**
+ * @brief 用命令行参数设置随机种子(十进制或0x开头的十六进制), 同一种子每次结果相同
+ */
+static inline void rng_seed(const char *text)
+{
+    g_rng = (uint32_t)strtoul(text, NULL, 0) | 1;
+}
+
+static inline uint32_t rng_next(void)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+/**
+ * @brief [lo, hi]内的均匀分布, 分辨率为区间的十万分之一
+ */
+static inline float rng_uniform(float lo, float hi)
+{
+    return lo + (hi - lo) * (rng_next() % 100001) / 100000.0f;
+}
+
+/**
+ * @brief 打印结果, 作为main的返回值: 全部通过时返回0, 否则返回1
+ */
+static inline int test_summary(void)
+{
+    printf(g_failures ? "%d check(s) failed\n" : "all checks passed\n", g_failures);
+    return g_failures ? 1 : 0;
+}
+
+#endif // TEST_UTIL_H
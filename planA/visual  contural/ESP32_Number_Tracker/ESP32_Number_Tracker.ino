@@ -2,6 +2,14 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include <ESP32Servo.h>
+#include <Preferences.h>
+#include "k210_parser.h"
+#include "k210_frame.h"
+#include "oled_dirty.h"
+#include "track_control.h"
+#include "track_params.h"
+#include "target_tracks.h"
+#include "latency_stats.h"
 
 // OLED显示屏设置
 #define SCREEN_WIDTH 128
@@ -9,19 +17,22 @@
 #define OLED_RESET    -1
 #define SCREEN_ADDRESS 0x3C  // 或尝试 0x3D
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+#define DISPLAY_INTERVAL_MS 100  // 显示任务最高刷新间隔(10次/秒)
+#define OLED_I2C_CHUNK 64        // 每次I2C传输的显存字节数，不超过Wire缓冲区
 
 // 舵机设置
 #define SERVO_X_PIN 25  // ESP32S3的GPIO25引脚连接X轴舵机
 #define SERVO_Y_PIN 26  // ESP32S3的GPIO26引脚连接Y轴舵机
+#define SERVO_MIN_US 500   // 0度脉宽
+#define SERVO_MAX_US 2500  // 180度脉宽
 
 // 摄像头视野中心点
 #define CENTER_X 112    // 224/2
 #define CENTER_Y 112    // 224/2
 
-// PID控制参数
-#define KP 0.1          // 比例系数
-#define KI 0.01         // 积分系数
-#define KD 0.05         // 微分系数
+// 跟踪控制参数(其余参数见track_default_config，可用"track"命令在线调整并保存到NVS)
+#define TRACK_PERIOD_MS 10        // 跟踪任务周期，与K210帧率无关
+#define K210_TEXT_LATENCY_MS 60   // 文本格式没有延迟信息时假定的检测延迟
 
 // 串口通信设置
 #define SERIAL_BAUD 115200
@@ -33,23 +44,90 @@ Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
 Servo servoX;
 Servo servoY;
 
-// PID控制变量
-float errorX = 0, errorY = 0;
-float prevErrorX = 0, prevErrorY = 0;
-float integralX = 0, integralY = 0;
-float derivativeX = 0, derivativeY = 0;
+// 跟踪控制器，loop输入检测结果，跟踪任务按固定周期更新舵机
+track_controller_t tracker;
+portMUX_TYPE trackMux = portMUX_INITIALIZER_UNLOCKED;
 
 // 目标位置
 int targetX = CENTER_X;
 int targetY = CENTER_Y;
 
-// 舵机当前角度
+// 舵机当前角度(取整后用于显示，实际下发带小数)
 int servoXPos = 90;
 int servoYPos = 90;
 
 // 识别结果
 int detectedNumber = -1;
-bool objectDetected = false;
+bool objectDetected = false;     // 是否有正在跟踪的目标轨迹
+bool targetSeen = false;         // 跟踪的目标在最新一帧中被检测到
+uint32_t targetCaptureMs = 0;    // 最新一帧的拍照时间(本机millis)
+
+// 多目标跟踪，云台锁定其中一条轨迹，直到该轨迹过期
+target_tracks_t targetTracks;
+uint8_t lockedTrackId = 0;       // 0表示未锁定
+
+// K210数据解析
+#define K210_DEBUG 0  // 为1时打印每个检测结果
+k210_parser_t k210Parser;
+k210_frame_decoder_t k210Decoder;
+bool k210BinaryMode = false;     // 收到第一帧二进制数据后不再按文本解析
+uint32_t k210FrameAgeMs = 0;     // 最新一帧从拍照到解析完成的估计时间
+unsigned long lastK210ByteTime = 0;
+
+// 原始数据捕获："cap on"后把K210串口收到的每段数据按"R,接收时间us,十六进制数据"打印，
+// 保存后用tracker_replay离线回放
+#define CAPTURE_CHUNK 32          // 每行最多的字节数
+bool captureMode = false;
+uint32_t captureBytes = 0;
+uint32_t captureDropped = 0;     // USB串口发送缓冲区不足时丢弃的行数
+
+// OLED显示任务使用的跟踪状态快照，由loop发布，显示任务加锁拷贝
+struct DisplayState {
+  bool objectDetected;
+  int detectedNumber;
+  int trackId;
+  int trackCount;
+  int targetX;
+  int targetY;
+  int servoXPos;
+  int servoYPos;
+  uint32_t seq;  // 每次发布加1，显示任务据此跳过没有变化的状态
+};
+DisplayState displayState = {};
+DisplayState renderState = {};  // 显示任务正在绘制的快照
+portMUX_TYPE displayMux = portMUX_INITIALIZER_UNLOCKED;
+uint8_t oledAddress = SCREEN_ADDRESS;
+oled_dirty_t oledDirty;
+
+// 延迟统计(us)，只统计二进制帧(文本格式没有K210端时间戳)
+#define LAT_K210      0  // K210拍照到开始发送(帧内latency_ms)
+#define LAT_RECEIVE   1  // 读到帧第一个字节到整帧收完(串口传输和读取等待)
+#define LAT_PARSE     2  // 整帧收完到检测结果交给跟踪控制器
+#define LAT_ACTUATOR  3  // 交给跟踪控制器到舵机下发
+#define LAT_TOTAL     4  // 拍照到舵机下发(按K210延迟和本机时间估计)
+#define LAT_DISPLAY   5  // 一次OLED重绘和发送
+#define LAT_STAGES    6
+const char *latencyStageNames[LAT_STAGES] = {"k210", "receive", "parse", "actuator", "total", "display"};
+latency_hist_t latencyHist[LAT_STAGES];
+portMUX_TYPE latencyMux = portMUX_INITIALIZER_UNLOCKED;
+bool latencyLog = false;         // 为true时每帧打印一行时间戳，供主机工具估计时钟偏差
+
+// 最新一帧的各阶段时间戳(本机micros)，舵机下发后补全
+struct LatencyRecord {
+  uint16_t frameId;
+  uint32_t captureMs;      // K210拍照时间(K210时钟)
+  uint16_t k210LatencyMs;  // K210拍照到发送
+  uint32_t rxStartUs;      // 读到第一个字节
+  uint32_t rxDoneUs;       // 整帧收完
+  uint32_t parsedUs;       // 交给跟踪控制器
+  uint32_t actuatorUs;     // 舵机下发
+  bool pending;            // 等待跟踪任务下发舵机
+  bool ready;              // 已补全，等待打印
+};
+LatencyRecord latencyRecord = {};
+uint32_t frameStartUs = 0;       // 正在接收的二进制帧第一个字节的读取时间
+uint32_t frameDoneUs = 0;        // 最新一帧最后一个字节的读取时间
+bool frameHasStamps = false;     // 最新检测来自二进制帧，可以统计延迟
 
 void setup() {
   // 初始化串口通信
@@ -63,6 +141,12 @@ void setup() {
   Serial.printf("Baud: %d\n", SERIAL_BAUD);
   
   K210_SERIAL.begin(SERIAL_BAUD, SERIAL_8N1, K210_RX_PIN, K210_TX_PIN);
+  k210_parser_reset(&k210Parser);
+  k210_frame_decoder_reset(&k210Decoder);
+  for (int i = 0; i < LAT_STAGES; i++) {
+    latency_hist_reset(&latencyHist[i]);
+  }
+  target_tracks_init(&targetTracks, NULL);
   Serial.println("K210 UART initialized");
   
   // 发送测试数据到K210
@@ -87,6 +171,7 @@ void setup() {
       for(;;);
     } else {
       Serial.println(F("SSD1306 initialized at address 0x3D"));
+      oledAddress = 0x3D;
     }
   } else {
     Serial.println(F("SSD1306 initialized at address 0x3C"));
@@ -115,6 +200,10 @@ void setup() {
   // 舵机归中
   servoX.write(servoXPos);
   servoY.write(servoYPos);
+  track_config_t trackConfig;
+  loadTrackParams(&trackConfig);
+  track_init(&tracker, &trackConfig, servoXPos, servoYPos);
+  xTaskCreatePinnedToCore(trackingTask, "Tracking", 4096, NULL, 2, NULL, 1);
   Serial.println("Servos initialized and centered");
   
   Serial.println("System started, waiting for K210 data...");
@@ -129,6 +218,11 @@ void setup() {
   display.setCursor(0, 32);
   display.println(F("Waiting for K210..."));
   display.display();
+  
+  // 之后只由显示任务访问OLED，第一次刷新时发送全屏
+  oled_dirty_init(&oledDirty);
+  publishDisplayState();
+  xTaskCreatePinnedToCore(displayTask, "Display", 4096, NULL, 1, NULL, 0);
 }
 
 void loop() {
@@ -157,193 +251,235 @@ void loop() {
   if (readDataFromK210()) {
     // 有数据时更新OLED和控制舵机
     receivedCount++;
+#if K210_DEBUG
     Serial.printf("Successfully parsed data #%d\n", receivedCount);
-    updateDisplay();
+#endif
+    trackObject();
     
-    if (objectDetected) {
-      trackObject();
-    }
+    // 只发布状态快照，由显示任务按限定频率刷新OLED
+    publishDisplayState();
   }
   
-  delay(10);  // 短暂延时
+  readSerialCommand();
+  printLatencyRecord();
+  
+  delay(1);  // 舵机由跟踪任务控制，这里只需及时处理串口数据
 }
 
-// 检查K210串口数据（包括测试消息和其他信息）
+// 检查K210串口是否有数据到达（不读取数据，数据统一由readDataFromK210解析）
 bool checkK210Serial(bool reportStatus) {
-  if (K210_SERIAL.available()) {
-    String data = K210_SERIAL.readStringUntil('\n');
-    // 清理字符串
-    data.trim();
-    
-    // 打印原始数据
-    Serial.print("K210 Serial Data: '");
-    Serial.print(data);
-    Serial.println("'");
-    
-    // 特殊消息处理
-    if (data.startsWith("K210") || data.startsWith("UART test") || 
-        data.startsWith("Camera") || data.startsWith("LCD") || 
-        data.startsWith("Model") || data.startsWith("Detection") ||
-        data.startsWith("No object")) {
-      // 这些是状态消息，不是检测数据
-      return true;
-    }
-    
-    return true;  // 有数据返回true
+  if (millis() - lastK210ByteTime <= 500) {
+    return true;
   }
   
   if (reportStatus) {
-    Serial.println("No data from K210");
+    if (k210BinaryMode) {
+      Serial.printf("No data from K210 (frames: %u, CRC errors: %u, lost: %u)\n",
+                    k210Decoder.frames, k210Decoder.crc_errors, k210Decoder.lost_frames);
+    } else {
+      Serial.printf("No data from K210 (parsed: %u, errors: %u)\n",
+                    k210Parser.detections, k210Parser.errors);
+    }
   }
   
   return false;
 }
 
-// 读取K210的数据，支持多种格式
-bool readDataFromK210() {
-  if (!K210_SERIAL.available()) {
-    return false;  // 没有数据
-  }
-  
-  String data = K210_SERIAL.readStringUntil('\n');
-  // 清理字符串
-  data.trim();
-  
-  // 打印原始数据
-  Serial.print("Raw data: '");
-  Serial.print(data);
-  Serial.println("'");
-  
-  // 记录接收到的每个字节（十六进制）
-  Serial.print("Hex: ");
-  for (int i = 0; i < data.length(); i++) {
-    Serial.printf("%02X ", (unsigned char)data.charAt(i));
-  }
-  Serial.println();
-  
-  // 如果是状态或测试消息，忽略处理
-  if (data.startsWith("K210") || data.startsWith("UART test") || 
-      data.startsWith("Camera") || data.startsWith("LCD") || 
-      data.startsWith("Model") || data.startsWith("Detection") ||
-      data.startsWith("No object")) {
-    Serial.println("Received status message, ignoring");
-    return false;
-  }
-  
-  // 尝试多种格式解析
-  
-  // 格式1: 使用逗号分隔的简单格式 (number,x,y,width,height)
-  if (data.indexOf(',') > 0) {
-    return parseCommaFormat(data);
+// 用一帧的全部检测结果更新多目标轨迹，并选出云台跟踪的目标
+void updateTargets(const k210_frame_det_t *dets, uint8_t count, uint32_t ageMs) {
+  targetCaptureMs = millis() - ageMs;
+  target_tracks_update(&targetTracks, dets, count, targetCaptureMs);
+  
+  // 锁定的轨迹还在就继续跟踪，否则选择命中次数最多的已确认轨迹
+  const target_track_t *track = target_tracks_lock(&targetTracks, &lockedTrackId);
+  
+  objectDetected = track != NULL;
+  targetSeen = track != NULL && track->last_seen == targetCaptureMs;
+  if (targetSeen) {
+    detectedNumber = track->number;
+    targetX = track->x + track->width / 2;
+    targetY = track->y + track->height / 2;
   }
-  
-  // 格式2: 使用冒号分隔的格式 (x:y:w:h:classid:confidence:label)
-  if (data.indexOf(':') > 0) {
-    return parseColonFormat(data);
-  }
-  
-  Serial.println("Unknown data format");
-  return false;
 }
 
-// 解析逗号分隔格式: number,x,y,width,height
-bool parseCommaFormat(String data) {
-  Serial.println("Parsing comma format");
-  
-  // 检查数据格式
-  if (data.indexOf(',') < 0) {
-    Serial.println("Invalid data format (no commas)");
-    return false;
-  }
-  
-  // 解析数据格式：NUMBER,X,Y,WIDTH,HEIGHT
-  int commaIndex1 = data.indexOf(',');
-  if (commaIndex1 > 0) {
-    // 尝试解析数字
-    String numberStr = data.substring(0, commaIndex1);
-    Serial.println("Detected number: " + numberStr);
-    detectedNumber = numberStr.toInt();
+// 处理一帧二进制检测结果
+void handleK210Frame(const k210_frame_t *frame) {
+  // K210端延迟加上串口传输时间(每字节10位)
+  uint32_t frameBytes = K210_FRAME_HEADER_LEN + K210_FRAME_DET_LEN * frame->count + K210_FRAME_CRC_LEN;
+  k210FrameAgeMs = frame->latency_ms + frameBytes * 10 * 1000 / SERIAL_BAUD;
+  
+#if K210_DEBUG
+  Serial.printf("Frame %u: %u objects, Age=%ums\n", frame->frame_id, frame->count, k210FrameAgeMs);
+#endif
+  updateTargets(frame->dets, frame->count, k210FrameAgeMs);
+  
+  // 记录本帧时间戳，舵机下发时间由跟踪任务补全
+  portENTER_CRITICAL(&latencyMux);
+  latencyRecord.frameId = frame->frame_id;
+  latencyRecord.captureMs = frame->capture_ms;
+  latencyRecord.k210LatencyMs = frame->latency_ms;
+  latencyRecord.rxStartUs = frameStartUs;
+  latencyRecord.rxDoneUs = frameDoneUs;
+  latencyRecord.pending = false;
+  latencyRecord.ready = false;
+  portEXIT_CRITICAL(&latencyMux);
+  frameHasStamps = true;
+}
+
+// 读取K210的数据，逐字节解析已到达的全部数据，支持二进制帧和逗号/冒号两种文本格式
+bool readDataFromK210() {
+  k210_detection_t det;
+  k210_frame_t frame;
+  bool updated = false;
+  uint8_t chunk[CAPTURE_CHUNK];
+  uint8_t chunkLen = 0;
+  uint32_t chunkUs = 0;
+  
+  while (K210_SERIAL.available()) {
+    uint8_t byte = (uint8_t)K210_SERIAL.read();
+    uint32_t readUs = micros();
+    lastK210ByteTime = millis();
     
-    int commaIndex2 = data.indexOf(',', commaIndex1 + 1);
-    int commaIndex3 = data.indexOf(',', commaIndex2 + 1);
-    int commaIndex4 = data.indexOf(',', commaIndex3 + 1);
+    if (captureMode) {
+      if (chunkLen == 0) {
+        chunkUs = readUs;
+      }
+      chunk[chunkLen++] = byte;
+      if (chunkLen == CAPTURE_CHUNK) {
+        captureChunk(chunk, chunkLen, chunkUs);
+        chunkLen = 0;
+      }
+    }
     
-    if (commaIndex2 > 0 && commaIndex3 > 0 && commaIndex4 > 0) {
-      int x = data.substring(commaIndex1 + 1, commaIndex2).toInt();
-      int y = data.substring(commaIndex2 + 1, commaIndex3).toInt();
-      int width = data.substring(commaIndex3 + 1, commaIndex4).toInt();
-      int height = data.substring(commaIndex4 + 1).toInt();
-      
-      // 打印解析后的数据
-      Serial.printf("Parsed data: Number=%d, X=%d, Y=%d, W=%d, H=%d\n", 
-                    detectedNumber, x, y, width, height);
-      
-      // 计算目标中心点
-      targetX = x + width / 2;
-      targetY = y + height / 2;
-      objectDetected = true;
-      
-      return true;
-    } else {
-      Serial.println("Invalid data format (missing commas)");
+    if (k210_frame_decoder_feed(&k210Decoder, byte, &frame)) {
+      k210BinaryMode = true;
+      frameDoneUs = readUs;
+      handleK210Frame(&frame);
+      updated = true;
+      continue;
+    }
+    if (k210Decoder.cnt == 1) {
+      frameStartUs = readUs;  // 可能是新帧的帧头
+    }
+    if (k210BinaryMode) {
+      continue;
+    }
+    
+    uint8_t result = k210_parser_feed(&k210Parser, byte, &det);
+    if (result == K210_PARSE_STATUS) {
+      // 状态或测试消息，打印后忽略
+      Serial.printf("K210: %s\n", k210Parser.line);
+    } else if (result == K210_PARSE_ERROR) {
+#if K210_DEBUG
+      Serial.printf("Unknown data format: '%s'\n", k210Parser.line);
+#endif
+    } else if (result == K210_PARSE_DETECTION) {
+#if K210_DEBUG
+      Serial.printf("Parsed data: Number=%d, X=%d, Y=%d, W=%d, H=%d, ClassID=%d, Conf=%.2f\n",
+                    det.number, det.x, det.y, det.width, det.height, det.class_id, det.confidence);
+#endif
+      // 文本格式每行一个检测，按单个检测的帧处理
+      k210_frame_det_t frameDet;
+      frameDet.class_id = det.class_id < 0 ? (uint8_t)det.number : det.class_id; // 逗号格式没有类别ID, 按数字区分
+      frameDet.number = (uint8_t)det.number;
+      frameDet.confidence = det.confidence < 0 ? 0 : (uint8_t)(det.confidence * 255);
+      frameDet.x = det.x;
+      frameDet.y = det.y;
+      frameDet.width = det.width;
+      frameDet.height = det.height;
+      updateTargets(&frameDet, 1, K210_TEXT_LATENCY_MS);
+      frameHasStamps = false;
+      updated = true;
     }
   }
   
-  return false;
+  if (chunkLen > 0) {
+    captureChunk(chunk, chunkLen, chunkUs);
+  }
+  return updated;
 }
 
-// 解析冒号分隔格式: x:y:w:h:classid:confidence:label
-bool parseColonFormat(String data) {
-  Serial.println("Parsing colon format");
-  
-  // 检查数据格式
-  if (data.indexOf(':') < 0) {
-    Serial.println("Invalid data format (no colons)");
-    return false;
+// 打印一段捕获的原始数据，发送缓冲区放不下时丢弃并计数，不阻塞接收
+void captureChunk(const uint8_t *data, uint8_t len, uint32_t rxUs) {
+  static const char hex[] = "0123456789abcdef";
+  char line[16 + CAPTURE_CHUNK * 2];
+  int n = snprintf(line, sizeof(line), "R,%u,", rxUs);
+  for (uint8_t i = 0; i < len; i++) {
+    line[n++] = hex[data[i] >> 4];
+    line[n++] = hex[data[i] & 0x0F];
   }
+  line[n++] = '\n';
   
-  // 解析格式: x:y:w:h:classid:confidence:label
-  int colonIndex1 = data.indexOf(':');
-  int colonIndex2 = data.indexOf(':', colonIndex1 + 1);
-  int colonIndex3 = data.indexOf(':', colonIndex2 + 1);
-  int colonIndex4 = data.indexOf(':', colonIndex3 + 1);
-  int colonIndex5 = data.indexOf(':', colonIndex4 + 1);
-  int colonIndex6 = data.indexOf(':', colonIndex5 + 1);
+  captureBytes += len;
+  if (Serial.availableForWrite() < n) {
+    captureDropped++;
+    return;
+  }
+  Serial.write((const uint8_t *)line, n);
+}
+
+// 发布显示用的状态快照
+void publishDisplayState() {
+  portENTER_CRITICAL(&displayMux);
+  displayState.objectDetected = objectDetected;
+  displayState.detectedNumber = detectedNumber;
+  displayState.trackId = lockedTrackId;
+  displayState.trackCount = target_tracks_count(&targetTracks);
+  displayState.targetX = targetX;
+  displayState.targetY = targetY;
+  displayState.servoXPos = servoXPos;
+  displayState.servoYPos = servoYPos;
+  displayState.seq++;
+  portEXIT_CRITICAL(&displayMux);
+}
+
+// 向SSD1306的一页写入一段显存
+void oledWriteRange(void *ctx, uint8_t page, uint8_t column, const uint8_t *data, uint8_t len) {
+  display.ssd1306_command(SSD1306_PAGEADDR);
+  display.ssd1306_command(page);
+  display.ssd1306_command(page);
+  display.ssd1306_command(SSD1306_COLUMNADDR);
+  display.ssd1306_command(column);
+  display.ssd1306_command(column + len - 1);
+  
+  while (len > 0) {
+    uint8_t n = len > OLED_I2C_CHUNK ? OLED_I2C_CHUNK : len;
+    Wire.beginTransmission(oledAddress);
+    Wire.write((uint8_t)0x40);  // 后面是显存数据
+    Wire.write(data, n);
+    Wire.endTransmission();
+    data += n;
+    len -= n;
+  }
+}
+
+// OLED显示任务：按固定间隔检查状态快照，有变化时重绘并只发送变化的部分
+void displayTask(void *pvParameters) {
+  uint32_t lastSeq = 0;
+  TickType_t lastWake = xTaskGetTickCount();
   
-  if (colonIndex1 > 0 && colonIndex2 > 0 && colonIndex3 > 0 && 
-      colonIndex4 > 0 && colonIndex5 > 0 && colonIndex6 > 0) {
+  for (;;) {
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(DISPLAY_INTERVAL_MS));
     
-    int x = data.substring(0, colonIndex1).toInt();
-    int y = data.substring(colonIndex1 + 1, colonIndex2).toInt();
-    int width = data.substring(colonIndex2 + 1, colonIndex3).toInt();
-    int height = data.substring(colonIndex3 + 1, colonIndex4).toInt();
-    int classId = data.substring(colonIndex4 + 1, colonIndex5).toInt();
-    float confidence = data.substring(colonIndex5 + 1, colonIndex6).toFloat();
-    String label = data.substring(colonIndex6 + 1);
+    portENTER_CRITICAL(&displayMux);
+    renderState = displayState;
+    portEXIT_CRITICAL(&displayMux);
     
-    // 打印解析后的数据
-    Serial.printf("Parsed data: X=%d, Y=%d, W=%d, H=%d, ClassID=%d, Conf=%.2f, Label=%s\n", 
-                  x, y, width, height, classId, confidence, label.c_str());
-    
-    // 获取数字标签
-    detectedNumber = label.toInt();
-    if (detectedNumber == 0 && label != "0") {
-      // 若无法转为数字，则使用原始类别ID
-      detectedNumber = classId + 1;  // 类别ID从0开始，所以+1使其从1开始
+    if (renderState.seq == lastSeq) {
+      continue;
     }
+    lastSeq = renderState.seq;
     
-    // 计算目标中心点
-    targetX = x + width / 2;
-    targetY = y + height / 2;
-    objectDetected = true;
-    
-    return true;
+    uint32_t startUs = micros();
+    updateDisplay();
+    uint32_t elapsedUs = micros() - startUs;
+    portENTER_CRITICAL(&latencyMux);
+    latency_hist_add(&latencyHist[LAT_DISPLAY], elapsedUs);
+    portEXIT_CRITICAL(&latencyMux);
   }
-  
-  Serial.println("Invalid colon format");
-  return false;
 }
 
+// 根据renderState绘制，只在显示任务中调用
 void updateDisplay() {
   display.clearDisplay();
   display.setTextSize(1);
@@ -351,64 +487,245 @@ void updateDisplay() {
   display.println(F("Number Tracking"));
   display.drawLine(0, 10, 128, 10, SSD1306_WHITE);
   
-  if (objectDetected) {
+  if (renderState.objectDetected) {
     display.setCursor(0, 16);
     display.print(F("Number: "));
-    display.println(detectedNumber);
+    display.println(renderState.detectedNumber);
+    
+    display.setCursor(0, 52);
+    display.print(F("ID:"));
+    display.print(renderState.trackId);
+    display.print(F(" Tracks:"));
+    display.println(renderState.trackCount);
     
     display.setCursor(0, 28);
     display.print(F("Pos: X="));
-    display.print(targetX);
+    display.print(renderState.targetX);
     display.print(F(" Y="));
-    display.println(targetY);
+    display.println(renderState.targetY);
     
     display.setCursor(0, 40);
     display.print(F("Servo: X="));
-    display.print(servoXPos);
+    display.print(renderState.servoXPos);
     display.print(F(" Y="));
-    display.println(servoYPos);
+    display.println(renderState.servoYPos);
     
     // 绘制简单的位置指示图
     display.drawRect(90, 16, 38, 38, SSD1306_WHITE);
-    int indicatorX = 90 + map(targetX, 0, 224, 0, 38);
-    int indicatorY = 16 + map(targetY, 0, 224, 0, 38);
+    int indicatorX = 90 + map(renderState.targetX, 0, 224, 0, 38);
+    int indicatorY = 16 + map(renderState.targetY, 0, 224, 0, 38);
     display.fillCircle(constrain(indicatorX, 92, 126), constrain(indicatorY, 18, 52), 2, SSD1306_WHITE);
   } else {
     display.setCursor(0, 24);
     display.println(F("Waiting for detection..."));
   }
   
-  display.display();
+  // 代替display.display()的全屏发送
+  oled_dirty_flush(&oledDirty, display.getBuffer(), oledWriteRange, NULL);
 }
 
+// 把最新检测结果交给跟踪控制器，舵机由跟踪任务更新
 void trackObject() {
-  // 计算误差
-  errorX = targetX - CENTER_X;
-  errorY = targetY - CENTER_Y;
-  
-  // 计算PID控制量
-  integralX += errorX;
-  integralY += errorY;
-  derivativeX = errorX - prevErrorX;
-  derivativeY = errorY - prevErrorY;
-  
-  // 防止积分过大
-  integralX = constrain(integralX, -300, 300);
-  integralY = constrain(integralY, -300, 300);
-  
-  // 计算舵机调整量
-  float adjustX = KP * errorX + KI * integralX + KD * derivativeX;
-  float adjustY = KP * errorY + KI * integralY + KD * derivativeY;
+  if (!objectDetected) {
+    portENTER_CRITICAL(&trackMux);
+    track_lost(&tracker);
+    portEXIT_CRITICAL(&trackMux);
+    return;
+  }
+  if (!targetSeen) {
+    return;  // 锁定的目标本帧未检测到，由跟踪任务外推
+  }
   
-  // 更新舵机位置 (注意X轴和Y轴可能需要反向)
-  servoXPos = constrain(servoXPos - adjustX, 0, 180);
-  servoYPos = constrain(servoYPos + adjustY, 0, 180);
+  // 控制器用拍照时刻的舵机角度计算目标位置
+  portENTER_CRITICAL(&trackMux);
+  track_measure(&tracker, targetX - CENTER_X, targetY - CENTER_Y, targetCaptureMs);
+  portEXIT_CRITICAL(&trackMux);
+  
+  if (frameHasStamps) {
+    uint32_t nowUs = micros();
+    portENTER_CRITICAL(&latencyMux);
+    latencyRecord.parsedUs = nowUs;
+    latencyRecord.pending = true;
+    latency_hist_add(&latencyHist[LAT_K210], latencyRecord.k210LatencyMs * 1000UL);
+    latency_hist_add(&latencyHist[LAT_RECEIVE], latencyRecord.rxDoneUs - latencyRecord.rxStartUs);
+    latency_hist_add(&latencyHist[LAT_PARSE], nowUs - latencyRecord.rxDoneUs);
+    portEXIT_CRITICAL(&latencyMux);
+  }
+}
+
+// 按角度下发舵机脉宽，保留小数部分
+void writeServoAngle(Servo &servo, float angle) {
+  servo.writeMicroseconds(SERVO_MIN_US + (int)(angle * (SERVO_MAX_US - SERVO_MIN_US) / 180.0f + 0.5f));
+}
+
+// 跟踪任务：固定周期更新控制器并下发舵机，检测之间按目标速度外推
+void trackingTask(void *pvParameters) {
+  TickType_t lastWake = xTaskGetTickCount();
+  uint32_t lastMicros = micros();
   
-  // 控制舵机
-  servoX.write(servoXPos);
-  servoY.write(servoYPos);
+  for (;;) {
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(TRACK_PERIOD_MS));
+    
+    uint32_t nowMicros = micros();
+    float dt = (nowMicros - lastMicros) / 1000000.0f;  // 实际周期
+    lastMicros = nowMicros;
+    
+    portENTER_CRITICAL(&trackMux);
+    track_update(&tracker, millis(), dt);
+    float pan = tracker.cmd_pan;
+    float tilt = tracker.cmd_tilt;
+    portEXIT_CRITICAL(&trackMux);
+    
+    writeServoAngle(servoX, pan);
+    writeServoAngle(servoY, tilt);
+    servoXPos = (int)(pan + 0.5f);
+    servoYPos = (int)(tilt + 0.5f);
+    
+    // 新检测结果后的第一次舵机下发，补全延迟记录
+    uint32_t actUs = micros();
+    portENTER_CRITICAL(&latencyMux);
+    if (latencyRecord.pending) {
+      latencyRecord.pending = false;
+      latencyRecord.actuatorUs = actUs;
+      latencyRecord.ready = true;
+      // 帧头第一个字节在读到之前已经传输了一个字节的时间
+      uint32_t totalUs = latencyRecord.k210LatencyMs * 1000UL + 10UL * 1000000UL / SERIAL_BAUD
+                         + (actUs - latencyRecord.rxStartUs);
+      latency_hist_add(&latencyHist[LAT_ACTUATOR], actUs - latencyRecord.parsedUs);
+      latency_hist_add(&latencyHist[LAT_TOTAL], totalUs);
+    }
+    portEXIT_CRITICAL(&latencyMux);
+  }
+}
+
+// 读取USB串口命令："lat"打印延迟统计，"lat reset"清空，"lat log on/off"开关每帧时间戳，
+// "cap on/off"开关原始数据捕获，"track ..."调整跟踪参数
+void readSerialCommand() {
+  static char line[96];
+  static uint8_t len = 0;
+  
+  while (Serial.available()) {
+    char c = (char)Serial.read();
+    if (c != '\n' && c != '\r') {
+      if (len < sizeof(line) - 1) {
+        line[len++] = c;
+      }
+      continue;
+    }
+    if (len == 0) {
+      continue;
+    }
+    line[len] = '\0';
+    len = 0;
+    
+    if (strcmp(line, "lat") == 0) {
+      printLatencyStats();
+    } else if (strcmp(line, "lat reset") == 0) {
+      portENTER_CRITICAL(&latencyMux);
+      for (int i = 0; i < LAT_STAGES; i++) {
+        latency_hist_reset(&latencyHist[i]);
+      }
+      portEXIT_CRITICAL(&latencyMux);
+      Serial.println("[LAT] reset");
+    } else if (strcmp(line, "lat log on") == 0) {
+      latencyLog = true;
+      Serial.println("[LAT] T,frame_id,k210_capture_ms,k210_latency_ms,rx_start_us,rx_done_us,parsed_us,actuator_us");
+    } else if (strcmp(line, "lat log off") == 0) {
+      latencyLog = false;
+    } else if (strcmp(line, "cap on") == 0) {
+      captureBytes = 0;
+      captureDropped = 0;
+      captureMode = true;
+      Serial.println("[CAP] start");
+    } else if (strcmp(line, "cap off") == 0) {
+      captureMode = false;
+      Serial.printf("[CAP] stop, bytes: %u, dropped lines: %u\n", captureBytes, captureDropped);
+    } else if (strncmp(line, "track", 5) == 0) {
+      handleTrackCommand(line);
+    } else {
+      Serial.printf("Unknown command: '%s'\n", line);
+    }
+  }
+}
+
+// 从NVS读取保存的跟踪参数，没有保存时为默认值
+void loadTrackParams(track_config_t *config) {
+  Preferences prefs;
+  track_default_config(config);
+  if (!prefs.begin("track", true)) {
+    return;
+  }
+  String text = prefs.getString("config", "");
+  prefs.end();
+  if (text.length() == 0) {
+    return;
+  }
+  if (track_params_parse_text(config, text.c_str()) != TRACK_PARAMS_EOK) {
+    Serial.println("[TRACK] some saved parameters were rejected, defaults kept for them");
+  }
+  Serial.println("[TRACK] parameters loaded from NVS");
+}
+
+// 跟踪参数命令："track save"/"track load"读写NVS，其余见track_params_command
+// 在参数副本上修改，再在临界区内整体交给跟踪任务
+void handleTrackCommand(const char *line) {
+  static char reply[768];
+  track_config_t config;
+  portENTER_CRITICAL(&trackMux);
+  config = tracker.config;
+  portEXIT_CRITICAL(&trackMux);
+
+  if (strcmp(line, "track save") == 0) {
+    Preferences prefs;
+    track_params_format(&config, reply, sizeof(reply), false);
+    bool ok = prefs.begin("track", false) && prefs.putString("config", reply) > 0;
+    prefs.end();
+    Serial.println(ok ? "[TRACK] saved" : "[TRACK] save failed");
+    return;
+  }
+  if (strcmp(line, "track load") == 0) {
+    loadTrackParams(&config);
+    snprintf(reply, sizeof(reply), "[TRACK] parameters reloaded");
+  } else {
+    track_params_command(&config, line, reply, sizeof(reply));
+  }
+
+  portENTER_CRITICAL(&trackMux);
+  tracker.config = config;
+  portEXIT_CRITICAL(&trackMux);
+  Serial.println(reply);
+}
+
+// 打印各阶段延迟统计(us)
+void printLatencyStats() {
+  static latency_hist_t snapshot[LAT_STAGES];
+  portENTER_CRITICAL(&latencyMux);
+  memcpy(snapshot, latencyHist, sizeof(snapshot));
+  portEXIT_CRITICAL(&latencyMux);
+  
+  Serial.println("[LAT] stage      count      min      avg      p50      p90      p99      max (us)");
+  for (int i = 0; i < LAT_STAGES; i++) {
+    const latency_hist_t *h = &snapshot[i];
+    Serial.printf("[LAT] %-8s %7u %8u %8u %8u %8u %8u %8u\n", latencyStageNames[i], h->count,
+                  h->count ? h->min_us : 0, h->count ? (uint32_t)(h->sum_us / h->count) : 0,
+                  latency_hist_percentile(h, 50), latency_hist_percentile(h, 90),
+                  latency_hist_percentile(h, 99), h->max_us);
+  }
+  Serial.printf("[LAT] frames: %u, CRC errors: %u, lost: %u\n",
+                k210Decoder.frames, k210Decoder.crc_errors, k210Decoder.lost_frames);
+}
+
+// 打印补全的单帧时间戳，由主机工具latency_offset.py估计两块板的时钟偏差
+void printLatencyRecord() {
+  if (!latencyLog || !latencyRecord.ready) {
+    return;
+  }
+  portENTER_CRITICAL(&latencyMux);
+  LatencyRecord r = latencyRecord;
+  latencyRecord.ready = false;
+  portEXIT_CRITICAL(&latencyMux);
   
-  // 保存当前误差
-  prevErrorX = errorX;
-  prevErrorY = errorY;
-} 
\ No newline at end of file
+  Serial.printf("T,%u,%u,%u,%u,%u,%u,%u\n", r.frameId, r.captureMs, r.k210LatencyMs,
+                r.rxStartUs, r.rxDoneUs, r.parsedUs, r.actuatorUs);
+}
+ 
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "k210_frame.h"
+
+#include <string.h>
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    put_u16(p, v & 0xFFFF);
+    put_u16(p + 2, v >> 16);
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+uint16_t k210_frame_crc16(const uint8_t *data, uint16_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (uint16_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+uint8_t k210_frame_encode(const k210_frame_t *frame, uint8_t *buf)
+{
+    uint8_t count = frame->count > K210_FRAME_MAX_DETS ? K210_FRAME_MAX_DETS : frame->count;
+
+    buf[0] = K210_FRAME_SYNC1;
+    buf[1] = K210_FRAME_SYNC2;
+    buf[2] = K210_FRAME_VERSION;
+    buf[3] = count;
+    put_u16(buf + 4, frame->frame_id);
+    put_u32(buf + 6, frame->capture_ms);
+    put_u16(buf + 10, frame->latency_ms);
+
+    uint8_t *p = buf + K210_FRAME_HEADER_LEN;
+    for (uint8_t i = 0; i < count; i++, p += K210_FRAME_DET_LEN)
+    {
+        const k210_frame_det_t *det = &frame->dets[i];
+        p[0] = det->class_id;
+        p[1] = det->number;
+        p[2] = det->confidence;
+        put_u16(p + 3, (uint16_t)det->x);
+        put_u16(p + 5, (uint16_t)det->y);
+        put_u16(p + 7, (uint16_t)det->width);
+        put_u16(p + 9, (uint16_t)det->height);
+    }
+
+    put_u16(p, k210_frame_crc16(buf + 2, p - (buf + 2)));
+    return p + K210_FRAME_CRC_LEN - buf;
+}
+
+// 解码已校验的帧
+static void frame_decode(const uint8_t *buf, k210_frame_t *frame)
+{
+    frame->count = buf[3];
+    frame->frame_id = get_u16(buf + 4);
+    frame->capture_ms = get_u32(buf + 6);
+    frame->latency_ms = get_u16(buf + 10);
+
+    const uint8_t *p = buf + K210_FRAME_HEADER_LEN;
+    for (uint8_t i = 0; i < frame->count; i++, p += K210_FRAME_DET_LEN)
+    {
+        k210_frame_det_t *det = &frame->dets[i];
+        det->class_id = p[0];
+        det->number = p[1];
+        det->confidence = p[2];
+        det->x = (int16_t)get_u16(p + 3);
+        det->y = (int16_t)get_u16(p + 5);
+        det->width = (int16_t)get_u16(p + 7);
+        det->height = (int16_t)get_u16(p + 9);
+    }
+}
+
+// 丢弃缓冲区前n个字节
+static void decoder_drop(k210_frame_decoder_t *decoder, uint8_t n)
+{
+    decoder->cnt -= n;
+    memmove(decoder->buf, decoder->buf + n, decoder->cnt);
+}
+
+// buf[0]处的帧头还没收齐时, 查找在当前字节正好结束且校验通过的帧, 返回其偏移, 没有时返回0。
+// 垃圾数据中出现的假帧头会让解码器等待它声明的长度, 不检查的话其中的真帧要等下一帧的字节到达才能解出。
+static uint8_t decoder_find_complete(const k210_frame_decoder_t *decoder)
+{
+    const uint8_t *buf = decoder->buf;
+    // 在cnt处结束的帧, 起点只可能是cnt减去count为0-8时的帧长, 最多检查9个位置
+    for (uint8_t count = 0; count <= K210_FRAME_MAX_DETS; count++)
+    {
+        uint8_t len = K210_FRAME_HEADER_LEN + K210_FRAME_DET_LEN * count + K210_FRAME_CRC_LEN;
+        if (len >= decoder->cnt)
+            break;
+        uint8_t i = decoder->cnt - len;
+        if (buf[i] != K210_FRAME_SYNC1 || buf[i + 1] != K210_FRAME_SYNC2 || buf[i + 2] != K210_FRAME_VERSION ||
+            buf[i + 3] != count)
+            continue;
+        uint8_t body = len - K210_FRAME_CRC_LEN;
+        if (get_u16(buf + i + body) == k210_frame_crc16(buf + i + 2, body - 2))
+            return i;
+    }
+    return 0;
+}
+
+void k210_frame_decoder_reset(k210_frame_decoder_t *decoder)
+{
+    memset(decoder, 0, sizeof(*decoder));
+}
+
+bool k210_frame_decoder_feed(k210_frame_decoder_t *decoder, uint8_t byte, k210_frame_t *frame)
+{
+    if (decoder->cnt >= K210_FRAME_MAX_LEN)
+        decoder_drop(decoder, 1);
+    decoder->buf[decoder->cnt++] = byte;
+
+    while (decoder->cnt > 0)
+    {
+        const uint8_t *buf = decoder->buf;
+
+        // 同步字
+        if (buf[0] != K210_FRAME_SYNC1 || (decoder->cnt >= 2 && buf[1] != K210_FRAME_SYNC2))
+        {
+            decoder_drop(decoder, 1);
+            continue;
+        }
+
+        // 帧头: 版本和个数决定帧长度
+        if (decoder->cnt < 4)
+            return false;
+        if (buf[2] != K210_FRAME_VERSION || buf[3] > K210_FRAME_MAX_DETS)
+        {
+            decoder->header_errors++;
+            decoder_drop(decoder, 1);
+            continue;
+        }
+
+        uint8_t body = K210_FRAME_HEADER_LEN + K210_FRAME_DET_LEN * buf[3];
+        uint8_t len = body + K210_FRAME_CRC_LEN;
+        if (decoder->cnt < len)
+        {
+            uint8_t skip = decoder_find_complete(decoder);
+            if (skip == 0)
+                return false;
+            decoder->crc_errors++; // buf[0]处是假帧头
+            decoder_drop(decoder, skip);
+            continue;
+        }
+
+        if (get_u16(buf + body) != k210_frame_crc16(buf + 2, body - 2))
+        {
+            decoder->crc_errors++;
+            decoder_drop(decoder, 1);
+            continue;
+        }
+
+        frame_decode(buf, frame);
+        // 序号跳变过大说明K210重启, 不计入丢帧
+        uint16_t gap = frame->frame_id - decoder->last_frame_id - 1;
+        if (decoder->frames > 0 && gap < 1000)
+            decoder->lost_frames += gap;
+        decoder->last_frame_id = frame->frame_id;
+        decoder->frames++;
+        decoder_drop(decoder, len);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,112 @@
+#ifndef K210_FRAME_H
+#define K210_FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief K210二进制检测帧编解码
+ *
+ * 每个摄像头帧发送一帧, 包含全部检测结果、帧序号和拍照时间, 带CRC16校验。
+ * 格式与K210端k210_frame.py一致(小端):
+ *   0xA5 0x5A | version u8 | count u8 | frame_id u16 | capture_ms u32 | latency_ms u16 |
+ *   count个检测(class_id u8, number u8, confidence u8, x i16, y i16, w i16, h i16) | crc16 u16
+ * CRC为CRC-16/CCITT-FALSE, 从version到最后一个检测。
+ * 不依赖Arduino, 可直接在主机上编译。
+ */
+
+#define K210_FRAME_SYNC1 0xA5
+#define K210_FRAME_SYNC2 0x5A
+#define K210_FRAME_VERSION 1
+
+/** 每帧最多检测个数 */
+#define K210_FRAME_MAX_DETS 8
+
+/** 帧头长度(含同步字)、每个检测长度、CRC长度 */
+#define K210_FRAME_HEADER_LEN 12
+#define K210_FRAME_DET_LEN 11
+#define K210_FRAME_CRC_LEN 2
+
+/** 最大帧长度 */
+#define K210_FRAME_MAX_LEN (K210_FRAME_HEADER_LEN + K210_FRAME_DET_LEN * K210_FRAME_MAX_DETS + K210_FRAME_CRC_LEN)
+
+/**
+ * @brief 一个检测结果
+ */
+typedef struct
+{
+    uint8_t class_id;  /**< 类别ID */
+    uint8_t number;    /**< 识别出的数字 */
+    uint8_t confidence; /**< 置信度(0-255对应0-1) */
+    int16_t x;         /**< 框左上角x */
+    int16_t y;         /**< 框左上角y */
+    int16_t width;     /**< 框宽 */
+    int16_t height;    /**< 框高 */
+} k210_frame_det_t;
+
+/**
+ * @brief 一帧检测结果
+ */
+typedef struct
+{
+    uint8_t count;        /**< 检测个数, 0表示本帧没有目标 */
+    uint16_t frame_id;    /**< 帧序号 */
+    uint32_t capture_ms;  /**< K210拍照时间(K210的ticks_ms) */
+    uint16_t latency_ms;  /**< K210从拍照到发送的时间 */
+    k210_frame_det_t dets[K210_FRAME_MAX_DETS]; /**< 按置信度从高到低 */
+} k210_frame_t;
+
+/**
+ * @brief 帧解码器
+ */
+typedef struct
+{
+    uint8_t buf[K210_FRAME_MAX_LEN];
+    uint8_t cnt;           /**< 已收字节数 */
+    uint32_t frames;       /**< 校验通过的帧数 */
+    uint32_t crc_errors;   /**< 校验失败的帧数 */
+    uint32_t header_errors; /**< 版本或个数无效的帧头数 */
+    uint32_t lost_frames;  /**< 根据帧序号推算的丢帧数 */
+    uint16_t last_frame_id; /**< 上一帧序号 */
+} k210_frame_decoder_t;
+
+/**
+ * @brief 计算CRC-16/CCITT-FALSE
+ *
+ * @param data 数据
+ * @param len 长度
+ * @return uint16_t CRC值
+ */
+uint16_t k210_frame_crc16(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 编码一帧
+ *
+ * @param frame 检测结果, count超过K210_FRAME_MAX_DETS时截断
+ * @param buf 输出缓冲区, 至少K210_FRAME_MAX_LEN字节
+ * @return uint8_t 帧长度
+ */
+uint8_t k210_frame_encode(const k210_frame_t *frame, uint8_t *buf);
+
+/**
+ * @brief 复位解码器
+ *
+ * @param decoder 解码器
+ */
+void k210_frame_decoder_reset(k210_frame_decoder_t *decoder);
+
+/**
+ * @brief 喂入一个字节, 校验失败时在已收数据中重新寻找同步字
+ *
+ * 垃圾数据中的假帧头会声明一个长度, 在收齐之前, 已收数据中在当前字节结束且校验通过的帧优先解出,
+ * 不必等待后续字节把假帧头排除。
+ *
+ * @param decoder 解码器
+ * @param byte 串口收到的字节
+ * @param frame 收到完整且校验通过的帧时写入
+ * @return true 得到一帧
+ * @return false 尚未收齐或该帧被丢弃
+ */
+bool k210_frame_decoder_feed(k210_frame_decoder_t *decoder, uint8_t byte, k210_frame_t *frame);
+
+#endif // K210_FRAME_H
@@ -0,0 +1,222 @@
+#include "k210_parser.h"
+
+#include <string.h>
+
+// 状态消息前缀, 这些行不是检测数据
+static const char *const STATUS_PREFIXES[] = {
+    "K210", "UART test", "Camera", "LCD", "Model", "Detection", "No object",
+};
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// 解析一个整数字段, 字段必须以sep或行尾结束; 成功后*p指向下一个字段
+static bool parse_int(const char **p, const char *end, char sep, int32_t *out)
+{
+    const char *s = *p;
+    bool negative = false;
+    int32_t value = 0;
+    uint8_t digits = 0;
+
+    while (s < end && is_space(*s))
+        s++;
+    if (s < end && (*s == '-' || *s == '+'))
+        negative = (*s++ == '-');
+    while (s < end && is_digit(*s))
+    {
+        if (digits < 9)
+            value = value * 10 + (*s - '0');
+        digits++;
+        s++;
+    }
+    while (s < end && is_space(*s))
+        s++;
+
+    if (digits == 0 || digits > 9)
+        return false;
+    if (s < end)
+    {
+        if (*s != sep)
+            return false;
+        s++;
+    }
+    *out = negative ? -value : value;
+    *p = s;
+    return true;
+}
+
+// 解析一个小数字段(不支持指数), 规则同parse_int
+static bool parse_float(const char **p, const char *end, char sep, float *out)
+{
+    const char *s = *p;
+    bool negative = false;
+    float value = 0.0f;
+    float divisor = 1.0f; // 除以10的幂而不是乘0.1: 后者累积误差, "1.00"会得到1.0000001
+    bool fraction = false;
+    uint8_t digits = 0;
+
+    while (s < end && is_space(*s))
+        s++;
+    if (s < end && (*s == '-' || *s == '+'))
+        negative = (*s++ == '-');
+    while (s < end && (is_digit(*s) || (*s == '.' && !fraction)))
+    {
+        if (*s == '.')
+        {
+            fraction = true;
+        }
+        else
+        {
+            if (fraction)
+                divisor *= 10.0f;
+            value = value * 10.0f + (*s - '0');
+            digits++;
+        }
+        s++;
+    }
+    while (s < end && is_space(*s))
+        s++;
+
+    if (digits == 0)
+        return false;
+    if (s < end)
+    {
+        if (*s != sep)
+            return false;
+        s++;
+    }
+    *out = negative ? -value / divisor : value / divisor;
+    *p = s;
+    return true;
+}
+
+static int16_t clamp16(int32_t value)
+{
+    if (value > 32767)
+        return 32767;
+    if (value < -32768)
+        return -32768;
+    return (int16_t)value;
+}
+
+// 逗号格式: number,x,y,width,height
+static bool parse_comma(const char *s, const char *end, k210_detection_t *det)
+{
+    int32_t v[5];
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        if (s >= end || !parse_int(&s, end, ',', &v[i]))
+            return false;
+    }
+    if (s != end)
+        return false;
+
+    det->number = clamp16(v[0]);
+    det->x = clamp16(v[1]);
+    det->y = clamp16(v[2]);
+    det->width = clamp16(v[3]);
+    det->height = clamp16(v[4]);
+    det->class_id = -1;
+    det->confidence = -1.0f;
+    return true;
+}
+
+// 冒号格式: x:y:w:h:classid:confidence:label
+static bool parse_colon(const char *s, const char *end, k210_detection_t *det)
+{
+    int32_t v[5];
+    float confidence;
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        if (s >= end || !parse_int(&s, end, ':', &v[i]))
+            return false;
+    }
+    if (s >= end || !parse_float(&s, end, ':', &confidence))
+        return false;
+    // K210的置信度在[0,1]内, 超出范围的是误码; 调用方会把它换算成0-255
+    if (!(confidence >= 0.0f && confidence <= 1.0f))
+        return false;
+
+    det->x = clamp16(v[0]);
+    det->y = clamp16(v[1]);
+    det->width = clamp16(v[2]);
+    det->height = clamp16(v[3]);
+    det->class_id = clamp16(v[4]);
+    det->confidence = confidence;
+
+    // 标签是数字时直接使用, 否则用类别ID(从0开始, 所以+1)
+    int32_t label;
+    const char *l = s;
+    if (l < end && parse_int(&l, end, '\0', &label) && l == end)
+        det->number = clamp16(label);
+    else
+        det->number = clamp16(v[4] + 1);
+    return true;
+}
+
+void k210_parser_reset(k210_parser_t *parser)
+{
+    memset(parser, 0, sizeof(*parser));
+}
+
+uint8_t k210_parser_feed(k210_parser_t *parser, uint8_t byte, k210_detection_t *detection)
+{
+    if (byte != '\n')
+    {
+        if (parser->len < K210_PARSER_LINE_MAX)
+            parser->line[parser->len++] = (char)byte;
+        else
+            parser->overflow = true;
+        return K210_PARSE_NONE;
+    }
+
+    // 行结束: 去掉首尾空白后就地解析
+    const char *s = parser->line;
+    const char *end = parser->line + parser->len;
+    bool overflow = parser->overflow;
+    parser->line[parser->len] = '\0';
+    parser->len = 0;
+    parser->overflow = false;
+
+    if (overflow)
+    {
+        parser->errors++;
+        return K210_PARSE_ERROR;
+    }
+    while (s < end && is_space(*s))
+        s++;
+    while (end > s && is_space(end[-1]))
+        end--;
+    if (s == end)
+        return K210_PARSE_NONE;
+
+    for (uint8_t i = 0; i < sizeof(STATUS_PREFIXES) / sizeof(STATUS_PREFIXES[0]); i++)
+    {
+        size_t n = strlen(STATUS_PREFIXES[i]);
+        if ((size_t)(end - s) >= n && memcmp(s, STATUS_PREFIXES[i], n) == 0)
+            return K210_PARSE_STATUS;
+    }
+
+    bool ok;
+    if (memchr(s, ',', end - s) != NULL)
+        ok = parse_comma(s, end, detection);
+    else if (memchr(s, ':', end - s) != NULL)
+        ok = parse_colon(s, end, detection);
+    else
+        ok = false;
+
+    if (!ok)
+    {
+        parser->errors++;
+        return K210_PARSE_ERROR;
+    }
+    parser->detections++;
+    return K210_PARSE_DETECTION;
+}
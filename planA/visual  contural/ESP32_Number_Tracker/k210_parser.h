@@ -0,0 +1,71 @@
+#ifndef K210_PARSER_H
+#define K210_PARSER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief K210检测结果的增量解析器
+ *
+ * 逐字节收进固定长度的行缓冲区, 收到换行后就地解析, 不使用String, 不分配堆内存。
+ * 支持两种格式:
+ *   逗号格式: number,x,y,width,height
+ *   冒号格式: x:y:w:h:classid:confidence:label
+ * 不依赖Arduino, 可直接在主机上编译。
+ */
+
+/** 行缓冲区长度, 超长的行整行丢弃 */
+#define K210_PARSER_LINE_MAX 96
+
+/**
+ * @brief 喂入字节的结果
+ */
+#define K210_PARSE_NONE 0      /**< 行未结束 */
+#define K210_PARSE_DETECTION 1 /**< 得到一个检测结果 */
+#define K210_PARSE_STATUS 2    /**< K210状态消息(K210/Camera/Model...开头), 内容见line */
+#define K210_PARSE_ERROR 3     /**< 格式错误或行过长 */
+
+/**
+ * @brief 检测结果
+ */
+typedef struct
+{
+    int16_t number;   /**< 识别出的数字 */
+    int16_t x;        /**< 框左上角x */
+    int16_t y;        /**< 框左上角y */
+    int16_t width;    /**< 框宽 */
+    int16_t height;   /**< 框高 */
+    int16_t class_id; /**< 类别ID, 逗号格式没有时为-1 */
+    float confidence; /**< 置信度[0,1], 超出范围的行按格式错误处理; 逗号格式没有时为-1 */
+} k210_detection_t;
+
+/**
+ * @brief 解析器状态
+ */
+typedef struct
+{
+    char line[K210_PARSER_LINE_MAX + 1]; /**< 当前行, 解析后以'\0'结尾 */
+    uint8_t len;                         /**< 当前行长度 */
+    bool overflow;                       /**< 当前行已超长, 丢弃到行尾 */
+    uint32_t detections;                 /**< 解析出的检测结果个数 */
+    uint32_t errors;                     /**< 格式错误或超长的行数 */
+} k210_parser_t;
+
+/**
+ * @brief 复位解析器
+ *
+ * @param parser 解析器
+ */
+void k210_parser_reset(k210_parser_t *parser);
+
+/**
+ * @brief 喂入一个字节
+ *
+ * @param parser 解析器
+ * @param byte 串口收到的字节
+ * @param detection 返回K210_PARSE_DETECTION时写入
+ * @return uint8_t K210_PARSE_xxx
+ */
+uint8_t k210_parser_feed(k210_parser_t *parser, uint8_t byte, k210_detection_t *detection);
+
+#endif // K210_PARSER_H
@@ -0,0 +1,57 @@
+#include "latency_stats.h"
+
+#include <string.h>
+
+void latency_hist_reset(latency_hist_t *hist)
+{
+    memset(hist, 0, sizeof(*hist));
+    hist->min_us = 0xFFFFFFFF;
+}
+
+// 样本所在的桶
+static uint8_t bucket_of(uint32_t us)
+{
+    uint8_t bucket = 0;
+    us >>= 5;
+    while (us != 0 && bucket < LATENCY_HIST_BUCKETS - 1)
+    {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+uint32_t latency_hist_bucket_low(uint8_t bucket)
+{
+    return bucket == 0 ? 0 : (uint32_t)1 << (bucket + 4);
+}
+
+void latency_hist_add(latency_hist_t *hist, uint32_t us)
+{
+    hist->count++;
+    hist->sum_us += us;
+    if (us < hist->min_us)
+        hist->min_us = us;
+    if (us > hist->max_us)
+        hist->max_us = us;
+    hist->buckets[bucket_of(us)]++;
+}
+
+uint32_t latency_hist_percentile(const latency_hist_t *hist, uint8_t percent)
+{
+    if (hist->count == 0)
+        return 0;
+
+    uint32_t target = ((uint64_t)hist->count * percent + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < LATENCY_HIST_BUCKETS - 1; i++)
+    {
+        seen += hist->buckets[i];
+        if (seen >= target && seen > 0)
+        {
+            uint32_t upper = latency_hist_bucket_low(i + 1);
+            return upper < hist->max_us ? upper : hist->max_us;
+        }
+    }
+    return hist->max_us;
+}
@@ -0,0 +1,61 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief 延迟直方图
+ *
+ * 以微秒为单位统计, 桶按2的幂划分: 第0桶 < 32us, 第i桶为[2^(i+4), 2^(i+5))us,
+ * 最后一桶包含所有更大的值。添加一个样本为O(1), 不分配内存。
+ * 不依赖Arduino, 可直接在主机上编译。
+ */
+
+#define LATENCY_HIST_BUCKETS 18 /**< 最后一桶从2^21us(约2.1s)开始 */
+
+/**
+ * @brief 一个阶段的延迟统计
+ */
+typedef struct
+{
+    uint32_t count;                           /**< 样本个数 */
+    uint32_t min_us;                          /**< 最小值 */
+    uint32_t max_us;                          /**< 最大值 */
+    uint64_t sum_us;                          /**< 总和 */
+    uint32_t buckets[LATENCY_HIST_BUCKETS];   /**< 直方图 */
+} latency_hist_t;
+
+/**
+ * @brief 清空统计
+ *
+ * @param hist 直方图
+ */
+void latency_hist_reset(latency_hist_t *hist);
+
+/**
+ * @brief 添加一个样本
+ *
+ * @param hist 直方图
+ * @param us 延迟(us)
+ */
+void latency_hist_add(latency_hist_t *hist, uint32_t us);
+
+/**
+ * @brief 估计百分位数(取所在桶的上界)
+ *
+ * @param hist 直方图
+ * @param percent 百分比(0-100)
+ * @return uint32_t 延迟(us), 没有样本时为0
+ */
+uint32_t latency_hist_percentile(const latency_hist_t *hist, uint8_t percent);
+
+/**
+ * @brief 桶的下界
+ *
+ * @param bucket 桶序号
+ * @return uint32_t 下界(us)
+ */
+uint32_t latency_hist_bucket_low(uint8_t bucket);
+
+#endif // LATENCY_STATS_H
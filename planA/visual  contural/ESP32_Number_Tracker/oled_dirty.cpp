@@ -0,0 +1,48 @@
+#include "oled_dirty.h"
+
+#include <string.h>
+
+void oled_dirty_init(oled_dirty_t *oled)
+{
+    memset(oled, 0, sizeof(*oled));
+}
+
+void oled_dirty_invalidate(oled_dirty_t *oled)
+{
+    oled->valid = false;
+}
+
+uint16_t oled_dirty_flush(oled_dirty_t *oled, const uint8_t *buffer, oled_dirty_write_fn write, void *ctx)
+{
+    uint16_t sent = 0;
+
+    for (uint8_t page = 0; page < OLED_DIRTY_PAGES; page++)
+    {
+        const uint8_t *cur = buffer + page * OLED_DIRTY_WIDTH;
+        uint8_t *prev = oled->shadow + page * OLED_DIRTY_WIDTH;
+        int16_t first = 0;
+        int16_t last = OLED_DIRTY_WIDTH - 1;
+
+        if (oled->valid)
+        {
+            // 找出本页第一个和最后一个变化的列
+            while (first < OLED_DIRTY_WIDTH && cur[first] == prev[first])
+                first++;
+            if (first == OLED_DIRTY_WIDTH)
+                continue;
+            while (cur[last] == prev[last])
+                last--;
+        }
+
+        uint8_t len = last - first + 1;
+        write(ctx, page, first, cur + first, len);
+        memcpy(prev + first, cur + first, len);
+        sent += len;
+        oled->ranges++;
+    }
+
+    oled->valid = true;
+    oled->flushes++;
+    oled->bytes_sent += sent;
+    return sent;
+}
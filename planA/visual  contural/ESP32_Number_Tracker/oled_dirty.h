@@ -0,0 +1,66 @@
+#ifndef OLED_DIRTY_H
+#define OLED_DIRTY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief SSD1306局部刷新
+ *
+ * 保存上一次已发送的显存副本, 每页(8行)只发送发生变化的列范围,
+ * 内容不变的页不发送。实际的I2C传输由回调完成, 主机上可用回调统计字节数。
+ * 不依赖Arduino, 可直接在主机上编译。
+ */
+
+#define OLED_DIRTY_WIDTH 128 /**< 列数 */
+#define OLED_DIRTY_PAGES 8   /**< 页数(64行/8) */
+
+/**
+ * @brief 发送一页中的一段数据
+ *
+ * @param ctx 用户参数
+ * @param page 页号
+ * @param column 起始列
+ * @param data 数据
+ * @param len 字节数
+ */
+typedef void (*oled_dirty_write_fn)(void *ctx, uint8_t page, uint8_t column, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief 局部刷新状态
+ */
+typedef struct
+{
+    uint8_t shadow[OLED_DIRTY_WIDTH * OLED_DIRTY_PAGES]; /**< 屏幕上当前的内容 */
+    bool valid;          /**< shadow是否与屏幕一致, 为false时下次全屏发送 */
+    uint32_t flushes;    /**< 刷新次数 */
+    uint32_t bytes_sent; /**< 累计发送的显存字节数 */
+    uint32_t ranges;     /**< 累计发送的段数(每段另有寻址命令开销) */
+} oled_dirty_t;
+
+/**
+ * @brief 初始化, 下次刷新发送全屏
+ *
+ * @param oled 局部刷新状态
+ */
+void oled_dirty_init(oled_dirty_t *oled);
+
+/**
+ * @brief 标记屏幕内容未知(例如其他代码直接刷新过屏幕), 下次刷新发送全屏
+ *
+ * @param oled 局部刷新状态
+ */
+void oled_dirty_invalidate(oled_dirty_t *oled);
+
+/**
+ * @brief 比较显存与屏幕内容, 只发送变化的部分
+ *
+ * @param oled 局部刷新状态
+ * @param buffer 显存(SSD1306页格式, 128*8字节)
+ * @param write 发送回调
+ * @param ctx 回调参数
+ * @return uint16_t 本次发送的显存字节数
+ */
+uint16_t oled_dirty_flush(oled_dirty_t *oled, const uint8_t *buffer, oled_dirty_write_fn write, void *ctx);
+
+#endif // OLED_DIRTY_H
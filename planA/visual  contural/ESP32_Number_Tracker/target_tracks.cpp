@@ -0,0 +1,235 @@
+#include "target_tracks.h"
+
+#include <string.h>
+
+void target_tracks_default_config(target_tracks_config_t *config)
+{
+    config->min_iou = 0.1f;
+    config->velocity_gain = 0.3f;
+    config->max_misses = 10;
+    config->expire_ms = 1500;
+    config->confirm_hits = 2;
+}
+
+void target_tracks_init(target_tracks_t *tracks, const target_tracks_config_t *config)
+{
+    memset(tracks, 0, sizeof(*tracks));
+    if (config != NULL)
+        tracks->config = *config;
+    else
+        target_tracks_default_config(&tracks->config);
+    tracks->next_id = 1;
+}
+
+// 两个框的IoU, 第一个框按偏移(dx, dy)平移
+static float box_iou(const target_track_t *t, float dx, float dy, const k210_frame_det_t *d)
+{
+    float ax0 = t->x + dx, ay0 = t->y + dy;
+    float ax1 = ax0 + t->width, ay1 = ay0 + t->height;
+    float bx0 = d->x, by0 = d->y;
+    float bx1 = bx0 + d->width, by1 = by0 + d->height;
+
+    float iw = (ax1 < bx1 ? ax1 : bx1) - (ax0 > bx0 ? ax0 : bx0);
+    float ih = (ay1 < by1 ? ay1 : by1) - (ay0 > by0 ? ay0 : by0);
+    if (iw <= 0.0f || ih <= 0.0f)
+        return 0.0f;
+
+    float inter = iw * ih;
+    float area = (float)t->width * t->height + (float)d->width * d->height - inter;
+    return area > 0.0f ? inter / area : 0.0f;
+}
+
+// 用检测更新已关联的轨迹
+static void track_hit(target_tracks_t *tracks, target_track_t *t, const k210_frame_det_t *d, uint32_t time_ms)
+{
+    float dt = (int32_t)(time_ms - t->last_seen) / 1000.0f;
+    if (dt > 0.0f)
+    {
+        float vx = ((d->x + d->width / 2.0f) - (t->x + t->width / 2.0f)) / dt;
+        float vy = ((d->y + d->height / 2.0f) - (t->y + t->height / 2.0f)) / dt;
+        float gain = t->hits > 1 ? tracks->config.velocity_gain : 1.0f;
+        t->vx += gain * (vx - t->vx);
+        t->vy += gain * (vy - t->vy);
+    }
+    t->number = d->number;
+    t->confidence = d->confidence;
+    t->x = d->x;
+    t->y = d->y;
+    t->width = d->width;
+    t->height = d->height;
+    t->last_seen = time_ms;
+    if (t->hits < 0xFFFF)
+        t->hits++;
+    t->misses = 0;
+}
+
+// 分配新轨迹ID: 从next_id开始, 跳过0和仍在使用的ID(最多8条轨迹, 一定能找到)
+static uint8_t track_new_id(target_tracks_t *tracks)
+{
+    for (;;)
+    {
+        uint8_t id = tracks->next_id++;
+        if (id != 0 && target_tracks_find_id(tracks, id) == NULL)
+            return id;
+    }
+}
+
+// 为未关联的检测新建轨迹, 没有空位时替换最久未命中的轨迹
+static void track_create(target_tracks_t *tracks, const k210_frame_det_t *d, uint32_t time_ms)
+{
+    target_track_t *slot = NULL;
+    for (uint8_t i = 0; i < TARGET_TRACKS_MAX; i++)
+    {
+        target_track_t *t = &tracks->tracks[i];
+        if (!t->active)
+        {
+            slot = t;
+            break;
+        }
+        if (slot == NULL || (int32_t)(t->last_seen - slot->last_seen) < 0)
+            slot = t;
+    }
+    if (slot->active)
+        tracks->expired++;
+
+    memset(slot, 0, sizeof(*slot));
+    slot->id = track_new_id(tracks);
+    slot->active = true;
+    slot->class_id = d->class_id;
+    slot->number = d->number;
+    slot->first_seen = time_ms;
+    slot->last_seen = time_ms;
+    slot->confidence = d->confidence;
+    slot->x = d->x;
+    slot->y = d->y;
+    slot->width = d->width;
+    slot->height = d->height;
+    slot->hits = 1;
+    tracks->created++;
+}
+
+void target_tracks_update(target_tracks_t *tracks, const k210_frame_det_t *dets, uint8_t count, uint32_t time_ms)
+{
+    const target_tracks_config_t *cfg = &tracks->config;
+    bool det_used[K210_FRAME_MAX_DETS] = {false};
+    bool track_used[TARGET_TRACKS_MAX] = {false};
+
+    if (count > K210_FRAME_MAX_DETS)
+        count = K210_FRAME_MAX_DETS;
+
+    // 贪心关联: 每次取IoU最大的一对(轨迹, 检测), 类别必须相同
+    for (;;)
+    {
+        float best_iou = cfg->min_iou;
+        int8_t best_t = -1, best_d = -1;
+
+        for (uint8_t i = 0; i < TARGET_TRACKS_MAX; i++)
+        {
+            const target_track_t *t = &tracks->tracks[i];
+            if (!t->active || track_used[i])
+                continue;
+            float dt = (int32_t)(time_ms - t->last_seen) / 1000.0f;
+            for (uint8_t j = 0; j < count; j++)
+            {
+                if (det_used[j] || dets[j].class_id != t->class_id)
+                    continue;
+                float iou = box_iou(t, t->vx * dt, t->vy * dt, &dets[j]);
+                if (iou >= best_iou)
+                {
+                    best_iou = iou;
+                    best_t = i;
+                    best_d = j;
+                }
+            }
+        }
+        if (best_t < 0)
+            break;
+
+        track_hit(tracks, &tracks->tracks[best_t], &dets[best_d], time_ms);
+        track_used[best_t] = true;
+        det_used[best_d] = true;
+    }
+
+    // 未关联的轨迹记一次丢失, 过期删除
+    for (uint8_t i = 0; i < TARGET_TRACKS_MAX; i++)
+    {
+        target_track_t *t = &tracks->tracks[i];
+        if (!t->active || track_used[i])
+            continue;
+        t->misses++;
+        if (t->misses > cfg->max_misses || (int32_t)(time_ms - t->last_seen) > (int32_t)cfg->expire_ms)
+        {
+            t->active = false;
+            tracks->expired++;
+        }
+    }
+
+    // 未关联的检测新建轨迹
+    for (uint8_t j = 0; j < count; j++)
+    {
+        if (!det_used[j])
+            track_create(tracks, &dets[j], time_ms);
+    }
+
+    tracks->frames++;
+}
+
+const target_track_t *target_tracks_find_id(const target_tracks_t *tracks, uint8_t id)
+{
+    for (uint8_t i = 0; i < TARGET_TRACKS_MAX; i++)
+    {
+        if (tracks->tracks[i].active && tracks->tracks[i].id == id)
+            return &tracks->tracks[i];
+    }
+    return NULL;
+}
+
+const target_track_t *target_tracks_find_number(const target_tracks_t *tracks, uint8_t number)
+{
+    const target_track_t *found = NULL;
+    for (uint8_t i = 0; i < TARGET_TRACKS_MAX; i++)
+    {
+        const target_track_t *t = &tracks->tracks[i];
+        if (!t->active || t->number != number || t->hits < tracks->config.confirm_hits)
+            continue;
+        if (found == NULL || (int32_t)(t->last_seen - found->last_seen) > 0)
+            found = t;
+    }
+    return found;
+}
+
+const target_track_t *target_tracks_best(const target_tracks_t *tracks)
+{
+    const target_track_t *best = NULL;
+    for (uint8_t i = 0; i < TARGET_TRACKS_MAX; i++)
+    {
+        const target_track_t *t = &tracks->tracks[i];
+        if (!t->active || t->hits < tracks->config.confirm_hits)
+            continue;
+        if (best == NULL || t->hits > best->hits)
+            best = t;
+    }
+    return best;
+}
+
+const target_track_t *target_tracks_lock(const target_tracks_t *tracks, uint8_t *locked_id)
+{
+    const target_track_t *track = target_tracks_find_id(tracks, *locked_id);
+    if (track == NULL)
+    {
+        track = target_tracks_best(tracks);
+        *locked_id = track != NULL ? track->id : 0;
+    }
+    return track;
+}
+
+uint8_t target_tracks_count(const target_tracks_t *tracks)
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < TARGET_TRACKS_MAX; i++)
+    {
+        if (tracks->tracks[i].active && tracks->tracks[i].hits >= tracks->config.confirm_hits)
+            n++;
+    }
+    return n;
+}
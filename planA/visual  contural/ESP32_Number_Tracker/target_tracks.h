@@ -0,0 +1,134 @@
+#ifndef TARGET_TRACKS_H
+#define TARGET_TRACKS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "k210_frame.h"
+
+/**
+ * @brief 多目标跟踪
+ *
+ * 每帧的检测结果按类别ID(class_id)和框重叠度(IoU)与已有轨迹关联, 轨迹保持固定ID、
+ * 速度和命中/丢失次数; 长时间未命中的轨迹自动删除。
+ * 不依赖Arduino, 可直接在主机上用合成场景驱动。
+ */
+
+/** 最多同时跟踪的目标个数 */
+#define TARGET_TRACKS_MAX 8
+
+/**
+ * @brief 一条轨迹
+ */
+typedef struct
+{
+    bool active;         /**< 是否在使用 */
+    uint8_t id;          /**< 轨迹ID, 从1开始, 轨迹存在期间不变, 不与其他存在的轨迹重复 */
+    uint8_t class_id;    /**< 类别ID, 关联时必须相同 */
+    uint8_t number;      /**< 最近一次检测识别出的数字 */
+    uint8_t confidence;  /**< 最近一次检测的置信度(0-255) */
+    int16_t x;           /**< 最近一次检测的框 */
+    int16_t y;
+    int16_t width;
+    int16_t height;
+    float vx;            /**< 框中心水平速度(像素/秒) */
+    float vy;            /**< 框中心垂直速度(像素/秒) */
+    uint32_t first_seen; /**< 第一次检测的时间(ms) */
+    uint32_t last_seen;  /**< 最近一次检测的时间(ms) */
+    uint16_t hits;       /**< 命中次数 */
+    uint16_t misses;     /**< 连续丢失帧数 */
+} target_track_t;
+
+/**
+ * @brief 跟踪参数
+ */
+typedef struct
+{
+    float min_iou;        /**< 关联所需的最小IoU(按速度预测后的框计算) */
+    float velocity_gain;  /**< 速度平滑系数(0-1) */
+    uint16_t max_misses;  /**< 连续丢失超过此帧数删除 */
+    uint32_t expire_ms;   /**< 超过此时间未命中删除 */
+    uint16_t confirm_hits; /**< 命中次数达到此值才算确认的目标 */
+} target_tracks_config_t;
+
+/**
+ * @brief 跟踪器状态
+ */
+typedef struct
+{
+    target_tracks_config_t config;
+    target_track_t tracks[TARGET_TRACKS_MAX];
+    uint8_t next_id;        /**< 下一个新轨迹的ID(回绕后跳过仍在使用的ID) */
+    uint32_t frames;        /**< 处理的帧数 */
+    uint32_t created;       /**< 新建的轨迹数 */
+    uint32_t expired;       /**< 删除的轨迹数 */
+} target_tracks_t;
+
+/**
+ * @brief 获取默认参数(IoU>=0.1, 丢失10帧或1.5秒删除, 命中2次确认)
+ *
+ * @param config 输出参数
+ */
+void target_tracks_default_config(target_tracks_config_t *config);
+
+/**
+ * @brief 初始化跟踪器
+ *
+ * @param tracks 跟踪器
+ * @param config 参数, 为NULL时使用默认参数
+ */
+void target_tracks_init(target_tracks_t *tracks, const target_tracks_config_t *config);
+
+/**
+ * @brief 输入一帧检测结果(可以为0个)
+ *
+ * @param tracks 跟踪器
+ * @param dets 检测结果
+ * @param count 检测个数
+ * @param time_ms 拍照时间(ms)
+ */
+void target_tracks_update(target_tracks_t *tracks, const k210_frame_det_t *dets, uint8_t count, uint32_t time_ms);
+
+/**
+ * @brief 按ID查找轨迹
+ *
+ * @param tracks 跟踪器
+ * @param id 轨迹ID
+ * @return const target_track_t* 轨迹, 不存在时为NULL
+ */
+const target_track_t *target_tracks_find_id(const target_tracks_t *tracks, uint8_t id);
+
+/**
+ * @brief 查找某个数字的已确认轨迹(有多个时取最近命中的)
+ *
+ * @param tracks 跟踪器
+ * @param number 数字
+ * @return const target_track_t* 轨迹, 不存在时为NULL
+ */
+const target_track_t *target_tracks_find_number(const target_tracks_t *tracks, uint8_t number);
+
+/**
+ * @brief 选择最稳定的已确认轨迹(命中次数最多)
+ *
+ * @param tracks 跟踪器
+ * @return const target_track_t* 轨迹, 没有已确认轨迹时为NULL
+ */
+const target_track_t *target_tracks_best(const target_tracks_t *tracks);
+
+/**
+ * @brief 选择云台锁定的轨迹: 锁定的轨迹还在就继续跟踪, 否则改为锁定最稳定的已确认轨迹
+ *
+ * @param tracks 跟踪器
+ * @param locked_id 锁定的轨迹ID, 0表示未锁定, 返回时更新
+ * @return const target_track_t* 锁定的轨迹, 没有时为NULL
+ */
+const target_track_t *target_tracks_lock(const target_tracks_t *tracks, uint8_t *locked_id);
+
+/**
+ * @brief 已确认的轨迹个数
+ *
+ * @param tracks 跟踪器
+ * @return uint8_t 个数
+ */
+uint8_t target_tracks_count(const target_tracks_t *tracks);
+
+#endif // TARGET_TRACKS_H
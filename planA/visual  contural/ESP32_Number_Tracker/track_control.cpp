@@ -0,0 +1,139 @@
+#include "track_control.h"
+
+#include <math.h>
+#include <string.h>
+
+// 两次检测间隔上限(s), 避免长时间无检测后角速度估计发散
+#define MAX_MEAS_DT 0.5f
+
+// alpha/beta按此检测间隔(s, K210约15FPS)给出; 其他间隔时换算, 使滤波的时间常数不随帧率变化,
+// 否则帧率提高时修正过于频繁, 闭环仿真中会持续振荡
+#define NOMINAL_MEAS_DT 0.067f
+
+static float clampf(float value, float low, float high)
+{
+    return value < low ? low : (value > high ? high : value);
+}
+
+void track_default_config(track_config_t *config)
+{
+    config->alpha = 0.6f;
+    config->beta = 0.2f;
+    config->deg_per_px_x = -0.19f; // 目标在右侧(偏差为正)时水平舵机角度减小
+    config->deg_per_px_y = 0.19f;  // 目标在下方(偏差为正)时垂直舵机角度增大
+    config->max_rate = 300.0f;
+    config->lead_ms = 20.0f;
+    config->servo_lag_ms = 30.0f;
+    config->coast_ms = 500;
+    config->min_angle = 0.0f;
+    config->max_angle = 180.0f;
+}
+
+void track_init(track_controller_t *track, const track_config_t *config, float pan, float tilt)
+{
+    memset(track, 0, sizeof(*track));
+    if (config != NULL)
+        track->config = *config;
+    else
+        track_default_config(&track->config);
+    track->cmd_pan = pan;
+    track->cmd_tilt = tilt;
+}
+
+// 查找拍照时刻的舵机角度: 取该时刻之前最近一次下发的角度
+static void history_lookup(const track_controller_t *track, uint32_t time, float *pan, float *tilt)
+{
+    *pan = track->cmd_pan;
+    *tilt = track->cmd_tilt;
+
+    for (uint8_t i = 1; i <= track->history_count; i++)
+    {
+        const track_sample_t *s = &track->history[(track->history_head + TRACK_HISTORY_LEN - i) % TRACK_HISTORY_LEN];
+        *pan = s->pan;
+        *tilt = s->tilt;
+        if ((int32_t)(time - s->time) >= 0)
+            return;
+    }
+    // 比历史更早, 使用最早的记录
+}
+
+static void axis_update(track_axis_t *axis, float measured, float dt, const track_config_t *cfg)
+{
+    float predicted = axis->angle + axis->rate * dt;
+    float residual = measured - predicted;
+    float scale = dt / NOMINAL_MEAS_DT;
+    float alpha = 1.0f - powf(1.0f - cfg->alpha, scale);
+    float beta = cfg->beta * (scale < 1.0f ? scale : 1.0f);
+    axis->angle = predicted + alpha * residual;
+    if (dt > 0.0f)
+        axis->rate += beta * residual / dt;
+}
+
+void track_measure(track_controller_t *track, float error_x, float error_y, uint32_t capture_ms)
+{
+    const track_config_t *cfg = &track->config;
+    float pan, tilt;
+
+    // 拍照时舵机实际所在的角度, 约为servo_lag_ms之前下发的指令
+    history_lookup(track, capture_ms - (uint32_t)cfg->servo_lag_ms, &pan, &tilt);
+    float target_pan = pan + error_x * cfg->deg_per_px_x;
+    float target_tilt = tilt + error_y * cfg->deg_per_px_y;
+
+    float dt = (int32_t)(capture_ms - track->meas_time) / 1000.0f;
+    if (!track->has_target || dt > cfg->coast_ms / 1000.0f)
+    {
+        // 第一次检测或目标丢失后重新出现, 重新开始估计
+        track->pan.angle = target_pan;
+        track->pan.rate = 0.0f;
+        track->tilt.angle = target_tilt;
+        track->tilt.rate = 0.0f;
+    }
+    else
+    {
+        if (dt < 0.0f)
+            dt = 0.0f;
+        if (dt > MAX_MEAS_DT)
+            dt = MAX_MEAS_DT;
+        axis_update(&track->pan, target_pan, dt, cfg);
+        axis_update(&track->tilt, target_tilt, dt, cfg);
+    }
+
+    track->meas_time = capture_ms;
+    track->has_target = true;
+    track->measurements++;
+}
+
+void track_lost(track_controller_t *track)
+{
+    track->has_target = false;
+}
+
+void track_update(track_controller_t *track, uint32_t now_ms, float dt)
+{
+    const track_config_t *cfg = &track->config;
+    uint32_t age = now_ms - track->meas_time;
+
+    if (track->has_target && age > cfg->coast_ms)
+        track->has_target = false;
+
+    if (track->has_target)
+    {
+        // 外推到当前时刻再加上舵机滞后提前量
+        float ahead = (age + cfg->lead_ms) / 1000.0f;
+        float goal_pan = clampf(track->pan.angle + track->pan.rate * ahead, cfg->min_angle, cfg->max_angle);
+        float goal_tilt = clampf(track->tilt.angle + track->tilt.rate * ahead, cfg->min_angle, cfg->max_angle);
+
+        float step = cfg->max_rate * dt;
+        track->cmd_pan += clampf(goal_pan - track->cmd_pan, -step, step);
+        track->cmd_tilt += clampf(goal_tilt - track->cmd_tilt, -step, step);
+    }
+
+    // 记录下发角度, 供之后的检测查找拍照时刻的舵机角度
+    track_sample_t *s = &track->history[track->history_head];
+    s->time = now_ms;
+    s->pan = track->cmd_pan;
+    s->tilt = track->cmd_tilt;
+    track->history_head = (track->history_head + 1) % TRACK_HISTORY_LEN;
+    if (track->history_count < TRACK_HISTORY_LEN)
+        track->history_count++;
+}
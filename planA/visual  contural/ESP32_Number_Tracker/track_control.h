@@ -0,0 +1,119 @@
+#ifndef TRACK_CONTROL_H
+#define TRACK_CONTROL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief 云台跟踪控制器
+ *
+ * 摄像头装在云台上, 目标的像素偏差加上拍照时刻的舵机角度即为目标的"绝对角度"。
+ * 舵机实际角度落后于指令, 所以拍照时刻的角度取servo_lag_ms之前下发的指令。
+ * 对绝对角度做alpha-beta滤波, 估计角度和角速度; 控制器以固定周期运行,
+ * 在两次检测之间按速度外推, 并按检测延迟和舵机滞后提前量补偿, 输出带小数的舵机角度。
+ * 不依赖Arduino, 可直接在主机上做闭环仿真。
+ */
+
+/** 舵机角度历史长度, 用于查找拍照时刻的舵机角度 */
+#define TRACK_HISTORY_LEN 32
+
+/**
+ * @brief 控制参数
+ */
+typedef struct
+{
+    float alpha;          /**< 角度修正系数(0-1), 对应约67ms的检测间隔, 其他间隔时自动换算 */
+    float beta;           /**< 角速度修正系数(0-1), 同上 */
+    float deg_per_px_x;   /**< 水平方向每像素对应角度, 符号与舵机方向一致 */
+    float deg_per_px_y;   /**< 垂直方向每像素对应角度, 符号与舵机方向一致 */
+    float max_rate;       /**< 舵机最大角速度(度/秒) */
+    float lead_ms;        /**< 舵机响应滞后的提前量(ms) */
+    float servo_lag_ms;   /**< 舵机实际角度落后于下发指令的时间(ms, PWM周期加舵机响应), 查找拍照时刻角度时扣除 */
+    uint32_t coast_ms;    /**< 超过此时间没有检测则停止外推, 保持当前角度 */
+    float min_angle;      /**< 舵机角度下限 */
+    float max_angle;      /**< 舵机角度上限 */
+} track_config_t;
+
+/**
+ * @brief 单轴alpha-beta状态
+ */
+typedef struct
+{
+    float angle; /**< 目标绝对角度 */
+    float rate;  /**< 目标角速度(度/秒) */
+} track_axis_t;
+
+/**
+ * @brief 舵机角度历史
+ */
+typedef struct
+{
+    uint32_t time; /**< 下发时间(ms) */
+    float pan;     /**< 水平舵机角度 */
+    float tilt;    /**< 垂直舵机角度 */
+} track_sample_t;
+
+/**
+ * @brief 控制器状态
+ */
+typedef struct
+{
+    track_config_t config;
+    track_axis_t pan;                          /**< 水平方向目标估计 */
+    track_axis_t tilt;                         /**< 垂直方向目标估计 */
+    float cmd_pan;                             /**< 当前水平舵机角度 */
+    float cmd_tilt;                            /**< 当前垂直舵机角度 */
+    track_sample_t history[TRACK_HISTORY_LEN]; /**< 舵机角度历史(环形) */
+    uint8_t history_head;                      /**< 下一个写入位置 */
+    uint8_t history_count;                     /**< 有效历史个数 */
+    uint32_t meas_time;                        /**< 最近一次检测的拍照时间 */
+    bool has_target;                           /**< 是否有目标估计 */
+    uint32_t measurements;                     /**< 检测次数 */
+} track_controller_t;
+
+/**
+ * @brief 获取默认参数(视野约42度/224像素, 舵机最大300度/秒, 舵机滞后30ms)
+ *
+ * 默认值用replay/track_closed_loop.cpp在不同帧率、检测延迟和舵机响应下的闭环仿真中选出。
+ *
+ * @param config 输出参数
+ */
+void track_default_config(track_config_t *config);
+
+/**
+ * @brief 初始化控制器
+ *
+ * @param track 控制器
+ * @param config 参数, 为NULL时使用默认参数
+ * @param pan 水平舵机初始角度
+ * @param tilt 垂直舵机初始角度
+ */
+void track_init(track_controller_t *track, const track_config_t *config, float pan, float tilt);
+
+/**
+ * @brief 输入一次检测
+ *
+ * @param track 控制器
+ * @param error_x 目标中心相对画面中心的水平像素偏差
+ * @param error_y 目标中心相对画面中心的垂直像素偏差
+ * @param capture_ms 拍照时间(本机millis(), 即收到时间减去检测延迟)
+ */
+void track_measure(track_controller_t *track, float error_x, float error_y, uint32_t capture_ms);
+
+/**
+ * @brief 目标丢失, 停止外推
+ *
+ * @param track 控制器
+ */
+void track_lost(track_controller_t *track);
+
+/**
+ * @brief 按固定周期调用, 更新舵机角度
+ *
+ * @param track 控制器
+ * @param now_ms 当前时间(ms)
+ * @param dt 距上次调用的时间(s)
+ */
+void track_update(track_controller_t *track, uint32_t now_ms, float dt);
+
+#endif // TRACK_CONTROL_H
@@ -0,0 +1,248 @@
+#include "track_params.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TYPE_FLOAT 0
+#define TYPE_U32 1
+
+typedef struct
+{
+    const char *name;
+    size_t offset; // track_config_t中的位置
+    uint8_t type;
+    float min;
+    float max;
+} track_param_t;
+
+// 范围按舵机和视野的物理限制给出, 默认值见track_default_config
+static const track_param_t g_params[] = {
+    {"track.alpha", offsetof(track_config_t, alpha), TYPE_FLOAT, 0.0f, 1.0f},
+    {"track.beta", offsetof(track_config_t, beta), TYPE_FLOAT, 0.0f, 1.0f},
+    {"track.deg_per_px_x", offsetof(track_config_t, deg_per_px_x), TYPE_FLOAT, -1.0f, 1.0f},
+    {"track.deg_per_px_y", offsetof(track_config_t, deg_per_px_y), TYPE_FLOAT, -1.0f, 1.0f},
+    {"track.max_rate", offsetof(track_config_t, max_rate), TYPE_FLOAT, 1.0f, 2000.0f},
+    {"track.lead_ms", offsetof(track_config_t, lead_ms), TYPE_FLOAT, 0.0f, 500.0f},
+    {"track.servo_lag_ms", offsetof(track_config_t, servo_lag_ms), TYPE_FLOAT, 0.0f, 500.0f},
+    {"track.coast_ms", offsetof(track_config_t, coast_ms), TYPE_U32, 0.0f, 10000.0f},
+    {"track.min_angle", offsetof(track_config_t, min_angle), TYPE_FLOAT, 0.0f, 180.0f},
+    {"track.max_angle", offsetof(track_config_t, max_angle), TYPE_FLOAT, 0.0f, 180.0f},
+};
+#define PARAM_COUNT (sizeof(g_params) / sizeof(g_params[0]))
+
+static const track_param_t *find(const char *name)
+{
+    for (size_t i = 0; i < PARAM_COUNT; i++)
+    {
+        if (strcmp(g_params[i].name, name) == 0)
+            return &g_params[i];
+    }
+    return NULL;
+}
+
+static float read_value(const track_config_t *config, const track_param_t *p)
+{
+    const uint8_t *field = (const uint8_t *)config + p->offset;
+    if (p->type == TYPE_U32)
+        return (float)*(const uint32_t *)field;
+    return *(const float *)field;
+}
+
+static int format_value(const track_config_t *config, const track_param_t *p, char *buf, size_t size)
+{
+    if (p->type == TYPE_U32)
+        return snprintf(buf, size, "%u", (unsigned)*(const uint32_t *)((const uint8_t *)config + p->offset));
+    return snprintf(buf, size, "%g", (double)read_value(config, p));
+}
+
+uint8_t track_params_set(track_config_t *config, const char *name, const char *value)
+{
+    const track_param_t *p = find(name);
+    if (p == NULL)
+        return TRACK_PARAMS_ENOTFOUND;
+
+    char *end;
+    float v;
+    if (p->type == TYPE_U32)
+        v = (float)strtol(value, &end, 10);
+    else
+        v = strtof(value, &end);
+    while (isspace((unsigned char)*end))
+        end++;
+    if (end == value || *end != '\0' || v != v)
+        return TRACK_PARAMS_EINVAL;
+    if (v < p->min || v > p->max)
+        return TRACK_PARAMS_ERANGE;
+
+    track_config_t updated = *config;
+    uint8_t *field = (uint8_t *)&updated + p->offset;
+    if (p->type == TYPE_U32)
+        *(uint32_t *)field = (uint32_t)v;
+    else
+        *(float *)field = v;
+    if (updated.min_angle > updated.max_angle)
+        return TRACK_PARAMS_ERANGE;
+    *config = updated;
+    return TRACK_PARAMS_EOK;
+}
+
+uint8_t track_params_get(const track_config_t *config, const char *name, char *buf, size_t size)
+{
+    const track_param_t *p = find(name);
+    if (p == NULL)
+        return TRACK_PARAMS_ENOTFOUND;
+    format_value(config, p, buf, size);
+    return TRACK_PARAMS_EOK;
+}
+
+size_t track_params_format(const track_config_t *config, char *buf, size_t size, bool detail)
+{
+    track_config_t defaults;
+    track_default_config(&defaults);
+    size_t len = 0;
+    if (size > 0)
+        buf[0] = '\0';
+
+    for (size_t i = 0; i < PARAM_COUNT; i++)
+    {
+        const track_param_t *p = &g_params[i];
+        char value[24], def[24];
+        format_value(config, p, value, sizeof(value));
+        format_value(&defaults, p, def, sizeof(def));
+        int n = detail ? snprintf(buf + len, size - len, "%s = %s # %g..%g, default %s\n", p->name, value,
+                                  (double)p->min, (double)p->max, def)
+                       : snprintf(buf + len, size - len, "%s = %s\n", p->name, value);
+        if (n < 0 || (size_t)n >= size - len)
+        {
+            if (size > 0)
+                buf[0] = '\0';
+            return 0;
+        }
+        len += (size_t)n;
+    }
+    return len;
+}
+
+// 去掉#注释和首尾空白, 结果写入out
+static void strip_line(const char *line, size_t len, char *out, size_t size)
+{
+    const char *hash = (const char *)memchr(line, '#', len);
+    if (hash != NULL)
+        len = (size_t)(hash - line);
+    while (len > 0 && isspace((unsigned char)*line))
+    {
+        line++;
+        len--;
+    }
+    while (len > 0 && isspace((unsigned char)line[len - 1]))
+        len--;
+    if (len >= size)
+        len = size - 1;
+    memcpy(out, line, len);
+    out[len] = '\0';
+}
+
+// "名称 = 值"
+static uint8_t apply_assignment(track_config_t *config, char *text)
+{
+    char *eq = strchr(text, '=');
+    if (eq == NULL)
+        return TRACK_PARAMS_EINVAL;
+    char *name_end = eq;
+    while (name_end > text && isspace((unsigned char)name_end[-1]))
+        name_end--;
+    *name_end = '\0';
+    char *value = eq + 1;
+    while (isspace((unsigned char)*value))
+        value++;
+    return track_params_set(config, text, value);
+}
+
+uint8_t track_params_parse_text(track_config_t *config, const char *text)
+{
+    uint8_t first = TRACK_PARAMS_EOK;
+    while (*text != '\0')
+    {
+        const char *end = strchr(text, '\n');
+        size_t len = end != NULL ? (size_t)(end - text) : strlen(text);
+        char line[96];
+        strip_line(text, len, line, sizeof(line));
+        text += end != NULL ? len + 1 : len;
+        if (line[0] == '\0')
+            continue;
+        uint8_t ret = apply_assignment(config, line);
+        if (ret != TRACK_PARAMS_EOK && first == TRACK_PARAMS_EOK)
+            first = ret;
+    }
+    return first;
+}
+
+static uint8_t error_reply(uint8_t ret, const char *name, char *reply, size_t size)
+{
+    static const char *const messages[] = {"ok", "invalid value", "unknown parameter", "out of range"};
+    snprintf(reply, size, "error: %s: %s", name, messages[ret]);
+    return ret;
+}
+
+uint8_t track_params_command(track_config_t *config, const char *line, char *reply, size_t size)
+{
+    char text[96];
+    strip_line(line, strlen(line), text, sizeof(text));
+    reply[0] = '\0';
+
+    if (strcmp(text, "track") == 0)
+    {
+        if (track_params_format(config, reply, size, true) == 0)
+            snprintf(reply, size, "error: reply buffer too small");
+        return TRACK_PARAMS_EOK;
+    }
+    if (strcmp(text, "track reset") == 0)
+    {
+        track_default_config(config);
+        snprintf(reply, size, "track parameters reset");
+        return TRACK_PARAMS_EOK;
+    }
+    if (strncmp(text, "track get ", 10) == 0)
+    {
+        const char *name = text + 10;
+        char value[24];
+        uint8_t ret = track_params_get(config, name, value, sizeof(value));
+        if (ret != TRACK_PARAMS_EOK)
+            return error_reply(ret, name, reply, size);
+        snprintf(reply, size, "%s = %s", name, value);
+        return TRACK_PARAMS_EOK;
+    }
+
+    // "track set 名称 值"改写成"名称 = 值"
+    char assignment[96];
+    if (strncmp(text, "track set ", 10) == 0)
+    {
+        const char *name = text + 10;
+        const char *sep = strpbrk(name, " \t=");
+        if (sep == NULL)
+            return error_reply(TRACK_PARAMS_EINVAL, name, reply, size);
+        const char *value = sep + strspn(sep, " \t=");
+        snprintf(assignment, sizeof(assignment), "%.*s = %s", (int)(sep - name), name, value);
+    }
+    else if (strncmp(text, "track.", 6) == 0 && strchr(text, '=') != NULL)
+    {
+        snprintf(assignment, sizeof(assignment), "%s", text);
+    }
+    else
+    {
+        snprintf(reply, size, "error: unknown command '%s'", text);
+        return TRACK_PARAMS_EINVAL;
+    }
+
+    char name[40];
+    snprintf(name, sizeof(name), "%.*s", (int)strcspn(assignment, " ="), assignment);
+    uint8_t ret = apply_assignment(config, assignment);
+    if (ret != TRACK_PARAMS_EOK)
+        return error_reply(ret, name, reply, size);
+    char value[24];
+    track_params_get(config, name, value, sizeof(value));
+    snprintf(reply, size, "%s = %s", name, value);
+    return TRACK_PARAMS_EOK;
+}
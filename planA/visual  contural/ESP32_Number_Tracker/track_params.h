@@ -0,0 +1,84 @@
+#ifndef TRACK_PARAMS_H
+#define TRACK_PARAMS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "track_control.h"
+
+/**
+ * @brief 跟踪控制参数的名称表
+ *
+ * track_config_t的各字段按名称("track.alpha"等)读写, 写入前检查范围, 可在串口上调整而不必重新烧录。
+ * 文本格式与底盘参数文件相同: 每行"名称 = 值", #后为注释; 保存到NVS的也是这种文本。
+ * 只修改调用方给出的track_config_t, 由调用方在临界区内复制给控制器。
+ * 不依赖Arduino, 可直接在主机上编译。
+ */
+
+/**
+ * @brief 错误码定义
+ */
+#define TRACK_PARAMS_EOK 0       /**< 操作成功 */
+#define TRACK_PARAMS_EINVAL 1    /**< 格式错误 */
+#define TRACK_PARAMS_ENOTFOUND 2 /**< 没有该名称的参数 */
+#define TRACK_PARAMS_ERANGE 3    /**< 值超出范围(或角度下限大于上限) */
+
+/**
+ * @brief 按名称设置参数
+ *
+ * @param config 参数
+ * @param name 名称
+ * @param value 值的文本(coast_ms不接受小数)
+ * @return uint8_t 错误码, 出错时参数不变
+ */
+uint8_t track_params_set(track_config_t *config, const char *name, const char *value);
+
+/**
+ * @brief 按名称读取参数, 格式化为文本
+ *
+ * @param config 参数
+ * @param name 名称
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小
+ * @return uint8_t 错误码
+ */
+uint8_t track_params_get(const track_config_t *config, const char *name, char *buf, size_t size);
+
+/**
+ * @brief 把全部参数格式化为"名称 = 值"文本, 每个参数一行
+ *
+ * @param config 参数
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小
+ * @param detail 为true时每行附注释: 范围和默认值
+ * @return size_t 字符串长度(不含结尾0), 缓冲区不足返回0
+ */
+size_t track_params_format(const track_config_t *config, char *buf, size_t size, bool detail);
+
+/**
+ * @brief 解析"名称 = 值"文本并逐行设置, 出错的行跳过, 其余行照常生效
+ *
+ * @param config 参数
+ * @param text 文本(以0结尾)
+ * @return uint8_t 第一个错误的错误码, 全部成功返回TRACK_PARAMS_EOK
+ */
+uint8_t track_params_parse_text(track_config_t *config, const char *text);
+
+/**
+ * @brief 执行一行串口命令
+ *   track               列出全部参数(范围和默认值写在注释中)
+ *   track get 名称      读取一个参数
+ *   track set 名称 值   设置一个参数, 也可写成"track.名称 = 值"(参数文件可以逐行发送)
+ *   track reset         恢复默认值(track_default_config)
+ * 保存和读取NVS与平台相关, 由调用方处理; 调用方只把以"track"开头的行交给本函数。
+ *
+ * @param config 参数
+ * @param line 命令(以0结尾, 可带结尾换行)
+ * @param reply 输出回复文本, 出错时以"error: "开头
+ * @param size 回复缓冲区大小
+ * @return uint8_t 错误码
+ */
+uint8_t track_params_command(track_config_t *config, const char *line, char *reply, size_t size);
+
+#endif // TRACK_PARAMS_H
@@ -5,6 +5,7 @@ import KPU as kpu
 import gc, sys
 from fpioa_manager import fm
 from machine import UART, Timer
+from k210_frame import encode_frame, label_number
 
 # 映射串口引脚
 fm.register(11, fm.fpioa.UART1_RX, force=True)
@@ -13,6 +14,9 @@ fm.register(10, fm.fpioa.UART1_TX, force=True)
 # 初始化串口
 uart = UART(UART.UART1, 115200, read_buf_len=4096)
 
+# 发送格式: True为二进制多目标帧(k210_frame.py), False为旧的文本格式"数字,x,y,宽,高"
+USE_BINARY_FRAME = True
+
 # 基本设置与变量定义
 input_size = (224, 224)
 labels = ['5', '6', '7', '8', '1', '2', '3', '4']
@@ -70,14 +74,29 @@ def main(anchors, labels = None, model_addr="/sd/model-11975.kmodel", sensor_win
         
         clock = time.clock()
         detection_count = 0
+        frame_id = 0
         
         # 主循环
         while(True):
             clock.tick()  # 更新时钟
             img = sensor.snapshot()
-            t = time.ticks_ms()
+            capture_ms = time.ticks_ms()
+            t = capture_ms
             objects = kpu.run_yolo2(task, img)
             t = time.ticks_ms() - t
+            frame_id += 1
+            
+            if USE_BINARY_FRAME:
+                # 每帧都发送, 包含全部检测结果(按置信度从高到低), 没有目标时count为0
+                dets = []
+                if objects:
+                    for obj in sorted(objects, key=lambda o: o.value(), reverse=True):
+                        pos = obj.rect()
+                        classid = obj.classid()
+                        dets.append((classid, label_number(labels[classid], classid), obj.value(),
+                                     pos[0], pos[1], pos[2], pos[3]))
+                latency_ms = time.ticks_diff(time.ticks_ms(), capture_ms)
+                uart.write(encode_frame(frame_id, capture_ms, latency_ms, dets))
             
             # 发送检测结果
             if objects:
@@ -96,9 +115,10 @@ def main(anchors, labels = None, model_addr="/sd/model-11975.kmodel", sensor_win
                 label = labels[classid]
                 
                 # 发送数据格式: 数字,x,y,宽,高
-                data = "{},{},{},{},{}\r\n".format(
-                    label, pos[0], pos[1], pos[2], pos[3])
-                uart.write(data)
+                if not USE_BINARY_FRAME:
+                    data = "{},{},{},{},{}\r\n".format(
+                        label, pos[0], pos[1], pos[2], pos[3])
+                    uart.write(data)
                 
                 # 只打印识别内容和坐标数据
                 print("数字: {}, 位置: ({}, {}, {}, {})".format(
@@ -0,0 +1,47 @@
+# 保存ESP32S3捕获的K210串口原始数据, 供replay/tracker_replay离线回放
+#
+# 发送"cap on"后把ESP32S3输出的"R,接收时间us,十六进制数据"行写入文件, Ctrl+C结束并发送"cap off"。
+#
+# 用法(在电脑上运行, 需要pyserial):
+#   python k210_capture.py --port COM5 --out capture.log
+import argparse
+import sys
+
+import serial
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Capture raw K210 UART stream via ESP32S3')
+    parser.add_argument('--port', required=True, help='ESP32S3 USB serial port')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--out', default='capture.log')
+    args = parser.parse_args()
+
+    lines = 0
+    with serial.Serial(args.port, args.baud, timeout=1) as ser, open(args.out, 'w') as out:
+        ser.write(b'cap on\n')
+        try:
+            while True:
+                line = ser.readline().decode('ascii', 'ignore')
+                if line.startswith('R,'):
+                    out.write(line)
+                    lines += 1
+                    if lines % 100 == 0:
+                        sys.stderr.write('\r%d lines' % lines)
+                elif line.startswith('[CAP]'):
+                    sys.stderr.write('\n' + line)
+        except KeyboardInterrupt:
+            pass
+        ser.write(b'cap off\n')
+        # 打印设备端统计(丢弃的行数)
+        for _ in range(20):
+            line = ser.readline().decode('ascii', 'ignore')
+            if line.startswith('[CAP]'):
+                sys.stderr.write('\n' + line)
+                break
+    sys.stderr.write('\nsaved %d lines to %s\n' % (lines, args.out))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
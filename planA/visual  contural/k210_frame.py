@@ -0,0 +1,82 @@
+# K210 -> ESP32S3 二进制检测帧编码
+# 与ESP32_Number_Tracker/k210_frame.h的解码器对应, 修改格式时两边同时修改
+#
+# 帧格式(小端):
+#   0xA5 0x5A                   同步字
+#   version      u8             协议版本, 当前为1
+#   count        u8             检测个数(0-8), 0表示本帧没有目标
+#   frame_id     u16            帧序号, 每帧加1
+#   capture_ms   u32            拍照时的time.ticks_ms()
+#   latency_ms   u16            拍照到发送的时间
+#   count个检测, 每个11字节:
+#     class_id u8, number u8, confidence u8(0-255), x i16, y i16, w i16, h i16
+#   crc16        u16            CRC-16/CCITT-FALSE, 从version到最后一个检测
+try:
+    import ustruct as struct
+except ImportError:
+    import struct
+
+FRAME_SYNC = b'\xa5\x5a'
+FRAME_VERSION = 1
+FRAME_MAX_DETS = 8
+FRAME_HEADER_FMT = '<BBHIH'
+FRAME_DET_FMT = '<BBBhhhh'
+
+# CRC16表, 启动时计算一次
+_CRC_TABLE = []
+for _i in range(256):
+    _c = _i << 8
+    for _ in range(8):
+        _c = ((_c << 1) ^ 0x1021) if _c & 0x8000 else (_c << 1)
+    _CRC_TABLE.append(_c & 0xFFFF)
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc = ((crc << 8) & 0xFFFF) ^ _CRC_TABLE[((crc >> 8) ^ b) & 0xFF]
+    return crc
+
+
+def label_number(label, classid):
+    # 标签是数字时直接使用, 否则用类别ID+1, 与文本冒号格式的规则相同
+    try:
+        return int(label)
+    except ValueError:
+        return classid + 1
+
+
+def _clamp16(v):
+    return max(-32768, min(32767, int(v)))
+
+
+def encode_frame(frame_id, capture_ms, latency_ms, dets):
+    """dets: [(class_id, number, confidence, x, y, w, h), ...], 超过8个时只取前8个"""
+    dets = dets[:FRAME_MAX_DETS]
+    body = bytearray(struct.pack(FRAME_HEADER_FMT, FRAME_VERSION, len(dets),
+                                 frame_id & 0xFFFF, capture_ms & 0xFFFFFFFF,
+                                 max(0, min(0xFFFF, latency_ms))))
+    for classid, number, confidence, x, y, w, h in dets:
+        conf = max(0, min(255, int(confidence * 255 + 0.5)))
+        body += struct.pack(FRAME_DET_FMT, classid & 0xFF, number & 0xFF, conf,
+                            _clamp16(x), _clamp16(y), _clamp16(w), _clamp16(h))
+    return FRAME_SYNC + body + struct.pack('<H', crc16(body))
+
+
+def decode_frame(data):
+    """解码一个完整帧, 供主机端测试使用, 出错时抛出ValueError"""
+    if data[:2] != FRAME_SYNC:
+        raise ValueError('bad sync')
+    version, count, frame_id, capture_ms, latency_ms = struct.unpack_from(FRAME_HEADER_FMT, data, 2)
+    if version != FRAME_VERSION or count > FRAME_MAX_DETS:
+        raise ValueError('bad header')
+    end = 12 + 11 * count
+    if len(data) < end + 2:
+        raise ValueError('short frame')
+    if struct.unpack_from('<H', data, end)[0] != crc16(data[2:end]):
+        raise ValueError('bad crc')
+    dets = []
+    for i in range(count):
+        classid, number, conf, x, y, w, h = struct.unpack_from(FRAME_DET_FMT, data, 12 + 11 * i)
+        dets.append((classid, number, conf / 255.0, x, y, w, h))
+    return frame_id, capture_ms, latency_ms, dets
@@ -0,0 +1,140 @@
+# 估计K210与ESP32S3的时钟偏差, 计算拍照到舵机下发的端到端延迟
+#
+# ESP32S3串口监视器输入"lat log on"后, 每帧打印一行:
+#   T,frame_id,k210_capture_ms,k210_latency_ms,rx_start_us,rx_done_us,parsed_us,actuator_us
+# 前两个时间是K210时钟(ms), 其余是ESP32S3的micros()。
+#
+# 每帧的 rx_start - (capture + latency) = 时钟偏差 + 串口传输和读取等待(>=0),
+# 所以按时间窗口取最小值作为没有等待的样本, 再用最小二乘拟合直线得到偏差和漂移。
+#
+# 用法(在电脑上运行):
+#   python latency_offset.py --port COM5            # 直接读串口(需要pyserial), 自动发送"lat log on"
+#   python latency_offset.py --file capture.log     # 分析保存的串口日志
+import argparse
+import sys
+
+WRAP = 1 << 32
+BYTE_US = 10 * 1000000.0 / 115200  # 一个字节的传输时间
+
+
+def parse_line(line):
+    if not line.startswith('T,'):
+        return None
+    fields = line.strip().split(',')
+    if len(fields) != 8:
+        return None
+    try:
+        values = [int(v) for v in fields[1:]]
+    except ValueError:
+        return None
+    keys = ('frame_id', 'capture_ms', 'latency_ms', 'rx_start_us', 'rx_done_us', 'parsed_us', 'actuator_us')
+    return dict(zip(keys, values))
+
+
+def unwrap(records, key):
+    # 32位计数器回绕后继续递增
+    base = 0
+    last = None
+    for r in records:
+        v = r[key]
+        if last is not None and v + base < last - WRAP // 2:
+            base += WRAP
+        r[key] = v + base
+        last = r[key]
+
+
+def fit_offset(records, window_s):
+    # 每个窗口取偏差最小的一帧, 拟合 offset(t) = a + b * t, t为K210时间(s)
+    points = {}
+    for r in records:
+        t = (r['capture_ms'] + r['latency_ms']) / 1000.0
+        offset_ms = (r['rx_start_us'] - BYTE_US) / 1000.0 - (r['capture_ms'] + r['latency_ms'])
+        slot = int(t // window_s)
+        if slot not in points or offset_ms < points[slot][1]:
+            points[slot] = (t, offset_ms)
+
+    pts = sorted(points.values())
+    if len(pts) < 2:
+        return pts[0][1], 0.0
+    n = float(len(pts))
+    mean_t = sum(p[0] for p in pts) / n
+    mean_o = sum(p[1] for p in pts) / n
+    var = sum((p[0] - mean_t) ** 2 for p in pts)
+    slope = sum((p[0] - mean_t) * (p[1] - mean_o) for p in pts) / var if var > 0 else 0.0
+    return mean_o - slope * mean_t, slope
+
+
+def percentile(values, p):
+    values = sorted(values)
+    index = min(len(values) - 1, int(round(p / 100.0 * (len(values) - 1))))
+    return values[index]
+
+
+def report(records, window_s):
+    for key in ('capture_ms', 'rx_start_us', 'rx_done_us', 'parsed_us', 'actuator_us'):
+        unwrap(records, key)
+
+    intercept, slope = fit_offset(records, window_s)
+    print('frames: %d' % len(records))
+    print('clock offset: %.3f ms (ESP32 - K210), drift: %.1f ppm' % (intercept, slope / 1000.0 * 1e6))
+
+    stages = {'k210 (capture->tx)': [], 'uart (tx->rx done)': [], 'parse': [],
+              'actuator': [], 'total (capture->actuator)': []}
+    for r in records:
+        t = (r['capture_ms'] + r['latency_ms']) / 1000.0
+        offset_ms = intercept + slope * t
+        capture_us = (r['capture_ms'] + offset_ms) * 1000.0
+        tx_us = capture_us + r['latency_ms'] * 1000.0
+        stages['k210 (capture->tx)'].append(r['latency_ms'] * 1000.0)
+        stages['uart (tx->rx done)'].append(r['rx_done_us'] - tx_us)
+        stages['parse'].append(r['parsed_us'] - r['rx_done_us'])
+        stages['actuator'].append(r['actuator_us'] - r['parsed_us'])
+        stages['total (capture->actuator)'].append(r['actuator_us'] - capture_us)
+
+    print('%-26s %10s %10s %10s %10s (us)' % ('stage', 'min', 'p50', 'p90', 'max'))
+    for name in ('k210 (capture->tx)', 'uart (tx->rx done)', 'parse', 'actuator', 'total (capture->actuator)'):
+        v = stages[name]
+        print('%-26s %10.0f %10.0f %10.0f %10.0f' % (name, min(v), percentile(v, 50), percentile(v, 90), max(v)))
+
+
+def read_port(port, baud, count):
+    import serial
+    records = []
+    with serial.Serial(port, baud, timeout=1) as ser:
+        ser.write(b'lat log on\n')
+        while len(records) < count:
+            r = parse_line(ser.readline().decode('ascii', 'ignore'))
+            if r is not None:
+                records.append(r)
+                sys.stderr.write('\r%d/%d' % (len(records), count))
+        ser.write(b'lat log off\n')
+    sys.stderr.write('\n')
+    return records
+
+
+def main():
+    parser = argparse.ArgumentParser(description='K210/ESP32S3 clock offset and latency estimate')
+    parser.add_argument('--port', help='ESP32S3 USB serial port')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--file', help='saved serial log')
+    parser.add_argument('--count', type=int, default=500, help='frames to collect from --port')
+    parser.add_argument('--window', type=float, default=5.0, help='seconds per minimum-offset window')
+    args = parser.parse_args()
+
+    if args.file:
+        with open(args.file) as f:
+            records = [r for r in (parse_line(line) for line in f) if r is not None]
+    elif args.port:
+        records = read_port(args.port, args.baud, args.count)
+    else:
+        parser.error('need --port or --file')
+
+    if not records:
+        print('no "T," lines found')
+        return 1
+    report(records, args.window)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,460 @@
+// 云台跟踪闭环仿真: 在带延迟的摄像头和有滞后的舵机模型上对比track_control与原来的PID
+//
+// 只仿真水平轴(垂直轴相同)。模型:
+//   摄像头  按--fps拍照, 目标像素偏差 = (目标角度 - 拍照时舵机实际角度) / 每像素角度(42度/224像素),
+//           取整并加±--noise像素均匀噪声, 超出画面(±112像素)时本帧没有检测;
+//           检测在拍照后--delay ms到达ESP32S3(K210推理 + 串口传输)
+//   舵机    50Hz PWM, 每20ms锁存一次指令; 实际角度按--servo-tau ms一阶滞后跟随, 角速度不超过--servo-rate
+//   旧PID   ESP32_Number_Tracker.ino原来的trackObject(): 每收到一个检测运行一次, KP=0.1, KI=0.01,
+//           KD=0.05(按像素), 积分限幅±300, 舵机角度取整后用write()下发
+//   新控制器 track_control: 每10ms调用track_update, 检测到达时按已知延迟调用track_measure,
+//           本帧没有检测时调用track_lost; 角度按writeMicroseconds()的1us分辨率下发
+// 两者使用相同的检测, 原主循环中每次检测前的全屏OLED刷新(约27ms)和delay(10)不计入, 对旧PID有利。
+//
+// 场景:
+//   step10/step18  舵机在90度, 目标静止在80/72度(偏差10/18度)
+//   ramp           目标从60度以30度/秒移动到120度后停住: 移动中的误差, 停住后的稳定时间和超调
+//   sine           目标在90±15度以0.5Hz摆动: 跟踪误差
+// 稳定时间: 误差此后一直在±1度以内的时刻; 超调: 越过目标的最大角度。
+//
+// 编译(在本目录):
+//   g++ -O2 -std=c++11 -I../ESP32_Number_Tracker -o track_closed_loop track_closed_loop.cpp ../ESP32_Number_Tracker/track_control.cpp
+//
+// 用法:
+//   ./track_closed_loop                                  默认模型, 打印对比表
+//   ./track_closed_loop --fps 20 --delay 50              其他帧率和检测延迟
+//   ./track_closed_loop --servo-rate 200 --servo-tau 60  更慢的舵机
+//   ./track_closed_loop --sweep                          在36组帧率/延迟/舵机组合上汇总, 检查参数是否稳健
+//   ./track_closed_loop --lag 40 --beta 0.1 --sweep      调整新控制器参数(--alpha --beta --max-rate --lag --lead)
+//   ./track_closed_loop --trace out.csv                  输出每ms的目标和两个控制器的舵机角度
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "track_control.h"
+
+// 与ESP32_Number_Tracker.ino保持一致
+#define CENTER_X 112
+#define TRACK_PERIOD_MS 10
+#define SERVO_MIN_US 500
+#define SERVO_MAX_US 2500
+
+#define PWM_PERIOD_MS 20
+#define TRUE_DEG_PER_PX (-42.0 / 224.0) // 实际镜头, 控制器默认参数用-0.19
+#define SETTLE_BAND_DEG 1.0
+
+struct PlantConfig
+{
+    track_config_t track; // 新控制器参数, 默认为track_default_config()
+    double fps;
+    uint32_t delay_ms;
+    double servo_rate;
+    double servo_tau_ms;
+    double noise_px;
+};
+
+enum Controller
+{
+    CTRL_PID,
+    CTRL_TRACK,
+    CTRL_COUNT
+};
+
+static const char *controller_names[CTRL_COUNT] = {"old PID", "track_control"};
+
+struct Scenario
+{
+    const char *name;
+    double start_angle; // 舵机初始角度
+    uint32_t duration_ms;
+    uint32_t track_from_ms, track_to_ms;  // 统计跟踪误差的区间, 为0时不统计
+    uint32_t settle_from_ms;              // 从此刻起统计稳定时间和超调, 为UINT32_MAX时不统计
+    double (*target)(uint32_t t_ms);
+};
+
+struct Result
+{
+    double settle_ms; // <0表示没有稳定
+    double overshoot;
+    double rms;
+    double max_err;
+};
+
+static double target_step10(uint32_t) { return 80.0; }
+static double target_step18(uint32_t) { return 72.0; }
+
+static double target_ramp(uint32_t t)
+{
+    if (t < 500)
+        return 60.0;
+    if (t > 2500)
+        return 120.0;
+    return 60.0 + 30.0 * (t - 500) / 1000.0;
+}
+
+static double target_sine(uint32_t t)
+{
+    return 90.0 + 15.0 * sin(2.0 * M_PI * 0.5 * t / 1000.0);
+}
+
+static const Scenario scenarios[] = {
+    {"step10", 90.0, 3000, 0, 0, 0, target_step10},
+    {"step18", 90.0, 3000, 0, 0, 0, target_step18},
+    {"ramp", 60.0, 4500, 1000, 2500, 2500, target_ramp},
+    {"sine", 90.0, 6000, 1000, 6000, UINT32_MAX, target_sine},
+};
+
+static uint32_t g_rng = 1;
+
+static double rng_uniform(void)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng / 4294967296.0;
+}
+
+// 原trackObject()的单轴部分
+struct OldPid
+{
+    int servo_pos;
+    float integral;
+    float prev_error;
+};
+
+static void old_pid_detection(OldPid *pid, int target_x)
+{
+    float error = target_x - CENTER_X;
+    pid->integral += error;
+    float derivative = error - pid->prev_error;
+    pid->integral = pid->integral < -300 ? -300 : pid->integral > 300 ? 300 : pid->integral;
+    float adjust = 0.1f * error + 0.01f * pid->integral + 0.05f * derivative;
+    float pos = pid->servo_pos - adjust;
+    pid->servo_pos = (int)(pos < 0 ? 0 : pos > 180 ? 180 : pos); // constrain后赋给int, 小数被截掉
+    pid->prev_error = error;
+}
+
+struct Detection
+{
+    uint32_t capture_ms;
+    uint32_t arrive_ms;
+    bool seen;
+    int px;
+};
+
+static Result run(const Scenario &sc, Controller ctrl, const PlantConfig &plant, std::vector<double> *trace)
+{
+    g_rng = 12345; // 两个控制器使用相同的噪声序列
+
+    OldPid pid = {(int)sc.start_angle, 0.0f, 0.0f};
+    track_controller_t track;
+    track_init(&track, &plant.track, (float)sc.start_angle, 90.0f);
+
+    double cmd = sc.start_angle;     // 当前下发的角度(按PWM分辨率)
+    double latched = sc.start_angle; // 舵机锁存的指令
+    double pos = sc.start_angle;     // 舵机实际角度
+    std::vector<Detection> pending;
+    double frame_period = 1000.0 / plant.fps;
+    double next_capture = 0.0;
+
+    double sum_sq = 0.0, max_err = 0.0;
+    uint32_t n = 0, last_out = 0;
+    double overshoot = 0.0;
+    double settle_dir = 0.0;
+    if (sc.settle_from_ms != UINT32_MAX)
+    {
+        double goal = sc.target(sc.settle_from_ms);
+        settle_dir = sc.settle_from_ms == 0 ? (goal > sc.start_angle ? 1.0 : -1.0) : (goal > sc.target(0) ? 1.0 : -1.0);
+    }
+
+    for (uint32_t t = 0; t <= sc.duration_ms; t++)
+    {
+        double target = sc.target(t);
+
+        // 摄像头拍照
+        if (t >= next_capture)
+        {
+            next_capture += frame_period;
+            Detection d;
+            d.capture_ms = t;
+            d.arrive_ms = t + plant.delay_ms;
+            double px = (target - pos) / TRUE_DEG_PER_PX + (rng_uniform() * 2.0 - 1.0) * plant.noise_px;
+            d.px = (int)lround(px);
+            d.seen = abs(d.px) <= CENTER_X;
+            pending.push_back(d);
+        }
+
+        // 检测到达ESP32S3
+        while (!pending.empty() && pending.front().arrive_ms <= t)
+        {
+            const Detection &d = pending.front();
+            if (ctrl == CTRL_PID)
+            {
+                if (d.seen)
+                {
+                    old_pid_detection(&pid, CENTER_X + d.px);
+                    cmd = pid.servo_pos;
+                }
+            }
+            else if (d.seen)
+            {
+                track_measure(&track, (float)d.px, 0.0f, d.capture_ms);
+            }
+            else
+            {
+                track_lost(&track);
+            }
+            pending.erase(pending.begin());
+        }
+
+        // 跟踪任务
+        if (ctrl == CTRL_TRACK && t % TRACK_PERIOD_MS == 0)
+        {
+            track_update(&track, t, TRACK_PERIOD_MS / 1000.0f);
+            int us = SERVO_MIN_US + (int)(track.cmd_pan * (SERVO_MAX_US - SERVO_MIN_US) / 180.0f + 0.5f);
+            cmd = (us - SERVO_MIN_US) * 180.0 / (SERVO_MAX_US - SERVO_MIN_US);
+        }
+
+        // 舵机
+        if (t % PWM_PERIOD_MS == 0)
+            latched = cmd;
+        double rate = (latched - pos) / (plant.servo_tau_ms / 1000.0);
+        if (rate > plant.servo_rate)
+            rate = plant.servo_rate;
+        if (rate < -plant.servo_rate)
+            rate = -plant.servo_rate;
+        pos += rate / 1000.0;
+
+        // 统计
+        double err = target - pos;
+        if (sc.track_to_ms > 0 && t >= sc.track_from_ms && t <= sc.track_to_ms)
+        {
+            sum_sq += err * err;
+            if (fabs(err) > max_err)
+                max_err = fabs(err);
+            n++;
+        }
+        if (t >= sc.settle_from_ms)
+        {
+            if (fabs(err) > SETTLE_BAND_DEG)
+                last_out = t;
+            double over = settle_dir * (pos - target);
+            if (over > overshoot)
+                overshoot = over;
+        }
+        if (trace != NULL)
+            trace->push_back(pos);
+    }
+
+    Result r;
+    r.rms = n > 0 ? sqrt(sum_sq / n) : 0.0;
+    r.max_err = max_err;
+    r.overshoot = overshoot;
+    if (sc.settle_from_ms == UINT32_MAX)
+        r.settle_ms = 0.0;
+    else if (last_out + 200 >= sc.duration_ms)
+        r.settle_ms = -1.0; // 到结束前仍在±1度以外
+    else
+        r.settle_ms = last_out + 1.0 - sc.settle_from_ms;
+    return r;
+}
+
+// 按场景打印两个控制器的对比表
+static void print_table(const PlantConfig &plant, FILE *trace)
+{
+    printf("camera %.0f fps, detection delay %u ms, noise +-%.1f px; servo %.0f deg/s, tau %.0f ms, PWM %d ms\n",
+           plant.fps, plant.delay_ms, plant.noise_px, plant.servo_rate, plant.servo_tau_ms, PWM_PERIOD_MS);
+    printf("%-8s %-14s %10s %14s %9s %9s\n", "scenario", "controller", "settle_ms", "overshoot_deg", "rms_deg",
+           "max_deg");
+    for (const Scenario &sc : scenarios)
+    {
+        std::vector<double> paths[CTRL_COUNT];
+        for (int c = 0; c < CTRL_COUNT; c++)
+        {
+            Result r = run(sc, (Controller)c, plant, trace != NULL ? &paths[c] : NULL);
+            char settle[16], over[16], rms[16], max_err[16];
+            if (sc.settle_from_ms == UINT32_MAX)
+            {
+                strcpy(settle, "-");
+                strcpy(over, "-");
+            }
+            else
+            {
+                if (r.settle_ms < 0)
+                    strcpy(settle, "never");
+                else
+                    snprintf(settle, sizeof(settle), "%.0f", r.settle_ms);
+                snprintf(over, sizeof(over), "%.2f", r.overshoot);
+            }
+            if (sc.track_to_ms > 0)
+            {
+                snprintf(rms, sizeof(rms), "%.2f", r.rms);
+                snprintf(max_err, sizeof(max_err), "%.2f", r.max_err);
+            }
+            else
+            {
+                strcpy(rms, "-");
+                strcpy(max_err, "-");
+            }
+            printf("%-8s %-14s %10s %14s %9s %9s\n", sc.name, controller_names[c], settle, over, rms, max_err);
+        }
+        if (trace != NULL)
+        {
+            for (uint32_t t = 0; t <= sc.duration_ms; t++)
+                fprintf(trace, "%s,%u,%.3f,%.3f,%.3f\n", sc.name, t, sc.target(t), paths[CTRL_PID][t],
+                        paths[CTRL_TRACK][t]);
+        }
+    }
+}
+
+// 在一组帧率、检测延迟和舵机响应上运行全部场景, 汇总每个控制器的结果
+static void print_sweep(const PlantConfig &base)
+{
+    static const double fps_list[] = {10, 15, 20, 30};
+    static const uint32_t delay_list[] = {40, 70, 120};
+    static const double servo_list[][2] = {{350, 30}, {200, 60}, {600, 15}}; // 角速度, 时间常数
+
+    struct Summary
+    {
+        unsigned runs, never;
+        double settle, overshoot;
+        unsigned settled;
+        double rms;
+        unsigned tracked;
+    } sum[CTRL_COUNT];
+    memset(sum, 0, sizeof(sum));
+
+    unsigned plants = 0;
+    for (const double *servo : servo_list)
+    {
+        for (double fps : fps_list)
+        {
+            for (uint32_t delay : delay_list)
+            {
+                PlantConfig plant = base;
+                plant.fps = fps;
+                plant.delay_ms = delay;
+                plant.servo_rate = servo[0];
+                plant.servo_tau_ms = servo[1];
+                plants++;
+                for (const Scenario &sc : scenarios)
+                {
+                    for (int c = 0; c < CTRL_COUNT; c++)
+                    {
+                        Result r = run(sc, (Controller)c, plant, NULL);
+                        Summary &s = sum[c];
+                        if (sc.settle_from_ms != UINT32_MAX)
+                        {
+                            s.runs++;
+                            s.overshoot += r.overshoot;
+                            if (r.settle_ms < 0)
+                            {
+                                s.never++;
+                            }
+                            else
+                            {
+                                s.settle += r.settle_ms;
+                                s.settled++;
+                            }
+                        }
+                        if (sc.track_to_ms > 0)
+                        {
+                            s.rms += r.rms;
+                            s.tracked++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    printf("%u plants: camera 10-30 fps, delay 40-120 ms, servo 200-600 deg/s with tau 15-60 ms\n", plants);
+    printf("%-14s %16s %15s %14s %13s\n", "controller", "never_settled", "mean_settle_ms", "mean_over_deg",
+           "mean_rms_deg");
+    for (int c = 0; c < CTRL_COUNT; c++)
+    {
+        const Summary &s = sum[c];
+        char never[24];
+        snprintf(never, sizeof(never), "%u/%u", s.never, s.runs);
+        printf("%-14s %16s %15.0f %14.2f %13.2f\n", controller_names[c], never,
+               s.settled ? s.settle / s.settled : 0.0, s.overshoot / s.runs, s.rms / s.tracked);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    PlantConfig plant;
+    track_default_config(&plant.track);
+    plant.fps = 15.0;
+    plant.delay_ms = 70;
+    plant.servo_rate = 350.0;
+    plant.servo_tau_ms = 30.0;
+    plant.noise_px = 1.0;
+    const char *trace_path = NULL;
+    bool sweep = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+            plant.fps = atof(argv[++i]);
+        else if (strcmp(argv[i], "--delay") == 0 && i + 1 < argc)
+            plant.delay_ms = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--servo-rate") == 0 && i + 1 < argc)
+            plant.servo_rate = atof(argv[++i]);
+        else if (strcmp(argv[i], "--servo-tau") == 0 && i + 1 < argc)
+            plant.servo_tau_ms = atof(argv[++i]);
+        else if (strcmp(argv[i], "--noise") == 0 && i + 1 < argc)
+            plant.noise_px = atof(argv[++i]);
+        else if (strcmp(argv[i], "--alpha") == 0 && i + 1 < argc)
+            plant.track.alpha = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--beta") == 0 && i + 1 < argc)
+            plant.track.beta = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--max-rate") == 0 && i + 1 < argc)
+            plant.track.max_rate = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--lag") == 0 && i + 1 < argc)
+            plant.track.servo_lag_ms = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--lead") == 0 && i + 1 < argc)
+            plant.track.lead_ms = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--sweep") == 0)
+            sweep = true;
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            trace_path = argv[++i];
+        else
+        {
+            fprintf(stderr,
+                    "usage: %s [--fps 15] [--delay 70] [--servo-rate 350] [--servo-tau 30] [--noise 1] "
+                    "[--alpha a] [--beta b] [--max-rate r] [--lag ms] [--lead ms] [--sweep] [--trace out.csv]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (plant.fps <= 0.0 || plant.servo_rate <= 0.0 || plant.servo_tau_ms <= 0.0)
+    {
+        fprintf(stderr, "fps, servo-rate and servo-tau must be positive\n");
+        return 2;
+    }
+
+    if (sweep)
+    {
+        print_sweep(plant);
+        return 0;
+    }
+
+    FILE *trace = NULL;
+    if (trace_path != NULL)
+    {
+        trace = fopen(trace_path, "w");
+        if (trace == NULL)
+        {
+            perror(trace_path);
+            return 1;
+        }
+        fprintf(trace, "scenario,time_ms,target,pid,track\n");
+    }
+    print_table(plant, trace);
+    if (trace != NULL)
+        fclose(trace);
+    return 0;
+}
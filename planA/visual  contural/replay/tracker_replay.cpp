@@ -0,0 +1,337 @@
+// K210串口数据离线回放
+//
+// 读取ESP32S3捕获模式("cap on")保存的日志, 按与ESP32_Number_Tracker.ino相同的流程
+// 把原始字节送入解析器、多目标跟踪和云台控制器, 跟踪控制器按10ms虚拟周期运行。
+// 输出吞吐量、每帧处理耗时, 并可把控制器输出写成CSV, 用于修改解析和跟踪代码后的离线对比。
+//
+// 编译(在本目录):
+//   g++ -O2 -std=c++11 -I../ESP32_Number_Tracker -o tracker_replay tracker_replay.cpp ../ESP32_Number_Tracker/*.cpp
+//
+// 用法:
+//   ./tracker_replay capture.log                   最快速度回放
+//   ./tracker_replay capture.log --speed 1         按接收时间实时回放
+//   ./tracker_replay capture.log --trace out.csv   输出控制器轨迹
+//   ./tracker_replay capture.log --repeat 20       重复回放, 用于稳定的耗时统计
+//
+// 日志中"R,接收时间us,十六进制数据"以外的行都被忽略, 可以直接保存整个串口监视器输出。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "k210_parser.h"
+#include "k210_frame.h"
+#include "target_tracks.h"
+#include "track_control.h"
+#include "latency_stats.h"
+
+// 与ESP32_Number_Tracker.ino保持一致
+#define CENTER_X 112
+#define CENTER_Y 112
+#define TRACK_PERIOD_MS 10
+#define K210_TEXT_LATENCY_MS 60
+#define SERIAL_BAUD 115200
+
+typedef std::chrono::steady_clock replay_clock;
+
+struct Chunk
+{
+    uint32_t rx_us;
+    std::vector<uint8_t> data;
+};
+
+// 与.ino中的全局变量对应
+struct Pipeline
+{
+    k210_parser_t parser;
+    k210_frame_decoder_t decoder;
+    target_tracks_t tracks;
+    track_controller_t tracker;
+    bool binary_mode;
+    uint8_t locked_id;
+    bool object_detected;
+    bool target_seen;
+    int target_x;
+    int target_y;
+    uint32_t capture_ms;
+    uint16_t frame_id;
+};
+
+static void pipeline_init(Pipeline *p)
+{
+    memset(p, 0, sizeof(*p));
+    k210_parser_reset(&p->parser);
+    k210_frame_decoder_reset(&p->decoder);
+    target_tracks_init(&p->tracks, NULL);
+    track_init(&p->tracker, NULL, 90, 90);
+    p->target_x = CENTER_X;
+    p->target_y = CENTER_Y;
+}
+
+// updateTargets()
+static void update_targets(Pipeline *p, const k210_frame_det_t *dets, uint8_t count, uint32_t now_ms, uint32_t age_ms)
+{
+    p->capture_ms = now_ms - age_ms;
+    target_tracks_update(&p->tracks, dets, count, p->capture_ms);
+
+    const target_track_t *track = target_tracks_lock(&p->tracks, &p->locked_id);
+    p->object_detected = track != NULL;
+    p->target_seen = track != NULL && track->last_seen == p->capture_ms;
+    if (p->target_seen)
+    {
+        p->target_x = track->x + track->width / 2;
+        p->target_y = track->y + track->height / 2;
+    }
+}
+
+// readDataFromK210()中一段数据的处理, 返回完成的帧数
+static uint32_t feed_chunk(Pipeline *p, const Chunk *c)
+{
+    uint32_t now_ms = c->rx_us / 1000;
+    uint32_t completed = 0;
+    k210_detection_t det;
+    k210_frame_t frame;
+
+    for (size_t i = 0; i < c->data.size(); i++)
+    {
+        uint8_t byte = c->data[i];
+        if (k210_frame_decoder_feed(&p->decoder, byte, &frame))
+        {
+            p->binary_mode = true;
+            uint32_t frame_bytes = K210_FRAME_HEADER_LEN + K210_FRAME_DET_LEN * frame.count + K210_FRAME_CRC_LEN;
+            uint32_t age_ms = frame.latency_ms + frame_bytes * 10 * 1000 / SERIAL_BAUD;
+            update_targets(p, frame.dets, frame.count, now_ms, age_ms);
+            p->frame_id = frame.frame_id;
+            completed++;
+            continue;
+        }
+        if (p->binary_mode)
+            continue;
+
+        if (k210_parser_feed(&p->parser, byte, &det) == K210_PARSE_DETECTION)
+        {
+            k210_frame_det_t d;
+            d.class_id = det.class_id < 0 ? (uint8_t)det.number : det.class_id; // 与主程序一致
+            d.number = (uint8_t)det.number;
+            d.confidence = det.confidence < 0 ? 0 : (uint8_t)(det.confidence * 255);
+            d.x = det.x;
+            d.y = det.y;
+            d.width = det.width;
+            d.height = det.height;
+            update_targets(p, &d, 1, now_ms, K210_TEXT_LATENCY_MS);
+            completed++;
+        }
+    }
+    return completed;
+}
+
+// trackObject()
+static bool track_object(Pipeline *p)
+{
+    if (!p->object_detected)
+    {
+        track_lost(&p->tracker);
+        return false;
+    }
+    if (!p->target_seen)
+        return false;
+    track_measure(&p->tracker, p->target_x - CENTER_X, p->target_y - CENTER_Y, p->capture_ms);
+    return true;
+}
+
+static bool parse_hex(const char *s, std::vector<uint8_t> *out)
+{
+    out->clear();
+    while (s[0] != '\0' && s[0] != '\n' && s[0] != '\r')
+    {
+        unsigned int value;
+        if (s[1] == '\0' || sscanf(s, "%2x", &value) != 1)
+            return false;
+        out->push_back((uint8_t)value);
+        s += 2;
+    }
+    return !out->empty();
+}
+
+static bool load_capture(const char *path, std::vector<Chunk> *chunks)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+        return false;
+
+    char line[512];
+    uint32_t last_us = 0;
+    uint32_t out_of_order = 0;
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        if (strncmp(line, "R,", 2) != 0)
+            continue;
+        char *end;
+        unsigned long rx = strtoul(line + 2, &end, 10);
+        if (*end != ',')
+            continue;
+
+        Chunk c;
+        if (!parse_hex(end + 1, &c.data))
+            continue;
+        // 时间用32位, micros()回绕后的比较与设备一致
+        c.rx_us = (uint32_t)rx;
+        if (!chunks->empty() && (int32_t)(c.rx_us - last_us) < 0)
+            out_of_order++;
+        last_us = c.rx_us;
+        chunks->push_back(c);
+    }
+    fclose(f);
+    if (out_of_order > 0)
+        fprintf(stderr, "warning: %u chunks out of order\n", out_of_order);
+    return true;
+}
+
+static void print_hist(const char *name, const latency_hist_t *h)
+{
+    printf("%-12s %8u %8u %8u %8u %8u %8u %8u\n", name, h->count,
+           h->count ? h->min_us : 0, h->count ? (uint32_t)(h->sum_us / h->count) : 0,
+           latency_hist_percentile(h, 50), latency_hist_percentile(h, 90),
+           latency_hist_percentile(h, 99), h->max_us);
+}
+
+static uint32_t elapsed_ns(replay_clock::time_point start)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(replay_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    const char *trace_path = NULL;
+    double speed = 0.0;
+    int repeat = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+            speed = atof(argv[++i]);
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            trace_path = argv[++i];
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = atoi(argv[++i]);
+        else if (path == NULL && argv[i][0] != '-')
+            path = argv[i];
+        else
+            repeat = 0;
+    }
+    if (path == NULL || repeat < 1)
+    {
+        fprintf(stderr, "usage: %s capture.log [--speed x] [--trace out.csv] [--repeat n]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<Chunk> chunks;
+    if (!load_capture(path, &chunks))
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+    if (chunks.empty())
+    {
+        fprintf(stderr, "no \"R,\" lines in %s\n", path);
+        return 1;
+    }
+
+    FILE *trace = NULL;
+    if (trace_path != NULL)
+    {
+        trace = fopen(trace_path, "w");
+        if (trace == NULL)
+        {
+            fprintf(stderr, "cannot write %s\n", trace_path);
+            return 1;
+        }
+        fprintf(trace, "time_ms,event,frame_id,track_id,target_x,target_y,pan,tilt\n");
+    }
+
+    // 耗时单位为ns
+    latency_hist_t frame_cost, tick_cost;
+    latency_hist_reset(&frame_cost);
+    latency_hist_reset(&tick_cost);
+    uint64_t bytes = 0, frames = 0, measurements = 0;
+    uint64_t busy_ns = 0;
+    Pipeline p;
+
+    for (int r = 0; r < repeat; r++)
+    {
+        pipeline_init(&p);
+        uint32_t first_us = chunks[0].rx_us;
+        uint32_t next_tick_us = first_us;
+        uint32_t pending_ns = 0;  // 上一帧完成后累计的解析耗时
+        replay_clock::time_point wall_start = replay_clock::now();
+
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            const Chunk *c = &chunks[i];
+
+            // 跟踪任务在这段数据之前应运行的周期
+            while ((int32_t)(c->rx_us - next_tick_us) >= 0)
+            {
+                replay_clock::time_point t0 = replay_clock::now();
+                track_update(&p.tracker, next_tick_us / 1000, TRACK_PERIOD_MS / 1000.0f);
+                uint32_t ns = elapsed_ns(t0);
+                latency_hist_add(&tick_cost, ns);
+                busy_ns += ns;
+                if (trace != NULL && r == 0)
+                    fprintf(trace, "%u,U,%u,%u,%d,%d,%.3f,%.3f\n", next_tick_us / 1000, p.frame_id, p.locked_id,
+                            p.target_x, p.target_y, p.tracker.cmd_pan, p.tracker.cmd_tilt);
+                next_tick_us += TRACK_PERIOD_MS * 1000;
+            }
+
+            if (speed > 0.0)
+            {
+                std::chrono::microseconds offset((long long)((c->rx_us - first_us) / speed));
+                std::this_thread::sleep_until(wall_start + offset);
+            }
+
+            replay_clock::time_point t0 = replay_clock::now();
+            uint32_t completed = feed_chunk(&p, c);
+            bool measured = completed > 0 && track_object(&p);
+            uint32_t ns = elapsed_ns(t0);
+
+            busy_ns += ns;
+            pending_ns += ns;
+            bytes += c->data.size();
+            if (completed > 0)
+            {
+                frames += completed;
+                latency_hist_add(&frame_cost, pending_ns / completed);
+                pending_ns = 0;
+            }
+            if (measured)
+            {
+                measurements++;
+                if (trace != NULL && r == 0)
+                    fprintf(trace, "%u,M,%u,%u,%d,%d,%.3f,%.3f\n", c->rx_us / 1000, p.frame_id, p.locked_id,
+                            p.target_x, p.target_y, p.tracker.cmd_pan, p.tracker.cmd_tilt);
+            }
+        }
+    }
+    if (trace != NULL)
+        fclose(trace);
+
+    double span_s = (uint32_t)(chunks.back().rx_us - chunks[0].rx_us) / 1e6;
+    double busy_s = busy_ns / 1e9;
+    printf("chunks: %u, bytes: %llu, capture: %.1f s, repeat: %d\n", (unsigned)chunks.size(),
+           (unsigned long long)(bytes / repeat), span_s, repeat);
+    printf("frames: %llu, measurements: %llu, binary: %s\n", (unsigned long long)(frames / repeat),
+           (unsigned long long)(measurements / repeat), p.binary_mode ? "yes" : "no");
+    printf("crc errors: %u, header errors: %u, lost frames: %u, text errors: %u\n", p.decoder.crc_errors,
+           p.decoder.header_errors, p.decoder.lost_frames, p.parser.errors);
+    printf("tracks created: %u, expired: %u\n", p.tracks.created, p.tracks.expired);
+    if (busy_s > 0.0)
+        printf("throughput: %.2f MB/s, %.0f frames/s (processing time only)\n", bytes / busy_s / 1e6, frames / busy_s);
+    printf("%-12s %8s %8s %8s %8s %8s %8s %8s (ns)\n", "cost", "count", "min", "avg", "p50", "p90", "p99", "max");
+    print_hist("frame", &frame_cost);
+    print_hist("track tick", &tick_cost);
+    return 0;
+}
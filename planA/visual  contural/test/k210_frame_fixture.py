@@ -0,0 +1,90 @@
+# 用K210端的k210_frame.py生成二进制帧测试数据, 供k210_frame_test.cpp检查ESP32S3端解码器
+#
+# 输出(默认fixtures/k210_frames.bin和.expected):
+#   .bin       字节流: 按K210_Detection_Sender.py的方式编码的帧, 中间混入随机垃圾、文本状态行、
+#              被截断的帧和改坏一个字节的帧; 帧序号从65530开始(跨过回绕), 中间有跳号
+#   .expected  每个应解码出的帧一行: frame_id capture_ms latency_ms count, 再跟count组
+#              class_id number confidence x y w h; 最后一行"corrupted 改坏的帧数 lost 丢帧数"
+# 期望值用k210_frame.decode_frame从编码结果解回, 所以同时检查了Python端自身的往返。
+#
+# 用法(在本目录, 修改帧格式后重新生成并提交):
+#   python k210_frame_fixture.py [--seed 1] [--frames 300] [--out fixtures/k210_frames]
+import argparse
+import os
+import random
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+import k210_frame  # noqa: E402
+
+
+def random_dets(rng):
+    # 偶尔超过8个(编码时截断)和超出16位的坐标(编码时限幅)
+    count = rng.choice([0, 0, 1, 1, 1, 2, 3, 5, 8, 10])
+    dets = []
+    for _ in range(count):
+        wide = rng.random() < 0.05
+        coord = (lambda: rng.randint(-100000, 100000)) if wide else (lambda: rng.randint(-20, 340))
+        classid = rng.randint(0, 9)
+        dets.append((classid, k210_frame.label_number(str(classid) if rng.random() < 0.5 else 'digit', classid),
+                     rng.random(), coord(), coord(), coord(), coord()))
+    return dets
+
+
+def main():
+    parser = argparse.ArgumentParser(description='generate K210 binary frame fixtures with k210_frame.py')
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--frames', type=int, default=300)
+    parser.add_argument('--out', default=os.path.join('fixtures', 'k210_frames'))
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    stream = bytearray()
+    expected = []
+    corrupted = 0
+    frame_id = 65530
+    capture_ms = 4294960000  # 跨过ticks_ms的32位回绕
+    for _ in range(args.frames):
+        frame_id = (frame_id + (rng.randint(2, 4) if rng.random() < 0.03 else 1)) & 0xFFFF
+        capture_ms = (capture_ms + rng.randint(30, 80)) & 0xFFFFFFFF
+        data = k210_frame.encode_frame(frame_id, capture_ms, rng.randint(0, 120), random_dets(rng))
+
+        r = rng.random()
+        if r < 0.05:
+            stream += bytes(rng.randint(0, 255) for _ in range(rng.randint(1, 40)))
+        elif r < 0.08:
+            stream += b'K210 ready\r\n'
+        elif r < 0.11:
+            stream += data[:rng.randint(1, len(data) - 1)]  # 发送中途复位的帧
+
+        if rng.random() < 0.05:
+            bad = bytearray(data)
+            bad[rng.randint(2, len(bad) - 1)] ^= 1 << rng.randint(0, 7)
+            stream += bad
+            corrupted += 1
+            continue
+        stream += data
+        expected.append(k210_frame.decode_frame(data))
+
+    # 按解码器的规则计算丢帧数: 序号跳变小于1000时计入
+    lost = 0
+    for prev, cur in zip(expected, expected[1:]):
+        gap = (cur[0] - prev[0] - 1) & 0xFFFF
+        if gap < 1000:
+            lost += gap
+
+    with open(args.out + '.bin', 'wb') as f:
+        f.write(stream)
+    with open(args.out + '.expected', 'w') as f:
+        for fid, cap, lat, dets in expected:
+            fields = [fid, cap, lat, len(dets)]
+            for classid, number, conf, x, y, w, h in dets:
+                fields += [classid, number, int(round(conf * 255)), x, y, w, h]
+            f.write(' '.join(str(v) for v in fields) + '\n')
+        f.write('corrupted %d lost %d\n' % (corrupted, lost))
+    print('%s.bin: %d bytes, %d frames, %d corrupted, %d lost' % (args.out, len(stream), len(expected), corrupted, lost))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,275 @@
+// K210二进制检测帧的往返测试: Python编码 -> C++解码, C++编码 -> C++解码, 以及出错后的重新同步
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../ESP32_Number_Tracker -I../../test -o k210_frame_test k210_frame_test.cpp ../ESP32_Number_Tracker/k210_frame.cpp
+//   ./k210_frame_test [fixtures/k210_frames] [随机种子]
+//
+// 检查:
+//   - CRC与CRC-16/CCITT-FALSE的标准校验值一致("123456789" -> 0x29B1)
+//   - fixtures/k210_frames.bin(k210_frame_fixture.py用k210_frame.py生成, 混有垃圾、截断帧和坏帧)
+//     逐字节解码后得到的帧与.expected完全一致, 坏帧全部丢弃, 丢帧数一致
+//   - 随机帧经k210_frame_encode编码后解码得到相同的内容, count超过8时截断
+//   - 随机垃圾、截断帧和单比特错误之后, 紧跟的完好帧在最后一个字节到达时就能解出
+//     (垃圾碰巧通过CRC的假帧除外, 只统计其比例)
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "k210_frame.h"
+#include "test_util.h"
+
+static bool same_frame(const k210_frame_t &a, const k210_frame_t &b)
+{
+    if (a.count != b.count || a.frame_id != b.frame_id || a.capture_ms != b.capture_ms ||
+        a.latency_ms != b.latency_ms)
+        return false;
+    for (uint8_t i = 0; i < a.count; i++)
+    {
+        const k210_frame_det_t &x = a.dets[i], &y = b.dets[i];
+        if (x.class_id != y.class_id || x.number != y.number || x.confidence != y.confidence || x.x != y.x ||
+            x.y != y.y || x.width != y.width || x.height != y.height)
+            return false;
+    }
+    return true;
+}
+
+static void test_crc(void)
+{
+    const char *check = "123456789";
+    uint16_t crc = k210_frame_crc16((const uint8_t *)check, 9);
+    CHECK(crc == 0x29B1, "crc16(\"123456789\") = 0x%04X", crc);
+}
+
+static bool load_expected(const char *path, std::vector<k210_frame_t> &frames, unsigned *corrupted, unsigned *lost)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+        return false;
+    char line[1024];
+    bool done = false;
+    while (fgets(line, sizeof(line), f))
+    {
+        if (sscanf(line, "corrupted %u lost %u", corrupted, lost) == 2)
+        {
+            done = true;
+            break;
+        }
+        k210_frame_t fr;
+        memset(&fr, 0, sizeof(fr));
+        char *p = line;
+        unsigned long v[4];
+        for (int i = 0; i < 4; i++)
+            v[i] = strtoul(p, &p, 10);
+        fr.frame_id = (uint16_t)v[0];
+        fr.capture_ms = (uint32_t)v[1];
+        fr.latency_ms = (uint16_t)v[2];
+        fr.count = (uint8_t)v[3];
+        for (uint8_t i = 0; i < fr.count && i < K210_FRAME_MAX_DETS; i++)
+        {
+            k210_frame_det_t &d = fr.dets[i];
+            d.class_id = (uint8_t)strtol(p, &p, 10);
+            d.number = (uint8_t)strtol(p, &p, 10);
+            d.confidence = (uint8_t)strtol(p, &p, 10);
+            d.x = (int16_t)strtol(p, &p, 10);
+            d.y = (int16_t)strtol(p, &p, 10);
+            d.width = (int16_t)strtol(p, &p, 10);
+            d.height = (int16_t)strtol(p, &p, 10);
+        }
+        frames.push_back(fr);
+    }
+    fclose(f);
+    return done;
+}
+
+static void test_python_fixture(const std::string &base)
+{
+    std::vector<k210_frame_t> expected;
+    unsigned corrupted = 0, lost = 0;
+    if (!load_expected((base + ".expected").c_str(), expected, &corrupted, &lost))
+    {
+        CHECK(false, "cannot read %s.expected", base.c_str());
+        return;
+    }
+    FILE *f = fopen((base + ".bin").c_str(), "rb");
+    if (f == NULL)
+    {
+        CHECK(false, "cannot read %s.bin", base.c_str());
+        return;
+    }
+    std::vector<uint8_t> stream;
+    int c;
+    while ((c = fgetc(f)) != EOF)
+        stream.push_back((uint8_t)c);
+    fclose(f);
+
+    k210_frame_decoder_t decoder;
+    k210_frame_decoder_reset(&decoder);
+    size_t got = 0;
+    for (uint8_t byte : stream)
+    {
+        k210_frame_t frame;
+        if (!k210_frame_decoder_feed(&decoder, byte, &frame))
+            continue;
+        if (got < expected.size())
+            CHECK(same_frame(frame, expected[got]), "frame %u differs from Python (expected frame_id %u)",
+                  frame.frame_id, expected[got].frame_id);
+        got++;
+    }
+    CHECK(got == expected.size(), "decoded %u frames, expected %u", (unsigned)got, (unsigned)expected.size());
+    CHECK(decoder.crc_errors >= corrupted, "%u crc errors for %u corrupted frames", decoder.crc_errors, corrupted);
+    CHECK(decoder.lost_frames == lost, "lost_frames %u, expected %u", decoder.lost_frames, lost);
+    printf("%s.bin: %u bytes, %u frames, crc errors %u (%u corrupted), header errors %u, lost %u\n", base.c_str(),
+           (unsigned)stream.size(), (unsigned)got, decoder.crc_errors, corrupted, decoder.header_errors,
+           decoder.lost_frames);
+}
+
+static void random_frame(k210_frame_t *fr, uint16_t frame_id)
+{
+    memset(fr, 0, sizeof(*fr));
+    fr->count = rng_next() % (K210_FRAME_MAX_DETS + 1);
+    fr->frame_id = frame_id;
+    fr->capture_ms = rng_next();
+    fr->latency_ms = (uint16_t)rng_next();
+    for (uint8_t i = 0; i < fr->count; i++)
+    {
+        k210_frame_det_t &d = fr->dets[i];
+        d.class_id = (uint8_t)rng_next();
+        d.number = (uint8_t)rng_next();
+        d.confidence = (uint8_t)rng_next();
+        d.x = (int16_t)rng_next();
+        d.y = (int16_t)rng_next();
+        d.width = (int16_t)rng_next();
+        d.height = (int16_t)rng_next();
+    }
+}
+
+static void test_round_trip(int rounds)
+{
+    k210_frame_decoder_t decoder;
+    k210_frame_decoder_reset(&decoder);
+    for (int i = 0; i < rounds; i++)
+    {
+        k210_frame_t in, out;
+        uint8_t buf[K210_FRAME_MAX_LEN];
+        random_frame(&in, (uint16_t)i);
+        uint8_t len = k210_frame_encode(&in, buf);
+        CHECK(len == K210_FRAME_HEADER_LEN + K210_FRAME_DET_LEN * in.count + K210_FRAME_CRC_LEN, "length %u", len);
+        bool done = false;
+        for (uint8_t j = 0; j < len; j++)
+        {
+            CHECK(!done, "frame completed early at byte %u", j);
+            done = k210_frame_decoder_feed(&decoder, buf[j], &out);
+        }
+        CHECK(done && same_frame(in, out), "round trip of frame %d failed", i);
+    }
+
+    // count超过上限时只编码前8个
+    k210_frame_t in, out;
+    random_frame(&in, 1);
+    in.count = K210_FRAME_MAX_DETS;
+    k210_frame_t over = in;
+    over.count = K210_FRAME_MAX_DETS + 3;
+    uint8_t buf[K210_FRAME_MAX_LEN];
+    uint8_t len = k210_frame_encode(&over, buf);
+    bool done = false;
+    k210_frame_decoder_reset(&decoder);
+    for (uint8_t j = 0; j < len; j++)
+        done = k210_frame_decoder_feed(&decoder, buf[j], &out);
+    CHECK(len == K210_FRAME_MAX_LEN && done && same_frame(in, out), "count > max not truncated");
+    printf("round trip: %d frames\n", rounds);
+}
+
+static void test_resync(int rounds)
+{
+    k210_frame_decoder_t decoder;
+    k210_frame_decoder_reset(&decoder);
+    unsigned good = 0, missed = 0, damaged = 0, false_frames = 0;
+    for (int i = 0; i < rounds; i++)
+    {
+        k210_frame_t in, out;
+        uint8_t buf[K210_FRAME_MAX_LEN];
+        random_frame(&in, (uint16_t)i);
+        uint8_t len = k210_frame_encode(&in, buf);
+
+        // 帧前的干扰: 垃圾(可能含同步字)、截断帧或单比特错误
+        switch (rng_next() % 4)
+        {
+        case 0:
+        {
+            int n = rng_next() % 64;
+            for (int j = 0; j < n; j++)
+            {
+                uint8_t byte = rng_next() % 8 == 0 ? K210_FRAME_SYNC1 : (uint8_t)rng_next();
+                k210_frame_decoder_feed(&decoder, byte, &out);
+                if (byte == K210_FRAME_SYNC1 && rng_next() % 2 == 0)
+                    k210_frame_decoder_feed(&decoder, K210_FRAME_SYNC2, &out);
+            }
+            break;
+        }
+        case 1:
+        {
+            k210_frame_t cut;
+            uint8_t cut_buf[K210_FRAME_MAX_LEN];
+            random_frame(&cut, 0);
+            uint8_t cut_len = k210_frame_encode(&cut, cut_buf);
+            uint8_t n = 1 + rng_next() % (cut_len - 1);
+            for (uint8_t j = 0; j < n; j++)
+                k210_frame_decoder_feed(&decoder, cut_buf[j], &out);
+            break;
+        }
+        case 2:
+        {
+            // 发送一份改坏一位的副本, 不应被接受
+            uint8_t bad[K210_FRAME_MAX_LEN];
+            memcpy(bad, buf, len);
+            bad[2 + rng_next() % (len - 2)] ^= 1 << (rng_next() % 8);
+            bool accepted = false;
+            for (uint8_t j = 0; j < len; j++)
+                accepted |= k210_frame_decoder_feed(&decoder, bad[j], &out);
+            CHECK(!accepted, "corrupted copy of frame %d accepted", i);
+            damaged++;
+            break;
+        }
+        default:
+            break;
+        }
+
+        bool done = false;
+        for (uint8_t j = 0; j < len; j++)
+        {
+            if (k210_frame_decoder_feed(&decoder, buf[j], &out))
+            {
+                if (same_frame(in, out))
+                    done = true;
+                else
+                    false_frames++;
+            }
+        }
+        good++;
+        missed += !done;
+    }
+    // 垃圾中的假帧头偶尔能通过16位CRC(约1/65536), 假帧可能吞掉后面真帧的开头字节;
+    // 除此之外每个完好的帧都必须立即解出
+    CHECK(missed <= false_frames, "%u intact frames lost, only %u false frames accepted", missed, false_frames);
+    CHECK(false_frames * 5000 <= (unsigned)rounds, "%u false frames accepted in %d rounds", false_frames, rounds);
+    printf("resync: %u intact frames after noise, %u lost, %u corrupted copies rejected, %u garbage frames passed "
+           "CRC, header errors %u, crc errors %u\n",
+           good, missed, damaged, false_frames, decoder.header_errors, decoder.crc_errors);
+}
+
+int main(int argc, char **argv)
+{
+    std::string base = argc > 1 ? argv[1] : "fixtures/k210_frames";
+    if (argc > 2)
+        rng_seed(argv[2]);
+    printf("seed %u\n", (unsigned)g_rng);
+    test_crc();
+    test_python_fixture(base);
+    test_round_trip(100000);
+    test_resync(100000);
+    return test_summary();
+}
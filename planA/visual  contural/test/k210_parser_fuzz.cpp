@@ -0,0 +1,252 @@
+// K210文本解析器的模糊测试: 随机字节流、变异的检测结果行和重新同步
+//
+// 编译并运行(在本目录, 带地址/未定义行为检查):
+//   g++ -O1 -g -std=c++11 -fsanitize=address,undefined -I../ESP32_Number_Tracker -I../../test -o k210_parser_fuzz k210_parser_fuzz.cpp ../ESP32_Number_Tracker/k210_parser.cpp
+//   ./k210_parser_fuzz [轮数] [随机种子]
+//
+// 检查:
+//   - 任意字节流: 返回值只有K210_PARSE_xxx, 行缓冲区不越界, detections/errors计数与返回值一致
+//   - 随机生成的合法行(含空白、正负号、超出16位的数值): 解析结果与按格式定义计算的结果一致
+//   - 合法行经随机变异(改/插/删字节)后: 若仍解析为检测结果, 置信度在[0,1]内,
+//     且把结果重新格式化再解析得到相同的值
+//   - 任意垃圾之后跟一个换行, 下一行合法数据能正确解析
+// 失败时打印出错的行, 返回1; 开头打印的种子可用于复现。
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "k210_parser.h"
+#include "test_util.h"
+
+static int32_t rng_range(int32_t lo, int32_t hi)
+{
+    return lo + (int32_t)(rng_next() % (uint32_t)(hi - lo + 1));
+}
+
+static int16_t clamp16(int64_t v)
+{
+    return v > 32767 ? 32767 : v < -32768 ? -32768 : (int16_t)v;
+}
+
+// 喂入一行(自动加换行), 返回换行处的结果
+static uint8_t feed_line(k210_parser_t *parser, const std::string &line, k210_detection_t *det)
+{
+    for (char c : line)
+        k210_parser_feed(parser, (uint8_t)c, det);
+    return k210_parser_feed(parser, '\n', det);
+}
+
+static bool same(const k210_detection_t &a, const k210_detection_t &b)
+{
+    return a.number == b.number && a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height &&
+           a.class_id == b.class_id && fabsf(a.confidence - b.confidence) < 1e-4f;
+}
+
+// 随机整数字段: 通常为小数值, 偶尔超出16位范围, 可带空白和正号
+static std::string int_field(int64_t *value)
+{
+    int64_t v = rng_next() % 8 == 0 ? rng_range(-999999999, 999999999) : rng_range(-50, 400);
+    *value = v;
+    std::string s;
+    if (rng_next() % 6 == 0)
+        s += ' ';
+    if (v >= 0 && rng_next() % 8 == 0)
+        s += '+';
+    s += std::to_string((long long)v);
+    if (rng_next() % 6 == 0)
+        s += '\t';
+    return s;
+}
+
+// 生成一行合法数据和期望的解析结果
+static std::string valid_line(k210_detection_t *want)
+{
+    int64_t v[5];
+    std::string line;
+    if (rng_next() % 2 == 0)
+    {
+        for (int i = 0; i < 5; i++)
+            line += (i ? "," : "") + int_field(&v[i]);
+        want->number = clamp16(v[0]);
+        want->x = clamp16(v[1]);
+        want->y = clamp16(v[2]);
+        want->width = clamp16(v[3]);
+        want->height = clamp16(v[4]);
+        want->class_id = -1;
+        want->confidence = -1.0f;
+    }
+    else
+    {
+        for (int i = 0; i < 5; i++)
+            line += int_field(&v[i]) + ":";
+        int conf = rng_range(0, 100);
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%d.%02d", conf / 100, conf % 100);
+        line += std::string(buf) + ":";
+        want->x = clamp16(v[0]);
+        want->y = clamp16(v[1]);
+        want->width = clamp16(v[2]);
+        want->height = clamp16(v[3]);
+        want->class_id = clamp16(v[4]);
+        want->confidence = conf / 100.0f;
+        if (rng_next() % 2 == 0)
+        {
+            int label = rng_range(0, 9);
+            line += std::to_string(label);
+            want->number = (int16_t)label;
+        }
+        else
+        {
+            line += "digit";
+            want->number = clamp16(v[4] + 1);
+        }
+    }
+    if (rng_next() % 4 == 0)
+        line += '\r';
+    return line;
+}
+
+// 把解析结果写回冒号/逗号格式
+static std::string format(const k210_detection_t &d)
+{
+    char buf[128];
+    if (d.class_id == -1 && d.confidence == -1.0f)
+        snprintf(buf, sizeof(buf), "%d,%d,%d,%d,%d", d.number, d.x, d.y, d.width, d.height);
+    else
+        snprintf(buf, sizeof(buf), "%d:%d:%d:%d:%d:%.6f:%d", d.x, d.y, d.width, d.height, d.class_id, d.confidence,
+                 d.number);
+    return buf;
+}
+
+static void fuzz_bytes(int rounds)
+{
+    k210_parser_t parser;
+    k210_parser_reset(&parser);
+    uint32_t detections = 0, errors = 0;
+    for (int i = 0; i < rounds; i++)
+    {
+        // 字节集中在格式相关的字符上, 更容易走到各个分支; 偶尔插入一行合法数据
+        static const char alphabet[] = "0123456789,:.-+ \t\r\nK210abc";
+        std::string chunk;
+        if (rng_next() % 64 == 0)
+        {
+            k210_detection_t want;
+            chunk = valid_line(&want) + '\n';
+        }
+        else
+        {
+            chunk += rng_next() % 4 == 0 ? (char)rng_next() : alphabet[rng_next() % (sizeof(alphabet) - 1)];
+        }
+        for (char c : chunk)
+        {
+            k210_detection_t det;
+            uint8_t ret = k210_parser_feed(&parser, (uint8_t)c, &det);
+            CHECK(ret <= K210_PARSE_ERROR, "bad return %u", ret);
+            CHECK(parser.len <= K210_PARSER_LINE_MAX, "line length %u", parser.len);
+            detections += ret == K210_PARSE_DETECTION;
+            errors += ret == K210_PARSE_ERROR;
+        }
+    }
+    CHECK(parser.detections == detections && parser.errors == errors, "counters %u/%u, returns %u/%u",
+          (unsigned)parser.detections, (unsigned)parser.errors, (unsigned)detections, (unsigned)errors);
+    printf("random bytes: %d chunks, %u detections, %u errors\n", rounds, (unsigned)detections, (unsigned)errors);
+}
+
+static void fuzz_valid_lines(int rounds)
+{
+    k210_parser_t parser;
+    k210_parser_reset(&parser);
+    for (int i = 0; i < rounds; i++)
+    {
+        k210_detection_t want, got;
+        std::string line = valid_line(&want);
+        uint8_t ret = feed_line(&parser, line, &got);
+        bool fits = line.size() <= K210_PARSER_LINE_MAX;
+        if (fits)
+            CHECK(ret == K210_PARSE_DETECTION && same(got, want), "line \"%s\" -> %u \"%s\"", line.c_str(), ret,
+                  ret == K210_PARSE_DETECTION ? format(got).c_str() : "");
+        else
+            CHECK(ret == K210_PARSE_ERROR, "overlong line \"%s\" -> %u", line.c_str(), ret);
+    }
+    printf("valid lines: %d lines, %u detections\n", rounds, (unsigned)parser.detections);
+}
+
+static void fuzz_mutations(int rounds)
+{
+    k210_parser_t parser, check;
+    k210_parser_reset(&parser);
+    k210_parser_reset(&check);
+    uint32_t still_valid = 0;
+    for (int i = 0; i < rounds; i++)
+    {
+        k210_detection_t want, got, again;
+        std::string line = valid_line(&want);
+        int edits = rng_range(1, 3);
+        for (int e = 0; e < edits && !line.empty(); e++)
+        {
+            size_t pos = rng_next() % line.size();
+            char c = "0123456789,:.- x\t"[rng_next() % 17];
+            switch (rng_next() % 3)
+            {
+            case 0:
+                line[pos] = c;
+                break;
+            case 1:
+                line.insert(line.begin() + pos, c);
+                break;
+            default:
+                line.erase(pos, 1);
+                break;
+            }
+        }
+        if (feed_line(&parser, line, &got) != K210_PARSE_DETECTION)
+            continue;
+        still_valid++;
+        CHECK(got.confidence == -1.0f || (got.confidence >= 0.0f && got.confidence <= 1.0f),
+              "mutated \"%s\" -> confidence %g", line.c_str(), got.confidence);
+        std::string text = format(got);
+        CHECK(feed_line(&check, text, &again) == K210_PARSE_DETECTION && same(got, again),
+              "mutated \"%s\" -> \"%s\" does not re-parse", line.c_str(), text.c_str());
+    }
+    printf("mutated lines: %d lines, %u still parse as detections\n", rounds, (unsigned)still_valid);
+}
+
+static void fuzz_resync(int rounds)
+{
+    k210_parser_t parser;
+    k210_parser_reset(&parser);
+    for (int i = 0; i < rounds; i++)
+    {
+        int n = rng_range(0, 200); // 可能超过行缓冲区
+        for (int j = 0; j < n; j++)
+        {
+            k210_detection_t det;
+            uint8_t byte = (uint8_t)rng_next();
+            k210_parser_feed(&parser, byte == '\n' ? 'x' : byte, &det);
+        }
+        k210_detection_t det, want, got;
+        k210_parser_feed(&parser, '\n', &det);
+        std::string line = valid_line(&want);
+        if (line.size() > K210_PARSER_LINE_MAX)
+            continue;
+        CHECK(feed_line(&parser, line, &got) == K210_PARSE_DETECTION && same(got, want),
+              "no resync after %d garbage bytes: \"%s\"", n, line.c_str());
+    }
+    printf("resync: %d garbage runs\n", rounds);
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = argc > 1 ? atoi(argv[1]) : 200000;
+    if (argc > 2)
+        rng_seed(argv[2]);
+    printf("seed %u\n", (unsigned)g_rng);
+    fuzz_bytes(rounds * 10);
+    fuzz_valid_lines(rounds);
+    fuzz_mutations(rounds);
+    fuzz_resync(rounds / 10);
+    return test_summary();
+}
@@ -0,0 +1,250 @@
+// OLED局部刷新的主机端测试: 每帧发送的字节数和屏幕内容的一致性
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../ESP32_Number_Tracker -I../../test -o oled_dirty_test oled_dirty_test.cpp ../ESP32_Number_Tracker/oled_dirty.cpp
+//   ./oled_dirty_test [随机种子]
+//
+// 发送回调写入模拟的屏幕显存, 并按ESP32_Number_Tracker.ino中oledWriteRange的方式估算I2C线上字节数
+// (每段6个寻址命令各3字节, 显存每64字节一次传输, 每次另加地址和控制字节)。检查:
+//   - 第一次和invalidate之后全屏发送, 内容不变时不发送, 改一个像素只发送1字节, 同页两处变化合并为一段
+//   - 随机修改后屏幕与显存一致, 发送字节数等于每页首尾变化列之间的列数之和
+//   - 按updateDisplay()的布局(标题、数字、位置、舵机角度、轨迹ID、位置指示图)绘制目标移动的300帧,
+//     打印每帧平均发送字节数和线上字节数, 与每帧全屏发送对比
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "oled_dirty.h"
+#include "test_util.h"
+
+#define SCREEN_BYTES (OLED_DIRTY_WIDTH * OLED_DIRTY_PAGES)
+#define I2C_CHUNK 64 // 与ESP32_Number_Tracker.ino的OLED_I2C_CHUNK相同
+
+// 模拟的SSD1306
+typedef struct
+{
+    uint8_t ram[SCREEN_BYTES];
+    uint32_t calls;
+    uint32_t data_bytes;
+    uint32_t wire_bytes;
+} mock_screen_t;
+
+static void mock_write(void *ctx, uint8_t page, uint8_t column, const uint8_t *data, uint8_t len)
+{
+    mock_screen_t *screen = (mock_screen_t *)ctx;
+    CHECK(page < OLED_DIRTY_PAGES && column + len <= OLED_DIRTY_WIDTH && len > 0, "bad range page %u col %u len %u",
+          page, column, len);
+    memcpy(screen->ram + page * OLED_DIRTY_WIDTH + column, data, len);
+    screen->calls++;
+    screen->data_bytes += len;
+    screen->wire_bytes += 6 * 3 + len + 2 * ((len + I2C_CHUNK - 1) / I2C_CHUNK);
+}
+
+static void mock_reset_counts(mock_screen_t *screen)
+{
+    screen->calls = screen->data_bytes = screen->wire_bytes = 0;
+}
+
+static void set_pixel(uint8_t *buf, int x, int y)
+{
+    if (x >= 0 && x < OLED_DIRTY_WIDTH && y >= 0 && y < OLED_DIRTY_PAGES * 8)
+        buf[(y / 8) * OLED_DIRTY_WIDTH + x] |= 1 << (y & 7);
+}
+
+static void test_basic(void)
+{
+    oled_dirty_t oled;
+    mock_screen_t screen;
+    uint8_t buf[SCREEN_BYTES];
+    memset(&screen, 0, sizeof(screen));
+    memset(buf, 0, sizeof(buf));
+    oled_dirty_init(&oled);
+
+    CHECK(oled_dirty_flush(&oled, buf, mock_write, &screen) == SCREEN_BYTES && screen.calls == OLED_DIRTY_PAGES,
+          "first flush sent %u bytes in %u ranges", screen.data_bytes, screen.calls);
+    mock_reset_counts(&screen);
+    CHECK(oled_dirty_flush(&oled, buf, mock_write, &screen) == 0 && screen.calls == 0, "unchanged frame sent %u bytes",
+          screen.data_bytes);
+
+    set_pixel(buf, 77, 45);
+    mock_reset_counts(&screen);
+    CHECK(oled_dirty_flush(&oled, buf, mock_write, &screen) == 1 && screen.calls == 1, "one pixel sent %u bytes",
+          screen.data_bytes);
+
+    set_pixel(buf, 3, 18);
+    set_pixel(buf, 100, 20);
+    mock_reset_counts(&screen);
+    CHECK(oled_dirty_flush(&oled, buf, mock_write, &screen) == 98 && screen.calls == 1,
+          "two changes on one page sent %u bytes in %u ranges", screen.data_bytes, screen.calls);
+
+    oled_dirty_invalidate(&oled);
+    mock_reset_counts(&screen);
+    CHECK(oled_dirty_flush(&oled, buf, mock_write, &screen) == SCREEN_BYTES, "flush after invalidate sent %u bytes",
+          screen.data_bytes);
+    CHECK(memcmp(screen.ram, buf, SCREEN_BYTES) == 0, "screen differs from buffer");
+    CHECK(oled.flushes == 5 && oled.bytes_sent == 2 * SCREEN_BYTES + 1 + 98, "counters: %u flushes, %u bytes",
+          oled.flushes, oled.bytes_sent);
+}
+
+static void test_random(int rounds)
+{
+    oled_dirty_t oled;
+    mock_screen_t screen;
+    uint8_t buf[SCREEN_BYTES];
+    memset(&screen, 0, sizeof(screen));
+    for (int i = 0; i < SCREEN_BYTES; i++)
+        buf[i] = (uint8_t)rng_next();
+    oled_dirty_init(&oled);
+    oled_dirty_flush(&oled, buf, mock_write, &screen);
+
+    for (int r = 0; r < rounds; r++)
+    {
+        uint8_t before[SCREEN_BYTES];
+        memcpy(before, buf, SCREEN_BYTES);
+        int edits = rng_next() % 12;
+        for (int e = 0; e < edits; e++)
+            buf[rng_next() % SCREEN_BYTES] ^= (uint8_t)(1 << (rng_next() % 8));
+
+        // 参考: 每页首尾变化列之间的列数
+        uint16_t want = 0;
+        for (int page = 0; page < OLED_DIRTY_PAGES; page++)
+        {
+            int first = -1, last = -1;
+            for (int col = 0; col < OLED_DIRTY_WIDTH; col++)
+            {
+                int idx = page * OLED_DIRTY_WIDTH + col;
+                if (buf[idx] != before[idx])
+                {
+                    if (first < 0)
+                        first = col;
+                    last = col;
+                }
+            }
+            if (first >= 0)
+                want += last - first + 1;
+        }
+
+        mock_reset_counts(&screen);
+        uint16_t sent = oled_dirty_flush(&oled, buf, mock_write, &screen);
+        CHECK(sent == want && screen.data_bytes == want, "round %d: sent %u bytes, expected %u", r, sent, want);
+        CHECK(memcmp(screen.ram, buf, SCREEN_BYTES) == 0, "round %d: screen differs from buffer", r);
+    }
+    printf("random edits: %d frames\n", rounds);
+}
+
+// 简化的6x8字体: 每个字符5列, 列图案由字符决定, 只用来产生与真实字体相近的变化范围
+static int draw_text(uint8_t *buf, int x, int y, const char *text)
+{
+    for (; *text; text++, x += 6)
+    {
+        if (*text == ' ')
+            continue;
+        for (int c = 0; c < 5; c++)
+        {
+            uint8_t bits = (uint8_t)((*text * 37 + c * 11) ^ (*text >> 1)) & 0x7F;
+            for (int b = 0; b < 7; b++)
+                if (bits & (1 << b))
+                    set_pixel(buf, x + c, y + b);
+        }
+    }
+    return x;
+}
+
+// 按updateDisplay()的布局绘制一帧
+static void render(uint8_t *buf, bool detected, int number, int tx, int ty, int sx, int sy, int id, int tracks)
+{
+    char line[48];
+    memset(buf, 0, SCREEN_BYTES);
+    draw_text(buf, 0, 0, "Number Tracking");
+    for (int x = 0; x < OLED_DIRTY_WIDTH; x++)
+        set_pixel(buf, x, 10);
+    if (!detected)
+    {
+        draw_text(buf, 0, 24, "Waiting for detection...");
+        return;
+    }
+    snprintf(line, sizeof(line), "Number: %d", number);
+    draw_text(buf, 0, 16, line);
+    snprintf(line, sizeof(line), "ID:%d Tracks:%d", id, tracks);
+    draw_text(buf, 0, 52, line);
+    snprintf(line, sizeof(line), "Pos: X=%d Y=%d", tx, ty);
+    draw_text(buf, 0, 28, line);
+    snprintf(line, sizeof(line), "Servo: X=%d Y=%d", sx, sy);
+    draw_text(buf, 0, 40, line);
+    for (int i = 0; i < 38; i++)
+    {
+        set_pixel(buf, 90 + i, 16);
+        set_pixel(buf, 90 + i, 53);
+        set_pixel(buf, 90, 16 + i);
+        set_pixel(buf, 127, 16 + i);
+    }
+    int cx = 90 + tx * 38 / 224, cy = 16 + ty * 38 / 224;
+    cx = cx < 92 ? 92 : cx > 126 ? 126 : cx;
+    cy = cy < 18 ? 18 : cy > 52 ? 52 : cy;
+    for (int dy = -2; dy <= 2; dy++)
+        for (int dx = -2; dx <= 2; dx++)
+            if (dx * dx + dy * dy <= 5)
+                set_pixel(buf, cx + dx, cy + dy);
+}
+
+static void test_tracker_frames(int frames)
+{
+    oled_dirty_t oled;
+    mock_screen_t screen;
+    uint8_t buf[SCREEN_BYTES];
+    memset(&screen, 0, sizeof(screen));
+    oled_dirty_init(&oled);
+
+    render(buf, false, 0, 0, 0, 0, 0, 0, 0);
+    oled_dirty_flush(&oled, buf, mock_write, &screen);
+    uint32_t full_wire = screen.wire_bytes;
+    mock_reset_counts(&screen);
+
+    // 目标在画面中缓慢移动, 舵机跟随; 偶尔丢失目标或换一个数字
+    int tx = 40, ty = 100, vx = 3, vy = 1, number = 3, id = 1;
+    uint32_t max_bytes = 0;
+    for (int f = 0; f < frames; f++)
+    {
+        tx += vx + (int)(rng_next() % 3) - 1;
+        ty += vy + (int)(rng_next() % 3) - 1;
+        if (tx < 10 || tx > 214)
+            vx = -vx;
+        if (ty < 10 || ty > 214)
+            vy = -vy;
+        bool detected = rng_next() % 50 != 0;
+        if (rng_next() % 100 == 0)
+        {
+            number = rng_next() % 10;
+            id++;
+        }
+        render(buf, detected, number, tx, ty, 90 + (tx - 112) / 4, 90 + (ty - 112) / 4, id, 1 + (int)(rng_next() % 2));
+
+        uint32_t before = screen.data_bytes;
+        oled_dirty_flush(&oled, buf, mock_write, &screen);
+        uint32_t sent = screen.data_bytes - before;
+        if (sent > max_bytes)
+            max_bytes = sent;
+        CHECK(memcmp(screen.ram, buf, SCREEN_BYTES) == 0, "frame %d: screen differs from buffer", f);
+    }
+
+    double avg = (double)screen.data_bytes / frames, avg_wire = (double)screen.wire_bytes / frames;
+    // 每帧只有数值和指示点变化, 平均应明显少于全屏
+    CHECK(avg < SCREEN_BYTES / 2, "average %.0f bytes per frame", avg);
+    printf("tracker screen: %d frames, %.0f bytes/frame (max %u, full %u), %.1f ranges/frame, "
+           "I2C ~%.0f bytes/frame vs %u full (%.0f%%), ~%.1f ms at 400 kHz vs %.1f ms\n",
+           frames, avg, max_bytes, SCREEN_BYTES, (double)screen.calls / frames, avg_wire, full_wire,
+           100.0 * avg_wire / full_wire, avg_wire * 9 / 400.0, full_wire * 9 / 400.0);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        rng_seed(argv[1]);
+    printf("seed %u\n", (unsigned)g_rng);
+    test_basic();
+    test_random(20000);
+    test_tracker_frames(300);
+    return test_summary();
+}
@@ -0,0 +1,231 @@
+// 多目标跟踪的合成场景测试和基准: 轨迹ID唯一性、按类别关联, 以及不同拥挤程度下的ID切换和耗时
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../ESP32_Number_Tracker -I../../test -o target_tracks_test target_tracks_test.cpp ../ESP32_Number_Tracker/target_tracks.cpp
+//   ./target_tracks_test [随机种子]
+//
+// 检查:
+//   - 轨迹ID回绕(新建超过255条)后, 同时存在的轨迹ID不重复, 一直存在的轨迹保持ID和锁定
+//   - 同一位置类别不同的检测不关联到同一轨迹; 同一类别识别出的数字变化时仍是同一轨迹
+//   - 合成场景(1-8个框在224x224画面内移动、反弹、交叉, 带漏检、位置噪声和误检):
+//     每帧存在的轨迹ID不重复, 稀疏场景中没有ID切换
+// 场景结果打印为表格: 每帧耗时(ns)、ID切换次数、新建轨迹数和真实目标的命中率。
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "target_tracks.h"
+#include "test_util.h"
+
+static k210_frame_det_t make_det(uint8_t class_id, uint8_t number, int16_t x, int16_t y)
+{
+    k210_frame_det_t d;
+    memset(&d, 0, sizeof(d));
+    d.class_id = class_id;
+    d.number = number;
+    d.confidence = 200;
+    d.x = x;
+    d.y = y;
+    d.width = 40;
+    d.height = 50;
+    return d;
+}
+
+// 存在的轨迹ID两两不同且不为0
+static bool ids_unique(const target_tracks_t *tracks)
+{
+    bool seen[256] = {false};
+    for (uint8_t i = 0; i < TARGET_TRACKS_MAX; i++)
+    {
+        const target_track_t *t = &tracks->tracks[i];
+        if (!t->active)
+            continue;
+        if (t->id == 0 || seen[t->id])
+            return false;
+        seen[t->id] = true;
+    }
+    return true;
+}
+
+static void test_id_wrap(void)
+{
+    target_tracks_t tracks;
+    target_tracks_init(&tracks, NULL);
+
+    // 一个固定不动的目标一直存在, 另一个目标每帧换一个类别, 每帧新建一条轨迹
+    uint8_t locked = 0;
+    uint8_t first_id = 0;
+    for (uint32_t frame = 0; frame < 1000; frame++)
+    {
+        k210_frame_det_t dets[2];
+        dets[0] = make_det(3, 3, 20, 20);
+        dets[1] = make_det((uint8_t)(10 + frame % 200), 5, 100, 120);
+        target_tracks_update(&tracks, dets, 2, frame * 66);
+        const target_track_t *lock = target_tracks_lock(&tracks, &locked);
+        if (frame == 1)
+            first_id = locked;
+        CHECK(ids_unique(&tracks), "duplicate track ID at frame %u", frame);
+        if (frame >= 1)
+            CHECK(lock != NULL && lock->id == first_id && lock->class_id == 3,
+                  "lock moved from %u to %u at frame %u", first_id, lock != NULL ? lock->id : 0, frame);
+    }
+    CHECK(tracks.created > 600, "only %u tracks created", tracks.created);
+    printf("id wrap: %u tracks created, long-lived track kept id %u\n", tracks.created, first_id);
+}
+
+static void test_class_association(void)
+{
+    target_tracks_t tracks;
+    target_tracks_init(&tracks, NULL);
+
+    // 同一位置两个类别: 两条轨迹
+    k210_frame_det_t dets[2] = {make_det(1, 7, 50, 50), make_det(2, 7, 52, 50)};
+    for (uint32_t frame = 0; frame < 5; frame++)
+        target_tracks_update(&tracks, dets, 2, frame * 66);
+    CHECK(target_tracks_count(&tracks) == 2, "%u tracks for two classes", target_tracks_count(&tracks));
+    CHECK(tracks.created == 2, "%u tracks created for two classes", tracks.created);
+
+    // 同一类别识别出的数字改变: 仍是原轨迹, 数字更新
+    target_tracks_init(&tracks, NULL);
+    k210_frame_det_t det = make_det(4, 4, 80, 80);
+    target_tracks_update(&tracks, &det, 1, 0);
+    det.number = 9;
+    det.x += 3;
+    target_tracks_update(&tracks, &det, 1, 66);
+    CHECK(tracks.created == 1, "%u tracks after number change", tracks.created);
+    CHECK(target_tracks_find_number(&tracks, 9) != NULL, "track number not updated");
+    printf("class association: ok\n");
+}
+
+/* ---------------- 合成场景 ---------------- */
+
+typedef struct
+{
+    const char *name;
+    int objects;      // 真实目标个数
+    int classes;      // 类别个数(少于目标数时有同类别目标交叉)
+    float speed;      // 最大速度(像素/秒)
+    float miss;       // 漏检概率
+    float noise;      // 框位置噪声(±像素)
+    float false_rate; // 每帧出现一个误检的概率
+    int max_switches; // 允许的ID切换次数, -1表示只统计
+} scene_t;
+
+static const scene_t scenes[] = {
+    {"sparse", 2, 2, 60, 0.05f, 1, 0.0f, 0},
+    {"typical", 4, 4, 120, 0.10f, 2, 0.05f, -1},
+    {"crowded", 8, 4, 150, 0.15f, 3, 0.10f, -1},
+    {"fast", 4, 4, 400, 0.10f, 2, 0.05f, -1},
+};
+
+typedef struct
+{
+    float x, y, vx, vy;
+    uint8_t class_id;
+    uint8_t last_id; // 上一次检测关联到的轨迹ID, 0表示还没有
+} object_t;
+
+#define SCENE_FRAMES 20000
+#define FRAME_MS 66
+#define VIEW 224
+
+static void run_scene(const scene_t &sc)
+{
+    std::vector<object_t> objects(sc.objects);
+    for (object_t &o : objects)
+    {
+        o.x = rng_uniform(0, VIEW - 40);
+        o.y = rng_uniform(0, VIEW - 50);
+        o.vx = rng_uniform(-sc.speed, sc.speed);
+        o.vy = rng_uniform(-sc.speed, sc.speed);
+        o.class_id = (uint8_t)((&o - &objects[0]) % sc.classes);
+        o.last_id = 0;
+    }
+
+    target_tracks_t tracks;
+    target_tracks_init(&tracks, NULL);
+    unsigned switches = 0, detected = 0, matched = 0;
+    double total_ns = 0;
+
+    for (uint32_t frame = 0; frame < SCENE_FRAMES; frame++)
+    {
+        uint32_t now = frame * FRAME_MS;
+        k210_frame_det_t dets[K210_FRAME_MAX_DETS];
+        int owner[K210_FRAME_MAX_DETS]; // 检测对应的真实目标, -1为误检
+        uint8_t count = 0;
+
+        for (size_t k = 0; k < objects.size(); k++)
+        {
+            object_t &o = objects[k];
+            o.x += o.vx * FRAME_MS / 1000.0f;
+            o.y += o.vy * FRAME_MS / 1000.0f;
+            if (o.x < 0 || o.x > VIEW - 40)
+                o.vx = -o.vx;
+            if (o.y < 0 || o.y > VIEW - 50)
+                o.vy = -o.vy;
+            if (rng_uniform(0, 1) < sc.miss || count >= K210_FRAME_MAX_DETS)
+                continue;
+            dets[count] = make_det(o.class_id, o.class_id, (int16_t)lroundf(o.x + rng_uniform(-sc.noise, sc.noise)),
+                                   (int16_t)lroundf(o.y + rng_uniform(-sc.noise, sc.noise)));
+            owner[count++] = (int)k;
+        }
+        if (count < K210_FRAME_MAX_DETS && rng_uniform(0, 1) < sc.false_rate)
+        {
+            dets[count] = make_det((uint8_t)(rng_next() % 10), 0, (int16_t)(rng_next() % VIEW),
+                                   (int16_t)(rng_next() % VIEW));
+            owner[count++] = -1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        target_tracks_update(&tracks, dets, count, now);
+        total_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        CHECK(ids_unique(&tracks), "%s: duplicate track ID at frame %u", sc.name, frame);
+
+        // 找出每个真实目标的检测被关联(或新建)到的轨迹
+        for (uint8_t j = 0; j < count; j++)
+        {
+            if (owner[j] < 0)
+                continue;
+            detected++;
+            for (uint8_t i = 0; i < TARGET_TRACKS_MAX; i++)
+            {
+                const target_track_t *t = &tracks.tracks[i];
+                if (!t->active || t->last_seen != now || t->class_id != dets[j].class_id || t->x != dets[j].x ||
+                    t->y != dets[j].y)
+                    continue;
+                object_t &o = objects[owner[j]];
+                matched++;
+                if (o.last_id != 0 && o.last_id != t->id)
+                    switches++;
+                o.last_id = t->id;
+                break;
+            }
+        }
+    }
+
+    printf("%-8s %7d %7.0f %8u %8u %9.1f%% %10.0f\n", sc.name, sc.objects, sc.speed, switches, tracks.created,
+           detected ? 100.0 * matched / detected : 0.0, total_ns / SCENE_FRAMES);
+    if (sc.max_switches >= 0)
+        CHECK((int)switches <= sc.max_switches, "%s: %u id switches", sc.name, switches);
+    CHECK(matched == detected, "%s: %u of %u detections not in any track", sc.name, detected - matched, detected);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        rng_seed(argv[1]);
+    printf("seed %u\n", (unsigned)g_rng);
+    test_id_wrap();
+    test_class_association();
+    printf("%-8s %7s %7s %8s %8s %10s %10s\n", "scene", "objects", "speed", "switches", "created", "matched",
+           "ns/frame");
+    for (const scene_t &sc : scenes)
+        run_scene(sc);
+    return test_summary();
+}
@@ -0,0 +1,170 @@
+// 跟踪参数名称表的主机端测试: 串口命令、范围检查和保存文本的往返
+//
+// 编译并运行(在本目录):
+//   g++ -O2 -std=c++11 -I../ESP32_Number_Tracker -I../../test -o track_params_test track_params_test.cpp ../ESP32_Number_Tracker/track_params.cpp ../ESP32_Number_Tracker/track_control.cpp
+//   ./track_params_test
+//
+// 检查:
+//   - track_config_t的每个字段都能按名称读写, 读出的值与字段相同
+//   - 未知名称、格式错误、超出范围、coast_ms带小数、角度下限大于上限均报错且参数不变
+//   - 修改后保存的文本(track save写入NVS的内容)解析回默认参数上, 得到相同的参数;
+//     解析时出错的行跳过, 其余行照常生效
+//   - 串口命令: track列出全部参数、track get/set、"track.名称 = 值 # 注释"、track reset, 未知命令报错
+// 全部通过时返回0, 否则打印失败项并返回1。
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "track_params.h"
+#include "test_util.h"
+
+static bool same_config(const track_config_t *a, const track_config_t *b)
+{
+    return a->alpha == b->alpha && a->beta == b->beta && a->deg_per_px_x == b->deg_per_px_x &&
+           a->deg_per_px_y == b->deg_per_px_y && a->max_rate == b->max_rate && a->lead_ms == b->lead_ms &&
+           a->servo_lag_ms == b->servo_lag_ms && a->coast_ms == b->coast_ms && a->min_angle == b->min_angle &&
+           a->max_angle == b->max_angle;
+}
+
+static void test_fields(void)
+{
+    track_config_t config;
+    char buf[32];
+    track_default_config(&config);
+
+    // 每个字段设置一个不同于默认值的值
+    CHECK(track_params_set(&config, "track.alpha", "0.45") == TRACK_PARAMS_EOK && config.alpha == 0.45f, "alpha");
+    CHECK(track_params_set(&config, "track.beta", "0.1") == TRACK_PARAMS_EOK && config.beta == 0.1f, "beta");
+    CHECK(track_params_set(&config, "track.deg_per_px_x", "0.2") == TRACK_PARAMS_EOK && config.deg_per_px_x == 0.2f,
+          "deg_per_px_x");
+    CHECK(track_params_set(&config, "track.deg_per_px_y", "-0.18") == TRACK_PARAMS_EOK &&
+              config.deg_per_px_y == -0.18f,
+          "deg_per_px_y");
+    CHECK(track_params_set(&config, "track.max_rate", "350") == TRACK_PARAMS_EOK && config.max_rate == 350.0f,
+          "max_rate");
+    CHECK(track_params_set(&config, "track.lead_ms", "35.5") == TRACK_PARAMS_EOK && config.lead_ms == 35.5f,
+          "lead_ms");
+    CHECK(track_params_set(&config, "track.servo_lag_ms", "45") == TRACK_PARAMS_EOK && config.servo_lag_ms == 45.0f,
+          "servo_lag_ms");
+    CHECK(track_params_set(&config, "track.coast_ms", "800") == TRACK_PARAMS_EOK && config.coast_ms == 800,
+          "coast_ms");
+    CHECK(track_params_set(&config, "track.min_angle", "10") == TRACK_PARAMS_EOK && config.min_angle == 10.0f,
+          "min_angle");
+    CHECK(track_params_set(&config, "track.max_angle", "170") == TRACK_PARAMS_EOK && config.max_angle == 170.0f,
+          "max_angle");
+    CHECK(track_params_get(&config, "track.lead_ms", buf, sizeof(buf)) == TRACK_PARAMS_EOK &&
+              strcmp(buf, "35.5") == 0,
+          "get lead_ms: %s", buf);
+    CHECK(track_params_get(&config, "track.coast_ms", buf, sizeof(buf)) == TRACK_PARAMS_EOK && strcmp(buf, "800") == 0,
+          "get coast_ms: %s", buf);
+
+    // 错误不改变参数
+    track_config_t before = config;
+    CHECK(track_params_set(&config, "track.gain", "1") == TRACK_PARAMS_ENOTFOUND, "unknown name");
+    CHECK(track_params_get(&config, "alpha", buf, sizeof(buf)) == TRACK_PARAMS_ENOTFOUND, "name without prefix");
+    CHECK(track_params_set(&config, "track.alpha", "fast") == TRACK_PARAMS_EINVAL, "text value");
+    CHECK(track_params_set(&config, "track.alpha", "") == TRACK_PARAMS_EINVAL, "empty value");
+    CHECK(track_params_set(&config, "track.alpha", "0.5x") == TRACK_PARAMS_EINVAL, "trailing text");
+    CHECK(track_params_set(&config, "track.alpha", "nan") == TRACK_PARAMS_EINVAL, "nan");
+    CHECK(track_params_set(&config, "track.alpha", "1.5") == TRACK_PARAMS_ERANGE, "alpha above 1");
+    CHECK(track_params_set(&config, "track.max_rate", "0") == TRACK_PARAMS_ERANGE, "zero max_rate");
+    CHECK(track_params_set(&config, "track.coast_ms", "12.5") == TRACK_PARAMS_EINVAL, "fractional coast_ms");
+    CHECK(track_params_set(&config, "track.coast_ms", "-1") == TRACK_PARAMS_ERANGE, "negative coast_ms");
+    CHECK(track_params_set(&config, "track.min_angle", "175") == TRACK_PARAMS_ERANGE, "min above max");
+    CHECK(track_params_set(&config, "track.max_angle", "5") == TRACK_PARAMS_ERANGE, "max below min");
+    CHECK(same_config(&config, &before), "failed set changed the config");
+    printf("fields: ok\n");
+}
+
+static void test_text_round_trip(void)
+{
+    track_config_t config, loaded;
+    char text[512];
+    track_default_config(&config);
+    config.alpha = 0.55f;
+    config.lead_ms = 27.25f;
+    config.coast_ms = 650;
+    config.deg_per_px_x = 0.17f;
+
+    // track save写入NVS的文本, 开机时解析到默认参数上
+    size_t len = track_params_format(&config, text, sizeof(text), false);
+    CHECK(len > 0 && len == strlen(text), "format length %u", (unsigned)len);
+    track_default_config(&loaded);
+    CHECK(track_params_parse_text(&loaded, text) == TRACK_PARAMS_EOK, "parse saved text");
+    CHECK(same_config(&loaded, &config), "saved text did not round-trip:\n%s", text);
+
+    // 带注释的详细列表同样可以解析
+    CHECK(track_params_format(&config, text, sizeof(text), true) > 0 && strstr(text, "default 0.6") != NULL,
+          "detail listing:\n%s", text);
+    track_default_config(&loaded);
+    CHECK(track_params_parse_text(&loaded, text) == TRACK_PARAMS_EOK && same_config(&loaded, &config),
+          "detail listing did not round-trip");
+
+    // 缓冲区不足
+    CHECK(track_params_format(&config, text, 40, false) == 0 && text[0] == '\0', "short buffer");
+
+    // 出错的行跳过, 其余行生效
+    track_default_config(&loaded);
+    CHECK(track_params_parse_text(&loaded, "# 保存的参数\n"
+                                           "track.alpha = 2\n"
+                                           "track.beta = 0.3   # 注释\n"
+                                           "\n"
+                                           "track.unknown = 1\r\n"
+                                           "  track.coast_ms = 900") == TRACK_PARAMS_ERANGE,
+          "first error");
+    CHECK(loaded.alpha == 0.6f && loaded.beta == 0.3f && loaded.coast_ms == 900, "valid lines not applied: %g %g %u",
+          (double)loaded.alpha, (double)loaded.beta, (unsigned)loaded.coast_ms);
+    printf("text round trip: ok\n");
+}
+
+static void test_commands(void)
+{
+    track_config_t config;
+    char reply[768];
+    track_default_config(&config);
+
+    CHECK(track_params_command(&config, "track\r\n", reply, sizeof(reply)) == TRACK_PARAMS_EOK &&
+              strstr(reply, "track.servo_lag_ms = 30 # 0..500, default 30") != NULL,
+          "list: %s", reply);
+    CHECK(track_params_command(&config, "track set track.lead_ms 25", reply, sizeof(reply)) == TRACK_PARAMS_EOK &&
+              config.lead_ms == 25.0f && strcmp(reply, "track.lead_ms = 25") == 0,
+          "set: %s", reply);
+    CHECK(track_params_command(&config, "track set track.beta = 0.25", reply, sizeof(reply)) == TRACK_PARAMS_EOK &&
+              config.beta == 0.25f,
+          "set with '=': %s", reply);
+    CHECK(track_params_command(&config, "track.max_rate = 250 # 慢舵机", reply, sizeof(reply)) == TRACK_PARAMS_EOK &&
+              config.max_rate == 250.0f,
+          "assignment: %s", reply);
+    CHECK(track_params_command(&config, "track get track.max_rate", reply, sizeof(reply)) == TRACK_PARAMS_EOK &&
+              strcmp(reply, "track.max_rate = 250") == 0,
+          "get: %s", reply);
+
+    CHECK(track_params_command(&config, "track set track.alpha 3", reply, sizeof(reply)) == TRACK_PARAMS_ERANGE &&
+              strncmp(reply, "error: ", 7) == 0 && config.alpha == 0.6f,
+          "out of range: %s", reply);
+    CHECK(track_params_command(&config, "track get track.kp", reply, sizeof(reply)) == TRACK_PARAMS_ENOTFOUND &&
+              strstr(reply, "unknown parameter") != NULL,
+          "unknown get: %s", reply);
+    CHECK(track_params_command(&config, "track set track.alpha", reply, sizeof(reply)) == TRACK_PARAMS_EINVAL,
+          "set without value: %s", reply);
+    CHECK(track_params_command(&config, "tracking on", reply, sizeof(reply)) == TRACK_PARAMS_EINVAL &&
+              strstr(reply, "unknown command") != NULL,
+          "unknown command: %s", reply);
+
+    CHECK(track_params_command(&config, "track reset", reply, sizeof(reply)) == TRACK_PARAMS_EOK, "reset: %s",
+          reply);
+    track_config_t defaults;
+    track_default_config(&defaults);
+    CHECK(same_config(&config, &defaults), "reset did not restore defaults");
+    printf("commands: ok\n");
+}
+
+int main(void)
+{
+    test_fields();
+    test_text_round_trip();
+    test_commands();
+    return test_summary();
+}